@@ -0,0 +1,657 @@
+// Filename: generate.cpp
+// bamboo-cppgen generates a C++ header from one or more .dc files.  For each struct, and for each
+//     field of each dclass, the header declares a plain C++ struct holding the values of that type,
+//     with inline functions to encode it into a Datagram and to decode it from a DatagramIterator.
+//     The generated code calls Datagram's inline add/read functions directly, so serializing a
+//     message involves no Type lookups or virtual calls.  Fixed-size types also get a constexpr
+//     kFixedSize, and decode with a single bounds check.
+//
+//     Numbers are stored as their raw wire values; divisors and moduli are not applied.
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <set>
+#include "module/Module.h"
+#include "module/Class.h"
+#include "module/Array.h"
+#include "module/Method.h"
+#include "module/Parameter.h"
+#include "module/MolecularField.h"
+#include "dcfile/parse.h"
+using namespace std;
+using namespace bamboo;
+
+static void usage(const char *program)
+{
+    cerr << "Usage: " << program << " [options] file.dc [file.dc ...]\n"
+         << "Options:\n"
+         << "  -o <file>       write the header to <file> instead of stdout\n"
+         << "  -n <namespace>  put the generated code in <namespace> (default: none)\n"
+         << "  -k <keyword>    declare a keyword used by the .dc files (may be repeated)\n"
+         << "  -I <prefix>     prefix for #includes of bamboo headers (default: bamboo/)\n";
+}
+
+// A Generator writes the header for a module.
+class Generator
+{
+  public:
+    explicit Generator(ostream& out) : m_out(out) {}
+
+    bool generate(const Module *module, const string& ns, const string& include_prefix,
+                  const vector<string>& sources);
+
+  private:
+    // A Member is a data member of a generated struct.
+    struct Member {
+        string name;
+        const Type *type;
+        string record; // for molecular fields, the name of the generated field struct
+    };
+
+    bool write_struct(const Struct *record, int indent);
+    bool write_class(const Class *cls, int indent);
+    bool write_field(const Class *cls, const Field *field, int indent);
+    bool write_record(const string& name, const string& id_decl,
+                      const vector<Member>& members, int indent);
+
+    bool check_type(const Type *type, const string& context);
+    string cpp_type(const Type *type);
+
+    void write_size(const Type *type, const string& expr, const string& var, int indent, int depth);
+    void write_encode(const Type *type, const string& expr, int indent, int depth);
+    void write_decode(const Type *type, const string& expr, const string& in, int indent,
+                      int depth);
+
+    ostream& line(int indent)
+    {
+        return m_out << string(4 * indent, ' ');
+    }
+
+    ostream& m_out;
+};
+
+static const set<string> kReservedWords = {
+    "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool", "break",
+    "case", "catch", "char", "char16_t", "char32_t", "class", "compl", "const", "constexpr",
+    "const_cast", "continue", "decltype", "default", "delete", "do", "double", "dynamic_cast",
+    "else", "enum", "explicit", "export", "extern", "false", "float", "for", "friend", "goto",
+    "if", "inline", "int", "long", "mutable", "namespace", "new", "noexcept", "not", "not_eq",
+    "nullptr", "operator", "or", "or_eq", "private", "protected", "public", "register",
+    "reinterpret_cast", "return", "short", "signed", "sizeof", "static", "static_assert",
+    "static_cast", "struct", "switch", "template", "this", "thread_local", "throw", "true", "try",
+    "typedef", "typeid", "typename", "union", "unsigned", "using", "virtual", "void", "volatile",
+    "wchar_t", "while", "xor", "xor_eq",
+    // names used by the generated code
+    "dg", "dgi", "in", "encode", "decode", "read", "packed_size", "kFixedSize",
+    "kFieldId", "kClassId", "kTypeId"
+};
+
+// cpp_name returns a name which is safe to use as a C++ identifier.
+static string cpp_name(const string& name)
+{
+    if(kReservedWords.count(name) > 0) {
+        return name + "_";
+    }
+    return name;
+}
+
+// numeric_name returns the suffix of the Datagram add/read functions for a numeric type.
+static const char *numeric_name(Subtype subtype)
+{
+    switch(subtype) {
+    case kTypeChar: return "char";
+    case kTypeInt8: return "int8";
+    case kTypeInt16: return "int16";
+    case kTypeInt32: return "int32";
+    case kTypeInt64: return "int64";
+    case kTypeUint8: return "uint8";
+    case kTypeUint16: return "uint16";
+    case kTypeUint32: return "uint32";
+    case kTypeUint64: return "uint64";
+    case kTypeFloat32: return "float32";
+    case kTypeFloat64: return "float64";
+    default: return nullptr;
+    }
+}
+
+// numeric_type returns the C++ type of a numeric type.
+static const char *numeric_type(Subtype subtype)
+{
+    switch(subtype) {
+    case kTypeChar: return "char";
+    case kTypeInt8: return "int8_t";
+    case kTypeInt16: return "int16_t";
+    case kTypeInt32: return "int32_t";
+    case kTypeInt64: return "int64_t";
+    case kTypeUint8: return "uint8_t";
+    case kTypeUint16: return "uint16_t";
+    case kTypeUint32: return "uint32_t";
+    case kTypeUint64: return "uint64_t";
+    case kTypeFloat32: return "float";
+    case kTypeFloat64: return "double";
+    default: return nullptr;
+    }
+}
+
+bool Generator::generate(const Module *module, const string& ns, const string& include_prefix,
+                         const vector<string>& sources)
+{
+    m_out << "// This file was generated by bamboo-cppgen from:\n";
+    for(const string& source : sources) {
+        m_out << "//     " << source << '\n';
+    }
+    m_out << "// Do not edit it by hand.\n"
+          << "#pragma once\n"
+          << "#include <stddef.h>\n"
+          << "#include <stdint.h>\n"
+          << "#include <string.h>\n"
+          << "#include <array>\n"
+          << "#include <string>\n"
+          << "#include <vector>\n"
+          << "#include <" << include_prefix << "wire/Datagram.h>\n"
+          << "#include <" << include_prefix << "wire/DatagramIterator.h>\n";
+    if(!ns.empty()) {
+        m_out << "namespace " << ns << "\n{\n";
+    }
+
+    for(unsigned int i = 0; i < module->num_structs(); ++i) {
+        m_out << '\n';
+        if(!write_struct(module->get_struct(i), 0)) { return false; }
+    }
+    for(unsigned int i = 0; i < module->num_classes(); ++i) {
+        m_out << '\n';
+        if(!write_class(module->get_class(i), 0)) { return false; }
+    }
+
+    if(!ns.empty()) {
+        m_out << "\n} // close namespace " << ns << '\n';
+    }
+    return true;
+}
+
+bool Generator::write_struct(const Struct *record, int indent)
+{
+    vector<Member> members;
+    for(unsigned int i = 0; i < record->num_fields(); ++i) {
+        const Field *field = record->get_field(i);
+        string name = field->name().empty() ? "field" + to_string(i) : cpp_name(field->name());
+        if(!check_type(field->type(), record->name() + "." + name)) { return false; }
+        members.push_back(Member{name, field->type(), ""});
+    }
+
+    line(indent) << "// " << record->name() << " is the struct " << record->name() << ".\n";
+    return write_record(cpp_name(record->name()),
+                        "static constexpr unsigned int kTypeId = " + to_string(record->id()) + ";",
+                        members, indent);
+}
+
+bool Generator::write_class(const Class *cls, int indent)
+{
+    line(indent) << "// " << cls->name() << " is the dclass " << cls->name() << ".\n";
+    line(indent) << "struct " << cpp_name(cls->name());
+    for(unsigned int i = 0; i < cls->num_parents(); ++i) {
+        m_out << (i == 0 ? " : " : ", ") << "public " << cpp_name(cls->get_parent(i)->name());
+    }
+    m_out << " {\n";
+    line(indent + 1) << "static constexpr unsigned int kClassId = " << cls->id() << ";\n";
+
+    // Inherited fields are declared by the parent's struct
+    for(unsigned int i = 0; i < cls->num_base_fields(); ++i) {
+        m_out << '\n';
+        if(!write_field(cls, cls->get_base_field(i), indent + 1)) { return false; }
+    }
+    line(indent) << "};\n";
+    return true;
+}
+
+bool Generator::write_field(const Class *cls, const Field *field, int indent)
+{
+    string name = cpp_name(field->name());
+    string context = cls->name() + "." + field->name();
+    string id_decl = "static constexpr unsigned int kFieldId = " + to_string(field->id()) + ";";
+
+    vector<Member> members;
+    const MolecularField *molecular = field->as_molecular();
+    if(molecular != nullptr) {
+        // A molecular field is made up of the values of its atomic fields
+        for(unsigned int i = 0; i < molecular->num_fields(); ++i) {
+            const Field *atomic = molecular->get_field(i);
+            members.push_back(Member{cpp_name(atomic->name()), atomic->type(),
+                                     cpp_name(cls->name()) + "::" + cpp_name(atomic->name())});
+        }
+        line(indent) << "// " << name << " is the molecular field " << context << ".\n";
+    } else if(field->type()->subtype() == kTypeMethod) {
+        const Method *method = field->type()->as_method();
+        for(unsigned int i = 0; i < method->num_parameters(); ++i) {
+            const Parameter *param = method->get_parameter(i);
+            string param_name = param->name().empty() ? "arg" + to_string(i)
+                                                      : cpp_name(param->name());
+            if(!check_type(param->type(), context + "." + param_name)) { return false; }
+            members.push_back(Member{param_name, param->type(), ""});
+        }
+        line(indent) << "// " << name << " holds the arguments of " << context << ".\n";
+    } else {
+        if(!check_type(field->type(), context)) { return false; }
+        members.push_back(Member{"value", field->type(), ""});
+        line(indent) << "// " << name << " holds the value of " << context << ".\n";
+    }
+
+    return write_record(name, id_decl, members, indent);
+}
+
+// check_type returns false, and prints an error, if the type can't be used as a member.
+bool Generator::check_type(const Type *type, const string& context)
+{
+    switch(type->subtype()) {
+    case kTypeMethod:
+        cerr << "Error: " << context << " has a method type, which can't be generated.\n";
+        return false;
+    case kTypeStruct:
+        if(type->as_struct()->as_class() != nullptr) {
+            cerr << "Error: " << context << " has a dclass type, which can't be generated.\n";
+            return false;
+        }
+        return true;
+    case kTypeArray:
+    case kTypeVararray:
+        return check_type(type->as_array()->element_type(), context);
+    case kTypeInvalid:
+        cerr << "Error: " << context << " has an invalid type.\n";
+        return false;
+    default:
+        return true;
+    }
+}
+
+// cpp_type returns the C++ type used to hold a value of the type.
+string Generator::cpp_type(const Type *type)
+{
+    if(numeric_type(type->subtype()) != nullptr) {
+        return numeric_type(type->subtype());
+    }
+
+    switch(type->subtype()) {
+    case kTypeString:
+    case kTypeVarstring:
+        return "std::string";
+    case kTypeBlob:
+        return "std::array<uint8_t, " + to_string(type->fixed_size()) + ">";
+    case kTypeVarblob:
+        return "std::vector<uint8_t>";
+    case kTypeArray: {
+        const Array *array = type->as_array();
+        return "std::array<" + cpp_type(array->element_type()) + ", " +
+               to_string(array->array_size()) + ">";
+    }
+    case kTypeVararray:
+        return "std::vector<" + cpp_type(type->as_array()->element_type()) + ">";
+    case kTypeStruct:
+        return cpp_name(type->as_struct()->name());
+    default:
+        return "void";
+    }
+}
+
+bool Generator::write_record(const string& name, const string& id_decl,
+                             const vector<Member>& members, int indent)
+{
+    bool fixed = true;
+    size_t fixed_size = 0;
+    for(const Member& member : members) {
+        if(!member.type->has_fixed_size()) {
+            fixed = false;
+        }
+        fixed_size += member.type->fixed_size();
+    }
+
+    line(indent) << "struct " << name << " {\n";
+    line(indent + 1) << id_decl << '\n';
+    if(fixed) {
+        line(indent + 1) << "static constexpr size_t kFixedSize = " << fixed_size << ";\n";
+    }
+    m_out << '\n';
+
+    // Members
+    for(const Member& member : members) {
+        string type = member.record.empty() ? cpp_type(member.type) : member.record;
+        line(indent + 1) << type << ' ' << member.name << "{};\n";
+    }
+    m_out << '\n';
+
+    // packed_size
+    line(indent + 1) << "// packed_size returns the number of bytes the value takes in a datagram.\n";
+    line(indent + 1) << "size_t packed_size() const\n";
+    line(indent + 1) << "{\n";
+    if(fixed) {
+        line(indent + 2) << "return kFixedSize;\n";
+    } else {
+        line(indent + 2) << "size_t size_ = 0;\n";
+        for(const Member& member : members) {
+            if(!member.record.empty()) {
+                line(indent + 2) << "size_ += " << member.name << ".packed_size();\n";
+            } else {
+                write_size(member.type, member.name, "size_", indent + 2, 0);
+            }
+        }
+        line(indent + 2) << "return size_;\n";
+    }
+    line(indent + 1) << "}\n\n";
+
+    // encode
+    line(indent + 1) << "// encode adds the value to the end of a datagram.\n";
+    line(indent + 1) << "void encode(bamboo::Datagram& dg) const\n";
+    line(indent + 1) << "{\n";
+    for(const Member& member : members) {
+        if(!member.record.empty()) {
+            line(indent + 2) << member.name << ".encode(dg);\n";
+        } else {
+            write_encode(member.type, member.name, indent + 2, 0);
+        }
+    }
+    if(members.empty()) {
+        line(indent + 2) << "(void)dg;\n";
+    }
+    line(indent + 1) << "}\n\n";
+
+    // decode
+    line(indent + 1) << "// decode reads the value from a datagram.\n";
+    line(indent + 1) << "//     Throws DatagramIteratorEOF if the datagram ends before the value.\n";
+    line(indent + 1) << "void decode(bamboo::DatagramIterator& dgi)\n";
+    line(indent + 1) << "{\n";
+    if(fixed) {
+        line(indent + 2) << "bamboo::ValidatedRegion region_ = "
+                         << "dgi.validate(bamboo::sizetag_t(kFixedSize));\n";
+        line(indent + 2) << "read(region_);\n";
+    } else {
+        line(indent + 2) << "read(dgi);\n";
+    }
+    line(indent + 1) << "}\n\n";
+
+    // read
+    line(indent + 1) << "// read decodes the value from a DatagramIterator or a ValidatedRegion.\n";
+    line(indent + 1) << "template<typename Reader>\n";
+    line(indent + 1) << "void read(Reader& in)\n";
+    line(indent + 1) << "{\n";
+    for(const Member& member : members) {
+        if(!member.record.empty()) {
+            line(indent + 2) << member.name << ".read(in);\n";
+        } else {
+            write_decode(member.type, member.name, "in", indent + 2, 0);
+        }
+    }
+    if(members.empty()) {
+        line(indent + 2) << "(void)in;\n";
+    }
+    line(indent + 1) << "}\n";
+
+    line(indent) << "};\n";
+    return true;
+}
+
+// write_size writes statements which add the packed size of <expr> to the variable <var>.
+void Generator::write_size(const Type *type, const string& expr, const string& var,
+                           int indent, int depth)
+{
+    if(type->has_fixed_size()) {
+        line(indent) << var << " += " << type->fixed_size() << ";\n";
+        return;
+    }
+
+    string element = "e" + to_string(depth) + "_";
+    switch(type->subtype()) {
+    case kTypeVarstring:
+    case kTypeVarblob:
+        line(indent) << var << " += sizeof(bamboo::sizetag_t) + " << expr << ".size();\n";
+        break;
+    case kTypeVararray: {
+        const Type *element_type = type->as_array()->element_type();
+        line(indent) << var << " += sizeof(bamboo::sizetag_t);\n";
+        if(element_type->has_fixed_size()) {
+            line(indent) << var << " += " << expr << ".size() * " << element_type->fixed_size()
+                         << ";\n";
+        } else {
+            line(indent) << "for(const auto& " << element << " : " << expr << ") {\n";
+            write_size(element_type, element, var, indent + 1, depth + 1);
+            line(indent) << "}\n";
+        }
+        break;
+    }
+    case kTypeStruct:
+        line(indent) << var << " += " << expr << ".packed_size();\n";
+        break;
+    default:
+        break;
+    }
+}
+
+// write_encode writes statements which add <expr> to the datagram "dg".
+void Generator::write_encode(const Type *type, const string& expr, int indent, int depth)
+{
+    Subtype subtype = type->subtype();
+    if(numeric_name(subtype) != nullptr) {
+        line(indent) << "dg.add_" << numeric_name(subtype) << '(' << expr << ");\n";
+        return;
+    }
+
+    string element = "e" + to_string(depth) + "_";
+    string length = "length" + to_string(depth) + "_";
+    switch(subtype) {
+    case kTypeString: {
+        // Fixed-length strings are truncated, or padded with zeros, to their length
+        size_t fixed = type->fixed_size();
+        line(indent) << "{\n";
+        line(indent + 1) << "size_t " << length << " = " << expr << ".size() < " << fixed
+                         << " ? " << expr << ".size() : " << fixed << ";\n";
+        line(indent + 1) << "dg.add_data(" << expr << ".data(), bamboo::sizetag_t(" << length
+                         << "));\n";
+        line(indent + 1) << "memset(dg.add_buffer(bamboo::sizetag_t(" << fixed << " - " << length
+                         << ")), 0, " << fixed << " - " << length << ");\n";
+        line(indent) << "}\n";
+        break;
+    }
+    case kTypeVarstring:
+        line(indent) << "dg.add_string(" << expr << ");\n";
+        break;
+    case kTypeBlob:
+        line(indent) << "dg.add_data(" << expr << ".data(), " << type->fixed_size() << ");\n";
+        break;
+    case kTypeVarblob:
+        line(indent) << "dg.add_blob(" << expr << ".data(), bamboo::sizetag_t(" << expr
+                     << ".size()));\n";
+        break;
+    case kTypeArray: {
+        const Array *array = type->as_array();
+        if(array->element_type()->as_numeric() != nullptr) {
+            line(indent) << "dg.add_array(" << expr << ".data(), " << array->array_size()
+                         << ");\n";
+        } else {
+            line(indent) << "for(const auto& " << element << " : " << expr << ") {\n";
+            write_encode(array->element_type(), element, indent + 1, depth + 1);
+            line(indent) << "}\n";
+        }
+        break;
+    }
+    case kTypeVararray: {
+        const Type *element_type = type->as_array()->element_type();
+        line(indent) << "{\n";
+        if(element_type->has_fixed_size()) {
+            line(indent + 1) << "size_t " << length << " = " << expr << ".size() * "
+                             << element_type->fixed_size() << ";\n";
+        } else {
+            line(indent + 1) << "size_t " << length << " = 0;\n";
+            line(indent + 1) << "for(const auto& " << element << " : " << expr << ") {\n";
+            write_size(element_type, element, length, indent + 2, depth + 1);
+            line(indent + 1) << "}\n";
+        }
+        line(indent + 1) << "dg.add_size(bamboo::sizetag_t(" << length << "));\n";
+        if(element_type->as_numeric() != nullptr) {
+            line(indent + 1) << "dg.add_array(" << expr << ".data(), " << expr << ".size());\n";
+        } else {
+            line(indent + 1) << "for(const auto& " << element << " : " << expr << ") {\n";
+            write_encode(element_type, element, indent + 2, depth + 1);
+            line(indent + 1) << "}\n";
+        }
+        line(indent) << "}\n";
+        break;
+    }
+    case kTypeStruct:
+        line(indent) << expr << ".encode(dg);\n";
+        break;
+    default:
+        break;
+    }
+}
+
+// write_decode writes statements which read <expr> from the reader <in>.
+void Generator::write_decode(const Type *type, const string& expr, const string& in,
+                             int indent, int depth)
+{
+    Subtype subtype = type->subtype();
+    if(numeric_name(subtype) != nullptr) {
+        line(indent) << expr << " = " << in << ".read_" << numeric_name(subtype) << "();\n";
+        return;
+    }
+
+    string element = "e" + to_string(depth) + "_";
+    string view = "view" + to_string(depth) + "_";
+    string iter = "it" + to_string(depth) + "_";
+    switch(subtype) {
+    case kTypeString:
+    case kTypeVarstring:
+        line(indent) << "{\n";
+        if(subtype == kTypeString) {
+            line(indent + 1) << "bamboo::DatagramView " << view << " = " << in
+                             << ".read_data_view(" << type->fixed_size() << ");\n";
+        } else {
+            line(indent + 1) << "bamboo::DatagramView " << view << " = " << in
+                             << ".read_data_view(" << in << ".read_size());\n";
+        }
+        line(indent + 1) << expr << ".assign(" << view << ".chars(), " << view << ".size());\n";
+        line(indent) << "}\n";
+        break;
+    case kTypeBlob:
+        line(indent) << "memcpy(" << expr << ".data(), " << in << ".read_data_view("
+                     << type->fixed_size() << ").data(), " << type->fixed_size() << ");\n";
+        break;
+    case kTypeVarblob:
+        line(indent) << "{\n";
+        line(indent + 1) << "bamboo::DatagramView " << view << " = " << in
+                         << ".read_data_view(" << in << ".read_size());\n";
+        line(indent + 1) << expr << ".assign(" << view << ".data(), " << view << ".data() + "
+                         << view << ".size());\n";
+        line(indent) << "}\n";
+        break;
+    case kTypeArray: {
+        const Array *array = type->as_array();
+        const Type *element_type = array->element_type();
+        if(element_type->as_numeric() != nullptr) {
+            line(indent) << "bamboo::swap_le_array<" << cpp_type(element_type) << ">(" << expr
+                         << ".data(), " << in << ".read_data_view(" << type->fixed_size()
+                         << ").data(), " << array->array_size() << ");\n";
+        } else {
+            line(indent) << "for(auto& " << element << " : " << expr << ") {\n";
+            write_decode(element_type, element, in, indent + 1, depth + 1);
+            line(indent) << "}\n";
+        }
+        break;
+    }
+    case kTypeVararray: {
+        const Type *element_type = type->as_array()->element_type();
+        line(indent) << "{\n";
+        if(element_type->as_numeric() != nullptr) {
+            size_t width = element_type->fixed_size();
+            line(indent + 1) << "bamboo::DatagramView " << view << " = " << in
+                             << ".read_data_view(" << in << ".read_size());\n";
+            if(width > 1) {
+                line(indent + 1) << "if(" << view << ".size() % " << width << " != 0) {\n";
+                line(indent + 2) << "throw bamboo::DatagramIteratorEOF(\"" << expr
+                                 << " ends partway through an element\");\n";
+                line(indent + 1) << "}\n";
+            }
+            line(indent + 1) << expr << ".resize(" << view << ".size() / " << width << ");\n";
+            line(indent + 1) << "bamboo::swap_le_array<" << cpp_type(element_type) << ">("
+                             << expr << ".data(), " << view << ".data(), " << expr
+                             << ".size());\n";
+        } else {
+            line(indent + 1) << "bamboo::DatagramIterator " << iter << "(" << in
+                             << ".read_data_view(" << in << ".read_size()));\n";
+            line(indent + 1) << expr << ".clear();\n";
+            if(element_type->has_fixed_size()) {
+                line(indent + 1) << expr << ".reserve(" << iter << ".remaining() / "
+                                 << element_type->fixed_size() << ");\n";
+            }
+            line(indent + 1) << "while(" << iter << ".remaining() > 0) {\n";
+            line(indent + 2) << expr << ".emplace_back();\n";
+            write_decode(element_type, expr + ".back()", iter, indent + 2, depth + 1);
+            line(indent + 1) << "}\n";
+        }
+        line(indent) << "}\n";
+        break;
+    }
+    case kTypeStruct:
+        line(indent) << expr << ".read(" << in << ");\n";
+        break;
+    default:
+        break;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    string output, ns, include_prefix = "bamboo/";
+    vector<string> keywords, sources;
+    for(int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if((arg == "-o" || arg == "-n" || arg == "-k" || arg == "-I") && i + 1 < argc) {
+            string value = argv[++i];
+            if(arg == "-o") { output = value; }
+            else if(arg == "-n") { ns = value; }
+            else if(arg == "-k") { keywords.push_back(value); }
+            else { include_prefix = value; }
+        } else if(arg == "-h" || arg == "--help") {
+            usage(argv[0]);
+            return 0;
+        } else if(!arg.empty() && arg[0] == '-') {
+            usage(argv[0]);
+            return 1;
+        } else {
+            sources.push_back(arg);
+        }
+    }
+    if(sources.empty()) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    Module module;
+    for(const string& keyword : keywords) {
+        module.add_keyword(keyword);
+    }
+    for(const string& source : sources) {
+        if(!parse_dcfile(&module, source)) {
+            cerr << "Error: could not parse " << source << ".\n";
+            return 1;
+        }
+    }
+
+    // Generate into memory first, so that a failure doesn't leave a partial header behind
+    stringstream header;
+    Generator generator(header);
+    if(!generator.generate(&module, ns, include_prefix, sources)) {
+        return 1;
+    }
+
+    if(output.empty()) {
+        cout << header.str();
+    } else {
+        ofstream file(output.c_str());
+        file << header.str();
+        if(!file) {
+            cerr << "Error: could not write " << output << ".\n";
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -262,7 +262,7 @@ def generate(file_):
     add_method(clsField, 'has_default_value', retval('bool'), [], is_const = True),
     #add_method(clsField, 'default_value', retval('const bamboo::Value'), [], is_const = True)
     add_method(clsField, 'set_name', retval('bool'), [param('std::string', 'name')])
-    add_method(clsField, 'set_type', None,
+    add_method(clsField, 'set_type', retval('bool'),
                [param('bamboo::Type *', 'type', transfer_ownership = False)]),
     #add_method(clsField, 'set_default_value', retval('bool'), [param('const bamboo::Value', 'value')])
     #add_method(clsField, 'set_default_value', retval('bool'), [param('const bamboo::Buffer&', 'value')])
@@ -4624,6 +4624,7 @@ PyObject *
 _wrap_PyBambooField_set_type(PyBambooField *self, PyObject *args, PyObject *kwargs)
 {
     PyObject *py_retval;
+    bool retval;
     PyBambooType *type;
     bamboo::Type *type_ptr;
     const char *keywords[] = {"type", NULL};
@@ -4632,9 +4633,8 @@ _wrap_PyBambooField_set_type(PyBambooField *self, PyObject *args, PyObject *kwar
         return NULL;
     }
     type_ptr = (type ? type->obj : NULL);
-    self->obj->set_type(type_ptr);
-    Py_INCREF(Py_None);
-    py_retval = Py_None;
+    retval = self->obj->set_type(type_ptr);
+    py_retval = Py_BuildValue((char *) "N", PyBool_FromLong(retval));
     return py_retval;
 }
 
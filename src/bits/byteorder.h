@@ -1,5 +1,9 @@
 // Filename: byteorder.h
 #pragma once
+#include <stdint.h> // for uint16_t, uint32_t, uint64_t
+#include <stddef.h> // for size_t
+#include <string.h> // for memcpy
+#include <type_traits> // for std::is_arithmetic, std::integral_constant
 namespace bamboo   // open namespace bamboo
 {
 
@@ -40,20 +44,134 @@ static inline uint64_t swap_le_64(uint64_t x)
            (x & 0xff00000000000000) >> 56;
 }
 
-#define swap_le(var) \
-( \
-    (sizeof(var) == 8) ? \
-        bamboo::swap_le_64(var) : \
-    (sizeof(var) == 4) ? \
-        bamboo::swap_le_32(var) : \
-    (sizeof(var) == 2) ? \
-        bamboo::swap_le_16(var) : \
-    var \
-)
+static inline int8_t swap_le(int8_t x) { return x; }
+static inline uint8_t swap_le(uint8_t x) { return x; }
+static inline char swap_le(char x) { return x; }
+static inline bool swap_le(bool x) { return x; }
+static inline int16_t swap_le(int16_t x) { return (int16_t)swap_le_16((uint16_t)x); }
+static inline uint16_t swap_le(uint16_t x) { return swap_le_16(x); }
+static inline int32_t swap_le(int32_t x) { return (int32_t)swap_le_32((uint32_t)x); }
+static inline uint32_t swap_le(uint32_t x) { return swap_le_32(x); }
+static inline int64_t swap_le(int64_t x) { return (int64_t)swap_le_64((uint64_t)x); }
+static inline uint64_t swap_le(uint64_t x) { return swap_le_64(x); }
+
+// Floating point values have to be swapped as raw bits, not converted to integers.
+static inline float swap_le(float x)
+{
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    bits = swap_le_32(bits);
+    memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+static inline double swap_le(double x)
+{
+    uint64_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    bits = swap_le_64(bits);
+    memcpy(&x, &bits, sizeof(x));
+    return x;
+}
 
 #else // (#ifdef PLATFORM_BIG_ENDIAN)
 #define swap_le(var) (var)
 #endif
 
+// On big-endian platforms with a byte-permute instruction (ie. AltiVec/VSX, the z/Architecture
+// vector facility, or NEON), GCC and Clang can swap 16 bytes at a time with a generic vector
+// shuffle.  Without one, the shuffle is emulated a byte at a time and is slower than swapping
+// each value, so the vector path is only enabled when the target has a permute.
+#if defined(PLATFORM_BIG_ENDIAN) && defined(__GNUC__) && \
+    (defined(__ALTIVEC__) || defined(__VX__) || defined(__ARM_NEON) || defined(__SSSE3__))
+#define BAMBOO_SWAP_VECTOR
+typedef uint8_t swap_vector_t __attribute__((vector_size(16)));
+
+#if defined(__clang__)
+#define BAMBOO_SHUFFLE_BYTES(v, ...) __builtin_shufflevector(v, v, __VA_ARGS__)
+#else
+#define BAMBOO_SHUFFLE_BYTES(v, ...) __builtin_shuffle(v, swap_vector_t{__VA_ARGS__})
+#endif
+
+// swap_vector reverses the bytes of each <width>-byte value in a vector.
+static inline swap_vector_t swap_vector(swap_vector_t v, std::integral_constant<size_t, 1>)
+{
+    return v;
+}
+static inline swap_vector_t swap_vector(swap_vector_t v, std::integral_constant<size_t, 2>)
+{
+    return BAMBOO_SHUFFLE_BYTES(v, 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+}
+static inline swap_vector_t swap_vector(swap_vector_t v, std::integral_constant<size_t, 4>)
+{
+    return BAMBOO_SHUFFLE_BYTES(v, 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+}
+static inline swap_vector_t swap_vector(swap_vector_t v, std::integral_constant<size_t, 8>)
+{
+    return BAMBOO_SHUFFLE_BYTES(v, 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+}
+#endif
+
+// swap_le_array copies <count> values of type T from <src> to <dst>, converting each value
+//     between native byte-order and little-endian.  Neither pointer has to be aligned.
+//     On little-endian platforms this is a single memcpy; on big-endian platforms it swaps
+//     16 bytes at a time with a vector shuffle (when the target supports it), then swaps
+//     any remaining values one at a time.
+template<typename T>
+inline void swap_le_array(void *dst, const void *src, size_t count)
+{
+#ifdef PLATFORM_BIG_ENDIAN
+    uint8_t *out = (uint8_t *)dst;
+    const uint8_t *in = (const uint8_t *)src;
+    size_t i = 0;
+#ifdef BAMBOO_SWAP_VECTOR
+    size_t num_vectors = count * sizeof(T) / sizeof(swap_vector_t);
+    for(size_t n = 0; n < num_vectors; ++n) {
+        swap_vector_t v;
+        memcpy(&v, in + n * sizeof(v), sizeof(v));
+        v = swap_vector(v, std::integral_constant<size_t, sizeof(T)>());
+        memcpy(out + n * sizeof(v), &v, sizeof(v));
+    }
+    i = num_vectors * sizeof(swap_vector_t) / sizeof(T);
+#endif
+    for(; i < count; ++i) {
+        T value;
+        memcpy(&value, in + i * sizeof(T), sizeof(T));
+        value = swap_le(value);
+        memcpy(out + i * sizeof(T), &value, sizeof(T));
+    }
+#else
+    if(count > 0) {
+        memcpy(dst, src, count * sizeof(T));
+    }
+#endif
+}
+
+// store_le writes a numeric value to <dst> in little-endian.  The pointer doesn't have to be aligned.
+template<typename T>
+inline void store_le(uint8_t *dst, T value)
+{
+    value = swap_le(value);
+    memcpy(dst, &value, sizeof(T));
+}
+
+// load_le reads a little-endian numeric value from <src>.  The pointer doesn't have to be aligned.
+template<typename T>
+inline T load_le(const uint8_t *src)
+{
+    T value;
+    memcpy(&value, src, sizeof(T));
+    return swap_le(value);
+}
+
+// packed_sizeof is the total size in bytes of a sequence of numeric types, with no padding.
+template<typename... Ts>
+struct packed_sizeof : std::integral_constant<size_t, 0> {};
+template<typename T, typename... Ts>
+struct packed_sizeof<T, Ts...> :
+    std::integral_constant<size_t, sizeof(T) + packed_sizeof<Ts...>::value>
+{
+    static_assert(std::is_arithmetic<T>::value, "packed_sizeof requires numeric types");
+};
+
 
 } // close namespace bamboo
@@ -0,0 +1,873 @@
+// Filename: compile.cpp
+#include "compile.h"
+#include <fstream>       // std::ifstream, std::ofstream
+#include <memory>        // std::unique_ptr
+#include <stdexcept>     // std::runtime_error
+#include <string.h>      // memcpy, memchr
+#include <unordered_map> // std::unordered_map
+#ifndef _WIN32
+#include <fcntl.h>       // open
+#include <sys/mman.h>    // mmap, munmap
+#include <sys/stat.h>    // fstat
+#include <unistd.h>      // close
+#endif
+#include "../bits/byteorder.h"
+#include "../bits/sizetag.h"
+#include "../module/Module.h"
+#include "../module/Type.h"
+#include "../module/Numeric.h"
+#include "../module/Array.h"
+#include "../module/Method.h"
+#include "../module/Parameter.h"
+#include "../module/Struct.h"
+#include "../module/Class.h"
+#include "../module/Field.h"
+#include "../module/MolecularField.h"
+#include "../module/Value.h"
+#include "../wire/DatagramIterator.h"
+using namespace std;
+namespace bamboo   // open namespace bamboo
+{
+
+
+// The file starts with a header of 32-bit words, followed by each of the sections.
+//     Every section starts on a 4-byte boundary; all values are little-endian.
+static const uint8_t kMagic[4] = { 'B', 'M', 'B', 'C' };
+static const uint32_t kVersion = 1;
+static const uint32_t kNone = 0xFFFFFFFF;
+
+enum HeaderWord {
+    kHeaderMagic,
+    kHeaderVersion,
+    kHeaderSizetag,     // sizeof(sizetag_t) in the library that compiled the module
+    kHeaderLength,      // the length of the whole file in bytes
+    kHeaderModuleTypes, // the number of types that belong to the module (ie. structs and classes)
+    kHeaderFirstKeyword,
+    kHeaderNumKeywords,
+    kHeaderSections     // followed by an (offset, count) pair for each section
+};
+
+enum Section {
+    kSectionStrings,    // NUL-terminated names; count is the size in bytes
+    kSectionBytes,      // packed default values; count is the size in bytes
+    kSectionRefs,       // lists of 32-bit indices or string offsets, referred to by other records
+    kSectionTypes,
+    kSectionFields,     // indexed by field id
+    kSectionParameters,
+    kSectionTypedefs,
+    kSectionImports,
+    kNumSections
+};
+static const size_t kHeaderWords = kHeaderSections + 2 * kNumSections;
+
+// The size of each section's records, in 32-bit words
+static const size_t kRecordWords[kNumSections] = { 0, 0, 1, 11, 10, 5, 2, 3 };
+
+// A TypeRecord starts with a kind, a Subtype, and an alias; the rest depends on the kind.
+enum TypeKind {
+    kKindInvalid,   // Type::invalid
+    kKindNumeric,   // divisor, modulus (2 words), range
+    kKindArray,     // element type, unused, unused, range
+    kKindMethod,    // first parameter, number of parameters
+    kKindStruct,    // name, first field (refs), number of fields
+    kKindClass,     // name, first field (refs), number of fields, first parent (refs), num parents
+    kKindMolecular  // the id of the molecular field
+};
+// A range is stored as a Number::Type, followed by the raw 64-bit min and max (2 words each).
+static const size_t kRangeWord = 6;
+
+// A FieldRecord is a name, type, molecular flag, first keyword (refs), number of keywords,
+//     default value flag, offset and length (bytes), first member (refs), number of members.
+// A ParameterRecord is a name, type, default value flag, offset and length (bytes).
+// A TypedefRecord is a name and type.
+// An ImportRecord is a module name, first symbol (refs), number of symbols.
+
+// A ModuleCompiler assigns indices to a module's types and lays out its records.
+class ModuleCompiler
+{
+  public:
+    explicit ModuleCompiler(const Module *module) : m_module(module) {}
+
+    vector<uint8_t> compile()
+    {
+        // The module's types come first, so a type's index is also its id
+        for(unsigned int i = 0; i < m_module->num_types(); ++i) {
+            add_type(m_module->type_by_id(i));
+        }
+
+        // Fields, typedefs, and the types themselves may refer to more types, which are added
+        //     to the end of the list; each of those is written when the loop reaches it.
+        for(unsigned int id = 0; id < m_module->num_fields(); ++id) {
+            add_field(m_module->field_by_id(id));
+        }
+        for(unsigned int n = 0; n < m_module->num_typedefs(); ++n) {
+            m_sections[kSectionTypedefs].push_back(add_string(m_module->get_typedef_name(n)));
+            m_sections[kSectionTypedefs].push_back(add_type(m_module->get_typedef_type(n)));
+        }
+        for(size_t i = 0; i < m_types.size(); ++i) {
+            write_type(m_types[i]);
+        }
+
+        for(unsigned int n = 0; n < m_module->num_imports(); ++n) {
+            const Import *import = m_module->get_import(n);
+            vector<uint32_t>& record = m_sections[kSectionImports];
+            record.push_back(add_string(import->module));
+            record.push_back((uint32_t)m_sections[kSectionRefs].size());
+            record.push_back((uint32_t)import->symbols.size());
+            for(const string& symbol : import->symbols) {
+                m_sections[kSectionRefs].push_back(add_string(symbol));
+            }
+        }
+
+        uint32_t first_keyword = (uint32_t)m_sections[kSectionRefs].size();
+        for(unsigned int n = 0; n < m_module->num_keywords(); ++n) {
+            m_sections[kSectionRefs].push_back(add_string(m_module->get_keyword(n)));
+        }
+
+        return layout(first_keyword);
+    }
+
+  private:
+    uint32_t add_string(const string& str)
+    {
+        if(str.empty()) { return kNone; }
+
+        auto it = m_strings_by_value.find(str);
+        if(it != m_strings_by_value.end()) { return it->second; }
+
+        uint32_t offset = (uint32_t)m_strings.size();
+        m_strings.insert(m_strings.end(), str.begin(), str.end());
+        m_strings.push_back('\0');
+        m_strings_by_value[str] = offset;
+        return offset;
+    }
+
+    uint32_t add_type(const Type *type)
+    {
+        auto it = m_indices.find(type);
+        if(it != m_indices.end()) { return it->second; }
+
+        uint32_t index = (uint32_t)m_types.size();
+        m_indices[type] = index;
+        m_types.push_back(type);
+        return index;
+    }
+
+    // add_field_type adds the type of a non-molecular field.  A field owns its type, so unless
+    //     the type is a struct, it is given a record of its own which nothing else refers to,
+    //     even if the module shares the type with a typedef or another field.
+    uint32_t add_field_type(const Type *type)
+    {
+        if(type->as_struct() != nullptr) { return add_type(type); }
+
+        uint32_t index = (uint32_t)m_types.size();
+        m_types.push_back(type);
+        return index;
+    }
+
+    void add_default(vector<uint32_t>& record, const Value *value)
+    {
+        if(value == nullptr) {
+            record.insert(record.end(), { 0, 0, 0 });
+            return;
+        }
+
+        size_t offset = m_bytes.size();
+        m_bytes.resize(offset + value->packed_size());
+        value->pack_into(m_bytes.data() + offset);
+        record.insert(record.end(), { 1, (uint32_t)offset, (uint32_t)(m_bytes.size() - offset) });
+    }
+
+    void add_field(const Field *field)
+    {
+        const MolecularField *molecular = field->as_molecular();
+        vector<uint32_t> record;
+        record.push_back(add_string(field->name()));
+        record.push_back(molecular != nullptr ? add_type(field->type()) : add_field_type(field->type()));
+        record.push_back(molecular != nullptr ? 1 : 0);
+        if(molecular != nullptr) { m_molecular_ids[field->type()] = field->id(); }
+
+        record.push_back((uint32_t)m_sections[kSectionRefs].size());
+        record.push_back((uint32_t)field->num_keywords());
+        for(unsigned int n = 0; n < field->num_keywords(); ++n) {
+            m_sections[kSectionRefs].push_back(add_string(field->get_keyword(n)));
+        }
+
+        add_default(record, field->has_default_value() ? field->default_value() : nullptr);
+
+        record.push_back((uint32_t)m_sections[kSectionRefs].size());
+        record.push_back(molecular != nullptr ? (uint32_t)molecular->num_fields() : 0);
+        for(unsigned int n = 0; molecular != nullptr && n < molecular->num_fields(); ++n) {
+            m_sections[kSectionRefs].push_back(molecular->get_field(n)->id());
+        }
+
+        vector<uint32_t>& fields = m_sections[kSectionFields];
+        fields.insert(fields.end(), record.begin(), record.end());
+    }
+
+    void write_range(uint32_t *record, const NumericRange& range)
+    {
+        record[kRangeWord] = (uint32_t)range.type;
+        record[kRangeWord + 1] = (uint32_t)range.min.uinteger;
+        record[kRangeWord + 2] = (uint32_t)(range.min.uinteger >> 32);
+        record[kRangeWord + 3] = (uint32_t)range.max.uinteger;
+        record[kRangeWord + 4] = (uint32_t)(range.max.uinteger >> 32);
+    }
+
+    void write_type(const Type *type)
+    {
+        uint32_t record[11] = { kKindInvalid, (uint32_t)type->subtype(), kNone };
+        if(type->has_alias()) { record[2] = add_string(type->alias()); }
+
+        const Struct *strct = type->as_struct();
+        auto molecular = m_molecular_ids.find(type);
+        if(molecular != m_molecular_ids.end()) {
+            // A molecular field is its own type; it is rebuilt along with the field
+            record[0] = kKindMolecular;
+            record[3] = molecular->second;
+        } else if(type->as_numeric() != nullptr) {
+            const Numeric *numeric = type->as_numeric();
+            double modulus = numeric->modulus();
+            uint64_t bits;
+            memcpy(&bits, &modulus, sizeof(bits));
+
+            record[0] = kKindNumeric;
+            record[3] = numeric->divisor();
+            record[4] = (uint32_t)bits;
+            record[5] = (uint32_t)(bits >> 32);
+            write_range(record, numeric->range());
+        } else if(type->as_array() != nullptr) {
+            const Array *array = type->as_array();
+            record[0] = kKindArray;
+            record[3] = add_type(array->element_type());
+            write_range(record, array->range());
+        } else if(type->as_method() != nullptr) {
+            const Method *method = type->as_method();
+            record[0] = kKindMethod;
+            record[3] = (uint32_t)m_sections[kSectionParameters].size() / kRecordWords[kSectionParameters];
+            record[4] = (uint32_t)method->num_parameters();
+            for(unsigned int n = 0; n < method->num_parameters(); ++n) {
+                const Parameter *param = method->get_parameter(n);
+                vector<uint32_t>& params = m_sections[kSectionParameters];
+                params.push_back(add_string(param->name()));
+                params.push_back(add_type(param->type()));
+                add_default(params, param->has_default_value() ? param->default_value() : nullptr);
+            }
+        } else if(strct != nullptr) {
+            vector<uint32_t>& refs = m_sections[kSectionRefs];
+            const Class *cls = strct->as_class();
+            record[0] = cls != nullptr ? kKindClass : kKindStruct;
+            record[3] = add_string(strct->name());
+            record[4] = (uint32_t)refs.size();
+            if(cls == nullptr) {
+                for(unsigned int n = 0; n < strct->num_fields(); ++n) {
+                    refs.push_back(strct->get_field(n)->id());
+                }
+            } else {
+                // Fields are listed in the order they were added to the class
+                if(cls->has_constructor()) { refs.push_back(cls->constructor()->id()); }
+                for(unsigned int n = 0; n < cls->num_base_fields(); ++n) {
+                    refs.push_back(cls->get_base_field(n)->id());
+                }
+            }
+            record[5] = (uint32_t)refs.size() - record[4];
+
+            if(cls != nullptr) {
+                record[6] = (uint32_t)refs.size();
+                record[7] = (uint32_t)cls->num_parents();
+                for(unsigned int n = 0; n < cls->num_parents(); ++n) {
+                    refs.push_back(add_type(cls->get_parent(n)));
+                }
+            }
+        }
+
+        vector<uint32_t>& types = m_sections[kSectionTypes];
+        types.insert(types.end(), record, record + 11);
+    }
+
+    vector<uint8_t> layout(uint32_t first_keyword)
+    {
+        uint32_t header[kHeaderWords] = {};
+        header[kHeaderVersion] = kVersion;
+        header[kHeaderSizetag] = sizeof(sizetag_t);
+        header[kHeaderModuleTypes] = (uint32_t)m_module->num_types();
+        header[kHeaderFirstKeyword] = first_keyword;
+        header[kHeaderNumKeywords] = (uint32_t)m_module->num_keywords();
+
+        vector<uint8_t> out(kHeaderWords * 4);
+        for(size_t s = 0; s < kNumSections; ++s) {
+            while(out.size() % 4 != 0) { out.push_back(0); }
+            header[kHeaderSections + 2 * s] = (uint32_t)out.size();
+            if(s == kSectionStrings || s == kSectionBytes) {
+                const vector<uint8_t>& data = s == kSectionStrings ? m_strings : m_bytes;
+                header[kHeaderSections + 2 * s + 1] = (uint32_t)data.size();
+                out.insert(out.end(), data.begin(), data.end());
+            } else {
+                const vector<uint32_t>& words = m_sections[s];
+                header[kHeaderSections + 2 * s + 1] = (uint32_t)(words.size() / kRecordWords[s]);
+                size_t offset = out.size();
+                out.resize(offset + words.size() * 4);
+                for(size_t i = 0; i < words.size(); ++i) {
+                    store_le<uint32_t>(&out[offset + i * 4], words[i]);
+                }
+            }
+        }
+        header[kHeaderLength] = (uint32_t)out.size();
+
+        for(size_t i = 1; i < kHeaderWords; ++i) {
+            store_le<uint32_t>(&out[i * 4], header[i]);
+        }
+        memcpy(out.data(), kMagic, sizeof(kMagic));
+        return out;
+    }
+
+    const Module *m_module;
+    vector<const Type *> m_types;
+    unordered_map<const Type *, uint32_t> m_indices;
+    unordered_map<const Type *, uint32_t> m_molecular_ids; // the field id of each molecular type
+    vector<uint8_t> m_strings;
+    unordered_map<string, uint32_t> m_strings_by_value;
+    vector<uint8_t> m_bytes;
+    vector<uint32_t> m_sections[kNumSections];
+};
+
+// A CompiledModuleError is thrown while reading a compiled module which is invalid.
+class CompiledModuleError : public runtime_error
+{
+  public:
+    explicit CompiledModuleError(const string& what) : runtime_error(what) {}
+};
+
+// A ModuleLoader builds a Module from the records of a compiled module.
+//     Records are read in place, and every offset and index is checked before it is used.
+class ModuleLoader
+{
+  public:
+    ModuleLoader(const uint8_t *data, size_t length) : m_data(data), m_length(length) {}
+
+    void load(Module *module)
+    {
+        m_module = module;
+        read_header();
+
+        m_types.assign(m_counts[kSectionTypes], nullptr);
+        m_building.assign(m_counts[kSectionTypes], false);
+        m_owned.assign(m_counts[kSectionTypes], false);
+        m_shared.assign(m_counts[kSectionTypes], false);
+        m_fields.reserve(m_counts[kSectionFields]);
+
+        // Rebuild the module's structs and classes in order, so they get the same ids;
+        //     each struct's fields are added in the same order, so they get the same ids too.
+        for(uint32_t i = 0; i < m_module_types; ++i) {
+            uint32_t kind = type_word(i, 0);
+            if(kind != kKindStruct && kind != kKindClass) {
+                throw CompiledModuleError("module type is not a struct or class");
+            }
+            get_type(i);
+        }
+        if(m_fields.size() != m_counts[kSectionFields]) {
+            throw CompiledModuleError("field does not belong to any struct or class");
+        }
+
+        for(uint32_t n = 0; n < m_counts[kSectionTypedefs]; ++n) {
+            const uint8_t *record = get_record(kSectionTypedefs, n);
+            if(!m_module->add_typedef(get_string(word(record, 0)), get_type(word(record, 1)))) {
+                throw CompiledModuleError("can't add typedef '" + get_string(word(record, 0)) + "'");
+            }
+        }
+
+        for(uint32_t n = 0; n < m_counts[kSectionImports]; ++n) {
+            const uint8_t *record = get_record(kSectionImports, n);
+            unique_ptr<Import> import(new Import(get_string(word(record, 0))));
+            const uint8_t *symbols = get_refs(word(record, 1), word(record, 2));
+            for(uint32_t s = 0; s < word(record, 2); ++s) {
+                import->symbols.push_back(get_string(word(symbols, s)));
+            }
+            m_module->add_import(move(import));
+        }
+
+        const uint8_t *keywords = get_refs(m_first_keyword, m_num_keywords);
+        for(uint32_t n = 0; n < m_num_keywords; ++n) {
+            m_module->add_keyword(get_string(word(keywords, n)));
+        }
+    }
+
+  private:
+    static uint32_t word(const uint8_t *record, size_t n)
+    {
+        return load_le<uint32_t>(record + n * 4);
+    }
+
+    void read_header()
+    {
+        if(m_length < kHeaderWords * 4 || memcmp(m_data, kMagic, sizeof(kMagic)) != 0) {
+            throw CompiledModuleError("not a compiled module");
+        }
+        if(word(m_data, kHeaderVersion) != kVersion) {
+            throw CompiledModuleError("unsupported version");
+        }
+        if(word(m_data, kHeaderSizetag) != sizeof(sizetag_t)) {
+            throw CompiledModuleError("compiled with a different size of sizetag_t");
+        }
+        if(word(m_data, kHeaderLength) != m_length) {
+            throw CompiledModuleError("file is truncated");
+        }
+        m_module_types = word(m_data, kHeaderModuleTypes);
+        m_first_keyword = word(m_data, kHeaderFirstKeyword);
+        m_num_keywords = word(m_data, kHeaderNumKeywords);
+
+        for(size_t s = 0; s < kNumSections; ++s) {
+            uint32_t offset = word(m_data, kHeaderSections + 2 * s);
+            uint32_t count = word(m_data, kHeaderSections + 2 * s + 1);
+            size_t size = kRecordWords[s] != 0 ? (size_t)count * kRecordWords[s] * 4 : count;
+            if(offset % 4 != 0 || offset > m_length || size > m_length - offset) {
+                throw CompiledModuleError("section is out of bounds");
+            }
+            m_sections[s] = m_data + offset;
+            m_counts[s] = count;
+        }
+
+        if(m_module_types > m_counts[kSectionTypes]) {
+            throw CompiledModuleError("module type is out of bounds");
+        }
+        if(m_counts[kSectionStrings] > 0 && m_sections[kSectionStrings][m_counts[kSectionStrings] - 1] != 0) {
+            throw CompiledModuleError("string table is not terminated");
+        }
+    }
+
+    const uint8_t *get_record(Section section, uint32_t index)
+    {
+        if(index >= m_counts[section]) {
+            throw CompiledModuleError("record index is out of bounds");
+        }
+        return m_sections[section] + (size_t)index * kRecordWords[section] * 4;
+    }
+
+    const uint8_t *get_refs(uint32_t first, uint32_t count)
+    {
+        if(first > m_counts[kSectionRefs] || count > m_counts[kSectionRefs] - first) {
+            throw CompiledModuleError("reference list is out of bounds");
+        }
+        return m_sections[kSectionRefs] + (size_t)first * 4;
+    }
+
+    string get_string(uint32_t offset)
+    {
+        if(offset == kNone) { return string(); }
+        if(offset >= m_counts[kSectionStrings]) {
+            throw CompiledModuleError("name is out of bounds");
+        }
+        // The string table is known to end with a NUL
+        return string((const char *)m_sections[kSectionStrings] + offset);
+    }
+
+    vector<uint8_t> get_bytes(uint32_t offset, uint32_t length)
+    {
+        if(offset > m_counts[kSectionBytes] || length > m_counts[kSectionBytes] - offset) {
+            throw CompiledModuleError("default value is out of bounds");
+        }
+        const uint8_t *bytes = m_sections[kSectionBytes] + offset;
+        return vector<uint8_t>(bytes, bytes + length);
+    }
+
+    uint32_t type_word(uint32_t index, size_t n)
+    {
+        return word(get_record(kSectionTypes, index), n);
+    }
+
+    NumericRange get_range(const uint8_t *record)
+    {
+        NumericRange range;
+        uint32_t type = word(record, kRangeWord);
+        if(type == Number::kNaN) { return range; }
+        if(type > Number::kFloat) {
+            throw CompiledModuleError("invalid range");
+        }
+        range.type = range.min.type = range.max.type = (Number::Type)type;
+        range.min.uinteger = word(record, kRangeWord + 1) | (uint64_t)word(record, kRangeWord + 2) << 32;
+        range.max.uinteger = word(record, kRangeWord + 3) | (uint64_t)word(record, kRangeWord + 4) << 32;
+        return range;
+    }
+
+    // get_default reads a default value in wire format, or returns nullptr if there isn't one.
+    unique_ptr<Value> get_default(const uint8_t *record, size_t n, const Type *type)
+    {
+        if(word(record, n) == 0) { return nullptr; }
+        vector<uint8_t> bytes = get_bytes(word(record, n + 1), word(record, n + 2));
+        if(bytes.size() > kSizetagMax) {
+            throw CompiledModuleError("default value is too large");
+        }
+
+        unique_ptr<Value> value;
+        try {
+            DatagramIterator dgi(DatagramView(bytes.data(), (sizetag_t)bytes.size()));
+            value.reset(new Value(dgi.read_value(type)));
+            if(dgi.remaining() != 0) { value.reset(); }
+        } catch(...) {
+            // Malformed data or an invalid type; either way the default can't be used
+        }
+        if(value == nullptr) {
+            throw CompiledModuleError("invalid default value");
+        }
+        return value;
+    }
+
+    // get_type returns the type with the index, for anything which doesn't own the type.
+    //     A type which isn't owned by a field is owned by the module.
+    Type *get_type(uint32_t index)
+    {
+        Type *type = build_type(index, false);
+        if(m_owned[index]) {
+            throw CompiledModuleError("type is owned by a field and can't be shared");
+        }
+        m_shared[index] = true;
+        return type;
+    }
+
+    // get_field_type returns the type with the index for a new, non-molecular field.
+    //     A field deletes its type when it is destroyed, so the type can't be used by another
+    //     field, or by a parameter, array or typedef; structs are owned by the module instead.
+    Type *get_field_type(uint32_t index)
+    {
+        Type *type = build_type(index, true);
+        if(type->as_struct() != nullptr) { return get_type(index); }
+        if(type == Type::invalid || m_owned[index] || m_shared[index]) {
+            throw CompiledModuleError("field type is shared with another field or type");
+        }
+        m_owned[index] = true;
+        return type;
+    }
+
+    // build_type returns the type with the index, creating it if it hasn't been created yet.
+    //     A new type is given to the module, unless it is being created for a field.
+    Type *build_type(uint32_t index, bool for_field)
+    {
+        const uint8_t *record = get_record(kSectionTypes, index);
+        if(m_types[index] != nullptr) { return m_types[index]; }
+        if(m_building[index]) {
+            throw CompiledModuleError("type is used before it is defined");
+        }
+        m_building[index] = true;
+
+        Type *type = nullptr;
+        unique_ptr<Type> created;
+        switch(word(record, 0)) {
+        case kKindInvalid:
+            type = Type::invalid;
+            break;
+        case kKindNumeric:
+            created.reset(make_numeric(record));
+            break;
+        case kKindArray:
+            created.reset(new Array(get_type(word(record, 3)), get_range(record)));
+            break;
+        case kKindMethod:
+            created.reset(make_method(record));
+            break;
+        case kKindStruct:
+        case kKindClass:
+            if(index >= m_module_types) {
+                throw CompiledModuleError("struct does not belong to the module");
+            }
+            type = make_struct(index, record);
+            break;
+        default:
+            // Molecular fields are created along with their class, before they can be used
+            throw CompiledModuleError("invalid type");
+        }
+        if(created != nullptr) { type = created.get(); }
+
+        if(type->subtype() != (Subtype)word(record, 1)) {
+            throw CompiledModuleError("type doesn't match its subtype");
+        }
+        if(word(record, 2) != kNone && type != Type::invalid) {
+            type->set_alias(get_string(word(record, 2)));
+        }
+        if(created != nullptr && for_field) {
+            created.release();
+        } else if(created != nullptr) {
+            m_module->add_shared_type(move(created));
+        }
+        m_types[index] = type;
+        return type;
+    }
+
+    Type *make_numeric(const uint8_t *record)
+    {
+        uint32_t subtype = word(record, 1);
+        if(subtype > kTypeFloat64) {
+            throw CompiledModuleError("invalid numeric type");
+        }
+
+        uint64_t bits = word(record, 4) | (uint64_t)word(record, 5) << 32;
+        double modulus;
+        memcpy(&modulus, &bits, sizeof(modulus));
+        NumericRange range = get_range(record);
+
+        unique_ptr<Numeric> numeric(new Numeric((Subtype)subtype));
+        bool ok = word(record, 3) == 1 || numeric->set_divisor(word(record, 3));
+        ok = ok && (modulus == 0.0 || numeric->set_modulus(modulus));
+        ok = ok && (range.is_empty() || numeric->set_range(range));
+        if(!ok) {
+            throw CompiledModuleError("invalid numeric constraints");
+        }
+        return numeric.release();
+    }
+
+    Type *make_method(const uint8_t *record)
+    {
+        // Parameters don't delete their types, so an incomplete method can be deleted
+        unique_ptr<Method> method(new Method());
+        uint32_t first = word(record, 3);
+        for(uint32_t n = 0; n < word(record, 4); ++n) {
+            // Read and check the whole record before creating the parameter
+            const uint8_t *param_record = get_record(kSectionParameters, first + n);
+            Type *type = get_type(word(param_record, 1));
+            string param_name = get_string(word(param_record, 0));
+            unique_ptr<Value> value = get_default(param_record, 2, type);
+            if(!param_name.empty() && method->parameter_by_name(param_name) != nullptr) {
+                throw CompiledModuleError("can't add parameter '" + param_name + "' to method");
+            }
+
+            unique_ptr<Parameter> param(new Parameter(type, param_name));
+            if(value != nullptr && !param->set_default_value(*value)) {
+                throw CompiledModuleError("invalid default value");
+            }
+            if(!method->add_parameter(move(param))) {
+                throw CompiledModuleError("can't add parameter '" + param_name + "' to method");
+            }
+        }
+        return method.release();
+    }
+
+    Struct *make_struct(uint32_t index, const uint8_t *record)
+    {
+        // The struct is deleted if it can't be loaded; none of its fields share a type
+        string name = get_string(word(record, 3));
+        unique_ptr<Struct> owner;
+        Class *cls = nullptr;
+        Struct *strct;
+        if(word(record, 0) == kKindClass) {
+            cls = new Class(m_module, name);
+            owner.reset(cls);
+            strct = cls;
+
+            const uint8_t *parents = get_refs(word(record, 6), word(record, 7));
+            for(uint32_t n = 0; n < word(record, 7); ++n) {
+                uint32_t parent = word(parents, n);
+                if(parent >= index || type_word(parent, 0) != kKindClass) {
+                    throw CompiledModuleError("class parent must be an earlier class");
+                }
+                if(!cls->add_parent(get_type(parent)->as_struct()->as_class())) {
+                    throw CompiledModuleError("can't add parent to class '" + name + "'");
+                }
+            }
+        } else {
+            strct = new Struct(m_module, name);
+            owner.reset(strct);
+        }
+
+        const uint8_t *fields = get_refs(word(record, 4), word(record, 5));
+        for(uint32_t n = 0; n < word(record, 5); ++n) {
+            uint32_t id = word(fields, n);
+            if(id != m_fields.size()) {
+                throw CompiledModuleError("fields are out of order");
+            }
+            const uint8_t *field_record = get_record(kSectionFields, id);
+
+            // A molecular field which can't be added is deleted by add_field, so only its name is kept
+            string field_name = get_string(word(field_record, 0));
+            Field *field;
+            bool ok;
+            if(word(field_record, 2) != 0) {
+                if(cls == nullptr) {
+                    throw CompiledModuleError("struct can't have a molecular field");
+                }
+                unique_ptr<MolecularField> molecular = make_molecular(cls, field_record);
+                field = molecular.get();
+                ok = cls->add_field(unique_ptr<Field>(molecular.release()));
+            } else {
+                // The whole record is read and checked before the field is created, because
+                //     a field which add_field refuses is deleted along with its type.
+                Type *type = get_field_type(word(field_record, 1));
+                unique_ptr<Type> owned_type(type->as_struct() == nullptr ? type : nullptr);
+                vector<string> field_keywords;
+                const uint8_t *keywords = get_refs(word(field_record, 3), word(field_record, 4));
+                for(uint32_t k = 0; k < word(field_record, 4); ++k) {
+                    field_keywords.push_back(get_string(word(keywords, k)));
+                }
+                unique_ptr<Value> value = get_default(field_record, 5, type);
+                if(!can_add_field(strct, cls, field_name, type)) {
+                    throw CompiledModuleError("can't add field '" + field_name + "'");
+                }
+
+                unique_ptr<Field> plain(new Field(type, field_name));
+                owned_type.release();
+                for(const string& keyword : field_keywords) {
+                    plain->add_keyword(keyword);
+                }
+                if(value != nullptr && !plain->set_default_value(*value)) {
+                    throw CompiledModuleError("invalid default value");
+                }
+                value.reset();
+                field = plain.get();
+                ok = strct->add_field(move(plain));
+            }
+            if(!ok || field->id() != id) {
+                throw CompiledModuleError("can't add field '" + field_name + "'");
+            }
+            if(field->as_molecular() != nullptr) {
+                m_types[word(field_record, 1)] = field->type();
+                m_owned[word(field_record, 1)] = true;
+            }
+            m_fields.push_back(field);
+        }
+
+        // A struct which can't be added is deleted by the module, so check its name first
+        bool added = !name.empty() && m_module->type_by_name(name) == nullptr;
+        if(added && cls != nullptr) {
+            owner.release();
+            added = m_module->add_class(unique_ptr<Class>(cls));
+        } else if(added) {
+            added = m_module->add_struct(move(owner));
+        }
+        if(!added || strct->id() != index) {
+            throw CompiledModuleError("can't add '" + name + "' to the module");
+        }
+        return strct;
+    }
+
+    // can_add_field returns true if a new, non-molecular field can be added to the struct or class.
+    //     It makes the same checks as Struct::add_field and Class::add_field, which would delete
+    //     a field they refuse, along with its type.
+    static bool can_add_field(const Struct *strct, const Class *cls, const string& name, const Type *type)
+    {
+        if(cls != nullptr) {
+            // Class fields must have names
+            if(name.empty()) { return false; }
+
+            // A constructor must be the first field, and there can only be one
+            if(name == cls->name()) {
+                return !cls->has_constructor() && cls->num_base_fields() == 0;
+            }
+
+            // Other fields can't share a name with a field declared in the class
+            for(unsigned int n = 0; n < cls->num_base_fields(); ++n) {
+                if(cls->get_base_field(n)->name() == name) { return false; }
+            }
+            return true;
+        }
+
+        // Structs can't have methods
+        if(type->as_method() != nullptr) { return false; }
+
+        // Named fields can't share a name with the struct, or with another field
+        return name.empty() || (name != strct->name() && strct->field_by_name(name) == nullptr);
+    }
+
+    unique_ptr<MolecularField> make_molecular(Class *cls, const uint8_t *record)
+    {
+        uint32_t type_index = word(record, 1);
+        if(type_word(type_index, 0) != kKindMolecular || type_word(type_index, 3) != m_fields.size()) {
+            throw CompiledModuleError("invalid molecular field");
+        }
+
+        unique_ptr<MolecularField> molecular(new MolecularField(cls, get_string(word(record, 0))));
+        const uint8_t *members = get_refs(word(record, 8), word(record, 9));
+        for(uint32_t n = 0; n < word(record, 9); ++n) {
+            uint32_t member = word(members, n);
+            if(member >= m_fields.size() || !molecular->add_field(m_fields[member])) {
+                throw CompiledModuleError("invalid molecular field");
+            }
+        }
+        return molecular;
+    }
+
+    const uint8_t *m_data;
+    size_t m_length;
+    Module *m_module = nullptr;
+
+    uint32_t m_module_types = 0;
+    uint32_t m_first_keyword = 0;
+    uint32_t m_num_keywords = 0;
+    const uint8_t *m_sections[kNumSections];
+    uint32_t m_counts[kNumSections];
+
+    vector<Type *> m_types;
+    vector<bool> m_building;
+    vector<bool> m_owned;  // the type is owned by a field
+    vector<bool> m_shared; // the type is used by something which doesn't own it
+    vector<Field *> m_fields;
+};
+
+// compile_module returns the compiled form of the module.
+vector<uint8_t> compile_module(const Module *module)
+{
+    ModuleCompiler compiler(module);
+    return compiler.compile();
+}
+
+// write_compiled_module writes the compiled form of the module to a stream or file.
+bool write_compiled_module(const Module *module, ostream& out)
+{
+    vector<uint8_t> data = compile_module(module);
+    out.write((const char *)data.data(), data.size());
+    return !out.fail();
+}
+bool write_compiled_module(const Module *module, const string& filename)
+{
+    ofstream out(filename.c_str(), ios::binary);
+    if(!out) {
+        cerr << "Cannot open " << filename << " for writing.\n";
+        return false;
+    }
+    return write_compiled_module(module, out);
+}
+
+// read_compiled_module creates a new Module from a compiled module in memory or in a file.
+Module *read_compiled_module(const uint8_t *data, size_t length, const string& filename)
+{
+    unique_ptr<Module> module(new Module());
+    try {
+        ModuleLoader loader(data, length);
+        loader.load(module.get());
+    } catch(const CompiledModuleError& e) {
+        cerr << "Error in compiled module " << filename << ": " << e.what() << ".\n";
+        return nullptr;
+    }
+    return module.release();
+}
+Module *read_compiled_module(const string& filename)
+{
+#ifndef _WIN32
+    int fd = open(filename.c_str(), O_RDONLY);
+    struct stat st;
+    if(fd < 0 || fstat(fd, &st) != 0) {
+        if(fd >= 0) { close(fd); }
+        cerr << "Cannot open " << filename << " for reading.\n";
+        return nullptr;
+    }
+
+    size_t length = (size_t)st.st_size;
+    void *data = length > 0 ? mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    close(fd);
+    if(data == MAP_FAILED) {
+        return read_compiled_module(nullptr, 0, filename);
+    }
+
+    Module *module = read_compiled_module((const uint8_t *)data, length, filename);
+    munmap(data, length);
+    return module;
+#else
+    ifstream in(filename.c_str(), ios::binary);
+    if(!in) {
+        cerr << "Cannot open " << filename << " for reading.\n";
+        return nullptr;
+    }
+    vector<uint8_t> data((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    return read_compiled_module(data.data(), data.size(), filename);
+#endif
+}
+
+
+} // close namespace bamboo
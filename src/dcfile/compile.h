@@ -0,0 +1,39 @@
+// Filename: compile.h
+#pragma once
+#include <stddef.h> // for size_t
+#include <stdint.h> // for uint8_t
+#include <iostream> // std::ostream
+#include <string>   // std::string
+#include <vector>   // std::vector
+namespace bamboo   // open namespace bamboo
+{
+
+
+// Forward declarations
+class Module;
+
+// A compiled module is a binary form of a Module which can be loaded without parsing a .dc file.
+//     Every type, field, and parameter is stored as a fixed-size little-endian record, and
+//     records refer to each other, to names, and to default values by index or offset rather
+//     than by pointer.  This makes it possible to read a compiled module directly from a
+//     memory-mapped file.  Compiled modules can be created with the bamboo-compile tool.
+//
+//     A compiled module depends on the size of sizetag_t; a module compiled by a library with
+//     16-bit sizetags can't be read by a library with 32-bit sizetags, or vice-versa.
+
+// compile_module returns the compiled form of the module.
+std::vector<uint8_t> compile_module(const Module *module);
+
+// write_compiled_module writes the compiled form of the module to a stream or file.
+//     Returns false if the module couldn't be written.
+bool write_compiled_module(const Module *module, std::ostream& out);
+bool write_compiled_module(const Module *module, const std::string& filename);
+
+// read_compiled_module creates a new Module from a compiled module in memory or in a file,
+//     which is memory-mapped while it is read.  Returns nullptr if the data isn't a valid
+//     compiled module.  When reading from memory, the filename is only used to report errors.
+Module *read_compiled_module(const uint8_t *data, size_t length, const std::string& filename);
+Module *read_compiled_module(const std::string& filename);
+
+
+} // close namespace bamboo
@@ -80,7 +80,7 @@ void format_value(const Value *value, ostream& out)
         // If we have a string alias format as a quoted string
         if(type->has_alias() && type->alias() == "string") {
             // Enquoute and escape string then output
-            format_quoted('"', value->string_, out);
+            format_quoted('"', string(value->string_.data(), value->string_.size()), out);
         } else {
             // Otherwise format as an array of chars
             out << '[';
@@ -100,14 +100,14 @@ void format_value(const Value *value, ostream& out)
         // If we have a blob alias format as a hex constant
         if(type->has_alias() && type->alias() == "blob") {
             // Format blob as a hex constant then output
-            format_hex(value->blob_, out);
+            format_hex(vector<uint8_t>(value->blob_.begin(), value->blob_.end()), out);
         } else {
             // Otherwise format as an array of uint8
             out << '[';
             if(value->blob_.size() > 0) {
                 out << uint32_t(value->blob_[0]);
             }
-            for(size_t i = 1; i < value->string_.size(); ++i) {
+            for(size_t i = 1; i < value->blob_.size(); ++i) {
                 out << ", " << uint32_t(value->blob_[i]);
             }
             out << ']';
@@ -135,14 +135,14 @@ void format_value(const Value *value, ostream& out)
         if(num_fields > 0) {
             const Field *field = struct_->get_field(0);
             if(field->as_molecular() == nullptr) {
-                format_value(value->fields_.at(field), out);
+                format_value(value->fields_[0], out);
             }
         }
         for(unsigned int i = 1; i < num_fields; ++i) {
             out << ", ";
             const Field *field = struct_->get_field(i);
             if(field->as_molecular() == nullptr) {
-                format_value(value->fields_.at(field), out);
+                format_value(value->fields_[i], out);
             }
         }
         out << '}';
@@ -153,12 +153,10 @@ void format_value(const Value *value, ostream& out)
         const Method *method_ = type->as_method();
         size_t num_params = method_->num_parameters();
         if(num_params > 0) {
-            const Parameter *param = method_->get_parameter(0);
-            format_value(value->arguments_.at(param), out);
+            format_value(value->arguments_[0], out);
         }
         for(unsigned int i = 1; i < num_params; ++i) {
-            const Parameter *param = method_->get_parameter(i);
-            format_value(value->arguments_.at(param), out);
+            format_value(value->arguments_[i], out);
         }
         out << ')';
         break;
@@ -6,15 +6,46 @@ namespace bamboo   // open namespace bamboo
 {
 
 
+// Forward declarations
+class DCToken;
+
+// A LexerState is the input and error-reporting state of a single lexer.
+//     Each parse has its own LexerState, so several files can be lexed at once.
+struct LexerState {
+    LexerState(std::istream& in, const std::string& filename, int initial_token);
+
+    // This is the pointer to the current input stream.
+    std::istream *input;
+
+    // This is the name of the dc file we're parsing.  We keep it so we
+    // can print it out for error messages.
+    std::string filename;
+
+    // This is the initial token state returned by the lexer.  It allows
+    // the yacc grammar to start from initial points.
+    int initial_token;
+
+    // We'll increment line_number and col_number as we parse the file, so
+    // that we can report the position of an error.
+    int line_number;
+    int col_number;
+
+    // current_line holds as much of the current line as will fit.  Its
+    // only purpose is for printing it out to report an error to the user.
+    std::string current_line;
+
+    int error_count;
+    int warning_count;
+};
+
 /* Published interface */
-int dclex();
-int dc_errors();
-int dc_warnings();
+int dclex(DCToken *lval, void *scanner);
 
 /* parser-to-lexer interface */
-void dclexer_init(std::istream& in, const std::string& filename, int initial_token);
-void dcerror(const std::string& msg);
-void dcwarning(const std::string& msg);
+void *dclexer_init(LexerState *state);
+void dclexer_destroy(void *scanner);
+void dcerror(void *scanner, const std::string& msg);
+void dcwarning(void *scanner, const std::string& msg);
 
 // we always read files
 #define YY_NEVER_INTERACTIVE 1
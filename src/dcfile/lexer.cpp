@@ -4,18 +4,12 @@
 
 #define yy_create_buffer dc_create_buffer
 #define yy_delete_buffer dc_delete_buffer
-#define yy_flex_debug dc_flex_debug
 #define yy_init_buffer dc_init_buffer
 #define yy_flush_buffer dc_flush_buffer
 #define yy_load_buffer_state dc_load_buffer_state
 #define yy_switch_to_buffer dc_switch_to_buffer
-#define yyin dcin
-#define yyleng dcleng
 #define yylex dclex
-#define yylineno dclineno
-#define yyout dcout
 #define yyrestart dcrestart
-#define yytext dctext
 #define yywrap dcwrap
 #define yyalloc dcalloc
 #define yyrealloc dcrealloc
@@ -134,24 +128,41 @@ typedef unsigned int flex_uint32_t;
  */
 #define YY_SC_TO_UI(c) ((unsigned int) (unsigned char) c)
 
+/* An opaque pointer. */
+#ifndef YY_TYPEDEF_YY_SCANNER_T
+#define YY_TYPEDEF_YY_SCANNER_T
+typedef void *yyscan_t;
+#endif
+
+/* For convenience, these vars (plus the bison vars far below)
+   are macros in the reentrant scanner. */
+#define yyin yyg->yyin_r
+#define yyout yyg->yyout_r
+#define yyextra yyg->yyextra_r
+#define yyleng yyg->yyleng_r
+#define yytext yyg->yytext_r
+#define yylineno (YY_CURRENT_BUFFER_LVALUE->yy_bs_lineno)
+#define yycolumn (YY_CURRENT_BUFFER_LVALUE->yy_bs_column)
+#define yy_flex_debug yyg->yy_flex_debug_r
+
 /* Enter a start condition.  This macro really ought to take a parameter,
  * but we do it the disgusting crufty way forced on us by the ()-less
  * definition of BEGIN.
  */
-#define BEGIN (yy_start) = 1 + 2 *
+#define BEGIN yyg->yy_start = 1 + 2 *
 
 /* Translate the current start state into a value that can be later handed
  * to BEGIN to return to the state.  The YYSTATE alias is for lex
  * compatibility.
  */
-#define YY_START (((yy_start) - 1) / 2)
+#define YY_START ((yyg->yy_start - 1) / 2)
 #define YYSTATE YY_START
 
 /* Action number for EOF rule of a given start state. */
 #define YY_STATE_EOF(state) (YY_END_OF_BUFFER + state + 1)
 
 /* Special action meaning "start processing a new file". */
-#define YY_NEW_FILE dcrestart(dcin  )
+#define YY_NEW_FILE dcrestart(yyin, yyscanner)
 
 #define YY_END_OF_BUFFER_CHAR 0
 
@@ -182,10 +193,6 @@ typedef struct yy_buffer_state *YY_BUFFER_STATE;
 typedef size_t yy_size_t;
 #endif
 
-extern yy_size_t dcleng;
-
-extern FILE *dcin, *dcout;
-
 #define EOB_ACT_CONTINUE_SCAN 0
 #define EOB_ACT_END_OF_FILE 1
 #define EOB_ACT_LAST_MATCH 2
@@ -197,17 +204,17 @@ extern FILE *dcin, *dcout;
 #define yyless(n) \
     do \
         { \
-        /* Undo effects of setting up dctext. */ \
+        /* Undo effects of setting up yytext. */ \
         int yyless_macro_arg = (n); \
         YY_LESS_LINENO(yyless_macro_arg);\
-        *yy_cp = (yy_hold_char); \
+        *yy_cp = yyg->yy_hold_char; \
         YY_RESTORE_YY_MORE_OFFSET \
-        (yy_c_buf_p) = yy_cp = yy_bp + yyless_macro_arg - YY_MORE_ADJ; \
-        YY_DO_BEFORE_ACTION; /* set up dctext again */ \
+        yyg->yy_c_buf_p = yy_cp = yy_bp + yyless_macro_arg - YY_MORE_ADJ; \
+        YY_DO_BEFORE_ACTION; /* set up yytext again */ \
         } \
     while ( 0 )
 
-#define unput(c) yyunput( c, (yytext_ptr)  )
+#define unput(c) yyunput( c, yyg->yytext_ptr, yyscanner)
 
 #ifndef YY_STRUCT_YY_BUFFER_STATE
 #define YY_STRUCT_YY_BUFFER_STATE
@@ -266,78 +273,58 @@ struct yy_buffer_state {
      *
      * When we actually see the EOF, we change the status to "new"
      * (via dcrestart()), so that the user can continue scanning by
-     * just pointing dcin at a new input file.
+     * just pointing yyin at a new input file.
      */
 #define YY_BUFFER_EOF_PENDING 2
 
 };
 #endif /* !YY_STRUCT_YY_BUFFER_STATE */
 
-/* Stack of input buffers. */
-static size_t yy_buffer_stack_top = 0; /**< index of top of stack. */
-static size_t yy_buffer_stack_max = 0; /**< capacity of stack. */
-static YY_BUFFER_STATE *yy_buffer_stack = 0;  /**< Stack as an array. */
-
 /* We provide macros for accessing buffer states in case in the
  * future we want to put the buffer states in a more general
  * "scanner state".
  *
  * Returns the top of the stack, or NULL.
  */
-#define YY_CURRENT_BUFFER ( (yy_buffer_stack) \
-                          ? (yy_buffer_stack)[(yy_buffer_stack_top)] \
+#define YY_CURRENT_BUFFER ( yyg->yy_buffer_stack \
+                          ? yyg->yy_buffer_stack[yyg->yy_buffer_stack_top] \
                           : NULL)
 
 /* Same as previous macro, but useful when we know that the buffer stack is not
  * NULL or when we need an lvalue. For internal use only.
  */
-#define YY_CURRENT_BUFFER_LVALUE (yy_buffer_stack)[(yy_buffer_stack_top)]
-
-/* yy_hold_char holds the character lost when dctext is formed. */
-static char yy_hold_char;
-static yy_size_t yy_n_chars;        /* number of characters read into yy_ch_buf */
-yy_size_t dcleng;
+#define YY_CURRENT_BUFFER_LVALUE yyg->yy_buffer_stack[yyg->yy_buffer_stack_top]
 
-/* Points to current character in buffer. */
-static char *yy_c_buf_p = (char *) 0;
-static int yy_init = 0;     /* whether we need to initialize */
-static int yy_start = 0;    /* start state number */
-
-/* Flag which is used to allow dcwrap()'s to do buffer switches
- * instead of setting up a fresh dcin.  A bit of a hack ...
- */
-static int yy_did_buffer_switch_on_eof;
+void dcrestart(FILE *input_file, yyscan_t yyscanner);
+void dc_switch_to_buffer(YY_BUFFER_STATE new_buffer, yyscan_t yyscanner);
+YY_BUFFER_STATE dc_create_buffer(FILE *file, int size, yyscan_t yyscanner);
+void dc_delete_buffer(YY_BUFFER_STATE b, yyscan_t yyscanner);
+void dc_flush_buffer(YY_BUFFER_STATE b, yyscan_t yyscanner);
+void dcpush_buffer_state(YY_BUFFER_STATE new_buffer, yyscan_t yyscanner);
+void dcpop_buffer_state(yyscan_t yyscanner);
 
-void dcrestart(FILE *input_file);
-void dc_switch_to_buffer(YY_BUFFER_STATE new_buffer);
-YY_BUFFER_STATE dc_create_buffer(FILE *file, int size);
-void dc_delete_buffer(YY_BUFFER_STATE b);
-void dc_flush_buffer(YY_BUFFER_STATE b);
-void dcpush_buffer_state(YY_BUFFER_STATE new_buffer);
-void dcpop_buffer_state(void);
+static void dcensure_buffer_stack(yyscan_t yyscanner);
+static void dc_load_buffer_state(yyscan_t yyscanner);
+static void dc_init_buffer(YY_BUFFER_STATE b, FILE *file, yyscan_t yyscanner);
 
-static void dcensure_buffer_stack(void);
-static void dc_load_buffer_state(void);
-static void dc_init_buffer(YY_BUFFER_STATE b, FILE *file);
+#define YY_FLUSH_BUFFER dc_flush_buffer(YY_CURRENT_BUFFER, yyscanner)
 
-#define YY_FLUSH_BUFFER dc_flush_buffer(YY_CURRENT_BUFFER )
+YY_BUFFER_STATE dc_scan_buffer(char *base, yy_size_t size, yyscan_t yyscanner);
+YY_BUFFER_STATE dc_scan_string(yyconst char *yy_str, yyscan_t yyscanner);
+YY_BUFFER_STATE dc_scan_bytes(yyconst char *bytes, yy_size_t len, yyscan_t yyscanner);
 
-YY_BUFFER_STATE dc_scan_buffer(char *base, yy_size_t size);
-YY_BUFFER_STATE dc_scan_string(yyconst char *yy_str);
-YY_BUFFER_STATE dc_scan_bytes(yyconst char *bytes, yy_size_t len);
-
-void *dcalloc(yy_size_t);
-void *dcrealloc(void *, yy_size_t);
-void dcfree(void *);
+void *dcalloc(yy_size_t, yyscan_t yyscanner);
+void *dcrealloc(void *, yy_size_t, yyscan_t yyscanner);
+void dcfree(void *, yyscan_t yyscanner);
 
 #define yy_new_buffer dc_create_buffer
 
 #define yy_set_interactive(is_interactive) \
     { \
     if ( ! YY_CURRENT_BUFFER ){ \
-        dcensure_buffer_stack (); \
+        dcensure_buffer_stack (yyscanner); \
         YY_CURRENT_BUFFER_LVALUE =    \
-            dc_create_buffer(dcin,YY_BUF_SIZE ); \
+            dc_create_buffer(yyin,YY_BUF_SIZE, yyscanner); \
     } \
     YY_CURRENT_BUFFER_LVALUE->yy_is_interactive = is_interactive; \
     }
@@ -345,9 +332,9 @@ void dcfree(void *);
 #define yy_set_bol(at_bol) \
     { \
     if ( ! YY_CURRENT_BUFFER ){\
-        dcensure_buffer_stack (); \
+        dcensure_buffer_stack (yyscanner); \
         YY_CURRENT_BUFFER_LVALUE =    \
-            dc_create_buffer(dcin,YY_BUF_SIZE ); \
+            dc_create_buffer(yyin,YY_BUF_SIZE, yyscanner); \
     } \
     YY_CURRENT_BUFFER_LVALUE->yy_at_bol = at_bol; \
     }
@@ -356,31 +343,27 @@ void dcfree(void *);
 
 typedef unsigned char YY_CHAR;
 
-FILE *dcin = (FILE *) 0, *dcout = (FILE *) 0;
+#define dcwrap(yyscanner) (/*CONSTCOND*/1)
+#define YY_SKIP_YYWRAP
 
 typedef int yy_state_type;
 
-extern int dclineno;
-
-int dclineno = 1;
+#define yytext_ptr yytext_r
 
-extern char *dctext;
-#define yytext_ptr dctext
-
-static yy_state_type yy_get_previous_state(void);
-static yy_state_type yy_try_NUL_trans(yy_state_type current_state);
-static int yy_get_next_buffer(void);
-static void yy_fatal_error(yyconst char msg[]);
+static yy_state_type yy_get_previous_state(yyscan_t yyscanner);
+static yy_state_type yy_try_NUL_trans(yy_state_type current_state, yyscan_t yyscanner);
+static int yy_get_next_buffer(yyscan_t yyscanner);
+static void yy_fatal_error(yyconst char msg[], yyscan_t yyscanner);
 
 /* Done after the current pattern has been matched and before the
- * corresponding action - sets up dctext.
+ * corresponding action - sets up yytext.
  */
 #define YY_DO_BEFORE_ACTION \
-    (yytext_ptr) = yy_bp; \
-    dcleng = (size_t) (yy_cp - yy_bp); \
-    (yy_hold_char) = *yy_cp; \
+    yyg->yytext_ptr = yy_bp; \
+    yyleng = (size_t) (yy_cp - yy_bp); \
+    yyg->yy_hold_char = *yy_cp; \
     *yy_cp = '\0'; \
-    (yy_c_buf_p) = yy_cp;
+    yyg->yy_c_buf_p = yy_cp;
 
 #define YY_NUM_RULES 32
 #define YY_END_OF_BUFFER 33
@@ -531,12 +514,6 @@ static yyconst flex_int16_t yy_chk[192] = {
 
 } ;
 
-static yy_state_type yy_last_accepting_state;
-static char *yy_last_accepting_cpos;
-
-extern int dc_flex_debug;
-int dc_flex_debug = 0;
-
 /* The intent behind this definition is that it'll catch
  * any uses of REJECT which flex missed.
  */
@@ -544,7 +521,6 @@ int dc_flex_debug = 0;
 #define yymore() yymore_used_but_not_detected
 #define YY_MORE_ADJ 0
 #define YY_RESTORE_YY_MORE_OFFSET
-char *dctext;
 /*
 // Filename: lexer.lxx
 // Created by: drose (05 Oct, 2000)
@@ -553,7 +529,9 @@ char *dctext;
 #include "lex.h"
 #include "parse.h"
 
+#include <algorithm> // std::min
 #include <iostream>
+#include <new>       // std::bad_alloc
 
 #include "../dcfile/token.h"
 #include "../dcfile/parser-defs.h"
@@ -561,127 +539,85 @@ char *dctext;
 #include "../module/Module.h"
 using namespace bamboo;
 
-static int yyinput(void); // declared by flex.
-extern "C" int should_lexer_wrap();
-namespace bamboo { extern int dclex(); }
+// The bison parser's semantic type is a DCToken.
+#define YYSTYPE DCSTYPE
+
+// These are declared by flex, but only after this block.
+static int yyinput(yyscan_t yyscanner);
+bamboo::LexerState *dcget_extra(yyscan_t yyscanner);
+yy_size_t dcget_leng(yyscan_t yyscanner);
 
-#define YY_DECL int bamboo::dclex(void)
-#define dcwrap should_lexer_wrap
+#define YY_DECL int bamboo::dclex(DCToken *yylval_param, yyscan_t yyscanner)
 
 ////////////////////////////////////////////////////////////////////
 // Static variables
 ////////////////////////////////////////////////////////////////////
 
-// We'll increment line_number and col_number as we parse the file, so
-// that we can report the position of an error.
-static int line_number = 0;
-static int col_number = 0;
-
-// current_line holds as much of the current line as will fit.  Its
-// only purpose is for printing it out to report an error to the user.
+// max_error_width is how much of the current line is kept to print in error messages.
 static const int max_error_width = 1024;
-static char current_line[max_error_width + 1];
-
-static int error_count = 0;
-static int warning_count = 0;
-
-// This is the pointer to the current input stream.
-static std::istream *input_p = nullptr;
-
-// This is the name of the dc file we're parsing.  We keep it so we
-// can print it out for error messages.
-static std::string dc_filename;
-
-// This is the initial token state returned by the lexer.  It allows
-// the yacc grammar to start from initial points.
-static int initial_token;
-
-////////////////////////////////////////////////////////////////////
-// Defining the interface to the lexer.
-////////////////////////////////////////////////////////////////////
-
-void bamboo::dclexer_init(std::istream& in, const std::string& filename, int initial)
-{
-    input_p = &in;
-    dc_filename = filename;
-    line_number = 0;
-    col_number = 0;
-    error_count = 0;
-    warning_count = 0;
-    initial_token = initial;
-}
-
-int bamboo::dc_errors()
-{
-    return error_count;
-}
-
-int bamboo::dc_warnings()
-{
-    return warning_count;
-}
 
 ////////////////////////////////////////////////////////////////////
 // Internal support functions.
 ////////////////////////////////////////////////////////////////////
 
-int should_lexer_wrap(void)
-{
-    return 1;
-}
+bamboo::LexerState::LexerState(std::istream& in, const std::string& name, int initial)
+    : input(&in), filename(name), initial_token(initial), line_number(0), col_number(0),
+      error_count(0), warning_count(0) {}
 
-void bamboo::dcerror(const std::string& msg)
+void bamboo::dcerror(void *scanner, const std::string& msg)
 {
+    LexerState *lexer = dcget_extra(scanner);
     std::cerr << "\nError";
-    if(!dc_filename.empty()) {
-        std::cerr << " in " << dc_filename;
+    if(!lexer->filename.empty()) {
+        std::cerr << " in " << lexer->filename;
     }
-    std::cerr << " at line " << line_number << ", column " << col_number
-              << ":\n" << current_line << "\n";
-    indent(std::cerr, col_number - 1) << "^\n" << msg << "\n\n";
+    std::cerr << " at line " << lexer->line_number << ", column " << lexer->col_number
+              << ":\n" << lexer->current_line << "\n";
+    indent(std::cerr, lexer->col_number - 1) << "^\n" << msg << "\n\n";
 
-    error_count++;
+    lexer->error_count++;
 }
 
-void bamboo::dcwarning(const std::string& msg)
+void bamboo::dcwarning(void *scanner, const std::string& msg)
 {
+    LexerState *lexer = dcget_extra(scanner);
     std::cerr << "\nWarning";
-    if(!dc_filename.empty()) {
-        std::cerr << " in " << dc_filename;
+    if(!lexer->filename.empty()) {
+        std::cerr << " in " << lexer->filename;
     }
-    std::cerr << " at line " << line_number << ", column " << col_number
-              << ":\n" << current_line << "\n";
-    indent(std::cerr, col_number - 1) << "^\n" << msg << "\n\n";
+    std::cerr << " at line " << lexer->line_number << ", column " << lexer->col_number
+              << ":\n" << lexer->current_line << "\n";
+    indent(std::cerr, lexer->col_number - 1) << "^\n" << msg << "\n\n";
 
-    warning_count++;
+    lexer->warning_count++;
 }
 
 // Now define a function to take input from an istream instead of a
 // stdio FILE pointer.  This is flex-specific.
-static void input_chars(char *buffer, int& result, int max_size)
+static void input_chars(LexerState *lexer, char *buffer, int& result, int max_size)
 {
-    if(*input_p) {
-        input_p->read(buffer, max_size);
-        result = int(input_p->gcount());
+    if(*lexer->input) {
+        lexer->input->read(buffer, max_size);
+        result = int(lexer->input->gcount());
         if(result >= 0 && result < max_size) {
             // Truncate at the end of the read.
             buffer[result] = '\0';
         }
 
-        if(line_number == 0) {
+        if(lexer->line_number == 0) {
             // This is a special case.  If we are reading the very first bit
             // from the stream, copy it into the current_line array.  This
             // is because the \n.* rule below, which fills current_line
             // normally, doesn't catch the first line.
-            strncpy(current_line, dctext, max_error_width);
-            current_line[max_error_width] = '\0';
-            line_number++;
-            col_number = 0;
+            int length = std::min(std::max(result, 0), max_error_width);
+            lexer->current_line.assign(buffer, length);
+            lexer->line_number++;
+            lexer->col_number = 0;
 
             // Truncate it at the newline.
-            char *end = strchr(current_line, '\n');
-            if(end != nullptr) {
-                *end = '\0';
+            size_t end = lexer->current_line.find_first_of("\n", 0);
+            if(end != std::string::npos) {
+                lexer->current_line.resize(end);
             }
         }
 
@@ -696,16 +632,16 @@ static void input_chars(char *buffer, int& result, int max_size)
 // with a different type for result.
 #define YY_INPUT(buffer, result, max_size) { \
          int int_result; \
-         input_chars((buffer), int_result, (max_size)); \
+         input_chars(yyextra, (buffer), int_result, (max_size)); \
          (result) = int_result; \
      }
 
 // read_char reads and returns a single character, incrementing the
 // supplied line and column numbers as appropriate.  A convenience
 // function for the scanning functions below.
-static int read_char(int& line, int& col)
+static int read_char(yyscan_t yyscanner, int& line, int& col)
 {
-    int c = yyinput();
+    int c = yyinput(yyscanner);
     if(c == '\n') {
         line++;
         col = 0;
@@ -717,7 +653,7 @@ static int read_char(int& line, int& col)
 
 // scan_quoted_string reads a string delimited by quotation marks and
 // returns it.
-static std::string scan_quoted_string(char quote_mark)
+static std::string scan_quoted_string(yyscan_t yyscanner, char quote_mark)
 {
     std::string result;
 
@@ -727,14 +663,15 @@ static std::string scan_quoted_string(char quote_mark)
     // occurring at the start of the string, not at the end--somewhat
     // more convenient for the user.
 
-    // Instead of adjusting the global line_number and col_number
+    // Instead of adjusting the lexer's line_number and col_number
     // variables, we'll operate on our own local variables for the
     // interim.
-    int line = line_number;
-    int col = col_number;
+    LexerState *lexer = dcget_extra(yyscanner);
+    int line = lexer->line_number;
+    int col = lexer->col_number;
 
     int c;
-    c = read_char(line, col);
+    c = read_char(yyscanner, line, col);
     while(c != quote_mark && c != EOF) {
         // A newline is not allowed within a string unless it is escaped.
         if(c == '\n') {
@@ -744,34 +681,34 @@ static std::string scan_quoted_string(char quote_mark)
         } else if(c == '\\') {
             // Backslash escapes the following character.  We also respect
             // some C conventions.
-            c = read_char(line, col);
+            c = read_char(yyscanner, line, col);
             switch(c) {
             case 'a':
                 result += '\a';
-                c = read_char(line, col);
+                c = read_char(yyscanner, line, col);
                 break;
 
             case 'n':
                 result += '\n';
-                c = read_char(line, col);
+                c = read_char(yyscanner, line, col);
                 break;
 
             case 'r':
                 result += '\r';
-                c = read_char(line, col);
+                c = read_char(yyscanner, line, col);
                 break;
 
             case 't':
                 result += '\t';
-                c = read_char(line, col);
+                c = read_char(yyscanner, line, col);
                 break;
 
             case 'x': {
                 int hex = 0;
-                c = read_char(line, col);
+                c = read_char(yyscanner, line, col);
                 for(int i = 0; i < 2 && isxdigit(c); i++) {
                     hex = hex * 16 + (isdigit(c) ? c - '0' : tolower(c) - 'a' + 10);
-                    c = read_char(line, col);
+                    c = read_char(yyscanner, line, col);
                 }
 
                 result += hex;
@@ -780,10 +717,10 @@ static std::string scan_quoted_string(char quote_mark)
 
             case '0': {
                 int oct = 0;
-                c = read_char(line, col);
+                c = read_char(yyscanner, line, col);
                 for(int i = 0; i < 3 && (c >= '0' && c < '7'); i++) {
                     oct = oct * 8 + (c - '0');
-                    c = read_char(line, col);
+                    c = read_char(yyscanner, line, col);
                 }
 
                 result += oct;
@@ -800,10 +737,10 @@ static std::string scan_quoted_string(char quote_mark)
             case '8':
             case '9': {
                 int dec = 0;
-                c = read_char(line, col);
+                c = read_char(yyscanner, line, col);
                 for(int i = 0; i < 3 && isdigit(c); i++) {
                     dec = dec * 10 + (c - '0');
-                    c = read_char(line, col);
+                    c = read_char(yyscanner, line, col);
                 }
 
                 result += dec;
@@ -815,28 +752,28 @@ static std::string scan_quoted_string(char quote_mark)
 
             default:
                 result += c;
-                c = read_char(line, col);
+                c = read_char(yyscanner, line, col);
             }
 
         } else {
             result += c;
-            c = read_char(line, col);
+            c = read_char(yyscanner, line, col);
         }
     }
 
     if(c == EOF) {
-        dcerror("This quotation mark is unterminated.");
+        dcerror(yyscanner, "This quotation mark is unterminated.");
     }
 
-    line_number = line;
-    col_number = col;
+    lexer->line_number = line;
+    lexer->col_number = col;
 
     return result;
 }
 
 // scan_hex_string reads a string of hexadecimal digits delimited by
 // angle brackets and returns the representative string.
-static std::string scan_hex_string()
+static std::string scan_hex_string(yyscan_t yyscanner)
 {
     std::string result;
 
@@ -846,16 +783,17 @@ static std::string scan_hex_string()
     // occurring at the start of the string, not at the end--somewhat
     // more convenient for the user.
 
-    // Instead of adjusting the global line_number and col_number
+    // Instead of adjusting the lexer's line_number and col_number
     // variables, we'll operate on our own local variables for the
     // interim.
-    int line = line_number;
-    int col = col_number;
+    LexerState *lexer = dcget_extra(yyscanner);
+    int line = lexer->line_number;
+    int col = lexer->col_number;
 
     bool odd = false;
     int last = 0;
     int c;
-    c = read_char(line, col);
+    c = read_char(yyscanner, line, col);
     while(c != '>' && c != EOF) {
         int value;
         if(c >= '0' && c <= '9') {
@@ -865,9 +803,9 @@ static std::string scan_hex_string()
         } else if(c >= 'A' && c <= 'F') {
             value = c - 'A' + 10;
         } else {
-            line_number = line;
-            col_number = col;
-            dcerror("Invalid hex digit.");
+            lexer->line_number = line;
+            lexer->col_number = col;
+            dcerror(yyscanner, "Invalid hex digit.");
             return std::string();
         }
 
@@ -877,58 +815,59 @@ static std::string scan_hex_string()
         } else {
             result += (char)((last << 4) | value);
         }
-        c = read_char(line, col);
+        c = read_char(yyscanner, line, col);
     }
 
     if(c == EOF) {
-        dcerror("This hex string is unterminated.");
+        dcerror(yyscanner, "This hex string is unterminated.");
         return std::string();
     } else if(odd) {
-        dcerror("Odd number of hex digits.");
+        dcerror(yyscanner, "Odd number of hex digits.");
         return std::string();
     }
 
-    line_number = line;
-    col_number = col;
+    lexer->line_number = line;
+    lexer->col_number = col;
 
     return result;
 }
 
 // eat_c_comment scans past all characters up until the first */
 // encountered.
-static void eat_c_comment()
+static void eat_c_comment(yyscan_t yyscanner)
 {
     // As above, we'll operate on our own local copies of line_number
     // and col_number within this function.
 
-    int line = line_number;
-    int col = col_number;
+    LexerState *lexer = dcget_extra(yyscanner);
+    int line = lexer->line_number;
+    int col = lexer->col_number;
 
     int c, last_c;
 
     last_c = '\0';
-    c = read_char(line, col);
+    c = read_char(yyscanner, line, col);
     while(c != EOF && !(last_c == '*' && c == '/')) {
         if(last_c == '/' && c == '*') {
-            dcwarning("This comment contains a nested /* symbol--possibly unclosed?");
+            dcwarning(yyscanner, "This comment contains a nested /* symbol--possibly unclosed?");
         }
         last_c = c;
-        c = read_char(line, col);
+        c = read_char(yyscanner, line, col);
     }
 
     if(c == EOF) {
-        dcerror("This comment marker is unclosed.");
+        dcerror(yyscanner, "This comment marker is unclosed.");
     }
 
-    line_number = line;
-    col_number = col;
+    lexer->line_number = line;
+    lexer->col_number = col;
 }
 
 // accept() is called below as each piece is pulled off and
 // accepted by the lexer; it increments the current column number.
-inline void accept()
+static void accept(yyscan_t yyscanner)
 {
-    col_number += int(dcleng);
+    dcget_extra(yyscanner)->col_number += int(dcget_leng(yyscanner));
 }
 
 #define YY_NO_UNISTD_H 1
@@ -943,40 +882,89 @@ inline void accept()
 #include <unistd.h>
 #endif
 
-#ifndef YY_EXTRA_TYPE
-#define YY_EXTRA_TYPE void *
-#endif
+#define YY_EXTRA_TYPE bamboo::LexerState *
+
+/* Holds the entire state of the reentrant scanner. */
+struct yyguts_t {
+
+    /* User-defined. Not touched by flex. */
+    YY_EXTRA_TYPE yyextra_r;
+
+    /* The rest are the same as the globals declared in the non-reentrant scanner. */
+    FILE *yyin_r, *yyout_r;
+    size_t yy_buffer_stack_top; /**< index of top of stack. */
+    size_t yy_buffer_stack_max; /**< capacity of stack. */
+    YY_BUFFER_STATE *yy_buffer_stack; /**< Stack as an array. */
+    char yy_hold_char;
+    yy_size_t yy_n_chars;
+    yy_size_t yyleng_r;
+    char *yy_c_buf_p;
+    int yy_init;
+    int yy_start;
+    int yy_did_buffer_switch_on_eof;
+    int yy_start_stack_ptr;
+    int yy_start_stack_depth;
+    int *yy_start_stack;
+    yy_state_type yy_last_accepting_state;
+    char *yy_last_accepting_cpos;
+
+    int yylineno_r;
+    int yy_flex_debug_r;
+
+    char *yytext_r;
+    int yy_more_flag;
+    int yy_more_len;
+
+    YYSTYPE *yylval_r;
 
-static int yy_init_globals(void);
+}; /* end struct yyguts_t */
+
+static int yy_init_globals(yyscan_t yyscanner);
+
+/* This must go here because YYSTYPE and YYLTYPE are included
+ * from bison output in section 1.*/
+#define yylval yyg->yylval_r
+
+int dclex_init(yyscan_t *scanner);
+
+int dclex_init_extra(YY_EXTRA_TYPE user_defined, yyscan_t *scanner);
 
 /* Accessor methods to globals.
    These are made visible to non-reentrant scanners for convenience. */
 
-int dclex_destroy(void);
+int dclex_destroy(yyscan_t yyscanner);
+
+int dcget_debug(yyscan_t yyscanner);
+
+void dcset_debug(int debug_flag, yyscan_t yyscanner);
+
+YY_EXTRA_TYPE dcget_extra(yyscan_t yyscanner);
+
+void dcset_extra(YY_EXTRA_TYPE user_defined, yyscan_t yyscanner);
 
-int dcget_debug(void);
+FILE *dcget_in(yyscan_t yyscanner);
 
-void dcset_debug(int debug_flag);
+void dcset_in(FILE *in_str, yyscan_t yyscanner);
 
-YY_EXTRA_TYPE dcget_extra(void);
+FILE *dcget_out(yyscan_t yyscanner);
 
-void dcset_extra(YY_EXTRA_TYPE user_defined);
+void dcset_out(FILE *out_str, yyscan_t yyscanner);
 
-FILE *dcget_in(void);
+yy_size_t dcget_leng(yyscan_t yyscanner);
 
-void dcset_in(FILE *in_str);
+char *dcget_text(yyscan_t yyscanner);
 
-FILE *dcget_out(void);
+int dcget_lineno(yyscan_t yyscanner);
 
-void dcset_out(FILE *out_str);
+void dcset_lineno(int line_number, yyscan_t yyscanner);
 
-yy_size_t dcget_leng(void);
+int dcget_column(yyscan_t yyscanner);
 
-char *dcget_text(void);
+void dcset_column(int column_no, yyscan_t yyscanner);
 
-int dcget_lineno(void);
+YYSTYPE *dcget_lval(yyscan_t yyscanner);
 
-void dcset_lineno(int line_number);
+void dcset_lval(YYSTYPE *yylval_param, yyscan_t yyscanner);
 
 /* Macros after this point can all be overridden by user definitions in
  * section 1.
@@ -984,26 +972,26 @@ void dcset_lineno(int line_number);
 
 #ifndef YY_SKIP_YYWRAP
 #ifdef __cplusplus
-extern "C" int dcwrap(void);
+extern "C" int dcwrap(yyscan_t yyscanner, yyscan_t yyscanner);
 #else
-extern int dcwrap(void);
+extern int dcwrap(yyscan_t yyscanner, yyscan_t yyscanner);
 #endif
 #endif
 
 #ifndef yytext_ptr
-static void yy_flex_strncpy(char *, yyconst char *, int);
+static void yy_flex_strncpy(char *, yyconst char *, int, yyscan_t yyscanner);
 #endif
 
 #ifdef YY_NEED_STRLEN
-static int yy_flex_strlen(yyconst char *);
+static int yy_flex_strlen(yyconst char *, yyscan_t yyscanner);
 #endif
 
 #ifndef YY_NO_INPUT
 
 #ifdef __cplusplus
-static int yyinput(void);
+static int yyinput(yyscan_t yyscanner);
 #else
-static int input(void);
+static int input(yyscan_t yyscanner);
 #endif
 
 #endif
@@ -1023,7 +1011,7 @@ static int input(void);
 /* This used to be an fputs(), but since the string might contain NUL's,
  * we now use fwrite().
  */
-#define ECHO do { if (fwrite( dctext, dcleng, 1, dcout )) {} } while (0)
+#define ECHO do { if (fwrite( yytext, yyleng, 1, yyout )) {} } while (0)
 #endif
 
 /* Gets input and stuffs it into "buf".  number of characters read, or YY_NULL,
@@ -1036,18 +1024,18 @@ static int input(void);
         int c = '*'; \
         size_t n; \
         for ( n = 0; n < max_size && \
-                 (c = getc( dcin )) != EOF && c != '\n'; ++n ) \
+                 (c = getc( yyin )) != EOF && c != '\n'; ++n ) \
             buf[n] = (char) c; \
         if ( c == '\n' ) \
             buf[n++] = (char) c; \
-        if ( c == EOF && ferror( dcin ) ) \
+        if ( c == EOF && ferror( yyin ) ) \
             YY_FATAL_ERROR( "input in flex scanner failed" ); \
         result = n; \
         } \
     else \
         { \
         errno=0; \
-        while ( (result = fread(buf, 1, max_size, dcin))==0 && ferror(dcin)) \
+        while ( (result = fread(buf, 1, max_size, yyin))==0 && ferror(yyin)) \
             { \
             if( errno != EINTR) \
                 { \
@@ -1055,7 +1043,7 @@ static int input(void);
                 break; \
                 } \
             errno=0; \
-            clearerr(dcin); \
+            clearerr(yyin); \
             } \
         }\
 \
@@ -1077,7 +1065,7 @@ static int input(void);
 
 /* Report a fatal error. */
 #ifndef YY_FATAL_ERROR
-#define YY_FATAL_ERROR(msg) yy_fatal_error( msg )
+#define YY_FATAL_ERROR(msg) yy_fatal_error( msg, yyscanner)
 #endif
 
 /* end tables serialization structures and prototypes */
@@ -1088,12 +1076,12 @@ static int input(void);
 #ifndef YY_DECL
 #define YY_DECL_IS_OURS 1
 
-extern int dclex(void);
+extern int dclex(YYSTYPE *yylval_param, yyscan_t yyscanner);
 
-#define YY_DECL int dclex (void)
+#define YY_DECL int dclex (YYSTYPE * yylval_param , yyscan_t yyscanner)
 #endif /* !YY_DECL */
 
-/* Code executed at the beginning of each rule, after dctext and dcleng
+/* Code executed at the beginning of each rule, after yytext and yyleng
  * have been set up.
  */
 #ifndef YY_USER_ACTION
@@ -1114,61 +1102,63 @@ YY_DECL {
     yy_state_type yy_current_state;
     char *yy_cp, *yy_bp;
     int yy_act;
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
 
-    if(!(yy_init))
+    yylval = yylval_param;
+
+    if(!yyg->yy_init)
     {
-        (yy_init) = 1;
+        yyg->yy_init = 1;
 
 #ifdef YY_USER_INIT
         YY_USER_INIT;
 #endif
 
-        if(!(yy_start))
-            (yy_start) = 1; /* first start state */
+        if(!yyg->yy_start)
+            yyg->yy_start = 1; /* first start state */
 
-        if(! dcin)
-            dcin = stdin;
+        if(! yyin)
+            yyin = stdin;
 
-        if(! dcout)
-            dcout = stdout;
+        if(! yyout)
+            yyout = stdout;
 
         if(! YY_CURRENT_BUFFER) {
-            dcensure_buffer_stack();
+            dcensure_buffer_stack(yyscanner);
             YY_CURRENT_BUFFER_LVALUE =
-            dc_create_buffer(dcin, YY_BUF_SIZE);
+            dc_create_buffer(yyin, YY_BUF_SIZE, yyscanner);
         }
 
-        dc_load_buffer_state();
+        dc_load_buffer_state(yyscanner);
     }
 
     {
 
-        if(initial_token != 0)
-        {
-            int t = initial_token;
-            initial_token = 0;
+        if(yyextra->initial_token != 0) {
+            int t = yyextra->initial_token;
+            yyextra->initial_token = 0;
             return t;
         }
 
         while(1)         /* loops until end-of-file is reached */
         {
-            yy_cp = (yy_c_buf_p);
+            yy_cp = yyg->yy_c_buf_p;
 
-            /* Support of dctext. */
-            *yy_cp = (yy_hold_char);
+            /* Support of yytext. */
+            *yy_cp = yyg->yy_hold_char;
 
             /* yy_bp points to the position in yy_ch_buf of the start of
              * the current run.
              */
             yy_bp = yy_cp;
 
-            yy_current_state = (yy_start);
+            yy_current_state = yyg->yy_start;
         yy_match:
             do {
                 YY_CHAR yy_c = yy_ec[YY_SC_TO_UI(*yy_cp)] ;
                 if(yy_accept[yy_current_state]) {
-                    (yy_last_accepting_state) = yy_current_state;
-                    (yy_last_accepting_cpos) = yy_cp;
+                    yyg->yy_last_accepting_state = yy_current_state;
+                    yyg->yy_last_accepting_cpos = yy_cp;
                 }
                 while(yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state) {
                     yy_current_state = (int) yy_def[yy_current_state];
@@ -1178,8 +1168,8 @@ YY_DECL {
                 yy_current_state = yy_nxt[yy_base[yy_current_state] + (unsigned int) yy_c];
                 ++yy_cp;
             } while(yy_current_state != 103);
-            yy_cp = (yy_last_accepting_cpos);
-            yy_current_state = (yy_last_accepting_state);
+            yy_cp = yyg->yy_last_accepting_cpos;
+            yy_current_state = yyg->yy_last_accepting_state;
 
         yy_find_action:
             yy_act = yy_accept[yy_current_state];
@@ -1192,9 +1182,9 @@ YY_DECL {
             /* beginning of action switch */
             case 0: /* must back up */
                 /* undo the effects of YY_DO_BEFORE_ACTION */
-                *yy_cp = (yy_hold_char);
-                yy_cp = (yy_last_accepting_cpos);
-                yy_current_state = (yy_last_accepting_state);
+                *yy_cp = yyg->yy_hold_char;
+                yy_cp = yyg->yy_last_accepting_cpos;
+                yy_current_state = yyg->yy_last_accepting_state;
                 goto yy_find_action;
 
             case 1:
@@ -1203,10 +1193,10 @@ YY_DECL {
                     // New line.  Save a copy of the line so we can print it out for the
                     // benefit of the user in case we get an error.
 
-                    strncpy(current_line, dctext + 1, max_error_width);
-                    current_line[max_error_width] = '\0';
-                    line_number++;
-                    col_number = 0;
+                    LexerState *lexer = yyextra;
+                    lexer->current_line.assign(yytext + 1, std::min(int(yyleng) - 1, max_error_width));
+                    lexer->line_number++;
+                    lexer->col_number = 0;
 
                     // Return the whole line to the lexer, except the newline character,
                     // which we eat.
@@ -1216,155 +1206,155 @@ YY_DECL {
             case 2:
                 YY_RULE_SETUP {
                     // Eat whitespace.
-                    accept();
+                    accept(yyscanner);
                 }
                 YY_BREAK
             case 3:
                 YY_RULE_SETUP {
                     // Eat C++-style comments.
-                    accept();
+                    accept(yyscanner);
                 }
                 YY_BREAK
             case 4:
                 YY_RULE_SETUP {
                     // Eat C-style comments.
-                    accept();
-                    eat_c_comment();
+                    accept(yyscanner);
+                    eat_c_comment(yyscanner);
                 }
                 YY_BREAK
             case 5:
                 YY_RULE_SETUP {
-                    accept();
+                    accept(yyscanner);
                     return KW_DCLASS;
                 }
                 YY_BREAK
             case 6:
                 YY_RULE_SETUP {
-                    accept();
+                    accept(yyscanner);
                     return KW_STRUCT;
                 }
                 YY_BREAK
             case 7:
                 YY_RULE_SETUP {
-                    accept();
+                    accept(yyscanner);
                     return KW_FROM;
                 }
                 YY_BREAK
             case 8:
                 YY_RULE_SETUP {
-                    accept();
+                    accept(yyscanner);
                     return KW_IMPORT;
                 }
                 YY_BREAK
             case 9:
                 YY_RULE_SETUP {
-                    accept();
+                    accept(yyscanner);
                     return KW_KEYWORD;
                 }
                 YY_BREAK
             case 10:
                 YY_RULE_SETUP {
-                    accept();
+                    accept(yyscanner);
                     return KW_TYPEDEF;
                 }
                 YY_BREAK
             case 11:
                 YY_RULE_SETUP {
-                    accept();
+                    accept(yyscanner);
                     return KW_INT8;
                 }
                 YY_BREAK
             case 12:
                 YY_RULE_SETUP {
-                    accept();
+                    accept(yyscanner);
                     return KW_INT16;
                 }
                 YY_BREAK
             case 13:
                 YY_RULE_SETUP {
-                    accept();
+                    accept(yyscanner);
                     return KW_INT32;
                 }
                 YY_BREAK
             case 14:
                 YY_RULE_SETUP {
-                    accept();
+                    accept(yyscanner);
                     return KW_INT64;
                 }
                 YY_BREAK
             case 15:
                 YY_RULE_SETUP {
-                    accept();
+                    accept(yyscanner);
                     return KW_UINT8;
                 }
                 YY_BREAK
             case 16:
                 YY_RULE_SETUP {
-                    accept();
+                    accept(yyscanner);
                     return KW_UINT16;
                 }
                 YY_BREAK
             case 17:
                 YY_RULE_SETUP {
-                    accept();
+                    accept(yyscanner);
                     return KW_UINT32;
                 }
                 YY_BREAK
             case 18:
                 YY_RULE_SETUP {
-                    accept();
+                    accept(yyscanner);
                     return KW_UINT64;
                 }
                 YY_BREAK
             case 19:
                 YY_RULE_SETUP {
-                    accept();
+                    accept(yyscanner);
                     return KW_FLOAT32;
                 }
                 YY_BREAK
             case 20:
                 YY_RULE_SETUP {
-                    accept();
+                    accept(yyscanner);
                     return KW_FLOAT64;
                 }
                 YY_BREAK
             case 21:
                 YY_RULE_SETUP {
-                    accept();
+                    accept(yyscanner);
                     return KW_STRING;
                 }
                 YY_BREAK
             case 22:
                 YY_RULE_SETUP {
-                    accept();
+                    accept(yyscanner);
                     return KW_BLOB;
                 }
                 YY_BREAK
             case 23:
                 YY_RULE_SETUP {
-                    accept();
+                    accept(yyscanner);
                     return KW_CHAR;
                 }
                 YY_BREAK
             case 24:
                 YY_RULE_SETUP {
                     // An unsigned integer number.
-                    accept();
+                    accept(yyscanner);
 
                     // atoll isn't fully portable, so we'll decode the integer by hand.
-                    dclval.str = dctext;
-                    dclval.uint64 = 0;
-                    const char *p = dctext;
+                    yylval->str = yytext;
+                    yylval->uint64 = 0;
+                    const char *p = yytext;
                     while(*p != '\0')
                     {
-                        uint64_t next_value = dclval.uint64 * 10;
-                        if(next_value < dclval.uint64) {
-                            dcerror("Number out of range.");
-                            dclval.uint64 = 1;
+                        uint64_t next_value = yylval->uint64 * 10;
+                        if(next_value < yylval->uint64) {
+                            dcerror(yyscanner, "Number out of range.");
+                            yylval->uint64 = 1;
                             return UNSIGNED_INTEGER;
                         }
 
-                        dclval.uint64 = next_value + (*p - '0');
+                        yylval->uint64 = next_value + (*p - '0');
                         ++p;
                     }
 
@@ -1374,25 +1364,25 @@ YY_DECL {
             case 25:
                 YY_RULE_SETUP {
                     // A hexadecimal integer number.
-                    accept();
+                    accept(yyscanner);
 
                     // As above, we'll decode the hex string by hand.
-                    dclval.str = dctext;
-                    dclval.uint64 = 0;
-                    const char *p = dctext + 2;
+                    yylval->str = yytext;
+                    yylval->uint64 = 0;
+                    const char *p = yytext + 2;
                     while(*p != '\0')
                     {
-                        uint64_t next_value = dclval.uint64 * 16;
-                        if(next_value < dclval.uint64) {
-                            dcerror("Number out of range.");
-                            dclval.uint64 = 1;
+                        uint64_t next_value = yylval->uint64 * 16;
+                        if(next_value < yylval->uint64) {
+                            dcerror(yyscanner, "Number out of range.");
+                            yylval->uint64 = 1;
                             return UNSIGNED_INTEGER;
                         }
 
                         if(isalpha(*p)) {
-                            dclval.uint64 = next_value + (tolower(*p) - 'a' + 10);
+                            yylval->uint64 = next_value + (tolower(*p) - 'a' + 10);
                         } else {
-                            dclval.uint64 = next_value + (*p - '0');
+                            yylval->uint64 = next_value + (*p - '0');
                         }
                         ++p;
                     }
@@ -1403,49 +1393,49 @@ YY_DECL {
             case 26:
                 YY_RULE_SETUP {
                     // A floating-point number.
-                    accept();
-                    dclval.real = atof(dctext);
-                    dclval.str = dctext;
+                    accept(yyscanner);
+                    yylval->real = atof(yytext);
+                    yylval->str = yytext;
                     return REAL;
                 }
                 YY_BREAK
             case 27:
                 YY_RULE_SETUP {
                     // Quoted string.
-                    accept();
-                    dclval.str = scan_quoted_string('"');
+                    accept(yyscanner);
+                    yylval->str = scan_quoted_string(yyscanner, '"');
                     return STRING;
                 }
                 YY_BREAK
             case 28:
                 YY_RULE_SETUP {
                     // Single-quoted string.
-                    accept();
-                    dclval.str = scan_quoted_string('\'');
+                    accept(yyscanner);
+                    yylval->str = scan_quoted_string(yyscanner, '\'');
                     return CHAR;
                 }
                 YY_BREAK
             case 29:
                 YY_RULE_SETUP {
                     // Long hex string.
-                    accept();
-                    dclval.str = scan_hex_string();
+                    accept(yyscanner);
+                    yylval->str = scan_hex_string(yyscanner);
                     return HEX_STRING;
                 }
                 YY_BREAK
             case 30:
                 YY_RULE_SETUP {
                     // Identifier or keyword.
-                    accept();
-                    dclval.str = dctext;
+                    accept(yyscanner);
+                    yylval->str = yytext;
                     return IDENTIFIER;
                 }
                 YY_BREAK
             case 31:
                 YY_RULE_SETUP {
                     // Send any other printable character as itself.
-                    accept();
-                    return dctext[0];
+                    accept(yyscanner);
+                    return yytext[0];
                 }
                 YY_BREAK
             case 32:
@@ -1457,24 +1447,24 @@ YY_DECL {
 
             case YY_END_OF_BUFFER: {
                 /* Amount of text matched not including the EOB char. */
-                int yy_amount_of_matched_text = (int)(yy_cp - (yytext_ptr)) - 1;
+                int yy_amount_of_matched_text = (int)(yy_cp - yyg->yytext_ptr) - 1;
 
                 /* Undo the effects of YY_DO_BEFORE_ACTION. */
-                *yy_cp = (yy_hold_char);
+                *yy_cp = yyg->yy_hold_char;
                 YY_RESTORE_YY_MORE_OFFSET
 
                 if(YY_CURRENT_BUFFER_LVALUE->yy_buffer_status == YY_BUFFER_NEW) {
                     /* We're scanning a new file or input source.  It's
                      * possible that this happened because the user
-                     * just pointed dcin at a new source and called
+                     * just pointed yyin at a new source and called
                      * dclex().  If so, then we have to assure
                      * consistency between YY_CURRENT_BUFFER and our
                      * globals.  Here is the right place to do so, because
                      * this is the first action (other than possibly a
                      * back-up) that will match for the new input source.
                      */
-                    (yy_n_chars) = YY_CURRENT_BUFFER_LVALUE->yy_n_chars;
-                    YY_CURRENT_BUFFER_LVALUE->yy_input_file = dcin;
+                    yyg->yy_n_chars = YY_CURRENT_BUFFER_LVALUE->yy_n_chars;
+                    YY_CURRENT_BUFFER_LVALUE->yy_input_file = yyin;
                     YY_CURRENT_BUFFER_LVALUE->yy_buffer_status = YY_BUFFER_NORMAL;
                 }
 
@@ -1485,13 +1475,13 @@ YY_DECL {
                  * end-of-buffer state).  Contrast this with the test
                  * in input().
                  */
-                if((yy_c_buf_p) <= &YY_CURRENT_BUFFER_LVALUE->yy_ch_buf[(yy_n_chars)]) {
+                if(yyg->yy_c_buf_p <= &YY_CURRENT_BUFFER_LVALUE->yy_ch_buf[yyg->yy_n_chars]) {
                     /* This was really a NUL. */
                     yy_state_type yy_next_state;
 
-                    (yy_c_buf_p) = (yytext_ptr) + yy_amount_of_matched_text;
+                    yyg->yy_c_buf_p = yyg->yytext_ptr + yy_amount_of_matched_text;
 
-                    yy_current_state = yy_get_previous_state();
+                    yy_current_state = yy_get_previous_state(yyscanner);
 
                     /* Okay, we're now positioned to make the NUL
                      * transition.  We couldn't have
@@ -1502,69 +1492,69 @@ YY_DECL {
                      * will run more slowly).
                      */
 
-                    yy_next_state = yy_try_NUL_trans(yy_current_state);
+                    yy_next_state = yy_try_NUL_trans(yy_current_state, yyscanner);
 
-                    yy_bp = (yytext_ptr) + YY_MORE_ADJ;
+                    yy_bp = yyg->yytext_ptr + YY_MORE_ADJ;
 
                     if(yy_next_state) {
                         /* Consume the NUL. */
-                        yy_cp = ++(yy_c_buf_p);
+                        yy_cp = ++yyg->yy_c_buf_p;
                         yy_current_state = yy_next_state;
                         goto yy_match;
                     }
 
                     else {
-                        yy_cp = (yy_last_accepting_cpos);
-                        yy_current_state = (yy_last_accepting_state);
+                        yy_cp = yyg->yy_last_accepting_cpos;
+                        yy_current_state = yyg->yy_last_accepting_state;
                         goto yy_find_action;
                     }
                 }
 
-                else switch(yy_get_next_buffer()) {
+                else switch(yy_get_next_buffer(yyscanner)) {
                     case EOB_ACT_END_OF_FILE: {
-                        (yy_did_buffer_switch_on_eof) = 0;
+                        yyg->yy_did_buffer_switch_on_eof = 0;
 
-                        if(dcwrap()) {
+                        if(dcwrap(yyscanner)) {
                             /* Note: because we've taken care in
                              * yy_get_next_buffer() to have set up
-                             * dctext, we can now set up
+                             * yytext, we can now set up
                              * yy_c_buf_p so that if some total
                              * hoser (like flex itself) wants to
                              * call the scanner after we return the
                              * YY_NULL, it'll still work - another
                              * YY_NULL will get returned.
                              */
-                            (yy_c_buf_p) = (yytext_ptr) + YY_MORE_ADJ;
+                            yyg->yy_c_buf_p = yyg->yytext_ptr + YY_MORE_ADJ;
 
                             yy_act = YY_STATE_EOF(YY_START);
                             goto do_action;
                         }
 
                         else {
-                            if(!(yy_did_buffer_switch_on_eof))
+                            if(!yyg->yy_did_buffer_switch_on_eof)
                                 YY_NEW_FILE;
                         }
                         break;
                     }
 
                     case EOB_ACT_CONTINUE_SCAN:
-                        (yy_c_buf_p) =
-                            (yytext_ptr) + yy_amount_of_matched_text;
+                        yyg->yy_c_buf_p =
+                            yyg->yytext_ptr + yy_amount_of_matched_text;
 
-                        yy_current_state = yy_get_previous_state();
+                        yy_current_state = yy_get_previous_state(yyscanner);
 
-                        yy_cp = (yy_c_buf_p);
-                        yy_bp = (yytext_ptr) + YY_MORE_ADJ;
+                        yy_cp = yyg->yy_c_buf_p;
+                        yy_bp = yyg->yytext_ptr + YY_MORE_ADJ;
                         goto yy_match;
 
                     case EOB_ACT_LAST_MATCH:
-                        (yy_c_buf_p) =
-                            &YY_CURRENT_BUFFER_LVALUE->yy_ch_buf[(yy_n_chars)];
+                        yyg->yy_c_buf_p =
+                            &YY_CURRENT_BUFFER_LVALUE->yy_ch_buf[yyg->yy_n_chars];
 
-                        yy_current_state = yy_get_previous_state();
+                        yy_current_state = yy_get_previous_state(yyscanner);
 
-                        yy_cp = (yy_c_buf_p);
-                        yy_bp = (yytext_ptr) + YY_MORE_ADJ;
+                        yy_cp = yyg->yy_c_buf_p;
+                        yy_bp = yyg->yytext_ptr + YY_MORE_ADJ;
                         goto yy_find_action;
                     }
                 break;
@@ -1585,20 +1575,21 @@ YY_DECL {
  *  EOB_ACT_CONTINUE_SCAN - continue scanning from current position
  *  EOB_ACT_END_OF_FILE - end of file
  */
-static int yy_get_next_buffer(void)
+static int yy_get_next_buffer(yyscan_t yyscanner)
 {
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
     char *dest = YY_CURRENT_BUFFER_LVALUE->yy_ch_buf;
-    char *source = (yytext_ptr);
+    char *source = yyg->yytext_ptr;
     int number_to_move, i;
     int ret_val;
 
-    if((yy_c_buf_p) > &YY_CURRENT_BUFFER_LVALUE->yy_ch_buf[(yy_n_chars) + 1])
+    if(yyg->yy_c_buf_p > &YY_CURRENT_BUFFER_LVALUE->yy_ch_buf[yyg->yy_n_chars + 1])
         YY_FATAL_ERROR(
             "fatal flex scanner internal error--end of buffer missed");
 
     if(YY_CURRENT_BUFFER_LVALUE->yy_fill_buffer == 0) {
         /* Don't try to fill the buffer, so this is an EOF. */
-        if((yy_c_buf_p) - (yytext_ptr) - YY_MORE_ADJ == 1) {
+        if(yyg->yy_c_buf_p - yyg->yytext_ptr - YY_MORE_ADJ == 1) {
             /* We matched a single character, the EOB, so
              * treat this as a final EOF.
              */
@@ -1616,7 +1607,7 @@ static int yy_get_next_buffer(void)
     /* Try to read more data. */
 
     /* First move last chars to start of buffer. */
-    number_to_move = (int)((yy_c_buf_p) - (yytext_ptr)) - 1;
+    number_to_move = (int)(yyg->yy_c_buf_p - yyg->yytext_ptr) - 1;
 
     for(i = 0; i < number_to_move; ++i)
         *(dest++) = *(source++);
@@ -1625,7 +1616,7 @@ static int yy_get_next_buffer(void)
         /* don't do the read, it's not guaranteed to return an EOF,
          * just force an EOF
          */
-        YY_CURRENT_BUFFER_LVALUE->yy_n_chars = (yy_n_chars) = 0;
+        YY_CURRENT_BUFFER_LVALUE->yy_n_chars = yyg->yy_n_chars = 0;
 
     else {
         yy_size_t num_to_read =
@@ -1638,7 +1629,7 @@ static int yy_get_next_buffer(void)
             YY_BUFFER_STATE b = YY_CURRENT_BUFFER_LVALUE;
 
             int yy_c_buf_p_offset =
-                (int)((yy_c_buf_p) - b->yy_ch_buf);
+                (int)(yyg->yy_c_buf_p - b->yy_ch_buf);
 
             if(b->yy_is_our_buffer) {
                 yy_size_t new_size = b->yy_buf_size * 2;
@@ -1650,7 +1641,7 @@ static int yy_get_next_buffer(void)
 
                 b->yy_ch_buf = (char *)
                                /* Include room in for 2 EOB chars. */
-                               dcrealloc((void *) b->yy_ch_buf, b->yy_buf_size + 2);
+                               dcrealloc((void *) b->yy_ch_buf, b->yy_buf_size + 2, yyscanner);
             } else
                 /* Can't grow it, we don't own it. */
                 b->yy_ch_buf = 0;
@@ -1659,7 +1650,7 @@ static int yy_get_next_buffer(void)
                 YY_FATAL_ERROR(
                     "fatal error - scanner input buffer overflow");
 
-            (yy_c_buf_p) = &b->yy_ch_buf[yy_c_buf_p_offset];
+            yyg->yy_c_buf_p = &b->yy_ch_buf[yy_c_buf_p_offset];
 
             num_to_read = YY_CURRENT_BUFFER_LVALUE->yy_buf_size -
                           number_to_move - 1;
@@ -1671,15 +1662,15 @@ static int yy_get_next_buffer(void)
 
         /* Read in more data. */
         YY_INPUT((&YY_CURRENT_BUFFER_LVALUE->yy_ch_buf[number_to_move]),
-                 (yy_n_chars), num_to_read);
+                 yyg->yy_n_chars, num_to_read);
 
-        YY_CURRENT_BUFFER_LVALUE->yy_n_chars = (yy_n_chars);
+        YY_CURRENT_BUFFER_LVALUE->yy_n_chars = yyg->yy_n_chars;
     }
 
-    if((yy_n_chars) == 0) {
+    if(yyg->yy_n_chars == 0) {
         if(number_to_move == YY_MORE_ADJ) {
             ret_val = EOB_ACT_END_OF_FILE;
-            dcrestart(dcin);
+            dcrestart(yyin, yyscanner);
         }
 
         else {
@@ -1692,38 +1683,39 @@ static int yy_get_next_buffer(void)
     else
         ret_val = EOB_ACT_CONTINUE_SCAN;
 
-    if((yy_size_t)((yy_n_chars) + number_to_move) > YY_CURRENT_BUFFER_LVALUE->yy_buf_size) {
+    if((yy_size_t)(yyg->yy_n_chars + number_to_move) > YY_CURRENT_BUFFER_LVALUE->yy_buf_size) {
         /* Extend the array by 50%, plus the number we really need. */
-        yy_size_t new_size = (yy_n_chars) + number_to_move + ((yy_n_chars) >> 1);
+        yy_size_t new_size = yyg->yy_n_chars + number_to_move + (yyg->yy_n_chars >> 1);
         YY_CURRENT_BUFFER_LVALUE->yy_ch_buf = (char *) dcrealloc((void *)
-                                              YY_CURRENT_BUFFER_LVALUE->yy_ch_buf, new_size);
+                                              YY_CURRENT_BUFFER_LVALUE->yy_ch_buf, new_size, yyscanner);
         if(! YY_CURRENT_BUFFER_LVALUE->yy_ch_buf)
             YY_FATAL_ERROR("out of dynamic memory in yy_get_next_buffer()");
     }
 
-    (yy_n_chars) += number_to_move;
-    YY_CURRENT_BUFFER_LVALUE->yy_ch_buf[(yy_n_chars)] = YY_END_OF_BUFFER_CHAR;
-    YY_CURRENT_BUFFER_LVALUE->yy_ch_buf[(yy_n_chars) + 1] = YY_END_OF_BUFFER_CHAR;
+    yyg->yy_n_chars += number_to_move;
+    YY_CURRENT_BUFFER_LVALUE->yy_ch_buf[yyg->yy_n_chars] = YY_END_OF_BUFFER_CHAR;
+    YY_CURRENT_BUFFER_LVALUE->yy_ch_buf[yyg->yy_n_chars + 1] = YY_END_OF_BUFFER_CHAR;
 
-    (yytext_ptr) = &YY_CURRENT_BUFFER_LVALUE->yy_ch_buf[0];
+    yyg->yytext_ptr = &YY_CURRENT_BUFFER_LVALUE->yy_ch_buf[0];
 
     return ret_val;
 }
 
 /* yy_get_previous_state - get the state just before the EOB char was reached */
 
-static yy_state_type yy_get_previous_state(void)
+static yy_state_type yy_get_previous_state(yyscan_t yyscanner)
 {
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
     yy_state_type yy_current_state;
     char *yy_cp;
 
-    yy_current_state = (yy_start);
+    yy_current_state = yyg->yy_start;
 
-    for(yy_cp = (yytext_ptr) + YY_MORE_ADJ; yy_cp < (yy_c_buf_p); ++yy_cp) {
+    for(yy_cp = yyg->yytext_ptr + YY_MORE_ADJ; yy_cp < yyg->yy_c_buf_p; ++yy_cp) {
         YY_CHAR yy_c = (*yy_cp ? yy_ec[YY_SC_TO_UI(*yy_cp)] : 1);
         if(yy_accept[yy_current_state]) {
-            (yy_last_accepting_state) = yy_current_state;
-            (yy_last_accepting_cpos) = yy_cp;
+            yyg->yy_last_accepting_state = yy_current_state;
+            yyg->yy_last_accepting_cpos = yy_cp;
         }
         while(yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state) {
             yy_current_state = (int) yy_def[yy_current_state];
@@ -1741,15 +1733,16 @@ static yy_state_type yy_get_previous_state(void)
  * synopsis
  *  next_state = yy_try_NUL_trans( current_state );
  */
-static yy_state_type yy_try_NUL_trans(yy_state_type yy_current_state)
+static yy_state_type yy_try_NUL_trans(yy_state_type yy_current_state, yyscan_t yyscanner)
 {
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
     int yy_is_jam;
-    char *yy_cp = (yy_c_buf_p);
+    char *yy_cp = yyg->yy_c_buf_p;
 
     YY_CHAR yy_c = 1;
     if(yy_accept[yy_current_state]) {
-        (yy_last_accepting_state) = yy_current_state;
-        (yy_last_accepting_cpos) = yy_cp;
+        yyg->yy_last_accepting_state = yy_current_state;
+        yyg->yy_last_accepting_cpos = yy_cp;
     }
     while(yy_chk[yy_base[yy_current_state] + yy_c] != yy_current_state) {
         yy_current_state = (int) yy_def[yy_current_state];
@@ -1764,31 +1757,32 @@ static yy_state_type yy_try_NUL_trans(yy_state_type yy_current_state)
 
 #ifndef YY_NO_INPUT
 #ifdef __cplusplus
-static int yyinput(void)
+static int yyinput(yyscan_t yyscanner)
 #else
-static int input(void)
+static int input(yyscan_t yyscanner)
 #endif
 
 {
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
     int c;
 
-    *(yy_c_buf_p) = (yy_hold_char);
+    *yyg->yy_c_buf_p = yyg->yy_hold_char;
 
-    if(*(yy_c_buf_p) == YY_END_OF_BUFFER_CHAR) {
+    if(*yyg->yy_c_buf_p == YY_END_OF_BUFFER_CHAR) {
         /* yy_c_buf_p now points to the character we want to return.
          * If this occurs *before* the EOB characters, then it's a
          * valid NUL; if not, then we've hit the end of the buffer.
          */
-        if((yy_c_buf_p) < &YY_CURRENT_BUFFER_LVALUE->yy_ch_buf[(yy_n_chars)])
+        if(yyg->yy_c_buf_p < &YY_CURRENT_BUFFER_LVALUE->yy_ch_buf[yyg->yy_n_chars])
             /* This was really a NUL. */
-            *(yy_c_buf_p) = '\0';
+            *yyg->yy_c_buf_p = '\0';
 
         else {
             /* need more input */
-            yy_size_t offset = (yy_c_buf_p) - (yytext_ptr);
-            ++(yy_c_buf_p);
+            yy_size_t offset = yyg->yy_c_buf_p - yyg->yytext_ptr;
+            ++yyg->yy_c_buf_p;
 
-            switch(yy_get_next_buffer()) {
+            switch(yy_get_next_buffer(yyscanner)) {
             case EOB_ACT_LAST_MATCH:
                 /* This happens because yy_g_n_b()
                  * sees that we've accumulated a
@@ -1801,33 +1795,33 @@ static int input(void)
                  */
 
                 /* Reset buffer status. */
-                dcrestart(dcin);
+                dcrestart(yyin, yyscanner);
 
             /*FALLTHROUGH*/
 
             case EOB_ACT_END_OF_FILE: {
-                if(dcwrap())
+                if(dcwrap(yyscanner))
                     return EOF;
 
-                if(!(yy_did_buffer_switch_on_eof))
+                if(!yyg->yy_did_buffer_switch_on_eof)
                     YY_NEW_FILE;
 #ifdef __cplusplus
-                return yyinput();
+                return yyinput(yyscanner);
 #else
-                return input();
+                return input(yyscanner);
 #endif
             }
 
             case EOB_ACT_CONTINUE_SCAN:
-                (yy_c_buf_p) = (yytext_ptr) + offset;
+                yyg->yy_c_buf_p = yyg->yytext_ptr + offset;
                 break;
             }
         }
     }
 
-    c = *(unsigned char *)(yy_c_buf_p);     /* cast for 8-bit char's */
-    *(yy_c_buf_p) = '\0';   /* preserve dctext */
-    (yy_hold_char) = *++(yy_c_buf_p);
+    c = *(unsigned char *)yyg->yy_c_buf_p;     /* cast for 8-bit char's */
+    *yyg->yy_c_buf_p = '\0';   /* preserve yytext */
+    yyg->yy_hold_char = *++yyg->yy_c_buf_p;
 
     return c;
 }
@@ -1838,59 +1832,62 @@ static int input(void)
  *
  * @note This function does not reset the start condition to @c INITIAL .
  */
-void dcrestart(FILE *input_file)
+void dcrestart(FILE *input_file, yyscan_t yyscanner)
 {
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
 
     if(! YY_CURRENT_BUFFER) {
-        dcensure_buffer_stack();
+        dcensure_buffer_stack(yyscanner);
         YY_CURRENT_BUFFER_LVALUE =
-            dc_create_buffer(dcin, YY_BUF_SIZE);
+            dc_create_buffer(yyin, YY_BUF_SIZE, yyscanner);
     }
 
-    dc_init_buffer(YY_CURRENT_BUFFER, input_file);
-    dc_load_buffer_state();
+    dc_init_buffer(YY_CURRENT_BUFFER, input_file, yyscanner);
+    dc_load_buffer_state(yyscanner);
 }
 
 /** Switch to a different input buffer.
  * @param new_buffer The new input buffer.
  *
  */
-void dc_switch_to_buffer(YY_BUFFER_STATE  new_buffer)
+void dc_switch_to_buffer(YY_BUFFER_STATE  new_buffer, yyscan_t yyscanner)
 {
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
 
     /* TODO. We should be able to replace this entire function body
      * with
      *      dcpop_buffer_state();
      *      dcpush_buffer_state(new_buffer);
      */
-    dcensure_buffer_stack();
+    dcensure_buffer_stack(yyscanner);
     if(YY_CURRENT_BUFFER == new_buffer)
         return;
 
     if(YY_CURRENT_BUFFER) {
         /* Flush out information for old buffer. */
-        *(yy_c_buf_p) = (yy_hold_char);
-        YY_CURRENT_BUFFER_LVALUE->yy_buf_pos = (yy_c_buf_p);
-        YY_CURRENT_BUFFER_LVALUE->yy_n_chars = (yy_n_chars);
+        *yyg->yy_c_buf_p = yyg->yy_hold_char;
+        YY_CURRENT_BUFFER_LVALUE->yy_buf_pos = yyg->yy_c_buf_p;
+        YY_CURRENT_BUFFER_LVALUE->yy_n_chars = yyg->yy_n_chars;
     }
 
     YY_CURRENT_BUFFER_LVALUE = new_buffer;
-    dc_load_buffer_state();
+    dc_load_buffer_state(yyscanner);
 
     /* We don't actually know whether we did this switch during
      * EOF (dcwrap()) processing, but the only time this flag
      * is looked at is after dcwrap() is called, so it's safe
      * to go ahead and always set it.
      */
-    (yy_did_buffer_switch_on_eof) = 1;
+    yyg->yy_did_buffer_switch_on_eof = 1;
 }
 
-static void dc_load_buffer_state(void)
+static void dc_load_buffer_state(yyscan_t yyscanner)
 {
-    (yy_n_chars) = YY_CURRENT_BUFFER_LVALUE->yy_n_chars;
-    (yytext_ptr) = (yy_c_buf_p) = YY_CURRENT_BUFFER_LVALUE->yy_buf_pos;
-    dcin = YY_CURRENT_BUFFER_LVALUE->yy_input_file;
-    (yy_hold_char) = *(yy_c_buf_p);
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
+    yyg->yy_n_chars = YY_CURRENT_BUFFER_LVALUE->yy_n_chars;
+    yyg->yytext_ptr = yyg->yy_c_buf_p = YY_CURRENT_BUFFER_LVALUE->yy_buf_pos;
+    yyin = YY_CURRENT_BUFFER_LVALUE->yy_input_file;
+    yyg->yy_hold_char = *yyg->yy_c_buf_p;
 }
 
 /** Allocate and initialize an input buffer state.
@@ -1899,11 +1896,11 @@ static void dc_load_buffer_state(void)
  *
  * @return the allocated buffer state.
  */
-YY_BUFFER_STATE dc_create_buffer(FILE *file, int  size)
+YY_BUFFER_STATE dc_create_buffer(FILE *file, int  size, yyscan_t yyscanner)
 {
     YY_BUFFER_STATE b;
 
-    b = (YY_BUFFER_STATE) dcalloc(sizeof(struct yy_buffer_state));
+    b = (YY_BUFFER_STATE) dcalloc(sizeof(struct yy_buffer_state), yyscanner);
     if(! b)
         YY_FATAL_ERROR("out of dynamic memory in dc_create_buffer()");
 
@@ -1912,13 +1909,13 @@ YY_BUFFER_STATE dc_create_buffer(FILE *file, int  size)
     /* yy_ch_buf has to be 2 characters longer than the size given because
      * we need to put in 2 end-of-buffer characters.
      */
-    b->yy_ch_buf = (char *) dcalloc(b->yy_buf_size + 2);
+    b->yy_ch_buf = (char *) dcalloc(b->yy_buf_size + 2, yyscanner);
     if(! b->yy_ch_buf)
         YY_FATAL_ERROR("out of dynamic memory in dc_create_buffer()");
 
     b->yy_is_our_buffer = 1;
 
-    dc_init_buffer(b, file);
+    dc_init_buffer(b, file, yyscanner);
 
     return b;
 }
@@ -1927,8 +1924,9 @@ YY_BUFFER_STATE dc_create_buffer(FILE *file, int  size)
  * @param b a buffer created with dc_create_buffer()
  *
  */
-void dc_delete_buffer(YY_BUFFER_STATE  b)
+void dc_delete_buffer(YY_BUFFER_STATE  b, yyscan_t yyscanner)
 {
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
 
     if(! b)
         return;
@@ -1937,21 +1935,22 @@ void dc_delete_buffer(YY_BUFFER_STATE  b)
         YY_CURRENT_BUFFER_LVALUE = (YY_BUFFER_STATE) 0;
 
     if(b->yy_is_our_buffer)
-        dcfree((void *) b->yy_ch_buf);
+        dcfree((void *) b->yy_ch_buf, yyscanner);
 
-    dcfree((void *) b);
+    dcfree((void *) b, yyscanner);
 }
 
 /* Initializes or reinitializes a buffer.
  * This function is sometimes called more than once on the same buffer,
  * such as during a dcrestart() or at EOF.
  */
-static void dc_init_buffer(YY_BUFFER_STATE  b, FILE *file)
+static void dc_init_buffer(YY_BUFFER_STATE  b, FILE *file, yyscan_t yyscanner)
 
 {
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
     int oerrno = errno;
 
-    dc_flush_buffer(b);
+    dc_flush_buffer(b, yyscanner);
 
     b->yy_input_file = file;
     b->yy_fill_buffer = 1;
@@ -1974,8 +1973,9 @@ static void dc_init_buffer(YY_BUFFER_STATE  b, FILE *file)
  * @param b the buffer state to be flushed, usually @c YY_CURRENT_BUFFER.
  *
  */
-void dc_flush_buffer(YY_BUFFER_STATE  b)
+void dc_flush_buffer(YY_BUFFER_STATE  b, yyscan_t yyscanner)
 {
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
     if(! b)
         return;
 
@@ -1994,7 +1994,7 @@ void dc_flush_buffer(YY_BUFFER_STATE  b)
     b->yy_buffer_status = YY_BUFFER_NEW;
 
     if(b == YY_CURRENT_BUFFER)
-        dc_load_buffer_state();
+        dc_load_buffer_state(yyscanner);
 }
 
 /** Pushes the new state onto the stack. The new state becomes
@@ -2003,94 +2003,95 @@ void dc_flush_buffer(YY_BUFFER_STATE  b)
  *  @param new_buffer The new state.
  *
  */
-void dcpush_buffer_state(YY_BUFFER_STATE new_buffer)
+void dcpush_buffer_state(YY_BUFFER_STATE new_buffer, yyscan_t yyscanner)
 {
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
     if(new_buffer == NULL)
         return;
 
-    dcensure_buffer_stack();
+    dcensure_buffer_stack(yyscanner);
 
     /* This block is copied from dc_switch_to_buffer. */
     if(YY_CURRENT_BUFFER) {
         /* Flush out information for old buffer. */
-        *(yy_c_buf_p) = (yy_hold_char);
-        YY_CURRENT_BUFFER_LVALUE->yy_buf_pos = (yy_c_buf_p);
-        YY_CURRENT_BUFFER_LVALUE->yy_n_chars = (yy_n_chars);
+        *yyg->yy_c_buf_p = yyg->yy_hold_char;
+        YY_CURRENT_BUFFER_LVALUE->yy_buf_pos = yyg->yy_c_buf_p;
+        YY_CURRENT_BUFFER_LVALUE->yy_n_chars = yyg->yy_n_chars;
     }
 
     /* Only push if top exists. Otherwise, replace top. */
     if(YY_CURRENT_BUFFER)
-        (yy_buffer_stack_top)++;
+        yyg->yy_buffer_stack_top++;
     YY_CURRENT_BUFFER_LVALUE = new_buffer;
 
     /* copied from dc_switch_to_buffer. */
-    dc_load_buffer_state();
-    (yy_did_buffer_switch_on_eof) = 1;
+    dc_load_buffer_state(yyscanner);
+    yyg->yy_did_buffer_switch_on_eof = 1;
 }
 
 /** Removes and deletes the top of the stack, if present.
  *  The next element becomes the new top.
  *
  */
-void dcpop_buffer_state(void)
+void dcpop_buffer_state(yyscan_t yyscanner)
 {
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
     if(!YY_CURRENT_BUFFER)
         return;
 
-    dc_delete_buffer(YY_CURRENT_BUFFER);
+    dc_delete_buffer(YY_CURRENT_BUFFER, yyscanner);
     YY_CURRENT_BUFFER_LVALUE = NULL;
-    if((yy_buffer_stack_top) > 0)
-        --(yy_buffer_stack_top);
+    if(yyg->yy_buffer_stack_top > 0)
+        --yyg->yy_buffer_stack_top;
 
     if(YY_CURRENT_BUFFER) {
-        dc_load_buffer_state();
-        (yy_did_buffer_switch_on_eof) = 1;
+        dc_load_buffer_state(yyscanner);
+        yyg->yy_did_buffer_switch_on_eof = 1;
     }
 }
 
 /* Allocates the stack if it does not exist.
  *  Guarantees space for at least one push.
  */
-static void dcensure_buffer_stack(void)
+static void dcensure_buffer_stack(yyscan_t yyscanner)
 {
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
     yy_size_t num_to_alloc;
 
-    if(!(yy_buffer_stack)) {
+    if(!yyg->yy_buffer_stack) {
 
         /* First allocation is just for 2 elements, since we don't know if this
          * scanner will even need a stack. We use 2 instead of 1 to avoid an
          * immediate realloc on the next call.
          */
         num_to_alloc = 1;
-        (yy_buffer_stack) = (struct yy_buffer_state **)dcalloc
-                            (num_to_alloc * sizeof(struct yy_buffer_state *)
-                            );
-        if(!(yy_buffer_stack))
+        yyg->yy_buffer_stack = (struct yy_buffer_state **)dcalloc
+                            (num_to_alloc * sizeof(struct yy_buffer_state *), yyscanner);
+        if(!yyg->yy_buffer_stack)
             YY_FATAL_ERROR("out of dynamic memory in dcensure_buffer_stack()");
 
-        memset((yy_buffer_stack), 0, num_to_alloc * sizeof(struct yy_buffer_state *));
+        memset(yyg->yy_buffer_stack, 0, num_to_alloc * sizeof(struct yy_buffer_state *));
 
-        (yy_buffer_stack_max) = num_to_alloc;
-        (yy_buffer_stack_top) = 0;
+        yyg->yy_buffer_stack_max = num_to_alloc;
+        yyg->yy_buffer_stack_top = 0;
         return;
     }
 
-    if((yy_buffer_stack_top) >= ((yy_buffer_stack_max)) - 1) {
+    if(yyg->yy_buffer_stack_top >= (yyg->yy_buffer_stack_max) - 1) {
 
         /* Increase the buffer to prepare for a possible push. */
         int grow_size = 8 /* arbitrary grow size */;
 
-        num_to_alloc = (yy_buffer_stack_max) + grow_size;
-        (yy_buffer_stack) = (struct yy_buffer_state **)dcrealloc
-                            ((yy_buffer_stack),
-                             num_to_alloc * sizeof(struct yy_buffer_state *)
-                            );
-        if(!(yy_buffer_stack))
+        num_to_alloc = yyg->yy_buffer_stack_max + grow_size;
+        yyg->yy_buffer_stack = (struct yy_buffer_state **)dcrealloc
+                            (yyg->yy_buffer_stack,
+                             num_to_alloc * sizeof(struct yy_buffer_state *), yyscanner);
+        if(!yyg->yy_buffer_stack)
             YY_FATAL_ERROR("out of dynamic memory in dcensure_buffer_stack()");
 
         /* zero only the new slots.*/
-        memset((yy_buffer_stack) + (yy_buffer_stack_max), 0, grow_size * sizeof(struct yy_buffer_state *));
-        (yy_buffer_stack_max) = num_to_alloc;
+        memset(yyg->yy_buffer_stack + yyg->yy_buffer_stack_max, 0, grow_size * sizeof(struct yy_buffer_state *));
+        yyg->yy_buffer_stack_max = num_to_alloc;
     }
 }
 
@@ -2100,7 +2101,7 @@ static void dcensure_buffer_stack(void)
  *
  * @return the newly allocated buffer state object.
  */
-YY_BUFFER_STATE dc_scan_buffer(char *base, yy_size_t  size)
+YY_BUFFER_STATE dc_scan_buffer(char *base, yy_size_t  size, yyscan_t yyscanner)
 {
     YY_BUFFER_STATE b;
 
@@ -2110,7 +2111,7 @@ YY_BUFFER_STATE dc_scan_buffer(char *base, yy_size_t  size)
         /* They forgot to leave room for the EOB's. */
         return 0;
 
-    b = (YY_BUFFER_STATE) dcalloc(sizeof(struct yy_buffer_state));
+    b = (YY_BUFFER_STATE) dcalloc(sizeof(struct yy_buffer_state), yyscanner);
     if(! b)
         YY_FATAL_ERROR("out of dynamic memory in dc_scan_buffer()");
 
@@ -2124,7 +2125,7 @@ YY_BUFFER_STATE dc_scan_buffer(char *base, yy_size_t  size)
     b->yy_fill_buffer = 0;
     b->yy_buffer_status = YY_BUFFER_NEW;
 
-    dc_switch_to_buffer(b);
+    dc_switch_to_buffer(b, yyscanner);
 
     return b;
 }
@@ -2137,10 +2138,10 @@ YY_BUFFER_STATE dc_scan_buffer(char *base, yy_size_t  size)
  * @note If you want to scan bytes that may contain NUL values, then use
  *       dc_scan_bytes() instead.
  */
-YY_BUFFER_STATE dc_scan_string(yyconst char *yystr)
+YY_BUFFER_STATE dc_scan_string(yyconst char *yystr, yyscan_t yyscanner)
 {
 
-    return dc_scan_bytes(yystr, strlen(yystr));
+    return dc_scan_bytes(yystr, strlen(yystr), yyscanner);
 }
 
 /** Setup the input buffer state to scan the given bytes. The next call to dclex() will
@@ -2150,7 +2151,7 @@ YY_BUFFER_STATE dc_scan_string(yyconst char *yystr)
  *
  * @return the newly allocated buffer state object.
  */
-YY_BUFFER_STATE dc_scan_bytes(yyconst char *yybytes, yy_size_t  _yybytes_len)
+YY_BUFFER_STATE dc_scan_bytes(yyconst char *yybytes, yy_size_t  _yybytes_len, yyscan_t yyscanner)
 {
     YY_BUFFER_STATE b;
     char *buf;
@@ -2159,7 +2160,7 @@ YY_BUFFER_STATE dc_scan_bytes(yyconst char *yybytes, yy_size_t  _yybytes_len)
 
     /* Get memory for full buffer, including space for trailing EOB's. */
     n = _yybytes_len + 2;
-    buf = (char *) dcalloc(n);
+    buf = (char *) dcalloc(n, yyscanner);
     if(! buf)
         YY_FATAL_ERROR("out of dynamic memory in dc_scan_bytes()");
 
@@ -2168,7 +2169,7 @@ YY_BUFFER_STATE dc_scan_bytes(yyconst char *yybytes, yy_size_t  _yybytes_len)
 
     buf[_yybytes_len] = buf[_yybytes_len + 1] = YY_END_OF_BUFFER_CHAR;
 
-    b = dc_scan_buffer(buf, n);
+    b = dc_scan_buffer(buf, n, yyscanner);
     if(! b)
         YY_FATAL_ERROR("bad buffer in dc_scan_bytes()");
 
@@ -2184,8 +2185,10 @@ YY_BUFFER_STATE dc_scan_bytes(yyconst char *yybytes, yy_size_t  _yybytes_len)
 #define YY_EXIT_FAILURE 2
 #endif
 
-static void yy_fatal_error(yyconst char *msg)
+static void yy_fatal_error(yyconst char *msg, yyscan_t yyscanner)
 {
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
+    (void)yyg;
     (void) fprintf(stderr, "%s\n", msg);
     exit(YY_EXIT_FAILURE);
 }
@@ -2196,117 +2199,264 @@ static void yy_fatal_error(yyconst char *msg)
 #define yyless(n) \
     do \
         { \
-        /* Undo effects of setting up dctext. */ \
+        /* Undo effects of setting up yytext. */ \
         int yyless_macro_arg = (n); \
         YY_LESS_LINENO(yyless_macro_arg);\
-        dctext[dcleng] = (yy_hold_char); \
-        (yy_c_buf_p) = dctext + yyless_macro_arg; \
-        (yy_hold_char) = *(yy_c_buf_p); \
-        *(yy_c_buf_p) = '\0'; \
-        dcleng = yyless_macro_arg; \
+        yytext[yyleng] = yyg->yy_hold_char; \
+        yyg->yy_c_buf_p = yytext + yyless_macro_arg; \
+        yyg->yy_hold_char = *yyg->yy_c_buf_p; \
+        *yyg->yy_c_buf_p = '\0'; \
+        yyleng = yyless_macro_arg; \
         } \
     while ( 0 )
 
 /* Accessor  methods (get/set functions) to struct members. */
 
+/** Get the user-defined data for this scanner.
+ * @param yyscanner The scanner object.
+ */
+YY_EXTRA_TYPE dcget_extra(yyscan_t yyscanner)
+{
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
+    return yyextra;
+}
+
 /** Get the current line number.
- *
+ * @param yyscanner The scanner object.
  */
-int dcget_lineno(void)
+int dcget_lineno(yyscan_t yyscanner)
 {
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
+
+    if(! YY_CURRENT_BUFFER)
+        return 0;
 
-    return dclineno;
+    return yylineno;
+}
+
+/** Get the current column number.
+ * @param yyscanner The scanner object.
+ */
+int dcget_column(yyscan_t yyscanner)
+{
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
+
+    if(! YY_CURRENT_BUFFER)
+        return 0;
+
+    return yycolumn;
 }
 
 /** Get the input stream.
- *
+ * @param yyscanner The scanner object.
  */
-FILE *dcget_in(void)
+FILE *dcget_in(yyscan_t yyscanner)
 {
-    return dcin;
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
+    return yyin;
 }
 
 /** Get the output stream.
- *
+ * @param yyscanner The scanner object.
  */
-FILE *dcget_out(void)
+FILE *dcget_out(yyscan_t yyscanner)
 {
-    return dcout;
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
+    return yyout;
 }
 
 /** Get the length of the current token.
- *
+ * @param yyscanner The scanner object.
  */
-yy_size_t dcget_leng(void)
+yy_size_t dcget_leng(yyscan_t yyscanner)
 {
-    return dcleng;
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
+    return yyleng;
 }
 
 /** Get the current token.
- *
+ * @param yyscanner The scanner object.
  */
 
-char *dcget_text(void)
+char *dcget_text(yyscan_t yyscanner)
 {
-    return dctext;
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
+    return yytext;
+}
+
+/** Set the user-defined data. This data is never touched by the scanner.
+ * @param user_defined The data to be associated with this scanner.
+ * @param yyscanner The scanner object.
+ */
+void dcset_extra(YY_EXTRA_TYPE user_defined, yyscan_t yyscanner)
+{
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
+    yyextra = user_defined ;
 }
 
 /** Set the current line number.
  * @param line_number line number
- *
+ * @param yyscanner The scanner object.
  */
-void dcset_lineno(int  line_number)
+void dcset_lineno(int  line_number, yyscan_t yyscanner)
 {
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
+
+    /* lineno is only valid if an input buffer exists. */
+    if(! YY_CURRENT_BUFFER)
+        YY_FATAL_ERROR("dcset_lineno called with no buffer");
 
-    dclineno = line_number;
+    yylineno = line_number;
+}
+
+/** Set the current column.
+ * @param column_no column number
+ * @param yyscanner The scanner object.
+ */
+void dcset_column(int  column_no, yyscan_t yyscanner)
+{
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
+
+    /* column is only valid if an input buffer exists. */
+    if(! YY_CURRENT_BUFFER)
+        YY_FATAL_ERROR("dcset_column called with no buffer");
+
+    yycolumn = column_no;
 }
 
 /** Set the input stream. This does not discard the current
  * input buffer.
  * @param in_str A readable stream.
- *
+ * @param yyscanner The scanner object.
  * @see dc_switch_to_buffer
  */
-void dcset_in(FILE   *in_str)
+void dcset_in(FILE   *in_str, yyscan_t yyscanner)
+{
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
+    yyin = in_str ;
+}
+
+void dcset_out(FILE   *out_str, yyscan_t yyscanner)
 {
-    dcin = in_str ;
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
+    yyout = out_str ;
 }
 
-void dcset_out(FILE   *out_str)
+int dcget_debug(yyscan_t yyscanner)
 {
-    dcout = out_str ;
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
+    return yy_flex_debug;
 }
 
-int dcget_debug(void)
+void dcset_debug(int  bdebug, yyscan_t yyscanner)
 {
-    return dc_flex_debug;
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
+    yy_flex_debug = bdebug ;
 }
 
-void dcset_debug(int  bdebug)
+/* Accessor methods for yylval and yylloc */
+
+YYSTYPE *dcget_lval(yyscan_t yyscanner)
 {
-    dc_flex_debug = bdebug ;
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
+    return yylval;
 }
 
-static int yy_init_globals(void)
+void dcset_lval(YYSTYPE *yylval_param, yyscan_t yyscanner)
 {
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
+    yylval = yylval_param;
+}
+
+/* User-visible API */
+
+/* dclex_init is special because it creates the scanner itself, so it is
+ * the ONLY reentrant function that doesn't take the scanner as the last argument.
+ * That's why we explicitly handle the declaration, instead of using our macros.
+ */
+
+int dclex_init(yyscan_t *ptr_yy_globals)
+
+{
+    if(ptr_yy_globals == NULL) {
+        errno = EINVAL;
+        return 1;
+    }
+
+    *ptr_yy_globals = (yyscan_t) dcalloc(sizeof(struct yyguts_t), NULL);
+
+    if(*ptr_yy_globals == NULL) {
+        errno = ENOMEM;
+        return 1;
+    }
+
+    /* By setting to 0xAA, we expose bugs in yy_init_globals. Leave at 0x00 for releases. */
+    memset(*ptr_yy_globals, 0x00, sizeof(struct yyguts_t));
+
+    return yy_init_globals(*ptr_yy_globals);
+}
+
+/* dclex_init_extra has the same functionality as dclex_init, but follows the
+ * convention of taking the scanner as the last argument. Note however, that
+ * this is a *pointer* to a scanner, as it will be allocated by this call (and
+ * is the reason, too, why this function also must handle its own declaration).
+ * The user defined value in the first argument will be available to dcalloc in
+ * the yyextra field.
+ */
+
+int dclex_init_extra(YY_EXTRA_TYPE yy_user_defined, yyscan_t *ptr_yy_globals)
+
+{
+    struct yyguts_t dummy_yyguts;
+
+    dcset_extra(yy_user_defined, &dummy_yyguts);
+
+    if(ptr_yy_globals == NULL) {
+        errno = EINVAL;
+        return 1;
+    }
+
+    *ptr_yy_globals = (yyscan_t) dcalloc(sizeof(struct yyguts_t), &dummy_yyguts);
+
+    if(*ptr_yy_globals == NULL) {
+        errno = ENOMEM;
+        return 1;
+    }
+
+    /* By setting to 0xAA, we expose bugs in
+    yy_init_globals. Leave at 0x00 for releases. */
+    memset(*ptr_yy_globals, 0x00, sizeof(struct yyguts_t));
+
+    dcset_extra(yy_user_defined, *ptr_yy_globals);
+
+    return yy_init_globals(*ptr_yy_globals);
+}
+
+static int yy_init_globals(yyscan_t yyscanner)
+{
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
     /* Initialization is the same as for the non-reentrant scanner.
-    * This function is called from dclex_destroy(), so don't allocate here.
-    */
+     * This function is called from dclex_destroy(), so don't allocate here.
+     */
+
+    yyg->yy_buffer_stack = 0;
+    yyg->yy_buffer_stack_top = 0;
+    yyg->yy_buffer_stack_max = 0;
+    yyg->yy_c_buf_p = (char *) 0;
+    yyg->yy_init = 0;
+    yyg->yy_start = 0;
 
-    (yy_buffer_stack) = 0;
-    (yy_buffer_stack_top) = 0;
-    (yy_buffer_stack_max) = 0;
-    (yy_c_buf_p) = (char *) 0;
-    (yy_init) = 0;
-    (yy_start) = 0;
+    yyg->yy_start_stack_ptr = 0;
+    yyg->yy_start_stack_depth = 0;
+    yyg->yy_start_stack =  NULL;
 
     /* Defined in main.c */
 #ifdef YY_STDINIT
-    dcin = stdin;
-    dcout = stdout;
+    yyin = stdin;
+    yyout = stdout;
 #else
-    dcin = (FILE *) 0;
-    dcout = (FILE *) 0;
+    yyin = (FILE *) 0;
+    yyout = (FILE *) 0;
 #endif
 
     /* For future reference: Set errno on error, since we are called by
@@ -2316,24 +2466,32 @@ static int yy_init_globals(void)
 }
 
 /* dclex_destroy is for both reentrant and non-reentrant scanners. */
-int dclex_destroy(void)
+int dclex_destroy(yyscan_t yyscanner)
 {
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
 
     /* Pop the buffer stack, destroying each element. */
     while(YY_CURRENT_BUFFER) {
-        dc_delete_buffer(YY_CURRENT_BUFFER);
+        dc_delete_buffer(YY_CURRENT_BUFFER, yyscanner);
         YY_CURRENT_BUFFER_LVALUE = NULL;
-        dcpop_buffer_state();
+        dcpop_buffer_state(yyscanner);
     }
 
     /* Destroy the stack itself. */
-    dcfree((yy_buffer_stack));
-    (yy_buffer_stack) = NULL;
+    dcfree(yyg->yy_buffer_stack, yyscanner);
+    yyg->yy_buffer_stack = NULL;
+
+    /* Destroy the start condition stack. */
+    dcfree(yyg->yy_start_stack, yyscanner);
+    yyg->yy_start_stack = NULL;
 
     /* Reset the globals. This is important in a non-reentrant scanner so the next time
      * dclex() is called, initialization will occur. */
-    yy_init_globals();
+    yy_init_globals(yyscanner);
 
+    /* Destroy the main struct (reentrant only). */
+    dcfree(yyscanner, yyscanner);
+    yyscanner = NULL;
     return 0;
 }
 
@@ -2342,8 +2500,11 @@ int dclex_destroy(void)
  */
 
 #ifndef yytext_ptr
-static void yy_flex_strncpy(char *s1, yyconst char *s2, int n)
+static void yy_flex_strncpy(char *s1, yyconst char *s2, int n, yyscan_t yyscanner)
 {
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
+    (void)yyg;
+
     int i;
     for(i = 0; i < n; ++i)
         s1[i] = s2[i];
@@ -2351,7 +2512,7 @@ static void yy_flex_strncpy(char *s1, yyconst char *s2, int n)
 #endif
 
 #ifdef YY_NEED_STRLEN
-static int yy_flex_strlen(yyconst char *s)
+static int yy_flex_strlen(yyconst char *s, yyscan_t yyscanner)
 {
     int n;
     for(n = 0; s[n]; ++n)
@@ -2361,13 +2522,18 @@ static int yy_flex_strlen(yyconst char *s)
 }
 #endif
 
-void *dcalloc(yy_size_t  size)
+void *dcalloc(yy_size_t  size, yyscan_t yyscanner)
 {
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
+    (void)yyg;
     return (void *) malloc(size);
 }
 
-void *dcrealloc(void *ptr, yy_size_t  size)
+void *dcrealloc(void *ptr, yy_size_t  size, yyscan_t yyscanner)
 {
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
+    (void)yyg;
+
     /* The cast to (char *) in the following accommodates both
      * implementations that use char* generic pointers, and those
      * that use void* generic pointers.  It works with the latter
@@ -2378,10 +2544,31 @@ void *dcrealloc(void *ptr, yy_size_t  size)
     return (void *) realloc((char *) ptr, size);
 }
 
-void dcfree(void *ptr)
+void dcfree(void *ptr, yyscan_t yyscanner)
 {
+    struct yyguts_t *yyg = (struct yyguts_t *)yyscanner;
+    (void)yyg;
     free((char *) ptr);      /* see dcrealloc() for (char *) cast */
 }
 
 #define YYTABLES_NAME "yytables"
 
+////////////////////////////////////////////////////////////////////
+// Defining the interface to the lexer.
+////////////////////////////////////////////////////////////////////
+
+void *bamboo::dclexer_init(LexerState *state)
+{
+    yyscan_t scanner;
+    if(dclex_init_extra(state, &scanner) != 0) {
+        throw std::bad_alloc();
+    }
+    return scanner;
+}
+
+void bamboo::dclexer_destroy(void *scanner)
+{
+    if(scanner != nullptr) {
+        dclex_destroy(scanner);
+    }
+}
@@ -20,6 +20,8 @@ Module *read_dcfile(const std::string& filename);
 // parse_dcfile opens the given file or stream and parses it as a .dc file.  The distributed
 //     classes defined in the file are added to the list of classes associated with the Module.
 //     When appending from a stream, a filename is optional only used to report errors.
+//     Each call has its own lexer and parser state, so files can be parsed by several threads
+//     at once as long as no two threads add to the same Module.
 bool parse_dcfile(Module *f, std::istream& in, const std::string& filename);
 bool parse_dcfile(Module *f, const std::string& filename);
 
@@ -27,6 +29,7 @@ bool parse_dcfile(Module *f, const std::string& filename);
 // parse_dcvalue reads a .dc-formatted parameter value and outputs the data in packed form
 //     matching the appropriate Type and suitable for a default parameter value.
 //     If an error occurs, the error reason is returned instead of the parsed value.
+//     Values may be parsed by several threads at once.
 std::vector<uint8_t> parse_dcvalue(const Type *, const std::string& formatted,
                                    bool& err);
 std::vector<uint8_t> parse_dcvalue(const Type *, std::istream& in, bool& err);
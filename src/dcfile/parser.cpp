@@ -1,8 +1,9 @@
-/* A Bison parser, made by GNU Bison 3.0.2.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison implementation for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989-1990, 2000-2013 Free Software Foundation, Inc.
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
    This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
@@ -15,7 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -33,6 +34,10 @@
 /* C LALR(1) parser skeleton written by Richard Stallman, by
    simplifying the original so-called "semantic" parser.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 /* All symbols defined below should begin with yy or YY, to avoid
    infringing on user name space.  This should be done even for local
    variables, as they might otherwise be expanded by user macros.
@@ -40,17 +45,17 @@
    define necessary library symbols; they are noted "INFRINGES ON
    USER NAME SPACE" below.  */
 
-/* Identify Bison output.  */
-#define YYBISON 1
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
 
-/* Bison version.  */
-#define YYBISON_VERSION "3.0.2"
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
 
 /* Skeleton name.  */
 #define YYSKELETON_NAME "yacc.c"
 
 /* Pure parsers.  */
-#define YYPURE 0
+#define YYPURE 2
 
 /* Push parsers.  */
 #define YYPUSH 0
@@ -67,141 +72,269 @@
 #define yydebug         dcdebug
 #define yynerrs         dcnerrs
 
-#define yylval          dclval
-#define yychar          dcchar
-
-/* Copy the first part of user declarations.  */
-
-
-#include "lex.h"
-#include "parse.h"
-
-#include <cstdint>  // for fixed-width integers
-#include <cmath>    // std::isinf
-#include <stack>    // std::stack
-#include <fstream>  // std::ifstream
-#include <sstream>  // std::stringstream
-
-#include "../dcfile/token.h"
-#include "../dcfile/parser-defs.h"
-#include "../dcfile/write.h"           // format_type(Subtype);
-#include "../module/Module.h"
-#include "../module/Type.h"
-#include "../module/NumericRange.h"
-#include "../module/Numeric.h"
-#include "../module/Array.h"
-#include "../module/Struct.h"
-#include "../module/Class.h"
-#include "../module/Field.h"
-#include "../module/Method.h"
-#include "../module/Parameter.h"
-#include "../module/MolecularField.h"
-#include "../bits/buffers.h"
-
-//#define yylex dclex
-//#define yyparse dcparse
-//#define yyerror dcerror
-//#define yywarning dcwarning
-//#define yychar dcyychar
-//#define yydebug dcyydebug
-//#define yynerrs dcyynerrs
-
-// Because our token type contains objects of type string, which
-// require correct copy construction (and not simply memcpying), we
-// cannot use bison's built-in autTo-stack-grow feature.  As an easy
-// solution, we ensure here that we have enough yacc stack to start
-// with, and that it doesn't ever try to grow.
-#define YYINITDEPTH 1000
-#define YYMAXDEPTH 1000
-
-using namespace std;
-using namespace bamboo;
-namespace bamboo   // open namespace bamboo
-{
-
-
-// Parser output
-static Module *parsed_module = nullptr;
-static vector<uint8_t> *parsed_value = nullptr;
-
-// Parser state
-static Class *current_class = nullptr;
-static Struct *current_struct = nullptr;
-
-// Stack of distributed types for parsing values
-struct TypeAndDepth {
-    int depth;
-    const Type *type;
-    TypeAndDepth(const Type *t, int d) : depth(d), type(t) {}
-};
-static stack<TypeAndDepth> type_stack;
-static int current_depth;
-
-// These two types are really common types the parser doesn't need to make new
-//     duplicates of every time a string or blob is used.
-static Array *default_string = nullptr;
-static Array *default_blob = nullptr;
-
-/* Helper functions */
-static bool check_depth();
-static void depth_error(string what);
-static void depth_error(int depth, string what);
-static vector<uint8_t> number_value(Subtype type, double& number);
-static vector<uint8_t> number_value(Subtype type, int64_t& number);
-static vector<uint8_t> number_value(Subtype type, uint64_t& number);
+/* First part of user prologue.  */
+
+    #include "lex.h"
+    #include "parse.h"
+
+    #include <cstdint>  // for fixed-width integers
+    #include <cmath>    // std::isinf
+    #include <stack>    // std::stack
+    #include <fstream>  // std::ifstream
+    #include <sstream>  // std::stringstream
+
+    #include "../dcfile/token.h"
+    #include "../dcfile/parser-defs.h"
+    #include "../dcfile/write.h"           // format_type(Subtype);
+    #include "../module/Module.h"
+    #include "../module/Type.h"
+    #include "../module/NumericRange.h"
+    #include "../module/Numeric.h"
+    #include "../module/Array.h"
+    #include "../module/Struct.h"
+    #include "../module/Class.h"
+    #include "../module/Field.h"
+    #include "../module/Method.h"
+    #include "../module/Parameter.h"
+    #include "../module/MolecularField.h"
+    #include "../bits/buffers.h"
+
+    // Because our token type contains objects of type string, which
+    // require correct copy construction (and not simply memcpying), we
+    // cannot use bison's built-in autTo-stack-grow feature.  As an easy
+    // solution, we ensure here that we have enough yacc stack to start
+    // with, and that it doesn't ever try to grow.
+    #define YYINITDEPTH 1000
+    #define YYMAXDEPTH 1000
+
+    using namespace std;
+    using namespace bamboo;
+    namespace bamboo   // open namespace bamboo
+    {
+
+
+    // Stack of distributed types for parsing values
+    struct TypeAndDepth
+    {
+        int depth;
+        const Type* type;
+        TypeAndDepth(const Type* t, int d) : depth(d), type(t) {}
+    };
+
+    // ParserState holds everything the parser keeps between rules.  Each call to
+    //     parse_dcfile or parse_dcvalue has its own state, so they can run concurrently.
+    struct ParserState
+    {
+        // Parser input and output
+        const LexerState* lexer = nullptr;
+        Module* module = nullptr;
+        vector<uint8_t>* value = nullptr;
+
+        // Current declarations
+        Class* current_class = nullptr;
+        Struct* current_struct = nullptr;
+
+        // Types of the values being parsed
+        stack<TypeAndDepth> type_stack;
+        int current_depth = 0;
+
+        // Element types shared by every string and blob, created on first use
+        Type* char_type = nullptr;
+        Type* byte_type = nullptr;
+    };
+
+    /* Helper functions */
+    static void dcerror(void* scanner, ParserState*, const char* msg);
+    static bool check_depth(ParserState* state);
+    static bool has_errors(ParserState* state);
+    static Type* shared_type(ParserState* state, Type* type);
+    static Type* builtin_element(ParserState* state, Subtype subtype);
+    static void depth_error(void* scanner, ParserState* state, string what);
+    static void depth_error(void* scanner, ParserState* state, int depth, string what);
+    static vector<uint8_t> number_value(void* scanner, Subtype type, double &number);
+    static vector<uint8_t> number_value(void* scanner, Subtype type, int64_t &number);
+    static vector<uint8_t> number_value(void* scanner, Subtype type, uint64_t &number);
 
 ////////////////////////////////////////////////////////////////////
 // Defining the interface to the parser.
 ////////////////////////////////////////////////////////////////////
 
-static void dcparser_init_file(istream& in, const string& filename, Module& module)
-{
-    dclexer_init(in, filename, START_DC_FILE);
-    parsed_module = &module;
-}
-
-static void dcparser_init_value(istream& in, const string& source,
-                                const Type *type, vector<uint8_t>& output)
-{
-    parsed_value = &output;
-    current_depth = 0;
-    type_stack.push(TypeAndDepth(type, 0));
-    dclexer_init(in, source, START_DC_VALUE);
-}
+    // ScannerGuard owns a lexer for the duration of one parse.
+    class ScannerGuard
+    {
+      public:
+        ScannerGuard(LexerState* lexer) : scanner(dclexer_init(lexer)) {}
+        ScannerGuard(const ScannerGuard&) = delete;
+        ScannerGuard& operator=(const ScannerGuard&) = delete;
+        ~ScannerGuard() { dclexer_destroy(scanner); }
 
-static void dcparser_cleanup()
-{
-    current_depth = 0;
-    type_stack = stack<TypeAndDepth>();
-    parsed_module = nullptr;
-    parsed_value = nullptr;
-}
+        void* scanner;
+    };
 
+    // dcerror reports a syntax error found by the bison parser.
+    void dcerror(void* scanner, ParserState*, const char* msg)
+    {
+        dcerror(scanner, string(msg));
+    }
 
-} // close namespace bamboo
 
+    } // close namespace bamboo
 
 
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
 # ifndef YY_NULLPTR
-#  if defined __cplusplus && 201103L <= __cplusplus
-#   define YY_NULLPTR nullptr
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
 #  else
-#   define YY_NULLPTR 0
+#   define YY_NULLPTR ((void*)0)
 #  endif
 # endif
 
-/* Enabling verbose error messages.  */
-#ifdef YYERROR_VERBOSE
-# undef YYERROR_VERBOSE
-# define YYERROR_VERBOSE 1
-#else
-# define YYERROR_VERBOSE 1
-#endif
-
-/* Include the parser definitions */
 #include "parser-defs.h"
+/* Symbol kind.  */
+enum yysymbol_kind_t
+{
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_UNSIGNED_INTEGER = 3,           /* UNSIGNED_INTEGER  */
+  YYSYMBOL_REAL = 4,                       /* REAL  */
+  YYSYMBOL_STRING = 5,                     /* STRING  */
+  YYSYMBOL_HEX_STRING = 6,                 /* HEX_STRING  */
+  YYSYMBOL_IDENTIFIER = 7,                 /* IDENTIFIER  */
+  YYSYMBOL_CHAR = 8,                       /* CHAR  */
+  YYSYMBOL_START_DC_FILE = 9,              /* START_DC_FILE  */
+  YYSYMBOL_START_DC_VALUE = 10,            /* START_DC_VALUE  */
+  YYSYMBOL_KW_DCLASS = 11,                 /* KW_DCLASS  */
+  YYSYMBOL_KW_STRUCT = 12,                 /* KW_STRUCT  */
+  YYSYMBOL_KW_FROM = 13,                   /* KW_FROM  */
+  YYSYMBOL_KW_IMPORT = 14,                 /* KW_IMPORT  */
+  YYSYMBOL_KW_TYPEDEF = 15,                /* KW_TYPEDEF  */
+  YYSYMBOL_KW_KEYWORD = 16,                /* KW_KEYWORD  */
+  YYSYMBOL_KW_INT8 = 17,                   /* KW_INT8  */
+  YYSYMBOL_KW_INT16 = 18,                  /* KW_INT16  */
+  YYSYMBOL_KW_INT32 = 19,                  /* KW_INT32  */
+  YYSYMBOL_KW_INT64 = 20,                  /* KW_INT64  */
+  YYSYMBOL_KW_UINT8 = 21,                  /* KW_UINT8  */
+  YYSYMBOL_KW_UINT16 = 22,                 /* KW_UINT16  */
+  YYSYMBOL_KW_UINT32 = 23,                 /* KW_UINT32  */
+  YYSYMBOL_KW_UINT64 = 24,                 /* KW_UINT64  */
+  YYSYMBOL_KW_FLOAT32 = 25,                /* KW_FLOAT32  */
+  YYSYMBOL_KW_FLOAT64 = 26,                /* KW_FLOAT64  */
+  YYSYMBOL_KW_STRING = 27,                 /* KW_STRING  */
+  YYSYMBOL_KW_BLOB = 28,                   /* KW_BLOB  */
+  YYSYMBOL_KW_CHAR = 29,                   /* KW_CHAR  */
+  YYSYMBOL_30_ = 30,                       /* ';'  */
+  YYSYMBOL_31_ = 31,                       /* '.'  */
+  YYSYMBOL_32_ = 32,                       /* '*'  */
+  YYSYMBOL_33_ = 33,                       /* ','  */
+  YYSYMBOL_34_ = 34,                       /* '/'  */
+  YYSYMBOL_35_ = 35,                       /* '['  */
+  YYSYMBOL_36_ = 36,                       /* ']'  */
+  YYSYMBOL_37_ = 37,                       /* '{'  */
+  YYSYMBOL_38_ = 38,                       /* '}'  */
+  YYSYMBOL_39_ = 39,                       /* ':'  */
+  YYSYMBOL_40_ = 40,                       /* '='  */
+  YYSYMBOL_41_ = 41,                       /* '('  */
+  YYSYMBOL_42_ = 42,                       /* ')'  */
+  YYSYMBOL_43_ = 43,                       /* '%'  */
+  YYSYMBOL_44_ = 44,                       /* '-'  */
+  YYSYMBOL_45_ = 45,                       /* '+'  */
+  YYSYMBOL_YYACCEPT = 46,                  /* $accept  */
+  YYSYMBOL_grammar = 47,                   /* grammar  */
+  YYSYMBOL_file = 48,                      /* file  */
+  YYSYMBOL_value = 49,                     /* value  */
+  YYSYMBOL_import = 50,                    /* import  */
+  YYSYMBOL_import_module = 51,             /* import_module  */
+  YYSYMBOL_import_symbols = 52,            /* import_symbols  */
+  YYSYMBOL_import_symbol_list = 53,        /* import_symbol_list  */
+  YYSYMBOL_import_alternatives = 54,       /* import_alternatives  */
+  YYSYMBOL_typedef = 55,                   /* typedef  */
+  YYSYMBOL_typedef_type = 56,              /* typedef_type  */
+  YYSYMBOL_nonmethod_type_with_name = 57,  /* nonmethod_type_with_name  */
+  YYSYMBOL_defined_type = 58,              /* defined_type  */
+  YYSYMBOL_keyword_decl = 59,              /* keyword_decl  */
+  YYSYMBOL_keyword_decl_list = 60,         /* keyword_decl_list  */
+  YYSYMBOL_dclass = 61,                    /* dclass  */
+  YYSYMBOL_62_1 = 62,                      /* $@1  */
+  YYSYMBOL_class_inheritance = 63,         /* class_inheritance  */
+  YYSYMBOL_class_parents = 64,             /* class_parents  */
+  YYSYMBOL_defined_class = 65,             /* defined_class  */
+  YYSYMBOL_class_fields = 66,              /* class_fields  */
+  YYSYMBOL_class_field = 67,               /* class_field  */
+  YYSYMBOL_dstruct = 68,                   /* dstruct  */
+  YYSYMBOL_69_2 = 69,                      /* $@2  */
+  YYSYMBOL_struct_fields = 70,             /* struct_fields  */
+  YYSYMBOL_struct_field = 71,              /* struct_field  */
+  YYSYMBOL_named_field = 72,               /* named_field  */
+  YYSYMBOL_unnamed_field = 73,             /* unnamed_field  */
+  YYSYMBOL_74_3 = 74,                      /* $@3  */
+  YYSYMBOL_field_with_name = 75,           /* field_with_name  */
+  YYSYMBOL_field_with_name_as_array = 76,  /* field_with_name_as_array  */
+  YYSYMBOL_field_with_name_and_default = 77, /* field_with_name_and_default  */
+  YYSYMBOL_78_4 = 78,                      /* $@4  */
+  YYSYMBOL_79_5 = 79,                      /* $@5  */
+  YYSYMBOL_80_6 = 80,                      /* $@6  */
+  YYSYMBOL_method_as_field = 81,           /* method_as_field  */
+  YYSYMBOL_nonmethod_type = 82,            /* nonmethod_type  */
+  YYSYMBOL_nonmethod_type_no_array = 83,   /* nonmethod_type_no_array  */
+  YYSYMBOL_type_with_array = 84,           /* type_with_array  */
+  YYSYMBOL_molecular = 85,                 /* molecular  */
+  YYSYMBOL_defined_field = 86,             /* defined_field  */
+  YYSYMBOL_builtin_array_type = 87,        /* builtin_array_type  */
+  YYSYMBOL_numeric_type = 88,              /* numeric_type  */
+  YYSYMBOL_numeric_token_only = 89,        /* numeric_token_only  */
+  YYSYMBOL_numeric_with_range = 90,        /* numeric_with_range  */
+  YYSYMBOL_numeric_with_modulus = 91,      /* numeric_with_modulus  */
+  YYSYMBOL_numeric_with_divisor = 92,      /* numeric_with_divisor  */
+  YYSYMBOL_method = 93,                    /* method  */
+  YYSYMBOL_method_body = 94,               /* method_body  */
+  YYSYMBOL_parameter = 95,                 /* parameter  */
+  YYSYMBOL_96_7 = 96,                      /* $@7  */
+  YYSYMBOL_param_with_name = 97,           /* param_with_name  */
+  YYSYMBOL_param_with_name_as_array = 98,  /* param_with_name_as_array  */
+  YYSYMBOL_param_with_name_and_default = 99, /* param_with_name_and_default  */
+  YYSYMBOL_100_8 = 100,                    /* $@8  */
+  YYSYMBOL_101_9 = 101,                    /* $@9  */
+  YYSYMBOL_numeric_range = 102,            /* numeric_range  */
+  YYSYMBOL_array_range = 103,              /* array_range  */
+  YYSYMBOL_char_or_uint = 104,             /* char_or_uint  */
+  YYSYMBOL_small_unsigned_integer = 105,   /* small_unsigned_integer  */
+  YYSYMBOL_number = 106,                   /* number  */
+  YYSYMBOL_char_or_number = 107,           /* char_or_number  */
+  YYSYMBOL_type_value = 108,               /* type_value  */
+  YYSYMBOL_method_value = 109,             /* method_value  */
+  YYSYMBOL_110_10 = 110,                   /* $@10  */
+  YYSYMBOL_parameter_values = 111,         /* parameter_values  */
+  YYSYMBOL_struct_value = 112,             /* struct_value  */
+  YYSYMBOL_113_11 = 113,                   /* $@11  */
+  YYSYMBOL_field_values = 114,             /* field_values  */
+  YYSYMBOL_array_value = 115,              /* array_value  */
+  YYSYMBOL_116_12 = 116,                   /* $@12  */
+  YYSYMBOL_element_values = 117,           /* element_values  */
+  YYSYMBOL_118_13 = 118,                   /* $@13  */
+  YYSYMBOL_array_expansion = 119,          /* array_expansion  */
+  YYSYMBOL_signed_integer = 120,           /* signed_integer  */
+  YYSYMBOL_array_type_token = 121,         /* array_type_token  */
+  YYSYMBOL_numeric_type_token = 122,       /* numeric_type_token  */
+  YYSYMBOL_keyword_list = 123,             /* keyword_list  */
+  YYSYMBOL_empty = 124                     /* empty  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
 
-/* Copy the second part of user declarations.  */
 
 
 
@@ -209,28 +342,87 @@ static void dcparser_cleanup()
 # undef short
 #endif
 
-#ifdef YYTYPE_UINT8
-typedef YYTYPE_UINT8 yytype_uint8;
-#else
-typedef unsigned char yytype_uint8;
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
 #endif
 
-#ifdef YYTYPE_INT8
-typedef YYTYPE_INT8 yytype_int8;
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
 #else
 typedef signed char yytype_int8;
 #endif
 
-#ifdef YYTYPE_UINT16
-typedef YYTYPE_UINT16 yytype_uint16;
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
+#else
+typedef short yytype_int16;
+#endif
+
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
 #else
-typedef unsigned short int yytype_uint16;
+typedef short yytype_uint8;
 #endif
 
-#ifdef YYTYPE_INT16
-typedef YYTYPE_INT16 yytype_int16;
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
 #else
-typedef short int yytype_int16;
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
 #endif
 
 #ifndef YYSIZE_T
@@ -238,15 +430,28 @@ typedef short int yytype_int16;
 #  define YYSIZE_T __SIZE_TYPE__
 # elif defined size_t
 #  define YYSIZE_T size_t
-# elif ! defined YYSIZE_T
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
 #  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
 #  define YYSIZE_T size_t
 # else
-#  define YYSIZE_T unsigned int
+#  define YYSIZE_T unsigned
 # endif
 #endif
 
-#define YYSIZE_MAXIMUM ((YYSIZE_T) -1)
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_int16 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
 
 #ifndef YY_
 # if defined YYENABLE_NLS && YYENABLE_NLS
@@ -260,47 +465,43 @@ typedef short int yytype_int16;
 # endif
 #endif
 
-#ifndef YY_ATTRIBUTE
-# if (defined __GNUC__                                               \
-      && (2 < __GNUC__ || (__GNUC__ == 2 && 96 <= __GNUC_MINOR__)))  \
-     || defined __SUNPRO_C && 0x5110 <= __SUNPRO_C
-#  define YY_ATTRIBUTE(Spec) __attribute__(Spec)
-# else
-#  define YY_ATTRIBUTE(Spec) /* empty */
-# endif
-#endif
 
 #ifndef YY_ATTRIBUTE_PURE
-# define YY_ATTRIBUTE_PURE   YY_ATTRIBUTE ((__pure__))
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
 #endif
 
 #ifndef YY_ATTRIBUTE_UNUSED
-# define YY_ATTRIBUTE_UNUSED YY_ATTRIBUTE ((__unused__))
-#endif
-
-#if !defined _Noreturn \
-     && (!defined __STDC_VERSION__ || __STDC_VERSION__ < 201112)
-# if defined _MSC_VER && 1200 <= _MSC_VER
-#  define _Noreturn __declspec (noreturn)
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
 # else
-#  define _Noreturn YY_ATTRIBUTE ((__noreturn__))
+#  define YY_ATTRIBUTE_UNUSED
 # endif
 #endif
 
 /* Suppress unused-variable warnings by "using" E.  */
 #if ! defined lint || defined __GNUC__
-# define YYUSE(E) ((void) (E))
+# define YY_USE(E) ((void) (E))
 #else
-# define YYUSE(E) /* empty */
+# define YY_USE(E) /* empty */
 #endif
 
-#if defined __GNUC__ && 407 <= __GNUC__ * 100 + __GNUC_MINOR__
 /* Suppress an incorrect diagnostic about yylval being uninitialized.  */
-# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN \
-    _Pragma ("GCC diagnostic push") \
-    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")\
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
     _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
-# define YY_IGNORE_MAYBE_UNINITIALIZED_END \
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
     _Pragma ("GCC diagnostic pop")
 #else
 # define YY_INITIAL_VALUE(Value) Value
@@ -313,8 +514,22 @@ typedef short int yytype_int16;
 # define YY_INITIAL_VALUE(Value) /* Nothing. */
 #endif
 
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
 
-#if ! defined yyoverflow || YYERROR_VERBOSE
+#if 1
 
 /* The parser invokes alloca or malloc; define the necessary symbols.  */
 
@@ -333,7 +548,7 @@ typedef short int yytype_int16;
 #    define YYSTACK_ALLOC alloca
 #    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
 #     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
-/* Use EXIT_SUCCESS as a witness for stdlib.h.  */
+      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
 #     ifndef EXIT_SUCCESS
 #      define EXIT_SUCCESS 0
 #     endif
@@ -343,13 +558,13 @@ typedef short int yytype_int16;
 # endif
 
 # ifdef YYSTACK_ALLOC
-/* Pacify GCC's 'empty if-body' warning.  */
+   /* Pacify GCC's 'empty if-body' warning.  */
 #  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
 #  ifndef YYSTACK_ALLOC_MAXIMUM
-/* The OS might guarantee only one guard page at the bottom of the stack,
-   and a page size can be as small as 4096 bytes.  So we cannot safely
-   invoke alloca (N) if N exceeds 4096.  Use a slightly smaller number
-   to allow for a few compiler-allocated temporary stack slots.  */
+    /* The OS might guarantee only one guard page at the bottom of the stack,
+       and a page size can be as small as 4096 bytes.  So we cannot safely
+       invoke alloca (N) if N exceeds 4096.  Use a slightly smaller number
+       to allow for a few compiler-allocated temporary stack slots.  */
 #   define YYSTACK_ALLOC_MAXIMUM 4032 /* reasonable circa 2006 */
 #  endif
 # else
@@ -369,36 +584,36 @@ typedef short int yytype_int16;
 #  ifndef YYMALLOC
 #   define YYMALLOC malloc
 #   if ! defined malloc && ! defined EXIT_SUCCESS
-void *malloc(YYSIZE_T);  /* INFRINGES ON USER NAME SPACE */
+void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 #  ifndef YYFREE
 #   define YYFREE free
 #   if ! defined free && ! defined EXIT_SUCCESS
-void free(void *);  /* INFRINGES ON USER NAME SPACE */
+void free (void *); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 # endif
-#endif /* ! defined yyoverflow || YYERROR_VERBOSE */
-
+#endif /* 1 */
 
 #if (! defined yyoverflow \
      && (! defined __cplusplus \
          || (defined DCSTYPE_IS_TRIVIAL && DCSTYPE_IS_TRIVIAL)))
 
 /* A type that is properly aligned for any stack member.  */
-union yyalloc {
-    yytype_int16 yyss_alloc;
-    YYSTYPE yyvs_alloc;
+union yyalloc
+{
+  yy_state_t yyss_alloc;
+  YYSTYPE yyvs_alloc;
 };
 
 /* The size of the maximum gap between one aligned stack and the next.  */
-# define YYSTACK_GAP_MAXIMUM (sizeof (union yyalloc) - 1)
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
 
 /* The size of an array large to enough to hold all stacks, each with
    N elements.  */
 # define YYSTACK_BYTES(N) \
-     ((N) * (sizeof (yytype_int16) + sizeof (YYSTYPE)) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
       + YYSTACK_GAP_MAXIMUM)
 
 # define YYCOPY_NEEDED 1
@@ -411,11 +626,11 @@ union yyalloc {
 # define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
     do                                                                  \
       {                                                                 \
-        YYSIZE_T yynewbytes;                                            \
+        YYPTRDIFF_T yynewbytes;                                         \
         YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
         Stack = &yyptr->Stack_alloc;                                    \
-        yynewbytes = yystacksize * sizeof (*Stack) + YYSTACK_GAP_MAXIMUM; \
-        yyptr += yynewbytes / sizeof (*yyptr);                          \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
       }                                                                 \
     while (0)
 
@@ -427,12 +642,12 @@ union yyalloc {
 # ifndef YYCOPY
 #  if defined __GNUC__ && 1 < __GNUC__
 #   define YYCOPY(Dst, Src, Count) \
-      __builtin_memcpy (Dst, Src, (Count) * sizeof (*(Src)))
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
 #  else
 #   define YYCOPY(Dst, Src, Count)              \
       do                                        \
         {                                       \
-          YYSIZE_T yyi;                         \
+          YYPTRDIFF_T yyi;                      \
           for (yyi = 0; yyi < (Count); yyi++)   \
             (Dst)[yyi] = (Src)[yyi];            \
         }                                       \
@@ -455,151 +670,160 @@ union yyalloc {
 /* YYNSTATES -- Number of states.  */
 #define YYNSTATES  265
 
-/* YYTRANSLATE[YYX] -- Symbol number corresponding to YYX as returned
-   by yylex, with out-of-bounds checking.  */
-#define YYUNDEFTOK  2
+/* YYMAXUTOK -- Last valid token kind.  */
 #define YYMAXUTOK   284
 
-#define YYTRANSLATE(YYX)                                                \
-  ((unsigned int) (YYX) <= YYMAXUTOK ? yytranslate[YYX] : YYUNDEFTOK)
+
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
 
 /* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
-   as returned by yylex, without out-of-bounds checking.  */
-static const yytype_uint8 yytranslate[] = {
-    0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-    2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-    2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-    2,     2,     2,     2,     2,     2,     2,    43,     2,     2,
-    41,    42,    32,    45,    33,    44,    31,    34,     2,     2,
-    2,     2,     2,     2,     2,     2,     2,     2,    39,    30,
-    2,    40,     2,     2,     2,     2,     2,     2,     2,     2,
-    2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-    2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-    2,    35,     2,    36,     2,     2,     2,     2,     2,     2,
-    2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-    2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-    2,     2,     2,    37,     2,    38,     2,     2,     2,     2,
-    2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-    2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-    2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-    2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-    2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-    2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-    2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-    2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-    2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-    2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-    2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-    2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
-    2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
-    5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
-    15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
-    25,    26,    27,    28,    29
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
+{
+       0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,    43,     2,     2,
+      41,    42,    32,    45,    33,    44,    31,    34,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,    39,    30,
+       2,    40,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,    35,     2,    36,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,    37,     2,    38,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
+       5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
+      15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
+      25,    26,    27,    28,    29
 };
 
 #if DCDEBUG
 /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
-static const yytype_uint16 yyrline[] = {
-    0,   218,   218,   219,   224,   225,   226,   227,   228,   229,
-    230,   234,   238,   243,   251,   256,   265,   266,   273,   274,
-    281,   285,   293,   294,   301,   346,   350,   358,   368,   383,
-    387,   388,   396,   395,   435,   436,   440,   447,   457,   488,
-    489,   490,   528,   552,   560,   559,   599,   600,   601,   635,
-    636,   640,   641,   642,   643,   647,   652,   651,   666,   673,
-    678,   687,   686,   698,   697,   709,   708,   722,   729,   730,
-    734,   752,   756,   760,   764,   768,   772,   779,   805,   837,
-    859,   887,   910,   911,   912,   913,   917,   921,   930,   939,
-    951,   963,   970,   980,   984,   991,  1001,  1014,  1015,  1016,
-    1017,  1022,  1021,  1035,  1042,  1047,  1056,  1055,  1067,  1066,
-    1080,  1081,  1082,  1086,  1087,  1088,  1092,  1104,  1108,  1121,
-    1122,  1123,  1127,  1136,  1140,  1154,  1168,  1182,  1214,  1241,
-    1242,  1247,  1246,  1283,  1284,  1294,  1293,  1330,  1331,  1332,
-    1338,  1347,  1384,  1383,  1445,  1447,  1446,  1469,  1474,  1493,
-    1512,  1531,  1577,  1626,  1627,  1631,  1632,  1636,  1637,  1638,
-    1639,  1640,  1641,  1642,  1643,  1644,  1645,  1646,  1650,  1654,
-    1667
+static const yytype_int16 yyrline[] =
+{
+       0,   223,   223,   224,   229,   230,   231,   232,   233,   234,
+     235,   239,   243,   248,   256,   261,   270,   271,   278,   279,
+     286,   290,   298,   299,   306,   352,   356,   364,   374,   389,
+     393,   394,   402,   401,   441,   442,   446,   453,   463,   494,
+     495,   496,   534,   558,   566,   565,   605,   606,   607,   641,
+     642,   646,   647,   648,   649,   653,   658,   657,   672,   679,
+     684,   693,   692,   704,   703,   715,   714,   728,   735,   736,
+     740,   758,   762,   766,   770,   774,   778,   785,   811,   843,
+     865,   885,   908,   909,   910,   911,   915,   919,   928,   937,
+     949,   961,   968,   978,   982,   989,   999,  1012,  1013,  1014,
+    1015,  1020,  1019,  1033,  1040,  1045,  1054,  1053,  1065,  1064,
+    1078,  1079,  1080,  1084,  1085,  1086,  1090,  1102,  1106,  1119,
+    1120,  1121,  1125,  1134,  1138,  1152,  1166,  1180,  1212,  1239,
+    1240,  1245,  1244,  1281,  1282,  1292,  1291,  1328,  1329,  1330,
+    1336,  1345,  1382,  1381,  1443,  1445,  1444,  1467,  1472,  1491,
+    1510,  1529,  1575,  1624,  1625,  1629,  1630,  1634,  1635,  1636,
+    1637,  1638,  1639,  1640,  1641,  1642,  1643,  1644,  1648,  1652,
+    1666
 };
 #endif
 
-#if DCDEBUG || YYERROR_VERBOSE || 1
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if 1
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
 /* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
    First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
-static const char *const yytname[] = {
-    "$end", "error", "$undefined", "UNSIGNED_INTEGER", "REAL", "STRING",
-    "HEX_STRING", "IDENTIFIER", "CHAR", "START_DC_FILE", "START_DC_VALUE",
-    "KW_DCLASS", "KW_STRUCT", "KW_FROM", "KW_IMPORT", "KW_TYPEDEF",
-    "KW_KEYWORD", "KW_INT8", "KW_INT16", "KW_INT32", "KW_INT64", "KW_UINT8",
-    "KW_UINT16", "KW_UINT32", "KW_UINT64", "KW_FLOAT32", "KW_FLOAT64",
-    "KW_STRING", "KW_BLOB", "KW_CHAR", "';'", "'.'", "'*'", "','", "'/'",
-    "'['", "']'", "'{'", "'}'", "':'", "'='", "'('", "')'", "'%'", "'-'",
-    "'+'", "$accept", "grammar", "file", "value", "import", "import_module",
-    "import_symbols", "import_symbol_list", "import_alternatives", "typedef",
-    "typedef_type", "nonmethod_type_with_name", "defined_type",
-    "keyword_decl", "keyword_decl_list", "dclass", "$@1",
-    "class_inheritance", "class_parents", "defined_class", "class_fields",
-    "class_field", "dstruct", "$@2", "struct_fields", "struct_field",
-    "named_field", "unnamed_field", "$@3", "field_with_name",
-    "field_with_name_as_array", "field_with_name_and_default", "$@4", "$@5",
-    "$@6", "method_as_field", "nonmethod_type", "nonmethod_type_no_array",
-    "type_with_array", "molecular", "defined_field", "builtin_array_type",
-    "numeric_type", "numeric_token_only", "numeric_with_range",
-    "numeric_with_modulus", "numeric_with_divisor", "method", "method_body",
-    "parameter", "$@7", "param_with_name", "param_with_name_as_array",
-    "param_with_name_and_default", "$@8", "$@9", "numeric_range",
-    "array_range", "char_or_uint", "small_unsigned_integer", "number",
-    "char_or_number", "type_value", "method_value", "$@10",
-    "parameter_values", "struct_value", "$@11", "field_values",
-    "array_value", "$@12", "element_values", "$@13", "array_expansion",
-    "signed_integer", "array_type_token", "numeric_type_token",
-    "keyword_list", "empty", YY_NULLPTR
+static const char *const yytname[] =
+{
+  "\"end of file\"", "error", "\"invalid token\"", "UNSIGNED_INTEGER",
+  "REAL", "STRING", "HEX_STRING", "IDENTIFIER", "CHAR", "START_DC_FILE",
+  "START_DC_VALUE", "KW_DCLASS", "KW_STRUCT", "KW_FROM", "KW_IMPORT",
+  "KW_TYPEDEF", "KW_KEYWORD", "KW_INT8", "KW_INT16", "KW_INT32",
+  "KW_INT64", "KW_UINT8", "KW_UINT16", "KW_UINT32", "KW_UINT64",
+  "KW_FLOAT32", "KW_FLOAT64", "KW_STRING", "KW_BLOB", "KW_CHAR", "';'",
+  "'.'", "'*'", "','", "'/'", "'['", "']'", "'{'", "'}'", "':'", "'='",
+  "'('", "')'", "'%'", "'-'", "'+'", "$accept", "grammar", "file", "value",
+  "import", "import_module", "import_symbols", "import_symbol_list",
+  "import_alternatives", "typedef", "typedef_type",
+  "nonmethod_type_with_name", "defined_type", "keyword_decl",
+  "keyword_decl_list", "dclass", "$@1", "class_inheritance",
+  "class_parents", "defined_class", "class_fields", "class_field",
+  "dstruct", "$@2", "struct_fields", "struct_field", "named_field",
+  "unnamed_field", "$@3", "field_with_name", "field_with_name_as_array",
+  "field_with_name_and_default", "$@4", "$@5", "$@6", "method_as_field",
+  "nonmethod_type", "nonmethod_type_no_array", "type_with_array",
+  "molecular", "defined_field", "builtin_array_type", "numeric_type",
+  "numeric_token_only", "numeric_with_range", "numeric_with_modulus",
+  "numeric_with_divisor", "method", "method_body", "parameter", "$@7",
+  "param_with_name", "param_with_name_as_array",
+  "param_with_name_and_default", "$@8", "$@9", "numeric_range",
+  "array_range", "char_or_uint", "small_unsigned_integer", "number",
+  "char_or_number", "type_value", "method_value", "$@10",
+  "parameter_values", "struct_value", "$@11", "field_values",
+  "array_value", "$@12", "element_values", "$@13", "array_expansion",
+  "signed_integer", "array_type_token", "numeric_type_token",
+  "keyword_list", "empty", YY_NULLPTR
 };
-#endif
 
-# ifdef YYPRINT
-/* YYTOKNUM[NUM] -- (External) token number corresponding to the
-   (internal) symbol number NUM (which must be that of a token).  */
-static const yytype_uint16 yytoknum[] = {
-    0,   256,   257,   258,   259,   260,   261,   262,   263,   264,
-    265,   266,   267,   268,   269,   270,   271,   272,   273,   274,
-    275,   276,   277,   278,   279,   280,   281,   282,   283,   284,
-    59,    46,    42,    44,    47,    91,    93,   123,   125,    58,
-    61,    40,    41,    37,    45,    43
-};
-# endif
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
+{
+  return yytname[yysymbol];
+}
+#endif
 
-#define YYPACT_NINF -196
+#define YYPACT_NINF (-196)
 
-#define yypact_value_is_default(Yystate) \
-  (!!((Yystate) == (-196)))
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
 
-#define YYTABLE_NINF -1
+#define YYTABLE_NINF (-1)
 
-#define yytable_value_is_error(Yytable_value) \
+#define yytable_value_is_error(Yyn) \
   0
 
 /* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
    STATE-NUM.  */
-static const yytype_int16 yypact[] = {
-    4,  -196,    13,    32,    96,  -196,  -196,  -196,  -196,  -196,
-    5,  -196,  -196,    73,    79,  -196,  -196,  -196,  -196,  -196,
+static const yytype_int16 yypact[] =
+{
+       4,  -196,    13,    32,    96,  -196,  -196,  -196,  -196,  -196,
+       5,  -196,  -196,    73,    79,  -196,  -196,  -196,  -196,  -196,
     -196,  -196,  -196,    76,   107,   108,   108,   218,  -196,  -196,
     -196,  -196,    51,  -196,  -196,  -196,  -196,    18,    13,    40,
     -196,  -196,  -196,  -196,  -196,    21,    63,    69,  -196,  -196,
     -196,  -196,  -196,  -196,  -196,  -196,  -196,  -196,  -196,  -196,
     -196,  -196,  -196,    68,   109,  -196,    82,    88,    89,    -1,
     -196,    31,    94,    95,  -196,   124,  -196,    93,   102,   105,
-    110,   111,  -196,    28,  -196,   114,  -196,  -196,    66,  -196,
-    -13,   100,   103,    24,   108,   134,    93,  -196,    93,    93,
-    93,   144,    22,    35,   144,    22,    22,    93,  -196,  -196,
+     110,   111,  -196,    28,  -196,   114,  -196,  -196,    66,  -196,
+     -13,   100,   103,    24,   108,   134,    93,  -196,    93,    93,
+      93,   144,    22,    35,   144,    22,    22,    93,  -196,  -196,
     -196,   112,   106,  -196,  -196,   144,   144,   144,   144,  -196,
     -196,   144,    13,  -196,    40,  -196,   142,   115,  -196,  -196,
     -196,  -196,   136,    63,    63,  -196,   131,   138,   139,   140,
     -196,  -196,  -196,  -196,   128,  -196,   129,  -196,  -196,  -196,
     -196,   130,   135,   153,  -196,    93,  -196,  -196,  -196,  -196,
-    18,  -196,  -196,  -196,  -196,  -196,   145,  -196,  -196,   164,
+      18,  -196,  -196,  -196,  -196,  -196,   145,  -196,  -196,   164,
     -196,   108,  -196,  -196,  -196,  -196,  -196,    22,  -196,  -196,
     -196,  -196,  -196,   142,   189,  -196,   156,  -196,  -196,  -196,
-    168,  -196,  -196,    78,    90,  -196,   159,    20,    63,  -196,
+     168,  -196,  -196,    78,    90,  -196,   159,    20,    63,  -196,
     -196,    10,  -196,  -196,   170,  -196,   171,   137,  -196,    26,
     -196,    93,  -196,    93,  -196,   160,  -196,   196,  -196,   213,
     -196,   196,  -196,   181,   215,  -196,    92,    98,  -196,   218,
@@ -612,233 +836,241 @@ static const yytype_int16 yypact[] = {
 /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
    Performed when YYTABLE does not specify something else to do.  Zero
    means the default is an error.  */
-static const yytype_uint8 yydefact[] = {
-    0,   170,   170,     0,     2,     4,   125,   126,   127,   128,
-    142,   135,   131,     0,     0,     3,    12,    13,   130,   129,
-    124,    11,     1,     0,     0,     0,     0,     0,   170,     5,
-    8,     9,    24,    10,     6,     7,   141,     0,     0,     0,
-    154,   153,    32,    44,    22,     0,    16,    14,    28,   158,
-    159,   160,   161,   162,   163,   164,   165,   166,   167,   155,
-    156,   157,    25,    70,     0,    68,    69,    72,    71,    82,
-    85,    83,    84,    80,    86,    29,    30,   170,   125,   126,
-    127,   128,   147,     0,   144,   124,   137,   138,     0,   133,
-    0,   170,     0,     0,     0,     0,   170,    27,   170,   170,
-    170,     0,   170,     0,     0,   170,   170,   170,    31,   118,
-    116,     0,   114,   117,   113,     0,     0,     0,     0,   145,
-    143,     0,     0,   136,     0,   132,     0,     0,    34,   170,
-    19,    15,    18,    20,    17,    23,     0,     0,     0,     0,
-    91,   119,   121,   122,     0,   123,   111,   120,   110,    90,
-    92,     0,     0,     0,    26,     0,   149,   150,   151,   152,
-    0,   148,   139,   140,   134,    38,    35,    36,   170,     0,
-    46,     0,    74,    76,    75,    73,    87,     0,    88,    89,
-    81,   115,   146,     0,     0,    39,    28,    47,    45,    58,
-    0,    49,    50,    51,    52,    53,    54,    55,    21,   112,
-    37,    28,    40,    33,     0,   170,    43,     0,    67,     0,
-    48,   170,    61,   170,    63,     0,    56,     0,    41,    42,
-    168,     0,    93,   100,    68,    95,    97,    98,    99,     0,
-    94,     0,     0,     0,     0,    65,     0,    79,    77,   169,
-    78,   101,   103,   170,   106,   170,   108,    96,    59,    62,
-    60,    64,     0,    57,     0,     0,     0,     0,     0,    66,
-    102,   104,   107,   105,   109
+static const yytype_uint8 yydefact[] =
+{
+       0,   170,   170,     0,     2,     4,   125,   126,   127,   128,
+     142,   135,   131,     0,     0,     3,    12,    13,   130,   129,
+     124,    11,     1,     0,     0,     0,     0,     0,   170,     5,
+       8,     9,    24,    10,     6,     7,   141,     0,     0,     0,
+     154,   153,    32,    44,    22,     0,    16,    14,    28,   158,
+     159,   160,   161,   162,   163,   164,   165,   166,   167,   155,
+     156,   157,    25,    70,     0,    68,    69,    72,    71,    82,
+      85,    83,    84,    80,    86,    29,    30,   170,   125,   126,
+     127,   128,   147,     0,   144,   124,   137,   138,     0,   133,
+       0,   170,     0,     0,     0,     0,   170,    27,   170,   170,
+     170,     0,   170,     0,     0,   170,   170,   170,    31,   118,
+     116,     0,   114,   117,   113,     0,     0,     0,     0,   145,
+     143,     0,     0,   136,     0,   132,     0,     0,    34,   170,
+      19,    15,    18,    20,    17,    23,     0,     0,     0,     0,
+      91,   119,   121,   122,     0,   123,   111,   120,   110,    90,
+      92,     0,     0,     0,    26,     0,   149,   150,   151,   152,
+       0,   148,   139,   140,   134,    38,    35,    36,   170,     0,
+      46,     0,    74,    76,    75,    73,    87,     0,    88,    89,
+      81,   115,   146,     0,     0,    39,    28,    47,    45,    58,
+       0,    49,    50,    51,    52,    53,    54,    55,    21,   112,
+      37,    28,    40,    33,     0,   170,    43,     0,    67,     0,
+      48,   170,    61,   170,    63,     0,    56,     0,    41,    42,
+     168,     0,    93,   100,    68,    95,    97,    98,    99,     0,
+      94,     0,     0,     0,     0,    65,     0,    79,    77,   169,
+      78,   101,   103,   170,   106,   170,   108,    96,    59,    62,
+      60,    64,     0,    57,     0,     0,     0,     0,     0,    66,
+     102,   104,   107,   105,   109
 };
 
 /* YYPGOTO[NTERM-NUM].  */
-static const yytype_int16 yypgoto[] = {
+static const yytype_int16 yypgoto[] =
+{
     -196,  -196,  -196,  -196,  -196,   203,  -196,  -196,   -83,  -196,
     -196,   204,  -196,  -196,  -196,  -196,  -196,  -196,  -196,    50,
     -196,  -196,  -196,  -196,  -196,  -196,    64,  -196,  -196,  -196,
     -196,  -196,  -196,  -196,  -196,  -196,  -160,  -195,  -196,  -196,
-    30,  -196,  -196,  -196,  -196,  -196,  -196,  -196,  -196,    29,
+      30,  -196,  -196,  -196,  -196,  -196,  -196,  -196,  -196,    29,
     -196,  -196,  -196,  -196,  -196,  -196,   -16,   -92,   104,   -23,
-    146,    80,    -2,   -35,  -196,  -196,  -196,  -196,  -196,  -196,
+     146,    80,    -2,   -35,  -196,  -196,  -196,  -196,  -196,  -196,
     -196,  -196,  -196,   101,   -32,  -196,  -196,  -196,     0
 };
 
 /* YYDEFGOTO[NTERM-NUM].  */
-static const yytype_int16 yydefgoto[] = {
-    -1,     3,     4,    15,    30,    45,   131,   132,    46,    31,
-    32,   189,    63,    33,    75,    34,    91,   127,   166,   167,
-    184,   204,    35,    92,   169,   190,   191,   192,   236,   193,
-    194,   195,   232,   234,   252,   196,    64,    65,    66,   206,
-    238,    67,    68,    69,    70,    71,    72,   208,   209,   225,
-    254,   226,   227,   228,   256,   258,   144,   111,   112,   113,
-    145,   146,    82,    17,    39,    90,    18,    38,    88,    19,
-    37,    83,   160,    84,    20,    73,    74,   219,   114
+static const yytype_int16 yydefgoto[] =
+{
+       0,     3,     4,    15,    30,    45,   131,   132,    46,    31,
+      32,   189,    63,    33,    75,    34,    91,   127,   166,   167,
+     184,   204,    35,    92,   169,   190,   191,   192,   236,   193,
+     194,   195,   232,   234,   252,   196,    64,    65,    66,   206,
+     238,    67,    68,    69,    70,    71,    72,   208,   209,   225,
+     254,   226,   227,   228,   256,   258,   144,   111,   112,   113,
+     145,   146,    82,    17,    39,    90,    18,    38,    88,    19,
+      37,    83,   160,    84,    20,    73,    74,   219,   114
 };
 
 /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
    positive, shift that token.  If negative, reduce the rule whose
    number is the opposite.  If YYTABLE_NINF, syntax error.  */
-static const yytype_uint16 yytable[] = {
-    16,     5,    21,    87,   136,    85,   137,   138,   139,   197,
-    133,   134,   224,     1,     2,   153,     6,     7,     8,     9,
-    124,    78,    79,    80,    81,   141,   142,    97,    76,   125,
-    143,    44,    22,   101,   224,    93,    86,    89,   141,   142,
-    102,    36,   103,     6,     7,     8,     9,   223,    10,   217,
-    11,   207,    94,    10,    12,    11,   130,    13,    14,   229,
-    216,   119,    13,    14,   120,   104,    13,    14,   230,   223,
-    147,   147,   105,   147,   147,    10,    40,    11,   140,    13,
-    14,   150,    41,    42,    13,    14,    77,   163,   198,   151,
-    152,   128,   156,   157,   158,   159,   109,    95,   161,   122,
-    94,   110,   148,    96,   123,   148,   148,    23,    24,    25,
-    26,    27,    28,   211,    43,    44,    97,    98,   212,   231,
-    162,   233,   164,    99,   100,   213,    29,   243,    85,   170,
-    214,   108,   244,   245,   115,   106,   107,   116,   246,   126,
-    129,   135,   117,   118,    48,   147,   121,   109,   154,   165,
-    155,   255,   168,   257,    49,    50,    51,    52,    53,    54,
-    55,    56,    57,    58,    59,    60,    61,   172,   185,   171,
-    176,   186,   178,   177,   173,   174,   175,   179,   183,   222,
-    235,    49,    50,    51,    52,    53,    54,    55,    56,    57,
-    58,    59,    60,    61,   187,   180,   201,   207,   210,   215,
-    218,    12,   188,   237,   221,   220,    49,    50,    51,    52,
-    53,    54,    55,    56,    57,    58,    59,    60,    61,   202,
-    239,   241,   242,   248,   250,    48,   261,   203,   263,    47,
-    249,    62,   251,   200,   253,    49,    50,    51,    52,    53,
-    54,    55,    56,    57,    58,    59,    60,    61,   205,   149,
-    259,   240,   260,     0,   262,     0,   264,   199,   247,   181,
-    0,   182
+static const yytype_int16 yytable[] =
+{
+      16,     5,    21,    87,   136,    85,   137,   138,   139,   197,
+     133,   134,   224,     1,     2,   153,     6,     7,     8,     9,
+     124,    78,    79,    80,    81,   141,   142,    97,    76,   125,
+     143,    44,    22,   101,   224,    93,    86,    89,   141,   142,
+     102,    36,   103,     6,     7,     8,     9,   223,    10,   217,
+      11,   207,    94,    10,    12,    11,   130,    13,    14,   229,
+     216,   119,    13,    14,   120,   104,    13,    14,   230,   223,
+     147,   147,   105,   147,   147,    10,    40,    11,   140,    13,
+      14,   150,    41,    42,    13,    14,    77,   163,   198,   151,
+     152,   128,   156,   157,   158,   159,   109,    95,   161,   122,
+      94,   110,   148,    96,   123,   148,   148,    23,    24,    25,
+      26,    27,    28,   211,    43,    44,    97,    98,   212,   231,
+     162,   233,   164,    99,   100,   213,    29,   243,    85,   170,
+     214,   108,   244,   245,   115,   106,   107,   116,   246,   126,
+     129,   135,   117,   118,    48,   147,   121,   109,   154,   165,
+     155,   255,   168,   257,    49,    50,    51,    52,    53,    54,
+      55,    56,    57,    58,    59,    60,    61,   172,   185,   171,
+     176,   186,   178,   177,   173,   174,   175,   179,   183,   222,
+     235,    49,    50,    51,    52,    53,    54,    55,    56,    57,
+      58,    59,    60,    61,   187,   180,   201,   207,   210,   215,
+     218,    12,   188,   237,   221,   220,    49,    50,    51,    52,
+      53,    54,    55,    56,    57,    58,    59,    60,    61,   202,
+     239,   241,   242,   248,   250,    48,   261,   203,   263,    47,
+     249,    62,   251,   200,   253,    49,    50,    51,    52,    53,
+      54,    55,    56,    57,    58,    59,    60,    61,   205,   149,
+     259,   240,   260,     0,   262,     0,   264,   199,   247,   181,
+       0,   182
 };
 
-static const yytype_int16 yycheck[] = {
-    2,     1,     2,    38,    96,    37,    98,    99,   100,   169,
-    93,    94,   207,     9,    10,   107,     3,     4,     5,     6,
-    33,     3,     4,     5,     6,     3,     4,     7,    28,    42,
-    8,     7,     0,    34,   229,    14,    38,    39,     3,     4,
-    41,    36,    43,     3,     4,     5,     6,   207,    35,    39,
-    37,    41,    31,    35,    41,    37,    32,    44,    45,    33,
-    40,    33,    44,    45,    36,    34,    44,    45,    42,   229,
-    102,   103,    41,   105,   106,    35,     3,    37,   101,    44,
-    45,   104,     3,     7,    44,    45,    35,   122,   171,   105,
-    106,    91,   115,   116,   117,   118,     3,    34,   121,    33,
-    31,     8,   102,    35,    38,   105,   106,    11,    12,    13,
-    14,    15,    16,    35,     7,     7,     7,    35,    40,   211,
-    122,   213,   124,    35,    35,    35,    30,    35,   160,   129,
-    40,     7,    40,    35,    32,    41,    41,    32,    40,    39,
-    37,     7,    32,    32,     7,   177,    32,     3,    36,     7,
-    44,   243,    37,   245,    17,    18,    19,    20,    21,    22,
-    23,    24,    25,    26,    27,    28,    29,    36,   168,    33,
-    42,     7,    42,    44,    36,    36,    36,    42,    33,    42,
-    215,    17,    18,    19,    20,    21,    22,    23,    24,    25,
-    26,    27,    28,    29,    30,    42,     7,    41,    30,    40,
-    30,    41,    38,     7,    33,   205,    17,    18,    19,    20,
-    21,    22,    23,    24,    25,    26,    27,    28,    29,    30,
-    7,    40,     7,    36,    36,     7,    36,    38,    36,    26,
-    232,    27,   234,   183,   236,    17,    18,    19,    20,    21,
-    22,    23,    24,    25,    26,    27,    28,    29,   184,   103,
-    252,   221,   254,    -1,   256,    -1,   258,   177,   229,   155,
-    -1,   160
+static const yytype_int16 yycheck[] =
+{
+       2,     1,     2,    38,    96,    37,    98,    99,   100,   169,
+      93,    94,   207,     9,    10,   107,     3,     4,     5,     6,
+      33,     3,     4,     5,     6,     3,     4,     7,    28,    42,
+       8,     7,     0,    34,   229,    14,    38,    39,     3,     4,
+      41,    36,    43,     3,     4,     5,     6,   207,    35,    39,
+      37,    41,    31,    35,    41,    37,    32,    44,    45,    33,
+      40,    33,    44,    45,    36,    34,    44,    45,    42,   229,
+     102,   103,    41,   105,   106,    35,     3,    37,   101,    44,
+      45,   104,     3,     7,    44,    45,    35,   122,   171,   105,
+     106,    91,   115,   116,   117,   118,     3,    34,   121,    33,
+      31,     8,   102,    35,    38,   105,   106,    11,    12,    13,
+      14,    15,    16,    35,     7,     7,     7,    35,    40,   211,
+     122,   213,   124,    35,    35,    35,    30,    35,   160,   129,
+      40,     7,    40,    35,    32,    41,    41,    32,    40,    39,
+      37,     7,    32,    32,     7,   177,    32,     3,    36,     7,
+      44,   243,    37,   245,    17,    18,    19,    20,    21,    22,
+      23,    24,    25,    26,    27,    28,    29,    36,   168,    33,
+      42,     7,    42,    44,    36,    36,    36,    42,    33,    42,
+     215,    17,    18,    19,    20,    21,    22,    23,    24,    25,
+      26,    27,    28,    29,    30,    42,     7,    41,    30,    40,
+      30,    41,    38,     7,    33,   205,    17,    18,    19,    20,
+      21,    22,    23,    24,    25,    26,    27,    28,    29,    30,
+       7,    40,     7,    36,    36,     7,    36,    38,    36,    26,
+     232,    27,   234,   183,   236,    17,    18,    19,    20,    21,
+      22,    23,    24,    25,    26,    27,    28,    29,   184,   103,
+     252,   221,   254,    -1,   256,    -1,   258,   177,   229,   155,
+      -1,   160
 };
 
-/* YYSTOS[STATE-NUM] -- The (internal number of the) accessing
-   symbol of state STATE-NUM.  */
-static const yytype_uint8 yystos[] = {
-    0,     9,    10,    47,    48,   124,     3,     4,     5,     6,
-    35,    37,    41,    44,    45,    49,   108,   109,   112,   115,
-    120,   124,     0,    11,    12,    13,    14,    15,    16,    30,
-    50,    55,    56,    59,    61,    68,    36,   116,   113,   110,
-    3,     3,     7,     7,     7,    51,    54,    51,     7,    17,
-    18,    19,    20,    21,    22,    23,    24,    25,    26,    27,
-    28,    29,    57,    58,    82,    83,    84,    87,    88,    89,
-    90,    91,    92,   121,   122,    60,   124,    35,     3,     4,
-    5,     6,   108,   117,   119,   120,   108,   109,   114,   108,
-    111,    62,    69,    14,    31,    34,    35,     7,    35,    35,
-    35,    34,    41,    43,    34,    41,    41,    41,     7,     3,
-    8,   103,   104,   105,   124,    32,    32,    32,    32,    33,
-    36,    32,    33,    38,    33,    42,    39,    63,   124,    37,
-    32,    52,    53,    54,    54,     7,   103,   103,   103,   103,
-    105,     3,     4,     8,   102,   106,   107,   120,   124,   106,
-    105,   102,   102,   103,    36,    44,   105,   105,   105,   105,
-    118,   105,   108,   109,   108,     7,    64,    65,    37,    70,
-    124,    33,    36,    36,    36,    36,    42,    44,    42,    42,
-    42,   104,   119,    33,    66,   124,     7,    30,    38,    57,
-    71,    72,    73,    75,    76,    77,    81,    82,    54,   107,
-    65,     7,    30,    38,    67,    72,    85,    41,    93,    94,
-    30,    35,    40,    35,    40,    40,    40,    39,    30,   123,
-    124,    33,    42,    82,    83,    95,    97,    98,    99,    33,
-    42,   103,    78,   103,    79,   109,    74,     7,    86,     7,
-    86,    40,     7,    35,    40,    35,    40,    95,    36,   108,
-    36,   108,    80,   108,    96,   103,   100,   103,   101,   108,
-    108,    36,   108,    36,   108
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
+{
+       0,     9,    10,    47,    48,   124,     3,     4,     5,     6,
+      35,    37,    41,    44,    45,    49,   108,   109,   112,   115,
+     120,   124,     0,    11,    12,    13,    14,    15,    16,    30,
+      50,    55,    56,    59,    61,    68,    36,   116,   113,   110,
+       3,     3,     7,     7,     7,    51,    54,    51,     7,    17,
+      18,    19,    20,    21,    22,    23,    24,    25,    26,    27,
+      28,    29,    57,    58,    82,    83,    84,    87,    88,    89,
+      90,    91,    92,   121,   122,    60,   124,    35,     3,     4,
+       5,     6,   108,   117,   119,   120,   108,   109,   114,   108,
+     111,    62,    69,    14,    31,    34,    35,     7,    35,    35,
+      35,    34,    41,    43,    34,    41,    41,    41,     7,     3,
+       8,   103,   104,   105,   124,    32,    32,    32,    32,    33,
+      36,    32,    33,    38,    33,    42,    39,    63,   124,    37,
+      32,    52,    53,    54,    54,     7,   103,   103,   103,   103,
+     105,     3,     4,     8,   102,   106,   107,   120,   124,   106,
+     105,   102,   102,   103,    36,    44,   105,   105,   105,   105,
+     118,   105,   108,   109,   108,     7,    64,    65,    37,    70,
+     124,    33,    36,    36,    36,    36,    42,    44,    42,    42,
+      42,   104,   119,    33,    66,   124,     7,    30,    38,    57,
+      71,    72,    73,    75,    76,    77,    81,    82,    54,   107,
+      65,     7,    30,    38,    67,    72,    85,    41,    93,    94,
+      30,    35,    40,    35,    40,    40,    40,    39,    30,   123,
+     124,    33,    42,    82,    83,    95,    97,    98,    99,    33,
+      42,   103,    78,   103,    79,   109,    74,     7,    86,     7,
+      86,    40,     7,    35,    40,    35,    40,    95,    36,   108,
+      36,   108,    80,   108,    96,   103,   100,   103,   101,   108,
+     108,    36,   108,    36,   108
 };
 
-/* YYR1[YYN] -- Symbol number of symbol that rule YYN derives.  */
-static const yytype_uint8 yyr1[] = {
-    0,    46,    47,    47,    48,    48,    48,    48,    48,    48,
-    48,    49,    49,    49,    50,    50,    51,    51,    52,    52,
-    53,    53,    54,    54,    55,    56,    56,    57,    58,    59,
-    60,    60,    62,    61,    63,    63,    64,    64,    65,    66,
-    66,    66,    67,    67,    69,    68,    70,    70,    70,    71,
-    71,    72,    72,    72,    72,    73,    74,    73,    75,    76,
-    76,    78,    77,    79,    77,    80,    77,    81,    82,    82,
-    83,    83,    83,    84,    84,    84,    84,    85,    85,    86,
-    87,    87,    88,    88,    88,    88,    89,    90,    90,    90,
-    91,    92,    92,    93,    93,    94,    94,    95,    95,    95,
-    95,    96,    95,    97,    98,    98,   100,    99,   101,    99,
-    102,   102,   102,   103,   103,   103,   104,   104,   105,   106,
-    106,   106,   107,   107,   108,   108,   108,   108,   108,   108,
-    108,   110,   109,   111,   111,   113,   112,   114,   114,   114,
-    114,   115,   116,   115,   117,   118,   117,   119,   119,   119,
-    119,   119,   119,   120,   120,   121,   121,   122,   122,   122,
-    122,   122,   122,   122,   122,   122,   122,   122,   123,   123,
-    124
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
+{
+       0,    46,    47,    47,    48,    48,    48,    48,    48,    48,
+      48,    49,    49,    49,    50,    50,    51,    51,    52,    52,
+      53,    53,    54,    54,    55,    56,    56,    57,    58,    59,
+      60,    60,    62,    61,    63,    63,    64,    64,    65,    66,
+      66,    66,    67,    67,    69,    68,    70,    70,    70,    71,
+      71,    72,    72,    72,    72,    73,    74,    73,    75,    76,
+      76,    78,    77,    79,    77,    80,    77,    81,    82,    82,
+      83,    83,    83,    84,    84,    84,    84,    85,    85,    86,
+      87,    87,    88,    88,    88,    88,    89,    90,    90,    90,
+      91,    92,    92,    93,    93,    94,    94,    95,    95,    95,
+      95,    96,    95,    97,    98,    98,   100,    99,   101,    99,
+     102,   102,   102,   103,   103,   103,   104,   104,   105,   106,
+     106,   106,   107,   107,   108,   108,   108,   108,   108,   108,
+     108,   110,   109,   111,   111,   113,   112,   114,   114,   114,
+     114,   115,   116,   115,   117,   118,   117,   119,   119,   119,
+     119,   119,   119,   120,   120,   121,   121,   122,   122,   122,
+     122,   122,   122,   122,   122,   122,   122,   122,   123,   123,
+     124
 };
 
-/* YYR2[YYN] -- Number of symbols on the right hand side of rule YYN.  */
-static const yytype_uint8 yyr2[] = {
-    0,     2,     2,     2,     1,     2,     2,     2,     2,     2,
-    2,     1,     1,     1,     2,     4,     1,     3,     1,     1,
-    1,     3,     1,     3,     1,     2,     4,     2,     1,     2,
-    1,     2,     0,     7,     1,     2,     1,     3,     1,     1,
-    2,     3,     2,     1,     0,     6,     1,     2,     3,     1,
-    1,     1,     1,     1,     1,     1,     0,     4,     1,     4,
-    4,     0,     4,     0,     4,     0,     5,     2,     1,     1,
-    1,     1,     1,     4,     4,     4,     4,     3,     3,     1,
-    1,     4,     1,     1,     1,     1,     1,     4,     4,     4,
-    3,     3,     3,     2,     2,     2,     3,     1,     1,     1,
-    1,     0,     4,     2,     4,     4,     0,     4,     0,     4,
-    1,     1,     3,     1,     1,     3,     1,     1,     1,     1,
-    1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
-    1,     0,     4,     1,     3,     0,     4,     1,     1,     3,
-    3,     2,     0,     4,     1,     0,     4,     1,     3,     3,
-    3,     3,     3,     2,     2,     1,     1,     1,     1,     1,
-    1,     1,     1,     1,     1,     1,     1,     1,     1,     2,
-    0
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
+{
+       0,     2,     2,     2,     1,     2,     2,     2,     2,     2,
+       2,     1,     1,     1,     2,     4,     1,     3,     1,     1,
+       1,     3,     1,     3,     1,     2,     4,     2,     1,     2,
+       1,     2,     0,     7,     1,     2,     1,     3,     1,     1,
+       2,     3,     2,     1,     0,     6,     1,     2,     3,     1,
+       1,     1,     1,     1,     1,     1,     0,     4,     1,     4,
+       4,     0,     4,     0,     4,     0,     5,     2,     1,     1,
+       1,     1,     1,     4,     4,     4,     4,     3,     3,     1,
+       1,     4,     1,     1,     1,     1,     1,     4,     4,     4,
+       3,     3,     3,     2,     2,     2,     3,     1,     1,     1,
+       1,     0,     4,     2,     4,     4,     0,     4,     0,     4,
+       1,     1,     3,     1,     1,     3,     1,     1,     1,     1,
+       1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
+       1,     0,     4,     1,     3,     0,     4,     1,     1,     3,
+       3,     2,     0,     4,     1,     0,     4,     1,     3,     3,
+       3,     3,     3,     2,     2,     1,     1,     1,     1,     1,
+       1,     1,     1,     1,     1,     1,     1,     1,     1,     2,
+       0
 };
 
 
+enum { YYENOMEM = -2 };
+
 #define yyerrok         (yyerrstatus = 0)
-#define yyclearin       (yychar = YYEMPTY)
-#define YYEMPTY         (-2)
-#define YYEOF           0
+#define yyclearin       (yychar = DCEMPTY)
 
 #define YYACCEPT        goto yyacceptlab
 #define YYABORT         goto yyabortlab
 #define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
 
 
 #define YYRECOVERING()  (!!yyerrstatus)
 
-#define YYBACKUP(Token, Value)                                  \
-do                                                              \
-  if (yychar == YYEMPTY)                                        \
-    {                                                           \
-      yychar = (Token);                                         \
-      yylval = (Value);                                         \
-      YYPOPSTACK (yylen);                                       \
-      yystate = *yyssp;                                         \
-      goto yybackup;                                            \
-    }                                                           \
-  else                                                          \
-    {                                                           \
-      yyerror (YY_("syntax error: cannot back up")); \
-      YYERROR;                                                  \
-    }                                                           \
-while (0)
-
-/* Error token number */
-#define YYTERROR        1
-#define YYERRCODE       256
-
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == DCEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (scanner, state, YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use DCerror or DCUNDEF. */
+#define YYERRCODE DCUNDEF
 
 
 /* Enable debugging if requested.  */
@@ -855,55 +1087,54 @@ do {                                            \
     YYFPRINTF Args;                             \
 } while (0)
 
-/* This macro is provided for backward compatibility. */
-#ifndef YY_LOCATION_PRINT
-# define YY_LOCATION_PRINT(File, Loc) ((void) 0)
-#endif
 
 
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)                    \
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
 do {                                                                      \
   if (yydebug)                                                            \
     {                                                                     \
       YYFPRINTF (stderr, "%s ", Title);                                   \
       yy_symbol_print (stderr,                                            \
-                  Type, Value); \
+                  Kind, Value, scanner, state); \
       YYFPRINTF (stderr, "\n");                                           \
     }                                                                     \
 } while (0)
 
 
-/*----------------------------------------.
-| Print this symbol's value on YYOUTPUT.  |
-`----------------------------------------*/
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
 
 static void
-yy_symbol_value_print(FILE *yyoutput, int yytype, YYSTYPE const *const yyvaluep)
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, void* scanner, bamboo::ParserState* state)
 {
-    FILE *yyo = yyoutput;
-    YYUSE(yyo);
-    if(!yyvaluep)
-        return;
-# ifdef YYPRINT
-    if(yytype < YYNTOKENS)
-        YYPRINT(yyoutput, yytoknum[yytype], *yyvaluep);
-# endif
-    YYUSE(yytype);
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  YY_USE (scanner);
+  YY_USE (state);
+  if (!yyvaluep)
+    return;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
-/*--------------------------------.
-| Print this symbol on YYOUTPUT.  |
-`--------------------------------*/
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
 
 static void
-yy_symbol_print(FILE *yyoutput, int yytype, YYSTYPE const *const yyvaluep)
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, void* scanner, bamboo::ParserState* state)
 {
-    YYFPRINTF(yyoutput, "%s %s (",
-              yytype < YYNTOKENS ? "token" : "nterm", yytname[yytype]);
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
 
-    yy_symbol_value_print(yyoutput, yytype, yyvaluep);
-    YYFPRINTF(yyoutput, ")");
+  yy_symbol_value_print (yyo, yykind, yyvaluep, scanner, state);
+  YYFPRINTF (yyo, ")");
 }
 
 /*------------------------------------------------------------------.
@@ -912,14 +1143,15 @@ yy_symbol_print(FILE *yyoutput, int yytype, YYSTYPE const *const yyvaluep)
 `------------------------------------------------------------------*/
 
 static void
-yy_stack_print(yytype_int16 *yybottom, yytype_int16 *yytop)
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
 {
-    YYFPRINTF(stderr, "Stack now");
-    for(; yybottom <= yytop; yybottom++) {
-        int yybot = *yybottom;
-        YYFPRINTF(stderr, " %d", yybot);
+  YYFPRINTF (stderr, "Stack now");
+  for (; yybottom <= yytop; yybottom++)
+    {
+      int yybot = *yybottom;
+      YYFPRINTF (stderr, " %d", yybot);
     }
-    YYFPRINTF(stderr, "\n");
+  YYFPRINTF (stderr, "\n");
 }
 
 # define YY_STACK_PRINT(Bottom, Top)                            \
@@ -934,36 +1166,37 @@ do {                                                            \
 `------------------------------------------------*/
 
 static void
-yy_reduce_print(yytype_int16 *yyssp, YYSTYPE *yyvsp, int yyrule)
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule, void* scanner, bamboo::ParserState* state)
 {
-    unsigned long int yylno = yyrline[yyrule];
-    int yynrhs = yyr2[yyrule];
-    int yyi;
-    YYFPRINTF(stderr, "Reducing stack by rule %d (line %lu):\n",
-              yyrule - 1, yylno);
-    /* The symbols being reduced.  */
-    for(yyi = 0; yyi < yynrhs; yyi++) {
-        YYFPRINTF(stderr, "   $%d = ", yyi + 1);
-        yy_symbol_print(stderr,
-                        yystos[yyssp[yyi + 1 - yynrhs]],
-                        &(yyvsp[(yyi + 1) - (yynrhs)])
-                       );
-        YYFPRINTF(stderr, "\n");
+  int yylno = yyrline[yyrule];
+  int yynrhs = yyr2[yyrule];
+  int yyi;
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
+  /* The symbols being reduced.  */
+  for (yyi = 0; yyi < yynrhs; yyi++)
+    {
+      YYFPRINTF (stderr, "   $%d = ", yyi + 1);
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)], scanner, state);
+      YYFPRINTF (stderr, "\n");
     }
 }
 
 # define YY_REDUCE_PRINT(Rule)          \
 do {                                    \
   if (yydebug)                          \
-    yy_reduce_print (yyssp, yyvsp, Rule); \
+    yy_reduce_print (yyssp, yyvsp, Rule, scanner, state); \
 } while (0)
 
 /* Nonzero means print parse trace.  It is left uninitialized so that
    multiple parsers can coexist.  */
 int yydebug;
 #else /* !DCDEBUG */
-# define YYDPRINTF(Args)
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
 # define YY_STACK_PRINT(Bottom, Top)
 # define YY_REDUCE_PRINT(Rule)
 #endif /* !DCDEBUG */
@@ -986,45 +1219,93 @@ int yydebug;
 #endif
 
 
-#if YYERROR_VERBOSE
+/* Context of a parse error.  */
+typedef struct
+{
+  yy_state_t *yyssp;
+  yysymbol_kind_t yytoken;
+} yypcontext_t;
+
+/* Put in YYARG at most YYARGN of the expected tokens given the
+   current YYCTX, and return the number of tokens stored in YYARG.  If
+   YYARG is null, return the number of expected tokens (guaranteed to
+   be less than YYNTOKENS).  Return YYENOMEM on memory exhaustion.
+   Return 0 if there are more than YYARGN expected tokens, yet fill
+   YYARG up to YYARGN. */
+static int
+yypcontext_expected_tokens (const yypcontext_t *yyctx,
+                            yysymbol_kind_t yyarg[], int yyargn)
+{
+  /* Actual size of YYARG. */
+  int yycount = 0;
+  int yyn = yypact[+*yyctx->yyssp];
+  if (!yypact_value_is_default (yyn))
+    {
+      /* Start YYX at -YYN if negative to avoid negative indexes in
+         YYCHECK.  In other words, skip the first -YYN actions for
+         this state because they are default actions.  */
+      int yyxbegin = yyn < 0 ? -yyn : 0;
+      /* Stay within bounds of both yycheck and yytname.  */
+      int yychecklim = YYLAST - yyn + 1;
+      int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
+      int yyx;
+      for (yyx = yyxbegin; yyx < yyxend; ++yyx)
+        if (yycheck[yyx + yyn] == yyx && yyx != YYSYMBOL_YYerror
+            && !yytable_value_is_error (yytable[yyx + yyn]))
+          {
+            if (!yyarg)
+              ++yycount;
+            else if (yycount == yyargn)
+              return 0;
+            else
+              yyarg[yycount++] = YY_CAST (yysymbol_kind_t, yyx);
+          }
+    }
+  if (yyarg && yycount == 0 && 0 < yyargn)
+    yyarg[0] = YYSYMBOL_YYEMPTY;
+  return yycount;
+}
+
+
 
-# ifndef yystrlen
-#  if defined __GLIBC__ && defined _STRING_H
-#   define yystrlen strlen
-#  else
+
+#ifndef yystrlen
+# if defined __GLIBC__ && defined _STRING_H
+#  define yystrlen(S) (YY_CAST (YYPTRDIFF_T, strlen (S)))
+# else
 /* Return the length of YYSTR.  */
-static YYSIZE_T
-yystrlen(const char *yystr)
+static YYPTRDIFF_T
+yystrlen (const char *yystr)
 {
-    YYSIZE_T yylen;
-    for(yylen = 0; yystr[yylen]; yylen++)
-        continue;
-    return yylen;
+  YYPTRDIFF_T yylen;
+  for (yylen = 0; yystr[yylen]; yylen++)
+    continue;
+  return yylen;
 }
-#  endif
 # endif
+#endif
 
-# ifndef yystpcpy
-#  if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
-#   define yystpcpy stpcpy
-#  else
+#ifndef yystpcpy
+# if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
+#  define yystpcpy stpcpy
+# else
 /* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
    YYDEST.  */
 static char *
-yystpcpy(char *yydest, const char *yysrc)
+yystpcpy (char *yydest, const char *yysrc)
 {
-    char *yyd = yydest;
-    const char *yys = yysrc;
+  char *yyd = yydest;
+  const char *yys = yysrc;
 
-    while((*yyd++ = *yys++) != '\0')
-        continue;
+  while ((*yyd++ = *yys++) != '\0')
+    continue;
 
-    return yyd - 1;
+  return yyd - 1;
 }
-#  endif
 # endif
+#endif
 
-# ifndef yytnamerr
+#ifndef yytnamerr
 /* Copy to YYRES the contents of YYSTR after stripping away unnecessary
    quotes and backslashes, so that it's suitable for yyerror.  The
    heuristic is that double-quoting is unnecessary unless the string
@@ -1032,199 +1313,206 @@ yystpcpy(char *yydest, const char *yysrc)
    backslash-backslash).  YYSTR is taken from yytname.  If YYRES is
    null, do not copy; instead, return the length of what the result
    would have been.  */
-static YYSIZE_T
-yytnamerr(char *yyres, const char *yystr)
+static YYPTRDIFF_T
+yytnamerr (char *yyres, const char *yystr)
 {
-    if(*yystr == '"') {
-        YYSIZE_T yyn = 0;
-        char const *yyp = yystr;
-
-        for(;;)
-            switch(*++yyp) {
-            case '\'':
-            case ',':
-                goto do_not_strip_quotes;
-
-            case '\\':
-                if(*++yyp != '\\')
-                    goto do_not_strip_quotes;
-            /* Fall through.  */
-            default:
-                if(yyres)
-                    yyres[yyn] = *yyp;
-                yyn++;
-                break;
+  if (*yystr == '"')
+    {
+      YYPTRDIFF_T yyn = 0;
+      char const *yyp = yystr;
+      for (;;)
+        switch (*++yyp)
+          {
+          case '\'':
+          case ',':
+            goto do_not_strip_quotes;
+
+          case '\\':
+            if (*++yyp != '\\')
+              goto do_not_strip_quotes;
+            else
+              goto append;
+
+          append:
+          default:
+            if (yyres)
+              yyres[yyn] = *yyp;
+            yyn++;
+            break;
 
-            case '"':
-                if(yyres)
-                    yyres[yyn] = '\0';
-                return yyn;
-            }
-    do_not_strip_quotes:
-        ;
+          case '"':
+            if (yyres)
+              yyres[yyn] = '\0';
+            return yyn;
+          }
+    do_not_strip_quotes: ;
     }
 
-    if(! yyres)
-        return yystrlen(yystr);
+  if (yyres)
+    return yystpcpy (yyres, yystr) - yyres;
+  else
+    return yystrlen (yystr);
+}
+#endif
+
 
-    return yystpcpy(yyres, yystr) - yyres;
+static int
+yy_syntax_error_arguments (const yypcontext_t *yyctx,
+                           yysymbol_kind_t yyarg[], int yyargn)
+{
+  /* Actual size of YYARG. */
+  int yycount = 0;
+  /* There are many possibilities here to consider:
+     - If this state is a consistent state with a default action, then
+       the only way this function was invoked is if the default action
+       is an error action.  In that case, don't check for expected
+       tokens because there are none.
+     - The only way there can be no lookahead present (in yychar) is if
+       this state is a consistent state with a default action.  Thus,
+       detecting the absence of a lookahead is sufficient to determine
+       that there is no unexpected or expected token to report.  In that
+       case, just report a simple "syntax error".
+     - Don't assume there isn't a lookahead just because this state is a
+       consistent state with a default action.  There might have been a
+       previous inconsistent state, consistent state with a non-default
+       action, or user semantic action that manipulated yychar.
+     - Of course, the expected token list depends on states to have
+       correct lookahead information, and it depends on the parser not
+       to perform extra reductions after fetching a lookahead from the
+       scanner and before detecting a syntax error.  Thus, state merging
+       (from LALR or IELR) and default reductions corrupt the expected
+       token list.  However, the list is correct for canonical LR with
+       one exception: it will still contain any token that will not be
+       accepted due to an error action in a later state.
+  */
+  if (yyctx->yytoken != YYSYMBOL_YYEMPTY)
+    {
+      int yyn;
+      if (yyarg)
+        yyarg[yycount] = yyctx->yytoken;
+      ++yycount;
+      yyn = yypcontext_expected_tokens (yyctx,
+                                        yyarg ? yyarg + 1 : yyarg, yyargn - 1);
+      if (yyn == YYENOMEM)
+        return YYENOMEM;
+      else
+        yycount += yyn;
+    }
+  return yycount;
 }
-# endif
 
 /* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
    about the unexpected token YYTOKEN for the state stack whose top is
    YYSSP.
 
-   Return 0 if *YYMSG was successfully written.  Return 1 if *YYMSG is
+   Return 0 if *YYMSG was successfully written.  Return -1 if *YYMSG is
    not large enough to hold the message.  In that case, also set
-   *YYMSG_ALLOC to the required number of bytes.  Return 2 if the
+   *YYMSG_ALLOC to the required number of bytes.  Return YYENOMEM if the
    required number of bytes is too large to store.  */
 static int
-yysyntax_error(YYSIZE_T *yymsg_alloc, char **yymsg,
-               yytype_int16 *yyssp, int yytoken)
+yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
+                const yypcontext_t *yyctx)
 {
-    YYSIZE_T yysize0 = yytnamerr(YY_NULLPTR, yytname[yytoken]);
-    YYSIZE_T yysize = yysize0;
-    enum { YYERROR_VERBOSE_ARGS_MAXIMUM = 5 };
-    /* Internationalized format string. */
-    const char *yyformat = YY_NULLPTR;
-    /* Arguments of yyformat. */
-    char const *yyarg[YYERROR_VERBOSE_ARGS_MAXIMUM];
-    /* Number of reported tokens (one for the "unexpected", one per
-       "expected"). */
-    int yycount = 0;
-
-    /* There are many possibilities here to consider:
-       - If this state is a consistent state with a default action, then
-         the only way this function was invoked is if the default action
-         is an error action.  In that case, don't check for expected
-         tokens because there are none.
-       - The only way there can be no lookahead present (in yychar) is if
-         this state is a consistent state with a default action.  Thus,
-         detecting the absence of a lookahead is sufficient to determine
-         that there is no unexpected or expected token to report.  In that
-         case, just report a simple "syntax error".
-       - Don't assume there isn't a lookahead just because this state is a
-         consistent state with a default action.  There might have been a
-         previous inconsistent state, consistent state with a non-default
-         action, or user semantic action that manipulated yychar.
-       - Of course, the expected token list depends on states to have
-         correct lookahead information, and it depends on the parser not
-         to perform extra reductions after fetching a lookahead from the
-         scanner and before detecting a syntax error.  Thus, state merging
-         (from LALR or IELR) and default reductions corrupt the expected
-         token list.  However, the list is correct for canonical LR with
-         one exception: it will still contain any token that will not be
-         accepted due to an error action in a later state.
-    */
-    if(yytoken != YYEMPTY) {
-        int yyn = yypact[*yyssp];
-        yyarg[yycount++] = yytname[yytoken];
-        if(!yypact_value_is_default(yyn)) {
-            /* Start YYX at -YYN if negative to avoid negative indexes in
-               YYCHECK.  In other words, skip the first -YYN actions for
-               this state because they are default actions.  */
-            int yyxbegin = yyn < 0 ? -yyn : 0;
-            /* Stay within bounds of both yycheck and yytname.  */
-            int yychecklim = YYLAST - yyn + 1;
-            int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
-            int yyx;
-
-            for(yyx = yyxbegin; yyx < yyxend; ++yyx)
-                if(yycheck[yyx + yyn] == yyx && yyx != YYTERROR
-                   && !yytable_value_is_error(yytable[yyx + yyn])) {
-                    if(yycount == YYERROR_VERBOSE_ARGS_MAXIMUM) {
-                        yycount = 1;
-                        yysize = yysize0;
-                        break;
-                    }
-                    yyarg[yycount++] = yytname[yyx];
-                    {
-                        YYSIZE_T yysize1 = yysize + yytnamerr(YY_NULLPTR, yytname[yyx]);
-                        if(!(yysize <= yysize1
-                             && yysize1 <= YYSTACK_ALLOC_MAXIMUM))
-                            return 2;
-                        yysize = yysize1;
-                    }
-                }
-        }
-    }
-
-    switch(yycount) {
-# define YYCASE_(N, S)                      \
+  enum { YYARGS_MAX = 5 };
+  /* Internationalized format string. */
+  const char *yyformat = YY_NULLPTR;
+  /* Arguments of yyformat: reported tokens (one for the "unexpected",
+     one per "expected"). */
+  yysymbol_kind_t yyarg[YYARGS_MAX];
+  /* Cumulated lengths of YYARG.  */
+  YYPTRDIFF_T yysize = 0;
+
+  /* Actual size of YYARG. */
+  int yycount = yy_syntax_error_arguments (yyctx, yyarg, YYARGS_MAX);
+  if (yycount == YYENOMEM)
+    return YYENOMEM;
+
+  switch (yycount)
+    {
+#define YYCASE_(N, S)                       \
       case N:                               \
         yyformat = S;                       \
-      break
-        YYCASE_(0, YY_("syntax error"));
-        YYCASE_(1, YY_("syntax error, unexpected %s"));
-        YYCASE_(2, YY_("syntax error, unexpected %s, expecting %s"));
-        YYCASE_(3, YY_("syntax error, unexpected %s, expecting %s or %s"));
-        YYCASE_(4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
-        YYCASE_(5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
-# undef YYCASE_
-    }
-
-    {
-        YYSIZE_T yysize1 = yysize + yystrlen(yyformat);
-        if(!(yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM))
-            return 2;
-        yysize = yysize1;
-    }
-
-    if(*yymsg_alloc < yysize) {
-        *yymsg_alloc = 2 * yysize;
-        if(!(yysize <= *yymsg_alloc
+        break
+    default: /* Avoid compiler warnings. */
+      YYCASE_(0, YY_("syntax error"));
+      YYCASE_(1, YY_("syntax error, unexpected %s"));
+      YYCASE_(2, YY_("syntax error, unexpected %s, expecting %s"));
+      YYCASE_(3, YY_("syntax error, unexpected %s, expecting %s or %s"));
+      YYCASE_(4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
+      YYCASE_(5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
+#undef YYCASE_
+    }
+
+  /* Compute error message size.  Don't count the "%s"s, but reserve
+     room for the terminator.  */
+  yysize = yystrlen (yyformat) - 2 * yycount + 1;
+  {
+    int yyi;
+    for (yyi = 0; yyi < yycount; ++yyi)
+      {
+        YYPTRDIFF_T yysize1
+          = yysize + yytnamerr (YY_NULLPTR, yytname[yyarg[yyi]]);
+        if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
+          yysize = yysize1;
+        else
+          return YYENOMEM;
+      }
+  }
+
+  if (*yymsg_alloc < yysize)
+    {
+      *yymsg_alloc = 2 * yysize;
+      if (! (yysize <= *yymsg_alloc
              && *yymsg_alloc <= YYSTACK_ALLOC_MAXIMUM))
-            *yymsg_alloc = YYSTACK_ALLOC_MAXIMUM;
-        return 1;
-    }
-
-    /* Avoid sprintf, as that infringes on the user's name space.
-       Don't have undefined behavior even if the translation
-       produced a string with the wrong number of "%s"s.  */
-    {
-        char *yyp = *yymsg;
-        int yyi = 0;
-        while((*yyp = *yyformat) != '\0')
-            if(*yyp == '%' && yyformat[1] == 's' && yyi < yycount) {
-                yyp += yytnamerr(yyp, yyarg[yyi++]);
-                yyformat += 2;
-            } else {
-                yyp++;
-                yyformat++;
-            }
-    }
-    return 0;
+        *yymsg_alloc = YYSTACK_ALLOC_MAXIMUM;
+      return -1;
+    }
+
+  /* Avoid sprintf, as that infringes on the user's name space.
+     Don't have undefined behavior even if the translation
+     produced a string with the wrong number of "%s"s.  */
+  {
+    char *yyp = *yymsg;
+    int yyi = 0;
+    while ((*yyp = *yyformat) != '\0')
+      if (*yyp == '%' && yyformat[1] == 's' && yyi < yycount)
+        {
+          yyp += yytnamerr (yyp, yytname[yyarg[yyi++]]);
+          yyformat += 2;
+        }
+      else
+        {
+          ++yyp;
+          ++yyformat;
+        }
+  }
+  return 0;
 }
-#endif /* YYERROR_VERBOSE */
+
 
 /*-----------------------------------------------.
 | Release the memory associated to this symbol.  |
 `-----------------------------------------------*/
 
 static void
-yydestruct(const char *yymsg, int yytype, YYSTYPE *yyvaluep)
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, void* scanner, bamboo::ParserState* state)
 {
-    YYUSE(yyvaluep);
-    if(!yymsg)
-        yymsg = "Deleting";
-    YY_SYMBOL_PRINT(yymsg, yytype, yyvaluep, yylocationp);
-
-    YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-    YYUSE(yytype);
-    YY_IGNORE_MAYBE_UNINITIALIZED_END
+  YY_USE (yyvaluep);
+  YY_USE (scanner);
+  YY_USE (state);
+  if (!yymsg)
+    yymsg = "Deleting";
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
 
 
-/* The lookahead symbol.  */
-int yychar;
-
-/* The semantic value of the lookahead symbol.  */
-YYSTYPE yylval;
-/* Number of syntax errors so far.  */
-int yynerrs;
 
 
 /*----------.
@@ -1232,1338 +1520,1268 @@ int yynerrs;
 `----------*/
 
 int
-yyparse(void)
+yyparse (void* scanner, bamboo::ParserState* state)
 {
-    int yystate;
-    /* Number of tokens to shift before error messages enabled.  */
-    int yyerrstatus;
+/* Lookahead token kind.  */
+int yychar;
+
+
+/* The semantic value of the lookahead symbol.  */
+/* Default value used for initialization, for pacifying older GCCs
+   or non-GCC compilers.  */
+YY_INITIAL_VALUE (static YYSTYPE yyval_default;)
+YYSTYPE yylval YY_INITIAL_VALUE (= yyval_default);
+
+    /* Number of syntax errors so far.  */
+    int yynerrs = 0;
 
-    /* The stacks and their tools:
-       'yyss': related to states.
-       'yyvs': related to semantic values.
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
 
-       Refer to the stacks through separate pointers, to allow yyoverflow
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
        to reallocate them elsewhere.  */
 
-    /* The state stack.  */
-    yytype_int16 yyssa[YYINITDEPTH];
-    yytype_int16 *yyss;
-    yytype_int16 *yyssp;
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
+
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
 
-    /* The semantic value stack.  */
+    /* The semantic value stack: array, bottom, top.  */
     YYSTYPE yyvsa[YYINITDEPTH];
-    YYSTYPE *yyvs;
-    YYSTYPE *yyvsp;
-
-    YYSIZE_T yystacksize;
-
-    int yyn;
-    int yyresult;
-    /* Lookahead token as an internal (translated) token number.  */
-    int yytoken = 0;
-    /* The variables used to return semantic value and location from the
-       action routines.  */
-    YYSTYPE yyval;
-
-#if YYERROR_VERBOSE
-    /* Buffer for error messages, and its allocated size.  */
-    char yymsgbuf[128];
-    char *yymsg = yymsgbuf;
-    YYSIZE_T yymsg_alloc = sizeof yymsgbuf;
-#endif
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
+
+  int yyn;
+  /* The return value of yyparse.  */
+  int yyresult;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
+  /* The variables used to return semantic value and location from the
+     action routines.  */
+  YYSTYPE yyval;
+
+  /* Buffer for error messages, and its allocated size.  */
+  char yymsgbuf[128];
+  char *yymsg = yymsgbuf;
+  YYPTRDIFF_T yymsg_alloc = sizeof yymsgbuf;
 
 #define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
 
-    /* The number of symbols on the RHS of the reduced rule.
-       Keep to zero when no symbol should be popped.  */
-    int yylen = 0;
+  /* The number of symbols on the RHS of the reduced rule.
+     Keep to zero when no symbol should be popped.  */
+  int yylen = 0;
+
+  YYDPRINTF ((stderr, "Starting parse\n"));
 
-    yyssp = yyss = yyssa;
-    yyvsp = yyvs = yyvsa;
-    yystacksize = YYINITDEPTH;
+  yychar = DCEMPTY; /* Cause a token to be read.  */
 
-    YYDPRINTF((stderr, "Starting parse\n"));
+  goto yysetstate;
 
-    yystate = 0;
-    yyerrstatus = 0;
-    yynerrs = 0;
-    yychar = YYEMPTY; /* Cause a token to be read.  */
-    goto yysetstate;
 
-    /*------------------------------------------------------------.
-    | yynewstate -- Push a new state, which is found in yystate.  |
-    `------------------------------------------------------------*/
+/*------------------------------------------------------------.
+| yynewstate -- push a new state, which is found in yystate.  |
+`------------------------------------------------------------*/
 yynewstate:
-    /* In all cases, when you get here, the value and location stacks
-       have just been pushed.  So pushing a state here evens the stacks.  */
-    yyssp++;
+  /* In all cases, when you get here, the value and location stacks
+     have just been pushed.  So pushing a state here evens the stacks.  */
+  yyssp++;
 
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
 yysetstate:
-    *yyssp = yystate;
-
-    if(yyss + yystacksize - 1 <= yyssp) {
-        /* Get the current used size of the three stacks, in elements.  */
-        YYSIZE_T yysize = yyssp - yyss + 1;
-
-#ifdef yyoverflow
-        {
-            /* Give user a chance to reallocate the stack.  Use copies of
-               these so that the &'s don't force the real ones into
-               memory.  */
-            YYSTYPE *yyvs1 = yyvs;
-            yytype_int16 *yyss1 = yyss;
-
-            /* Each stack pointer address is followed by the size of the
-               data in use in that stack, in bytes.  This used to be a
-               conditional around just the two extra args, but that might
-               be undefined if yyoverflow is a macro.  */
-            yyoverflow(YY_("memory exhausted"),
-                       &yyss1, yysize * sizeof(*yyssp),
-                       &yyvs1, yysize * sizeof(*yyvsp),
-                       &yystacksize);
-
-            yyss = yyss1;
-            yyvs = yyvs1;
-        }
-#else /* no yyoverflow */
-# ifndef YYSTACK_RELOCATE
-        goto yyexhaustedlab;
-# else
-        /* Extend the stack our own way.  */
-        if(YYMAXDEPTH <= yystacksize)
-            goto yyexhaustedlab;
-        yystacksize *= 2;
-        if(YYMAXDEPTH < yystacksize)
-            yystacksize = YYMAXDEPTH;
-
-        {
-            yytype_int16 *yyss1 = yyss;
-            union yyalloc *yyptr =
-                        (union yyalloc *) YYSTACK_ALLOC(YYSTACK_BYTES(yystacksize));
-            if(! yyptr)
-                goto yyexhaustedlab;
-            YYSTACK_RELOCATE(yyss_alloc, yyss);
-            YYSTACK_RELOCATE(yyvs_alloc, yyvs);
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
+
+  if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
+    {
+      /* Get the current used size of the three stacks, in elements.  */
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
+
+# if defined yyoverflow
+      {
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
+      }
+# else /* defined YYSTACK_RELOCATE */
+      /* Extend the stack our own way.  */
+      if (YYMAXDEPTH <= yystacksize)
+        YYNOMEM;
+      yystacksize *= 2;
+      if (YYMAXDEPTH < yystacksize)
+        yystacksize = YYMAXDEPTH;
+
+      {
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
 #  undef YYSTACK_RELOCATE
-            if(yyss1 != yyssa)
-                YYSTACK_FREE(yyss1);
-        }
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
+      }
 # endif
-#endif /* no yyoverflow */
 
-        yyssp = yyss + yysize - 1;
-        yyvsp = yyvs + yysize - 1;
+      yyssp = yyss + yysize - 1;
+      yyvsp = yyvs + yysize - 1;
 
-        YYDPRINTF((stderr, "Stack size increased to %lu\n",
-                   (unsigned long int) yystacksize));
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
 
-        if(yyss + yystacksize - 1 <= yyssp)
-            YYABORT;
+      if (yyss + yystacksize - 1 <= yyssp)
+        YYABORT;
     }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
 
-    YYDPRINTF((stderr, "Entering state %d\n", yystate));
 
-    if(yystate == YYFINAL)
-        YYACCEPT;
+  if (yystate == YYFINAL)
+    YYACCEPT;
 
-    goto yybackup;
+  goto yybackup;
 
-    /*-----------.
-    | yybackup.  |
-    `-----------*/
-yybackup:
 
-    /* Do appropriate processing given the current state.  Read a
-       lookahead token if we need one and don't already have one.  */
+/*-----------.
+| yybackup.  |
+`-----------*/
+yybackup:
+  /* Do appropriate processing given the current state.  Read a
+     lookahead token if we need one and don't already have one.  */
 
-    /* First try to decide what to do without reference to lookahead token.  */
-    yyn = yypact[yystate];
-    if(yypact_value_is_default(yyn))
-        goto yydefault;
+  /* First try to decide what to do without reference to lookahead token.  */
+  yyn = yypact[yystate];
+  if (yypact_value_is_default (yyn))
+    goto yydefault;
 
-    /* Not known => get a lookahead token if don't already have one.  */
+  /* Not known => get a lookahead token if don't already have one.  */
 
-    /* YYCHAR is either YYEMPTY or YYEOF or a valid lookahead symbol.  */
-    if(yychar == YYEMPTY) {
-        YYDPRINTF((stderr, "Reading a token: "));
-        yychar = yylex();
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
+  if (yychar == DCEMPTY)
+    {
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex (&yylval, scanner);
     }
 
-    if(yychar <= YYEOF) {
-        yychar = yytoken = YYEOF;
-        YYDPRINTF((stderr, "Now at end of input.\n"));
-    } else {
-        yytoken = YYTRANSLATE(yychar);
-        YY_SYMBOL_PRINT("Next token is", yytoken, &yylval, &yylloc);
+  if (yychar <= DCEOF)
+    {
+      yychar = DCEOF;
+      yytoken = YYSYMBOL_YYEOF;
+      YYDPRINTF ((stderr, "Now at end of input.\n"));
     }
-
-    /* If the proper action on seeing token YYTOKEN is to reduce or to
-       detect an error, take that action.  */
-    yyn += yytoken;
-    if(yyn < 0 || YYLAST < yyn || yycheck[yyn] != yytoken)
-        goto yydefault;
-    yyn = yytable[yyn];
-    if(yyn <= 0) {
-        if(yytable_value_is_error(yyn))
-            goto yyerrlab;
-        yyn = -yyn;
-        goto yyreduce;
+  else if (yychar == DCerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = DCUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
+  else
+    {
+      yytoken = YYTRANSLATE (yychar);
+      YY_SYMBOL_PRINT ("Next token is", yytoken, &yylval, &yylloc);
     }
 
-    /* Count tokens shifted since error; after three, turn off error
-       status.  */
-    if(yyerrstatus)
-        yyerrstatus--;
-
-    /* Shift the lookahead token.  */
-    YY_SYMBOL_PRINT("Shifting", yytoken, &yylval, &yylloc);
+  /* If the proper action on seeing token YYTOKEN is to reduce or to
+     detect an error, take that action.  */
+  yyn += yytoken;
+  if (yyn < 0 || YYLAST < yyn || yycheck[yyn] != yytoken)
+    goto yydefault;
+  yyn = yytable[yyn];
+  if (yyn <= 0)
+    {
+      if (yytable_value_is_error (yyn))
+        goto yyerrlab;
+      yyn = -yyn;
+      goto yyreduce;
+    }
 
-    /* Discard the shifted token.  */
-    yychar = YYEMPTY;
+  /* Count tokens shifted since error; after three, turn off error
+     status.  */
+  if (yyerrstatus)
+    yyerrstatus--;
 
-    yystate = yyn;
-    YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-    *++yyvsp = yylval;
-    YY_IGNORE_MAYBE_UNINITIALIZED_END
+  /* Shift the lookahead token.  */
+  YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
+  yystate = yyn;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 
-    goto yynewstate;
+  /* Discard the shifted token.  */
+  yychar = DCEMPTY;
+  goto yynewstate;
 
 
-    /*-----------------------------------------------------------.
-    | yydefault -- do the default action for the current state.  |
-    `-----------------------------------------------------------*/
+/*-----------------------------------------------------------.
+| yydefault -- do the default action for the current state.  |
+`-----------------------------------------------------------*/
 yydefault:
-    yyn = yydefact[yystate];
-    if(yyn == 0)
-        goto yyerrlab;
-    goto yyreduce;
+  yyn = yydefact[yystate];
+  if (yyn == 0)
+    goto yyerrlab;
+  goto yyreduce;
 
 
-    /*-----------------------------.
-    | yyreduce -- Do a reduction.  |
-    `-----------------------------*/
+/*-----------------------------.
+| yyreduce -- do a reduction.  |
+`-----------------------------*/
 yyreduce:
-    /* yyn is the number of a rule to reduce with.  */
-    yylen = yyr2[yyn];
+  /* yyn is the number of a rule to reduce with.  */
+  yylen = yyr2[yyn];
 
-    /* If YYLEN is nonzero, implement the default value of the action:
-       '$$ = $1'.
+  /* If YYLEN is nonzero, implement the default value of the action:
+     '$$ = $1'.
 
-       Otherwise, the following line sets YYVAL to garbage.
-       This behavior is undocumented and Bison
-       users should not rely upon it.  Assigning to YYVAL
-       unconditionally makes the parser a bit smaller, and it avoids a
-       GCC warning that YYVAL may be used uninitialized.  */
-    yyval = yyvsp[1 - yylen];
+     Otherwise, the following line sets YYVAL to garbage.
+     This behavior is undocumented and Bison
+     users should not rely upon it.  Assigning to YYVAL
+     unconditionally makes the parser a bit smaller, and it avoids a
+     GCC warning that YYVAL may be used uninitialized.  */
+  yyval = yyvsp[1-yylen];
 
 
-    YY_REDUCE_PRINT(yyn);
-    switch(yyn) {
-    case 11:
-
+  YY_REDUCE_PRINT (yyn);
+  switch (yyn)
     {
-        parsed_value->clear();
+  case 11: /* value: empty  */
+        {
+        state->value->clear();
     }
-
     break;
 
-    case 12:
-
-    {
-        parsed_value->assign((yyvsp[0].buffer).begin(), (yyvsp[0].buffer).end());
-        if(!type_stack.empty()) depth_error(0, "type");
+  case 12: /* value: type_value  */
+        {
+        state->value->assign((yyvsp[0].buffer).begin(), (yyvsp[0].buffer).end());
+        if(!state->type_stack.empty()) depth_error(scanner, state, 0, "type");
     }
-
     break;
 
-    case 13:
-
-    {
-        parsed_value->assign((yyvsp[0].buffer).begin(), (yyvsp[0].buffer).end());
-        if(!type_stack.empty()) depth_error(0, "method");
+  case 13: /* value: method_value  */
+        {
+        state->value->assign((yyvsp[0].buffer).begin(), (yyvsp[0].buffer).end());
+        if(!state->type_stack.empty()) depth_error(scanner, state, 0, "method");
     }
-
     break;
 
-    case 14:
-
-    {
-        Import *import = new Import((yyvsp[0].str));
-        parsed_module->add_import(unique_ptr<Import>(import));
+  case 14: /* import: KW_IMPORT import_module  */
+        {
+        Import* import = new Import((yyvsp[0].str));
+        state->module->add_import(unique_ptr<Import>(import));
     }
-
     break;
 
-    case 15:
-
-    {
-        Import *import = new Import((yyvsp[-2].str));
+  case 15: /* import: KW_FROM import_module KW_IMPORT import_symbols  */
+        {
+        Import* import = new Import((yyvsp[-2].str));
         import->symbols.assign((yyvsp[0].strings).begin(), (yyvsp[0].strings).end());
-        parsed_module->add_import(unique_ptr<Import>(import));
+        state->module->add_import(unique_ptr<Import>(import));
     }
-
     break;
 
-    case 16:
-
-    { (yyval.str) = (yyvsp[0].str); }
-
+  case 16: /* import_module: import_alternatives  */
+                              { (yyval.str) = (yyvsp[0].str); }
     break;
 
-    case 17:
-
-    {
+  case 17: /* import_module: import_module '.' import_alternatives  */
+        {
         (yyval.str) = (yyvsp[-2].str) + string(".") + (yyvsp[0].str);
     }
-
     break;
 
-    case 18:
-
-    { (yyval.strings) = (yyvsp[0].strings); }
-
+  case 18: /* import_symbols: import_symbol_list  */
+                             { (yyval.strings) = (yyvsp[0].strings); }
     break;
 
-    case 19:
-
-    {
+  case 19: /* import_symbols: '*'  */
+        {
         (yyval.strings) = vector<string>();
     }
-
     break;
 
-    case 20:
-
-    {
+  case 20: /* import_symbol_list: import_alternatives  */
+        {
         (yyval.strings) = vector<string>(1, (yyvsp[0].str));
     }
-
     break;
 
-    case 21:
-
-    {
+  case 21: /* import_symbol_list: import_symbol_list ',' import_alternatives  */
+        {
         (yyvsp[-2].strings).push_back((yyvsp[0].str));
         (yyval.strings) = (yyvsp[-2].strings);
     }
-
     break;
 
-    case 22:
-
-    { (yyval.str) = (yyvsp[0].str); }
-
+  case 22: /* import_alternatives: IDENTIFIER  */
+                     { (yyval.str) = (yyvsp[0].str); }
     break;
 
-    case 23:
-
-    {
+  case 23: /* import_alternatives: import_alternatives '/' IDENTIFIER  */
+        {
         (yyval.str) = (yyvsp[-2].str) + string("/") + (yyvsp[0].str);
     }
-
     break;
 
-    case 24:
-
-    {
-        if((yyvsp[0].nametype).type == nullptr) {
+  case 24: /* typedef: typedef_type  */
+        {
+        if((yyvsp[0].nametype).type == nullptr)
+        {
             // Ignore this typedef, it should have already produced an error
             break;
         }
 
-        // Set the type's typedef
+        // Set the type's typedef; the type is shared by every field which uses the typedef
+        shared_type(state, (yyvsp[0].nametype).type);
         (yyvsp[0].nametype).type->set_alias((yyvsp[0].nametype).name);
 
-        bool type_added = parsed_module->add_typedef((yyvsp[0].nametype).name, (yyvsp[0].nametype).type);
-        if(!type_added) {
+        bool type_added = state->module->add_typedef((yyvsp[0].nametype).name, (yyvsp[0].nametype).type);
+        if(!type_added)
+        {
             // Lets be really descriptive about why this failed
-            Type *dtype = parsed_module->type_by_name((yyvsp[0].nametype).name);
-            if(dtype == nullptr) {
-                dcerror("Unknown error adding typedef to module.");
+            Type* dtype = state->module->type_by_name((yyvsp[0].nametype).name);
+            if(dtype == nullptr)
+            {
+                dcerror(scanner, "Unknown error adding typedef to module.");
                 break;
             }
 
-            Struct *dstruct = dtype->as_struct();
-            if(dstruct == nullptr) {
-                dcerror("Cannot add 'typedef " + (yyvsp[0].nametype).name
-                        + "' to module because a typedef was already declared with that name.");
+            Struct* dstruct = dtype->as_struct();
+            if(dstruct == nullptr)
+            {
+                dcerror(scanner, "Cannot add 'typedef " + (yyvsp[0].nametype).name
+                             + "' to module because a typedef was already declared with that name.");
                 break;
             }
 
-            if(dstruct->as_class()) {
-                dcerror("Cannot add 'typedef " + (yyvsp[0].nametype).name
-                        + "' to module because a class was already declared with that name.");
-            } else {
-                dcerror("Cannot add 'typedef " + (yyvsp[0].nametype).name
-                        + "' to module because a struct was already declared with that name.");
+            if(dstruct->as_class())
+            {
+                dcerror(scanner, "Cannot add 'typedef " + (yyvsp[0].nametype).name
+                             + "' to module because a class was already declared with that name.");
+            }
+            else
+            {
+                dcerror(scanner, "Cannot add 'typedef " + (yyvsp[0].nametype).name
+                             + "' to module because a struct was already declared with that name.");
             }
         }
     }
-
     break;
 
-    case 25:
-
-    {
+  case 25: /* typedef_type: KW_TYPEDEF nonmethod_type_with_name  */
+        {
         (yyval.nametype) = (yyvsp[0].nametype);
     }
-
     break;
 
-    case 26:
-
-    {
+  case 26: /* typedef_type: typedef_type '[' array_range ']'  */
+        {
         (yyval.nametype) = (yyvsp[-3].nametype);
-        (yyval.nametype).type = new Array((yyvsp[-3].nametype).type, (yyvsp[-1].range));
+        (yyval.nametype).type = new Array(shared_type(state, (yyvsp[-3].nametype).type), (yyvsp[-1].range));
     }
-
     break;
 
-    case 27:
-
-    {
+  case 27: /* nonmethod_type_with_name: nonmethod_type IDENTIFIER  */
+        {
         DCToken::NameType nt;
         nt.type = (yyvsp[-1].dtype);
         nt.name = (yyvsp[0].str);
         (yyval.nametype) = nt;
     }
-
     break;
 
-    case 28:
-
-    {
-        Type *dtype = parsed_module->type_by_name((yyvsp[0].str));
-        if(dtype == nullptr) {
-            dcerror("Subtype '" + string((yyvsp[0].str)) + "' has not been declared.");
+  case 28: /* defined_type: IDENTIFIER  */
+        {
+        Type* dtype = state->module->type_by_name((yyvsp[0].str));
+        if(dtype == nullptr)
+        {
+            dcerror(scanner, "Subtype '" + string((yyvsp[0].str)) + "' has not been declared.");
             (yyval.dtype) = nullptr;
             break;
         }
 
         (yyval.dtype) = dtype;
     }
-
     break;
 
-    case 31:
-
-    {
-        parsed_module->add_keyword((yyvsp[0].str));
+  case 31: /* keyword_decl_list: keyword_decl_list IDENTIFIER  */
+        {
+        state->module->add_keyword((yyvsp[0].str));
     }
-
     break;
 
-    case 32:
-
-    {
-        current_class = new Class(parsed_module, (yyvsp[0].str));
+  case 32: /* $@1: %empty  */
+        {
+        state->current_class = new Class(state->module, (yyvsp[0].str));
     }
-
     break;
 
-    case 33:
-
-    {
-        bool class_added = parsed_module->add_class(unique_ptr<Class>(current_class));
-        if(!class_added) {
+  case 33: /* dclass: KW_DCLASS IDENTIFIER $@1 class_inheritance '{' class_fields '}'  */
+        {
+        bool class_added = state->module->add_class(unique_ptr<Class>(state->current_class));
+        if(!class_added)
+        {
             // Lets be really descriptive about why this failed
-            Type *dtype = parsed_module->type_by_name(current_class->name());
-            if(dtype == nullptr) {
-                dcerror("Unknown error adding class to module.");
+            Type* dtype = state->module->type_by_name(state->current_class->name());
+            if(dtype == nullptr)
+            {
+                dcerror(scanner, "Unknown error adding class to module.");
                 break;
             }
 
-            Struct *dstruct = dtype->as_struct();
-            if(dstruct == nullptr) {
-                dcerror("Cannot add 'dclass " + current_class->name()
-                        + "' to module because a typedef was already declared with that name.");
+            Struct* dstruct = dtype->as_struct();
+            if(dstruct == nullptr)
+            {
+                dcerror(scanner, "Cannot add 'dclass " + state->current_class->name()
+                             + "' to module because a typedef was already declared with that name.");
                 break;
             }
 
-            if(dstruct->as_class()) {
-                dcerror("Cannot add 'dclass " + current_class->name()
-                        + "' to module because a class was already declared with that name.");
-            } else {
-                dcerror("Cannot add 'dclass " + current_class->name()
-                        + "' to module because a struct was already declared with that name.");
+            if(dstruct->as_class())
+            {
+                dcerror(scanner, "Cannot add 'dclass " + state->current_class->name()
+                             + "' to module because a class was already declared with that name.");
+            }
+            else
+            {
+                dcerror(scanner, "Cannot add 'dclass " + state->current_class->name()
+                             + "' to module because a struct was already declared with that name.");
             }
         }
     }
-
     break;
 
-    case 36:
-
-    {
-        if((yyvsp[0].dclass) != nullptr) {
-            current_class->add_parent((yyvsp[0].dclass));
+  case 36: /* class_parents: defined_class  */
+        {
+        if((yyvsp[0].dclass) != nullptr)
+        {
+            state->current_class->add_parent((yyvsp[0].dclass));
         }
     }
-
     break;
 
-    case 37:
-
-    {
-        if((yyvsp[0].dclass) != nullptr) {
-            current_class->add_parent((yyvsp[0].dclass));
+  case 37: /* class_parents: class_parents ',' defined_class  */
+        {
+        if((yyvsp[0].dclass) != nullptr)
+        {
+            state->current_class->add_parent((yyvsp[0].dclass));
         }
     }
-
     break;
 
-    case 38:
-
-    {
-        Type *dtype = parsed_module->type_by_name((yyvsp[0].str));
-        if(dtype == nullptr) {
-            dcerror("'dclass " + string((yyvsp[0].str)) + "' has not been declared.");
+  case 38: /* defined_class: IDENTIFIER  */
+        {
+        Type* dtype = state->module->type_by_name((yyvsp[0].str));
+        if(dtype == nullptr)
+        {
+            dcerror(scanner, "'dclass " + string((yyvsp[0].str)) + "' has not been declared.");
             (yyval.dclass) = nullptr;
             break;
         }
 
-        Struct *dstruct = dtype->as_struct();
-        if(dstruct == nullptr) {
-            dcerror("class cannot inherit from non-class type '" + string((yyvsp[0].str)) + "'.");
+        Struct* dstruct = dtype->as_struct();
+        if(dstruct == nullptr)
+        {
+            dcerror(scanner, "class cannot inherit from non-class type '" + string((yyvsp[0].str)) + "'.");
             (yyval.dclass) = nullptr;
             break;
         }
 
-        Class *dclass = dstruct->as_class();
-        if(dclass == nullptr) {
-            dcerror("class cannot inherit from struct type '" + string((yyvsp[0].str)) + "'.");
+        Class* dclass = dstruct->as_class();
+        if(dclass == nullptr)
+        {
+            dcerror(scanner, "class cannot inherit from struct type '" + string((yyvsp[0].str)) + "'.");
             (yyval.dclass) = nullptr;
             break;
         }
 
         (yyval.dclass) = dclass;
     }
-
     break;
 
-    case 41:
-
-    {
-        if((yyvsp[-1].dfield) == nullptr) {
+  case 41: /* class_fields: class_fields class_field ';'  */
+        {
+        if((yyvsp[-1].dfield) == nullptr)
+        {
             // Ignore this field, it should have already generated a parser error
             break;
         }
 
-        bool field_added = current_class->add_field(unique_ptr<Field>((yyvsp[-1].dfield)));
-        if(!field_added) {
+        bool field_added = state->current_class->add_field(unique_ptr<Field>((yyvsp[-1].dfield)));
+        if(!field_added)
+        {
             // Lets be really descriptive about why this failed
-            if(current_class->field_by_name((yyvsp[-1].dfield)->name())) {
-                dcerror("Cannot add field '" + (yyvsp[-1].dfield)->name()
-                        + "', a field with that name already exists in 'dclass "
-                        + current_class->name() + "'.");
-            } else if(current_class->name() == (yyvsp[-1].dfield)->name()) {
-                if((yyvsp[-1].dfield)->as_molecular()) {
-                    dcerror("Cannot use a molecular field as a constructor.");
-                } else {
-                    dcerror("The constructor must be the first field in the class.");
+            if(state->current_class->field_by_name((yyvsp[-1].dfield)->name()))
+            {
+                dcerror(scanner, "Cannot add field '" + (yyvsp[-1].dfield)->name()
+                             + "', a field with that name already exists in 'dclass "
+                             + state->current_class->name() + "'.");
+            }
+            else if(state->current_class->name() == (yyvsp[-1].dfield)->name())
+            {
+                if((yyvsp[-1].dfield)->as_molecular())
+                {
+                    dcerror(scanner, "Cannot use a molecular field as a constructor.");
                 }
-            } else {
-                dcerror("Unknown error adding field to class.");
+                else
+                {
+                    dcerror(scanner, "The constructor must be the first field in the class.");
+                }
+            }
+            else
+            {
+                dcerror(scanner, "Unknown error adding field to class.");
             }
         }
     }
-
     break;
 
-    case 42:
-
-    {
-        if((yyvsp[-1].dfield) == nullptr) {
+  case 42: /* class_field: named_field keyword_list  */
+        {
+        if((yyvsp[-1].dfield) == nullptr)
+        {
             // Ignore this field, it should have already generated a parser error
             (yyval.dfield) = nullptr;
             break;
         }
 
-        if((yyvsp[-1].dfield)->name().empty()) {
-            dcerror("An unnamed field can't be defined in a class.");
+        if((yyvsp[-1].dfield)->name().empty())
+        {
+            dcerror(scanner, "An unnamed field can't be defined in a class.");
             (yyval.dfield) = nullptr;
             break;
         }
 
         // Add the keywords to the class
-        for(auto it = (yyvsp[0].strings).begin(); it != (yyvsp[0].strings).end(); ++it) {
+        for(auto it = (yyvsp[0].strings).begin(); it != (yyvsp[0].strings).end(); ++it)
+        {
             (yyvsp[-1].dfield)->add_keyword(*it);
         }
 
         (yyval.dfield) = (yyvsp[-1].dfield);
     }
-
     break;
 
-    case 43:
-
-    {
-        (yyval.dfield) = (Field *)(yyvsp[0].dmolecule);
+  case 43: /* class_field: molecular  */
+        {
+        (yyval.dfield) = (Field*)(yyvsp[0].dmolecule);
     }
-
     break;
 
-    case 44:
-
-    {
-        current_struct = new Struct(parsed_module, (yyvsp[0].str));
+  case 44: /* $@2: %empty  */
+        {
+        state->current_struct = new Struct(state->module, (yyvsp[0].str));
     }
-
     break;
 
-    case 45:
-
-    {
-        bool struct_added = parsed_module->add_struct(unique_ptr<Struct>(current_struct));
-        if(!struct_added) {
+  case 45: /* dstruct: KW_STRUCT IDENTIFIER $@2 '{' struct_fields '}'  */
+        {
+        bool struct_added = state->module->add_struct(unique_ptr<Struct>(state->current_struct));
+        if(!struct_added)
+        {
             // Lets be really descriptive about why this failed
-            Type *dtype = parsed_module->type_by_name(current_struct->name());
-            if(dtype == nullptr) {
-                dcerror("Unknown error adding struct to module.");
+            Type* dtype = state->module->type_by_name(state->current_struct->name());
+            if(dtype == nullptr)
+            {
+                dcerror(scanner, "Unknown error adding struct to module.");
                 break;
             }
 
-            Struct *dstruct = dtype->as_struct();
-            if(dstruct == nullptr) {
-                dcerror("Cannot add 'struct " + current_struct->name()
-                        + "' to module because a typedef was already declared with that name.");
+            Struct* dstruct = dtype->as_struct();
+            if(dstruct == nullptr)
+            {
+                dcerror(scanner, "Cannot add 'struct " + state->current_struct->name()
+                             + "' to module because a typedef was already declared with that name.");
                 break;
             }
 
-            if(dstruct->as_class()) {
-                dcerror("Cannot add 'struct " + current_struct->name()
-                        + "' to module because a class was already declared with that name.");
-            } else {
-                dcerror("Cannot add 'struct " + current_struct->name()
-                        + "' to module because a struct was already declared with that name.");
+            if(dstruct->as_class())
+            {
+                dcerror(scanner, "Cannot add 'struct " + state->current_struct->name()
+                             + "' to module because a class was already declared with that name.");
+            }
+            else
+            {
+                dcerror(scanner, "Cannot add 'struct " + state->current_struct->name()
+                             + "' to module because a struct was already declared with that name.");
             }
         }
     }
-
     break;
 
-    case 48:
-
-    {
-        if((yyvsp[-1].dfield) == nullptr || (yyvsp[-1].dfield)->type() == nullptr) {
+  case 48: /* struct_fields: struct_fields struct_field ';'  */
+        {
+        if((yyvsp[-1].dfield) == nullptr || (yyvsp[-1].dfield)->type() == nullptr)
+        {
             // Ignore this field, it should have already generated a parser error
             break;
         }
 
-        if(!current_struct->add_field(unique_ptr<Field>((yyvsp[-1].dfield)))) {
+        if(!state->current_struct->add_field(unique_ptr<Field>((yyvsp[-1].dfield))))
+        {
             // Lets be really descriptive about why this failed
-            if(current_struct->field_by_name((yyvsp[-1].dfield)->name())) {
-                dcerror("Cannot add field '" + (yyvsp[-1].dfield)->name()
-                        + "', a field with that name already exists in 'struct "
-                        + current_struct->name() + "'.");
-            } else if(current_struct->name() == (yyvsp[-1].dfield)->name()) {
-                dcerror("A constructor can't be defined in a struct.");
-            } else if((yyvsp[-1].dfield)->type()->as_method()) {
-                dcerror("A method can't be defined in a struct.");
-            } else {
-                dcerror("Unknown error adding field to struct.");
+            if(state->current_struct->field_by_name((yyvsp[-1].dfield)->name()))
+            {
+                dcerror(scanner, "Cannot add field '" + (yyvsp[-1].dfield)->name()
+                             + "', a field with that name already exists in 'struct "
+                             + state->current_struct->name() + "'.");
+            }
+            else if(state->current_struct->name() == (yyvsp[-1].dfield)->name())
+            {
+                dcerror(scanner, "A constructor can't be defined in a struct.");
+            }
+            else if((yyvsp[-1].dfield)->type()->as_method())
+            {
+                dcerror(scanner, "A method can't be defined in a struct.");
+            }
+            else
+            {
+                dcerror(scanner, "Unknown error adding field to struct.");
             }
         }
     }
-
     break;
 
-    case 55:
-
-    {
+  case 55: /* unnamed_field: nonmethod_type  */
+        {
         (yyval.dfield) = new Field((yyvsp[0].dtype));
     }
-
     break;
 
-    case 56:
-
-    {
-        current_depth = 0;
-        type_stack.push(TypeAndDepth((yyvsp[-1].dtype), 0));
+  case 56: /* $@3: %empty  */
+        {
+        state->current_depth = 0;
+        state->type_stack.push(TypeAndDepth((yyvsp[-1].dtype), 0));
     }
-
     break;
 
-    case 57:
-
-    {
-        Field *field = new Field((yyvsp[-3].dtype));
-        if(!type_stack.empty()) depth_error(0, "unnamed field");
-        field->set_default_value((yyvsp[0].buffer));
+  case 57: /* unnamed_field: nonmethod_type '=' $@3 type_value  */
+        {
+        Field* field = new Field((yyvsp[-3].dtype));
+        if(!state->type_stack.empty()) depth_error(scanner, state, 0, "unnamed field");
+        if(!has_errors(state)) field->set_default_value((yyvsp[0].buffer));
         (yyval.dfield) = field;
     }
-
     break;
 
-    case 58:
-
-    {
+  case 58: /* field_with_name: nonmethod_type_with_name  */
+        {
         (yyval.dfield) = new Field((yyvsp[0].nametype).type, (yyvsp[0].nametype).name);
     }
-
     break;
 
-    case 59:
-
-    {
-        (yyvsp[-3].dfield)->set_type(new Array((yyvsp[-3].dfield)->type(), (yyvsp[-1].range)));
+  case 59: /* field_with_name_as_array: field_with_name '[' array_range ']'  */
+        {
+        (yyvsp[-3].dfield)->set_type(new Array(shared_type(state, (yyvsp[-3].dfield)->type()), (yyvsp[-1].range)));
         (yyval.dfield) = (yyvsp[-3].dfield);
     }
-
     break;
 
-    case 60:
-
-    {
-        (yyvsp[-3].dfield)->set_type(new Array((yyvsp[-3].dfield)->type(), (yyvsp[-1].range)));
+  case 60: /* field_with_name_as_array: field_with_name_as_array '[' array_range ']'  */
+        {
+        (yyvsp[-3].dfield)->set_type(new Array(shared_type(state, (yyvsp[-3].dfield)->type()), (yyvsp[-1].range)));
         (yyval.dfield) = (yyvsp[-3].dfield);
     }
-
     break;
 
-    case 61:
-
-    {
-        current_depth = 0;
-        type_stack.push(TypeAndDepth((yyvsp[-1].dfield)->type(), 0));
+  case 61: /* $@4: %empty  */
+        {
+        state->current_depth = 0;
+        state->type_stack.push(TypeAndDepth((yyvsp[-1].dfield)->type(), 0));
     }
-
     break;
 
-    case 62:
-
-    {
-        if(!type_stack.empty()) depth_error(0, "field '" + (yyvsp[-3].dfield)->name() + "'");
-        (yyvsp[-3].dfield)->set_default_value((yyvsp[0].buffer));
+  case 62: /* field_with_name_and_default: field_with_name '=' $@4 type_value  */
+        {
+        if(!state->type_stack.empty()) depth_error(scanner, state, 0, "field '" + (yyvsp[-3].dfield)->name() + "'");
+        if(!has_errors(state)) (yyvsp[-3].dfield)->set_default_value((yyvsp[0].buffer));
         (yyval.dfield) = (yyvsp[-3].dfield);
     }
-
     break;
 
-    case 63:
-
-    {
-        current_depth = 0;
-        type_stack.push(TypeAndDepth((yyvsp[-1].dfield)->type(), 0));
+  case 63: /* $@5: %empty  */
+        {
+        state->current_depth = 0;
+        state->type_stack.push(TypeAndDepth((yyvsp[-1].dfield)->type(), 0));
     }
-
     break;
 
-    case 64:
-
-    {
-        if(!type_stack.empty()) depth_error(0, "field '" + (yyvsp[-3].dfield)->name() + "'");
-        (yyvsp[-3].dfield)->set_default_value((yyvsp[0].buffer));
+  case 64: /* field_with_name_and_default: field_with_name_as_array '=' $@5 type_value  */
+        {
+        if(!state->type_stack.empty()) depth_error(scanner, state, 0, "field '" + (yyvsp[-3].dfield)->name() + "'");
+        if(!has_errors(state)) (yyvsp[-3].dfield)->set_default_value((yyvsp[0].buffer));
         (yyval.dfield) = (yyvsp[-3].dfield);
     }
-
     break;
 
-    case 65:
-
-    {
-        current_depth = 0;
-        type_stack.push(TypeAndDepth((yyvsp[-2].dfield)->type(), 0));
+  case 65: /* $@6: %empty  */
+        {
+        state->current_depth = 0;
+        state->type_stack.push(TypeAndDepth((yyvsp[-2].dfield)->type(), 0));
     }
-
     break;
 
-    case 66:
-
-    {
-        if(!type_stack.empty()) depth_error(0, "method");
-        (yyvsp[-4].dfield)->set_default_value((yyvsp[-2].buffer));
+  case 66: /* field_with_name_and_default: method_as_field '=' method_value $@6 type_value  */
+        {
+        if(!state->type_stack.empty()) depth_error(scanner, state, 0, "method");
+        if(!has_errors(state)) (yyvsp[-4].dfield)->set_default_value((yyvsp[-2].buffer));
         (yyval.dfield) = (yyvsp[-4].dfield);
     }
-
     break;
 
-    case 67:
-
-    {
+  case 67: /* method_as_field: IDENTIFIER method  */
+        {
         (yyval.dfield) = new Field((yyvsp[0].dmethod), (yyvsp[-1].str));
     }
-
     break;
 
-    case 70:
-
-    {
-        if((yyvsp[0].dtype) == nullptr) {
+  case 70: /* nonmethod_type_no_array: defined_type  */
+        {
+        if((yyvsp[0].dtype) == nullptr)
+        {
             // defined_type should have output an error, pass nullptr upstream
             (yyval.dtype) = nullptr;
             break;
         }
 
-        if((yyvsp[0].dtype)->subtype() == kTypeMethod) {
-            dcerror("Cannot use a method type here.");
+        if((yyvsp[0].dtype)->subtype() == kTypeMethod)
+        {
+            dcerror(scanner, "Cannot use a method type here.");
             (yyval.dtype) = nullptr;
             break;
         }
 
         (yyval.dtype) = (yyvsp[0].dtype);
     }
-
     break;
 
-    case 71:
-
-    {
-        (yyval.dtype) = (Type *)(yyvsp[0].dnumeric);
+  case 71: /* nonmethod_type_no_array: numeric_type  */
+        {
+        (yyval.dtype) = (Type*)(yyvsp[0].dnumeric);
     }
-
     break;
 
-    case 73:
-
-    {
-        (yyval.dtype) = new Array((yyvsp[-3].dnumeric), (yyvsp[-1].range));
+  case 73: /* type_with_array: numeric_type '[' array_range ']'  */
+        {
+        (yyval.dtype) = new Array(shared_type(state, (yyvsp[-3].dnumeric)), (yyvsp[-1].range));
     }
-
     break;
 
-    case 74:
-
-    {
-        (yyval.dtype) = new Array((yyvsp[-3].dtype), (yyvsp[-1].range));
+  case 74: /* type_with_array: defined_type '[' array_range ']'  */
+        {
+        (yyval.dtype) = new Array(shared_type(state, (yyvsp[-3].dtype)), (yyvsp[-1].range));
     }
-
     break;
 
-    case 75:
-
-    {
-        (yyval.dtype) = new Array((yyvsp[-3].dtype), (yyvsp[-1].range));
+  case 75: /* type_with_array: builtin_array_type '[' array_range ']'  */
+        {
+        (yyval.dtype) = new Array(shared_type(state, (yyvsp[-3].dtype)), (yyvsp[-1].range));
     }
-
     break;
 
-    case 76:
-
-    {
-        (yyval.dtype) = new Array((yyvsp[-3].dtype), (yyvsp[-1].range));
+  case 76: /* type_with_array: type_with_array '[' array_range ']'  */
+        {
+        (yyval.dtype) = new Array(shared_type(state, (yyvsp[-3].dtype)), (yyvsp[-1].range));
     }
-
     break;
 
-    case 77:
-
-    {
-        MolecularField *mol = new MolecularField(current_class, (yyvsp[-2].str));
-        if((yyvsp[0].dfield) == nullptr) {
+  case 77: /* molecular: IDENTIFIER ':' defined_field  */
+        {
+        MolecularField* mol = new MolecularField(state->current_class, (yyvsp[-2].str));
+        if((yyvsp[0].dfield) == nullptr)
+        {
             // Ignore this field, it should have already generated an error
             (yyval.dmolecule) = mol;
             break;
         }
 
         bool field_added = mol->add_field((yyvsp[0].dfield));
-        if(!field_added) {
-            if((yyvsp[0].dfield)->as_molecular()) {
-                dcerror("Cannot add molecular '" + (yyvsp[0].dfield)->name() + "' to a molecular field.");
-            } else {
-                dcerror("Unkown error adding field " + (yyvsp[0].dfield)->name() + " to molecular '"
-                        + (yyvsp[-2].str) + "'.");
+        if(!field_added)
+        {
+            if((yyvsp[0].dfield)->as_molecular())
+            {
+                dcerror(scanner, "Cannot add molecular '" + (yyvsp[0].dfield)->name() + "' to a molecular field.");
+            }
+            else
+            {
+                dcerror(scanner, "Unkown error adding field " + (yyvsp[0].dfield)->name() + " to molecular '"
+                             + (yyvsp[-2].str) + "'.");
             }
         }
 
         (yyval.dmolecule) = mol;
     }
-
     break;
 
-    case 78:
-
-    {
-        if((yyvsp[0].dfield) == nullptr) {
+  case 78: /* molecular: molecular ',' defined_field  */
+        {
+        if((yyvsp[0].dfield) == nullptr)
+        {
             // Ignore this field, it should have already generated an error
             (yyval.dmolecule) = (yyvsp[-2].dmolecule);
             break;
         }
 
         bool field_added = (yyvsp[-2].dmolecule)->add_field((yyvsp[0].dfield));
-        if(!field_added) {
-            if((yyvsp[0].dfield)->as_molecular()) {
-                dcerror("Cannot add molecular '" + (yyvsp[0].dfield)->name() + "' to a molecular field.");
-            } else if(!(yyvsp[-2].dmolecule)->has_matching_keywords(*(yyvsp[0].dfield))) {
-                dcerror("Mismatched keywords in molecular between " +
-                        (yyvsp[-2].dmolecule)->get_field(0)->name() + " and " + (yyvsp[0].dfield)->name() + ".");
-            } else {
-                dcerror("Unkown error adding field " + (yyvsp[0].dfield)->name() + " to molecular '"
-                        + (yyvsp[-2].dmolecule)->name() + "'.");
+        if(!field_added)
+        {
+            if((yyvsp[0].dfield)->as_molecular())
+            {
+                dcerror(scanner, "Cannot add molecular '" + (yyvsp[0].dfield)->name() + "' to a molecular field.");
+            }
+            else if(!(yyvsp[-2].dmolecule)->has_matching_keywords(*(yyvsp[0].dfield)))
+            {
+                dcerror(scanner, "Mismatched keywords in molecular between " +
+                    (yyvsp[-2].dmolecule)->get_field(0)->name() + " and " + (yyvsp[0].dfield)->name() + ".");
+            }
+            else
+            {
+                dcerror(scanner, "Unkown error adding field " + (yyvsp[0].dfield)->name() + " to molecular '"
+                             + (yyvsp[-2].dmolecule)->name() + "'.");
             }
         }
 
         (yyval.dmolecule) = (yyvsp[-2].dmolecule);
     }
-
     break;
 
-    case 79:
-
-    {
-        if(!current_class) {
-            dcerror("Field '" + (yyvsp[0].str) + "' not defined in current class.");
+  case 79: /* defined_field: IDENTIFIER  */
+        {
+        if(!state->current_class)
+        {
+            dcerror(scanner, "Field '" + (yyvsp[0].str) + "' not defined in current class.");
             (yyval.dfield) = nullptr;
             break;
         }
 
-        Field *field = current_class->field_by_name((yyvsp[0].str));
-        if(field == nullptr) {
-            dcerror("Field '" + (yyvsp[0].str) + "' not defined in current class.");
+        Field *field = state->current_class->field_by_name((yyvsp[0].str));
+        if(field == nullptr)
+        {
+            dcerror(scanner, "Field '" + (yyvsp[0].str) + "' not defined in current class.");
             (yyval.dfield) = nullptr;
             break;
         }
 
         (yyval.dfield) = field;
     }
-
     break;
 
-    case 80:
-
-    {
-        if((yyvsp[0].subtype) == kTypeString) {
-            if(default_string == nullptr) {
-                default_string = new Array(new Numeric(kTypeChar));
-                default_string->set_alias("string");
-            }
-
-            (yyval.dtype) = default_string;
-        } else if((yyvsp[0].subtype) == kTypeBlob) {
-            if(default_blob == nullptr) {
-                default_blob = new Array(new Numeric(kTypeUint8));
-                default_blob->set_alias("blob");
-            }
-
-            (yyval.dtype) = default_blob;
-        } else {
-            dcerror("Found builtin Array not handled by parser.");
+  case 80: /* builtin_array_type: array_type_token  */
+        {
+        if((yyvsp[0].subtype) == kTypeString)
+        {
+            Array* arr = new Array(builtin_element(state, kTypeChar));
+            arr->set_alias("string");
+            (yyval.dtype) = arr;
+        }
+        else if((yyvsp[0].subtype) == kTypeBlob)
+        {
+            Array* arr = new Array(builtin_element(state, kTypeUint8));
+            arr->set_alias("blob");
+            (yyval.dtype) = arr;
+        }
+        else
+        {
+            dcerror(scanner, "Found builtin Array not handled by parser.");
             (yyval.dtype) = nullptr;
         }
     }
-
     break;
 
-    case 81:
-
-    {
-        if((yyvsp[-3].subtype) == kTypeString) {
-            Array *arr = new Array(new Numeric(kTypeChar), (yyvsp[-1].range));
+  case 81: /* builtin_array_type: array_type_token '(' array_range ')'  */
+        {
+        if((yyvsp[-3].subtype) == kTypeString)
+        {
+            Array* arr = new Array(builtin_element(state, kTypeChar), (yyvsp[-1].range));
             arr->set_alias("string");
             (yyval.dtype) = arr;
-        } else if((yyvsp[-3].subtype) == kTypeBlob) {
-            Array *arr = new Array(new Numeric(kTypeUint8), (yyvsp[-1].range));
+        }
+        else if((yyvsp[-3].subtype) == kTypeBlob)
+        {
+            Array* arr = new Array(builtin_element(state, kTypeUint8), (yyvsp[-1].range));
             arr->set_alias("blob");
             (yyval.dtype) = arr;
-        } else {
-            dcerror("Found builtin Array not handled by parser.");
+        }
+        else
+        {
+            dcerror(scanner, "Found builtin Array not handled by parser.");
             (yyval.dtype) = nullptr;
         }
     }
-
     break;
 
-    case 86:
-
-    { (yyval.dnumeric) = new Numeric((yyvsp[0].subtype)); }
-
+  case 86: /* numeric_token_only: numeric_type_token  */
+                             { (yyval.dnumeric) = new Numeric((yyvsp[0].subtype)); }
     break;
 
-    case 87:
-
-    {
-        if(!(yyvsp[-3].dnumeric)->set_range((yyvsp[-1].range))) {
-            dcerror("Invalid range for type.");
+  case 87: /* numeric_with_range: numeric_token_only '(' numeric_range ')'  */
+        {
+        if(!(yyvsp[-3].dnumeric)->set_range((yyvsp[-1].range)))
+        {
+            dcerror(scanner, "Invalid range for type.");
         }
 
         (yyval.dnumeric) = (yyvsp[-3].dnumeric);
     }
-
     break;
 
-    case 88:
-
-    {
-        if(!(yyvsp[-3].dnumeric)->set_range((yyvsp[-1].range))) {
-            dcerror("Invalid range for type.");
+  case 88: /* numeric_with_range: numeric_with_modulus '(' numeric_range ')'  */
+        {
+        if(!(yyvsp[-3].dnumeric)->set_range((yyvsp[-1].range)))
+        {
+            dcerror(scanner, "Invalid range for type.");
         }
 
         (yyval.dnumeric) = (yyvsp[-3].dnumeric);
     }
-
     break;
 
-    case 89:
-
-    {
-        if(!(yyvsp[-3].dnumeric)->set_range((yyvsp[-1].range))) {
-            dcerror("Invalid range for type.");
+  case 89: /* numeric_with_range: numeric_with_divisor '(' numeric_range ')'  */
+        {
+        if(!(yyvsp[-3].dnumeric)->set_range((yyvsp[-1].range)))
+        {
+            dcerror(scanner, "Invalid range for type.");
         }
 
         (yyval.dnumeric) = (yyvsp[-3].dnumeric);
     }
-
     break;
 
-    case 90:
-
-    {
-        if(!(yyvsp[-2].dnumeric)->set_modulus((yyvsp[0].real))) {
-            dcerror("Invalid modulus for type.");
+  case 90: /* numeric_with_modulus: numeric_token_only '%' number  */
+        {
+        if(!(yyvsp[-2].dnumeric)->set_modulus((yyvsp[0].real)))
+        {
+            dcerror(scanner, "Invalid modulus for type.");
         }
 
         (yyval.dnumeric) = (yyvsp[-2].dnumeric);
     }
-
     break;
 
-    case 91:
-
-    {
-        if(!(yyvsp[-2].dnumeric)->set_divisor((yyvsp[0].uint32))) {
-            dcerror("Invalid divisor for type.");
+  case 91: /* numeric_with_divisor: numeric_token_only '/' small_unsigned_integer  */
+        {
+        if(!(yyvsp[-2].dnumeric)->set_divisor((yyvsp[0].uint32)))
+        {
+            dcerror(scanner, "Invalid divisor for type.");
         }
     }
-
     break;
 
-    case 92:
-
-    {
-        if(!(yyvsp[-2].dnumeric)->set_divisor((yyvsp[0].uint32))) {
-            dcerror("Invalid divisor for type.");
+  case 92: /* numeric_with_divisor: numeric_with_modulus '/' small_unsigned_integer  */
+        {
+        if(!(yyvsp[-2].dnumeric)->set_divisor((yyvsp[0].uint32)))
+        {
+            dcerror(scanner, "Invalid divisor for type.");
         }
     }
-
     break;
 
-    case 93:
-
-    {
+  case 93: /* method: '(' ')'  */
+        {
         (yyval.dmethod) = new Method();
     }
-
     break;
 
-    case 94:
-
-    {
+  case 94: /* method: method_body ')'  */
+        {
         (yyval.dmethod) = (yyvsp[-1].dmethod);
     }
-
     break;
 
-    case 95:
-
-    {
-        Method *fn = new Method();
+  case 95: /* method_body: '(' parameter  */
+        {
+        Method* fn = new Method();
         bool param_added = fn->add_parameter(unique_ptr<Parameter>((yyvsp[0].dparam)));
-        if(!param_added) {
-            dcerror("Unknown error adding parameter to method.");
+        if(!param_added)
+        {
+            dcerror(scanner, "Unknown error adding parameter to method.");
         }
         (yyval.dmethod) = fn;
     }
-
     break;
 
-    case 96:
-
-    {
+  case 96: /* method_body: method_body ',' parameter  */
+        {
         bool param_added = (yyvsp[-2].dmethod)->add_parameter(unique_ptr<Parameter>((yyvsp[0].dparam)));
-        if(!param_added) {
-            dcerror("Cannot add parameter '" + (yyvsp[0].dparam)->name()
-                    + "', a parameter with that name is already used in this method.");
+        if(!param_added)
+        {
+            dcerror(scanner, "Cannot add parameter '" + (yyvsp[0].dparam)->name()
+                         + "', a parameter with that name is already used in this method.");
         }
         (yyval.dmethod) = (yyvsp[-2].dmethod);
     }
-
     break;
 
-    case 100:
-
-    {
-        (yyval.dparam) = new Parameter((yyvsp[0].dtype));
+  case 100: /* parameter: nonmethod_type  */
+        {
+        (yyval.dparam) = new Parameter(shared_type(state, (yyvsp[0].dtype)));
     }
-
     break;
 
-    case 101:
-
-    {
-        current_depth = 0;
-        type_stack.push(TypeAndDepth((yyvsp[-1].dtype), 0));
+  case 101: /* $@7: %empty  */
+        {
+        state->current_depth = 0;
+        state->type_stack.push(TypeAndDepth((yyvsp[-1].dtype),0));
     }
-
     break;
 
-    case 102:
-
-    {
-        Parameter *param = new Parameter((yyvsp[-3].dtype));
-        if(!type_stack.empty()) depth_error(0, "type");
-        param->set_default_value((yyvsp[0].buffer));
+  case 102: /* parameter: nonmethod_type '=' $@7 type_value  */
+        {
+        Parameter* param = new Parameter(shared_type(state, (yyvsp[-3].dtype)));
+        if(!state->type_stack.empty()) depth_error(scanner, state, 0, "type");
+        if(!has_errors(state)) param->set_default_value((yyvsp[0].buffer));
         (yyval.dparam) = param;
     }
-
     break;
 
-    case 103:
-
-    {
-        (yyval.dparam) = new Parameter((yyvsp[-1].dtype), (yyvsp[0].str));
+  case 103: /* param_with_name: nonmethod_type_no_array IDENTIFIER  */
+        {
+        (yyval.dparam) = new Parameter(shared_type(state, (yyvsp[-1].dtype)), (yyvsp[0].str));
     }
-
     break;
 
-    case 104:
-
-    {
-        (yyvsp[-3].dparam)->set_type(new Array((yyvsp[-3].dparam)->type(), (yyvsp[-1].range)));
+  case 104: /* param_with_name_as_array: param_with_name '[' array_range ']'  */
+        {
+        (yyvsp[-3].dparam)->set_type(shared_type(state, new Array((yyvsp[-3].dparam)->type(), (yyvsp[-1].range))));
         (yyval.dparam) = (yyvsp[-3].dparam);
     }
-
     break;
 
-    case 105:
-
-    {
-        (yyvsp[-3].dparam)->set_type(new Array((yyvsp[-3].dparam)->type(), (yyvsp[-1].range)));
+  case 105: /* param_with_name_as_array: param_with_name_as_array '[' array_range ']'  */
+        {
+        (yyvsp[-3].dparam)->set_type(shared_type(state, new Array((yyvsp[-3].dparam)->type(), (yyvsp[-1].range))));
         (yyval.dparam) = (yyvsp[-3].dparam);
     }
-
     break;
 
-    case 106:
-
-    {
-        current_depth = 0;
-        type_stack.push(TypeAndDepth((yyvsp[-1].dparam)->type(), 0));
+  case 106: /* $@8: %empty  */
+        {
+        state->current_depth = 0;
+        state->type_stack.push(TypeAndDepth((yyvsp[-1].dparam)->type(), 0));
     }
-
     break;
 
-    case 107:
-
-    {
-        if(!type_stack.empty()) depth_error(0, "parameter '" + (yyvsp[-3].dparam)->name() + "'");
-        (yyvsp[-3].dparam)->set_default_value((yyvsp[0].buffer));
+  case 107: /* param_with_name_and_default: param_with_name '=' $@8 type_value  */
+        {
+        if(!state->type_stack.empty()) depth_error(scanner, state, 0, "parameter '" + (yyvsp[-3].dparam)->name() + "'");
+        if(!has_errors(state)) (yyvsp[-3].dparam)->set_default_value((yyvsp[0].buffer));
         (yyval.dparam) = (yyvsp[-3].dparam);
     }
-
     break;
 
-    case 108:
-
-    {
-        current_depth = 0;
-        type_stack.push(TypeAndDepth((yyvsp[-1].dparam)->type(), 0));
+  case 108: /* $@9: %empty  */
+        {
+        state->current_depth = 0;
+        state->type_stack.push(TypeAndDepth((yyvsp[-1].dparam)->type(), 0));
     }
-
     break;
 
-    case 109:
-
-    {
-        if(!type_stack.empty()) depth_error(0, "parameter '" + (yyvsp[-3].dparam)->name() + "'");
-        (yyvsp[-3].dparam)->set_default_value((yyvsp[0].buffer));
+  case 109: /* param_with_name_and_default: param_with_name_as_array '=' $@9 type_value  */
+        {
+        if(!state->type_stack.empty()) depth_error(scanner, state, 0, "parameter '" + (yyvsp[-3].dparam)->name() + "'");
+        if(!has_errors(state)) (yyvsp[-3].dparam)->set_default_value((yyvsp[0].buffer));
         (yyval.dparam) = (yyvsp[-3].dparam);
     }
-
     break;
 
-    case 110:
-
-    { (yyval.range) = NumericRange(); }
-
+  case 110: /* numeric_range: empty  */
+                { (yyval.range) = NumericRange(); }
     break;
 
-    case 111:
-
-    { (yyval.range) = NumericRange((yyvsp[0].real), (yyvsp[0].real)); }
-
+  case 111: /* numeric_range: char_or_number  */
+                         { (yyval.range) = NumericRange((yyvsp[0].real), (yyvsp[0].real)); }
     break;
 
-    case 112:
-
-    { (yyval.range) = NumericRange((yyvsp[-2].real), (yyvsp[0].real)); }
-
+  case 112: /* numeric_range: char_or_number '-' char_or_number  */
+                                            { (yyval.range) = NumericRange((yyvsp[-2].real), (yyvsp[0].real)); }
     break;
 
-    case 113:
-
-    { (yyval.range) = NumericRange(); }
-
+  case 113: /* array_range: empty  */
+                { (yyval.range) = NumericRange(); }
     break;
 
-    case 114:
-
-    { (yyval.range) = NumericRange((yyvsp[0].uint32), (yyvsp[0].uint32)); }
-
+  case 114: /* array_range: char_or_uint  */
+                       { (yyval.range) = NumericRange((yyvsp[0].uint32), (yyvsp[0].uint32)); }
     break;
 
-    case 115:
-
-    { (yyval.range) = NumericRange((yyvsp[-2].uint32), (yyvsp[0].uint32)); }
-
+  case 115: /* array_range: char_or_uint '-' char_or_uint  */
+                                        { (yyval.range) = NumericRange((yyvsp[-2].uint32), (yyvsp[0].uint32)); }
     break;
 
-    case 116:
-
-    {
-        if((yyvsp[0].str).length() != 1) {
-            dcerror("Single character required.");
+  case 116: /* char_or_uint: CHAR  */
+        {
+        if((yyvsp[0].str).length() != 1)
+        {
+            dcerror(scanner, "Single character required.");
             (yyval.uint32) = 0;
-        } else {
+        }
+        else
+        {
             (yyval.uint32) = (unsigned char)(yyvsp[0].str)[0];
         }
     }
-
     break;
 
-    case 118:
-
-    {
+  case 118: /* small_unsigned_integer: UNSIGNED_INTEGER  */
+        {
         unsigned int num = (unsigned int)(yyvsp[0].uint64);
-        if(num != (yyvsp[0].uint64)) {
-            dcerror("Number out of range.");
+        if(num != (yyvsp[0].uint64))
+        {
+            dcerror(scanner, "Number out of range.");
             (yyval.uint32) = 1;
         }
         (yyval.uint32) = num;
     }
-
     break;
 
-    case 119:
-
-    { (yyval.real) = (double)(yyvsp[0].uint64); }
-
+  case 119: /* number: UNSIGNED_INTEGER  */
+                           { (yyval.real) = (double)(yyvsp[0].uint64); }
     break;
 
-    case 120:
-
-    { (yyval.real) = (double)(yyvsp[0].int64); }
-
+  case 120: /* number: signed_integer  */
+                         { (yyval.real) = (double)(yyvsp[0].int64); }
     break;
 
-    case 122:
-
-    {
+  case 122: /* char_or_number: CHAR  */
+        {
         if((yyvsp[0].str).length() != 1) {
-            dcerror("Single character required.");
+            dcerror(scanner, "Single character required.");
             (yyval.real) = 0;
         } else {
             (yyval.real) = (double)(unsigned char)(yyvsp[0].str)[0];
         }
     }
-
     break;
 
-    case 124:
-
-    {
-        if(!check_depth()) depth_error("signed integer");
+  case 124: /* type_value: signed_integer  */
+        {
+        if(!check_depth(state)) depth_error(scanner, state, "signed integer");
 
-        const Type *dtype = type_stack.top().type;
+        const Type* dtype = state->type_stack.top().type;
         if(dtype == nullptr) {
             // Ignore this field, it should have already generated an error
             (yyval.buffer) = vector<uint8_t>();
             break;
         }
-        type_stack.pop(); // Remove numeric type from stack
+        state->type_stack.pop(); // Remove numeric type from stack
 
-        (yyval.buffer) = number_value(dtype->subtype(), (yyvsp[0].int64));
+        (yyval.buffer) = number_value(scanner, dtype->subtype(), (yyvsp[0].int64));
     }
-
     break;
 
-    case 125:
-
-    {
-        if(!check_depth()) depth_error("unsigned integer");
+  case 125: /* type_value: UNSIGNED_INTEGER  */
+        {
+        if(!check_depth(state)) depth_error(scanner, state, "unsigned integer");
 
-        const Type *dtype = type_stack.top().type;
+        const Type* dtype = state->type_stack.top().type;
         if(dtype == nullptr) {
             // Ignore this field, it should have already generated an error
             (yyval.buffer) = vector<uint8_t>();
             break;
         }
-        type_stack.pop(); // Remove numeric type from stack
+        state->type_stack.pop(); // Remove numeric type from stack
 
-        (yyval.buffer) = number_value(dtype->subtype(), (yyvsp[0].uint64));
+        (yyval.buffer) = number_value(scanner, dtype->subtype(), (yyvsp[0].uint64));
     }
-
     break;
 
-    case 126:
-
-    {
-        if(!check_depth()) depth_error("floating point");
+  case 126: /* type_value: REAL  */
+        {
+        if(!check_depth(state)) depth_error(scanner, state, "floating point");
 
-        const Type *dtype = type_stack.top().type;
+        const Type* dtype = state->type_stack.top().type;
         if(dtype == nullptr) {
             // Ignore this field, it should have already generated an error
             (yyval.buffer) = vector<uint8_t>();
             break;
         }
-        type_stack.pop(); // Remove numeric type from stack
+        state->type_stack.pop(); // Remove numeric type from stack
 
-        (yyval.buffer) = number_value(dtype->subtype(), (yyvsp[0].real));
+        (yyval.buffer) = number_value(scanner, dtype->subtype(), (yyvsp[0].real));
     }
-
     break;
 
-    case 127:
-
-    {
-        if(!check_depth()) depth_error("string");
+  case 127: /* type_value: STRING  */
+        {
+        if(!check_depth(state)) depth_error(scanner, state, "string");
 
-        const Type *dtype = type_stack.top().type;
+        const Type* dtype = state->type_stack.top().type;
         if(dtype == nullptr) {
             // Ignore this field, it should have already generated an error
             (yyval.buffer) = vector<uint8_t>();
             break;
         }
-        type_stack.pop(); // Remove string type from stack
+        state->type_stack.pop(); // Remove string type from stack
 
         if(dtype->subtype() == kTypeString || dtype->subtype() == kTypeBlob) {
             if((yyvsp[0].str).length() != dtype->fixed_size()) {
-                dcerror("Value for fixed-length string has incorrect length.");
+                dcerror(scanner, "Value for fixed-length string has incorrect length.");
             }
 
             (yyval.buffer) = as_buffer((yyvsp[0].str));
         } else if(dtype->subtype() == kTypeVarstring || dtype->subtype() == kTypeVarblob) {
             // TODO: Check for range limits
             // Prepend length tag
-            size_t length = (yyvsp[0].str).length();
+            sizetag_t length = (yyvsp[0].str).length();
             vector<uint8_t> buf = as_buffer(length);
             pack_value((yyvsp[0].str), buf);
             (yyval.buffer) = buf;
-        } else {
-            dcerror("Cannot use string value for non-string type '"
-                    + format_type(dtype->subtype()) + "'.");
+        }
+        else {
+            dcerror(scanner, "Cannot use string value for non-string type '"
+                         + format_type(dtype->subtype()) + "'.");
             (yyval.buffer) = as_buffer((yyvsp[0].str));
         }
     }
-
     break;
 
-    case 128:
-
-    {
-        if(!check_depth()) depth_error("hex-string");
+  case 128: /* type_value: HEX_STRING  */
+        {
+        if(!check_depth(state)) depth_error(scanner, state, "hex-string");
 
-        const Type *dtype = type_stack.top().type;
+        const Type* dtype = state->type_stack.top().type;
         if(dtype == nullptr) {
             // Ignore this field, it should have already generated an error
             (yyval.buffer) = vector<uint8_t>();
             break;
         }
-        type_stack.pop(); // Remove type from stack
+        state->type_stack.pop(); // Remove type from stack
 
         if(dtype->subtype() == kTypeBlob) {
             if((yyvsp[0].str).length() != dtype->fixed_size()) {
-                dcerror("Value for fixed-length blob has incorrect length.");
+                dcerror(scanner, "Value for fixed-length blob has incorrect length.");
             }
 
             (yyval.buffer) = as_buffer((yyvsp[0].str));
@@ -2571,158 +2789,142 @@ yyreduce:
             // TODO: Check for range limits
             (yyval.buffer) = as_buffer((yyvsp[0].str));
         } else {
-            dcerror("Cannot use hex value for non-blob type '"
-                    + format_type(dtype->subtype()) + "'.");
+            dcerror(scanner, "Cannot use hex value for non-blob type '"
+                         + format_type(dtype->subtype()) + "'.");
             (yyval.buffer) = as_buffer((yyvsp[0].str));
         }
     }
-
     break;
 
-    case 131:
-
-    {
-        if(!check_depth()) depth_error("method");
+  case 131: /* $@10: %empty  */
+        {
+        if(!check_depth(state)) depth_error(scanner, state, "method");
 
-        const Type *dtype = type_stack.top().type;
+        const Type* dtype = state->type_stack.top().type;
         if(dtype == nullptr) {
             // Ignore this field, it should have already generated an error
             break;
         }
 
         if(dtype->as_method()) {
-            current_depth++;
-            const Method *method = dtype->as_method();
+            state->current_depth++;
+            const Method* method = dtype->as_method();
 
             size_t num_params = method->num_parameters();
             for(unsigned int i = 1; i <= num_params; ++i) {
                 // Reverse iteration
-                const Parameter *param = method->get_parameter((unsigned int)num_params - i);
+                const Parameter* param = method->get_parameter((unsigned int)num_params-i);
                 // Add parameter types to stack such that the first is on top
-                type_stack.push(TypeAndDepth(param->type(), current_depth));
+                state->type_stack.push(TypeAndDepth(param->type(), state->current_depth));
             }
         } else {
-            dcerror("Cannot use method-value for non-method type '"
-                    + format_type(dtype->subtype()) + "'.");
+            dcerror(scanner, "Cannot use method-value for non-method type '"
+                         + format_type(dtype->subtype()) + "'.");
         }
     }
-
     break;
 
-    case 132:
-
-    {
-        if(type_stack.top().type->as_method()) {
-            current_depth--;
+  case 132: /* method_value: '(' $@10 parameter_values ')'  */
+        {
+        if(state->type_stack.top().type->as_method()) {
+            state->current_depth--;
         }
-        type_stack.pop(); // Remove method type from the stack
+        state->type_stack.pop(); // Remove method type from the stack
         (yyval.buffer) = (yyvsp[-1].buffer);
     }
-
     break;
 
-    case 134:
-
-    {
+  case 134: /* parameter_values: parameter_values ',' type_value  */
+        {
         vector<uint8_t> buf = (yyvsp[-2].buffer);
         pack_value((yyvsp[0].buffer), buf);
         (yyval.buffer) = buf;
     }
-
     break;
 
-    case 135:
-
-    {
-        if(!check_depth()) depth_error("struct");
+  case 135: /* $@11: %empty  */
+        {
+        if(!check_depth(state)) depth_error(scanner, state, "struct");
 
-        const Type *dtype = type_stack.top().type;
+        const Type* dtype = state->type_stack.top().type;
         if(dtype == nullptr) {
             // Ignore this field, it should have already generated an error
             break;
         }
 
         if(dtype->as_struct()) {
-            current_depth++;
-            const Struct *dstruct = dtype->as_struct();
+            state->current_depth++;
+            const Struct* dstruct = dtype->as_struct();
 
             size_t num_fields = dstruct->num_fields();
             for(unsigned int i = 1; i <= num_fields; ++i) {
                 // Reverse iteration
-                const Field *field = dstruct->get_field((unsigned int)num_fields - i);
+                const Field* field = dstruct->get_field((unsigned int)num_fields-i);
                 // Add field types to stack such that the first is on top
-                type_stack.push(TypeAndDepth(field->type(), current_depth));
+                state->type_stack.push(TypeAndDepth(field->type(), state->current_depth));
             }
         } else {
-            dcerror("Cannot use struct-composition for non-struct type '"
-                    + format_type(dtype->subtype()) + "'.");
+            dcerror(scanner, "Cannot use struct-composition for non-struct type '"
+                         + format_type(dtype->subtype()) + "'.");
         }
     }
-
     break;
 
-    case 136:
-
-    {
-        if(type_stack.top().type->as_struct()) {
-            current_depth--;
+  case 136: /* struct_value: '{' $@11 field_values '}'  */
+        {
+        if(state->type_stack.top().type->as_struct()) {
+            state->current_depth--;
         }
-        type_stack.pop(); // Remove method type from the stack
+        state->type_stack.pop(); // Remove method type from the stack
         (yyval.buffer) = (yyvsp[-1].buffer);
     }
-
     break;
 
-    case 139:
-
-    {
+  case 139: /* field_values: field_values ',' type_value  */
+        {
         vector<uint8_t> buf = (yyvsp[-2].buffer);
         pack_value((yyvsp[0].buffer), buf);
         (yyval.buffer) = buf;
     }
-
     break;
 
-    case 140:
-
-    {
+  case 140: /* field_values: field_values ',' method_value  */
+        {
         vector<uint8_t> buf = (yyvsp[-2].buffer);
         pack_value((yyvsp[0].buffer), buf);
         (yyval.buffer) = buf;
     }
-
     break;
 
-    case 141:
-
-    {
-        if(!check_depth()) depth_error("array");
+  case 141: /* array_value: '[' ']'  */
+        {
+        if(!check_depth(state)) depth_error(scanner, state, "array");
 
-        const Type *dtype = type_stack.top().type;
+        const Type* dtype = state->type_stack.top().type;
         if(dtype == nullptr) {
             // Ignore this field, it should have already generated an error
             (yyval.buffer) = vector<uint8_t>();;
             break;
         }
-        type_stack.pop();
+        state->type_stack.pop();
         if(!dtype->as_array()) {
-            dcerror("Cannot use array-composition for non-array type '"
-                    + format_type(dtype->subtype()) + "'.");
+            dcerror(scanner, "Cannot use array-composition for non-array type '"
+                         + format_type(dtype->subtype()) + "'.");
             (yyval.buffer) = vector<uint8_t>();;
             break;
         }
-        const Array *array = dtype->as_array();
+        const Array* array = dtype->as_array();
 
         if(array->array_size() > 0) {
             // For fixed size arrays, an empty array is an error
-            dcerror("Fixed-sized array of size "
-                    + to_string(array->array_size())
-                    + " can't have 0 elements.");
+            dcerror(scanner, "Fixed-sized array of size "
+                         + to_string(array->array_size())
+                         + " can't have 0 elements.");
         } else if(array->has_range()) {
             // If we have a range, 0 elements must be valid in the range
             if(0 < array->range().min.uinteger) {
-                dcerror("Too few elements in array value, minimum "
-                        + to_string(array->range().min.uinteger) + ".");
+                dcerror(scanner, "Too few elements in array value, minimum "
+                             + to_string(array->range().min.uinteger) + ".");
             }
         }
 
@@ -2730,58 +2932,54 @@ yyreduce:
         // the default value for a varsize array, which is the length-tag 0.
         (yyval.buffer) = vector<uint8_t>(sizeof(sizetag_t), 0);
     }
-
     break;
 
-    case 142:
-
-    {
-        if(!check_depth()) depth_error("array");
+  case 142: /* $@12: %empty  */
+        {
+        if(!check_depth(state)) depth_error(scanner, state, "array");
 
-        const Type *dtype = type_stack.top().type;
+        const Type* dtype = state->type_stack.top().type;
         if(dtype == nullptr) {
             // Ignore this field, it should have already generated an error
             break;
         }
 
         if(dtype->as_array()) {
-            const Array *array = dtype->as_array();
+            const Array* array = dtype->as_array();
 
             // For arrays we're going to do something pretty hacky:
             //    For every element we had we are going to increment the depth,
             //    and after we finish the element_values production we will compare
             //    the current_depth to the depth of our original symbol to check
             //    if the array size is proper.
-            type_stack.push(TypeAndDepth(array->element_type(), current_depth));
+            state->type_stack.push(TypeAndDepth(array->element_type(), state->current_depth));
         } else {
-            dcerror("Cannot use array-composition for non-array type '"
-                    + format_type(dtype->subtype()) + "'.");
+            dcerror(scanner, "Cannot use array-composition for non-array type '"
+                         + format_type(dtype->subtype()) + "'.");
         }
     }
-
     break;
 
-    case 143:
-
-    {
-        if(type_stack.top().type->as_array()) {
-            uint64_t actual_size = current_depth - type_stack.top().depth;
+  case 143: /* array_value: '[' $@12 element_values ']'  */
+        {
+        if(state->type_stack.top().type->as_array()) {
+            uint64_t actual_size = state->current_depth - state->type_stack.top().depth;
 
-            const Type *dtype = type_stack.top().type;
+            const Type* dtype = state->type_stack.top().type;
             if(dtype == nullptr) {
                 // Ignore this field, it should have already generated an error
                 (yyval.buffer) = vector<uint8_t>();
                 break;
             }
 
-            const Array *array = dtype->as_array();
+            const Array* array = dtype->as_array();
             if(array->has_range()) {
                 if(actual_size > array->range().max.uinteger) {
-                    dcerror("Too many elements in array value, maximum "
-                            + to_string(array->range().max.uinteger) + ".");
+                    dcerror(scanner, "Too many elements in array value, maximum "
+                                 + to_string(array->range().max.uinteger) + ".");
                 } else if(actual_size < array->range().min.uinteger) {
-                    dcerror("Too few elements in array value, minimum "
-                            + to_string(array->range().min.uinteger) + ".");
+                    dcerror(scanner, "Too few elements in array value, minimum "
+                                 + to_string(array->range().min.uinteger) + ".");
                 }
             }
 
@@ -2792,135 +2990,121 @@ yyreduce:
             } else {
                 (yyval.buffer) = (yyvsp[-1].buffer);
             }
-            current_depth = type_stack.top().depth;
+            state->current_depth = state->type_stack.top().depth;
         }
 
-        type_stack.pop(); // Remove array type from the stack
+        state->type_stack.pop(); // Remove array type from the stack
     }
-
     break;
 
-    case 145:
-
-    {
+  case 145: /* $@13: %empty  */
+        {
         // We popped off the only element we added, so we're back to the array
         // Don't increment the depth; the array_expansion will add to
         // the current_depth depending on the number of elements it adds.
-        const Type *dtype = type_stack.top().type;
+        const Type* dtype = state->type_stack.top().type;
         if(dtype == nullptr) {
             // Ignore this field, it should have already generated an error
             break;
         }
-        const Array *array = dtype->as_array();
-        type_stack.push(TypeAndDepth(array->element_type(), current_depth));
+        const Array* array = dtype->as_array();
+        state->type_stack.push(TypeAndDepth(array->element_type(), state->current_depth));
     }
-
     break;
 
-    case 146:
-
-    {
+  case 146: /* element_values: element_values ',' $@13 array_expansion  */
+        {
         // $4 packed onto end of $1
         std::vector<uint8_t> buf = (yyvsp[-3].buffer);
         pack_value((yyvsp[0].buffer), buf);
         (yyval.buffer) = buf;
     }
-
     break;
 
-    case 147:
-
-    {
-        current_depth++;
+  case 147: /* array_expansion: type_value  */
+        {
+        state->current_depth++;
         (yyval.buffer) = (yyvsp[0].buffer);
     }
-
     break;
 
-    case 148:
-
-    {
-        const Type *dtype = type_stack.top().type;
+  case 148: /* array_expansion: signed_integer '*' small_unsigned_integer  */
+        {
+        const Type* dtype = state->type_stack.top().type;
         if(dtype == nullptr) {
             // Ignore this field, it should have already generated an error
             (yyval.buffer) = vector<uint8_t>();
             break;
         }
-        type_stack.pop(); // Pop that array element type
-        current_depth += (yyvsp[0].uint32); // For arrays, we add 1 to the depth per element
+        state->type_stack.pop(); // Pop that array element type
+        state->current_depth += (yyvsp[0].uint32); // For arrays, we add 1 to the depth per element
 
         vector<uint8_t> buf;
-        vector<uint8_t> base = number_value(dtype->subtype(), (yyvsp[-2].int64));
+        vector<uint8_t> base = number_value(scanner, dtype->subtype(), (yyvsp[-2].int64));
         buf.reserve(base.size() * (yyvsp[0].uint32));
         for(unsigned int i = 0; i < (yyvsp[0].uint32); ++i) {
             pack_value(base, buf);
         }
         (yyval.buffer) = buf;
     }
-
     break;
 
-    case 149:
-
-    {
-        const Type *dtype = type_stack.top().type;
+  case 149: /* array_expansion: UNSIGNED_INTEGER '*' small_unsigned_integer  */
+        {
+        const Type* dtype = state->type_stack.top().type;
         if(dtype == nullptr) {
             // Ignore this field, it should have already generated an error
             (yyval.buffer) = vector<uint8_t>();
             break;
         }
-        type_stack.pop(); // Pop that array element type
-        current_depth += (yyvsp[0].uint32); // For arrays, we add 1 to the depth per element
+        state->type_stack.pop(); // Pop that array element type
+        state->current_depth += (yyvsp[0].uint32); // For arrays, we add 1 to the depth per element
 
         vector<uint8_t> buf;
-        vector<uint8_t> base = number_value(dtype->subtype(), (yyvsp[-2].uint64));
+        vector<uint8_t> base = number_value(scanner, dtype->subtype(), (yyvsp[-2].uint64));
         buf.reserve(base.size() * (yyvsp[0].uint32));
         for(unsigned int i = 0; i < (yyvsp[0].uint32); ++i) {
             pack_value(base, buf);
         }
         (yyval.buffer) = buf;
     }
-
     break;
 
-    case 150:
-
-    {
-        const Type *dtype = type_stack.top().type;
+  case 150: /* array_expansion: REAL '*' small_unsigned_integer  */
+        {
+        const Type* dtype = state->type_stack.top().type;
         if(dtype == nullptr) {
             // Ignore this field, it should have already generated an error
             (yyval.buffer) = vector<uint8_t>();
             break;
         }
-        type_stack.pop(); // Pop that array element type
-        current_depth += (yyvsp[0].uint32); // For arrays, we add 1 to the depth per element
+        state->type_stack.pop(); // Pop that array element type
+        state->current_depth += (yyvsp[0].uint32); // For arrays, we add 1 to the depth per element
 
         vector<uint8_t> buf;
-        vector<uint8_t> base = number_value(dtype->subtype(), (yyvsp[-2].real));
+        vector<uint8_t> base = number_value(scanner, dtype->subtype(), (yyvsp[-2].real));
         buf.reserve(base.size() * (yyvsp[0].uint32));
         for(unsigned int i = 0; i < (yyvsp[0].uint32); ++i) {
             pack_value(base, buf);
         }
         (yyval.buffer) = buf;
     }
-
     break;
 
-    case 151:
-
-    {
-        const Type *dtype = type_stack.top().type;
+  case 151: /* array_expansion: STRING '*' small_unsigned_integer  */
+        {
+        const Type* dtype = state->type_stack.top().type;
         if(dtype == nullptr) {
             // Ignore this field, it should have already generated an error
             (yyval.buffer) = vector<uint8_t>();
             break;
         }
-        type_stack.pop(); // Pop that array element type
-        current_depth += (yyvsp[0].uint32); // For arrays, we add 1 to the depth per element
+        state->type_stack.pop(); // Pop that array element type
+        state->current_depth += (yyvsp[0].uint32); // For arrays, we add 1 to the depth per element
 
         if(dtype->subtype() == kTypeString) {
             if((yyvsp[-2].str).length() != dtype->fixed_size()) {
-                dcerror("Value for fixed-length string has incorrect length.");
+                dcerror(scanner, "Value for fixed-length string has incorrect length.");
             }
 
             vector<uint8_t> buf;
@@ -2942,8 +3126,8 @@ yyreduce:
             // TODO: Check for range limits
 
         } else {
-            dcerror("Cannot use string value for non-string type '"
-                    + format_type(dtype->subtype()) + "'.");
+            dcerror(scanner, "Cannot use string value for non-string type '"
+                         + format_type(dtype->subtype()) + "'.");
 
             vector<uint8_t> buf;
             buf.reserve((yyvsp[-2].str).length() * (yyvsp[0].uint32));
@@ -2953,24 +3137,22 @@ yyreduce:
             (yyval.buffer) = buf;
         }
     }
-
     break;
 
-    case 152:
-
-    {
-        const Type *dtype = type_stack.top().type;
+  case 152: /* array_expansion: HEX_STRING '*' small_unsigned_integer  */
+        {
+        const Type* dtype = state->type_stack.top().type;
         if(dtype == nullptr) {
             // Ignore this field, it should have already generated an error
             (yyval.buffer) = vector<uint8_t>();
             break;
         }
-        type_stack.pop(); // Pop that array element type
-        current_depth += (yyvsp[0].uint32); // For arrays, we add 1 to the depth per element
+        state->type_stack.pop(); // Pop that array element type
+        state->current_depth += (yyvsp[0].uint32); // For arrays, we add 1 to the depth per element
 
         if(dtype->subtype() == kTypeBlob) {
             if((yyvsp[-2].str).length() != dtype->fixed_size()) {
-                dcerror("Value for fixed-length blob has incorrect length.");
+                dcerror(scanner, "Value for fixed-length blob has incorrect length.");
             }
 
             vector<uint8_t> buf;
@@ -2992,8 +3174,8 @@ yyreduce:
             // TODO: Check for range limits
 
         } else {
-            dcerror("Cannot use hex value for non-blob type '"
-                    + format_type(dtype->subtype()) + "'.");
+            dcerror(scanner, "Cannot use hex value for non-blob type '"
+                         + format_type(dtype->subtype()) + "'.");
 
             vector<uint8_t> buf;
             buf.reserve((yyvsp[-2].str).length() * (yyvsp[0].uint32));
@@ -3003,345 +3185,316 @@ yyreduce:
             (yyval.buffer) = buf;
         }
     }
-
     break;
 
-    case 153:
-
-    { (yyval.int64) = int64_t((yyvsp[0].uint64)); }
-
+  case 153: /* signed_integer: '+' UNSIGNED_INTEGER  */
+                               { (yyval.int64) = int64_t((yyvsp[0].uint64)); }
     break;
 
-    case 154:
-
-    { (yyval.int64) = -int64_t((yyvsp[0].uint64)); }
-
+  case 154: /* signed_integer: '-' UNSIGNED_INTEGER  */
+                               { (yyval.int64) = -int64_t((yyvsp[0].uint64)); }
     break;
 
-    case 155:
-
-    { (yyval.subtype) = kTypeString; }
-
+  case 155: /* array_type_token: KW_STRING  */
+                    { (yyval.subtype) = kTypeString; }
     break;
 
-    case 156:
-
-    { (yyval.subtype) = kTypeBlob; }
-
+  case 156: /* array_type_token: KW_BLOB  */
+                  { (yyval.subtype) = kTypeBlob; }
     break;
 
-    case 157:
-
-    { (yyval.subtype) = kTypeChar; }
-
+  case 157: /* numeric_type_token: KW_CHAR  */
+                  { (yyval.subtype) = kTypeChar; }
     break;
 
-    case 158:
-
-    { (yyval.subtype) = kTypeInt8; }
-
+  case 158: /* numeric_type_token: KW_INT8  */
+                  { (yyval.subtype) = kTypeInt8; }
     break;
 
-    case 159:
-
-    { (yyval.subtype) = kTypeInt16; }
-
+  case 159: /* numeric_type_token: KW_INT16  */
+                   { (yyval.subtype) = kTypeInt16; }
     break;
 
-    case 160:
-
-    { (yyval.subtype) = kTypeInt32; }
-
+  case 160: /* numeric_type_token: KW_INT32  */
+                   { (yyval.subtype) = kTypeInt32; }
     break;
 
-    case 161:
-
-    { (yyval.subtype) = kTypeInt64; }
-
+  case 161: /* numeric_type_token: KW_INT64  */
+                   { (yyval.subtype) = kTypeInt64; }
     break;
 
-    case 162:
-
-    { (yyval.subtype) = kTypeUint8; }
-
+  case 162: /* numeric_type_token: KW_UINT8  */
+                   { (yyval.subtype) = kTypeUint8; }
     break;
 
-    case 163:
-
-    { (yyval.subtype) = kTypeUint16; }
-
+  case 163: /* numeric_type_token: KW_UINT16  */
+                    { (yyval.subtype) = kTypeUint16; }
     break;
 
-    case 164:
-
-    { (yyval.subtype) = kTypeUint32; }
-
+  case 164: /* numeric_type_token: KW_UINT32  */
+                    { (yyval.subtype) = kTypeUint32; }
     break;
 
-    case 165:
-
-    { (yyval.subtype) = kTypeUint64; }
-
+  case 165: /* numeric_type_token: KW_UINT64  */
+                    { (yyval.subtype) = kTypeUint64; }
     break;
 
-    case 166:
-
-    { (yyval.subtype) = kTypeFloat32; }
-
+  case 166: /* numeric_type_token: KW_FLOAT32  */
+                     { (yyval.subtype) = kTypeFloat32; }
     break;
 
-    case 167:
-
-    { (yyval.subtype) = kTypeFloat64; }
-
+  case 167: /* numeric_type_token: KW_FLOAT64  */
+                     { (yyval.subtype) = kTypeFloat64; }
     break;
 
-    case 168:
-
-    {
+  case 168: /* keyword_list: empty  */
+        {
         (yyval.strings) = vector<string>();
     }
-
     break;
 
-    case 169:
-
-    {
-        if(!parsed_module->has_keyword((yyvsp[0].str))) {
-            dcerror("Keyword '" + (yyvsp[0].str) + "' has not been declared.");
+  case 169: /* keyword_list: keyword_list IDENTIFIER  */
+        {
+        if(!state->module->has_keyword((yyvsp[0].str)))
+        {
+            dcerror(scanner, "Keyword '" + (yyvsp[0].str) + "' has not been declared.");
             break;
         }
 
         (yyvsp[-1].strings).push_back((yyvsp[0].str));
         (yyval.strings) = (yyvsp[-1].strings);
     }
-
     break;
 
 
 
-    default:
-        break;
+      default: break;
     }
-    /* User semantic actions sometimes alter yychar, and that requires
-       that yytoken be updated with the new translation.  We take the
-       approach of translating immediately before every use of yytoken.
-       One alternative is translating here after every semantic action,
-       but that translation would be missed if the semantic action invokes
-       YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
-       if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
-       incorrect destructor might then be invoked immediately.  In the
-       case of YYERROR or YYBACKUP, subsequent parser actions might lead
-       to an incorrect destructor call or verbose syntax error message
-       before the lookahead is translated.  */
-    YY_SYMBOL_PRINT("-> $$ =", yyr1[yyn], &yyval, &yyloc);
-
-    YYPOPSTACK(yylen);
-    yylen = 0;
-    YY_STACK_PRINT(yyss, yyssp);
-
-    *++yyvsp = yyval;
+  /* User semantic actions sometimes alter yychar, and that requires
+     that yytoken be updated with the new translation.  We take the
+     approach of translating immediately before every use of yytoken.
+     One alternative is translating here after every semantic action,
+     but that translation would be missed if the semantic action invokes
+     YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
+     if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
+     incorrect destructor might then be invoked immediately.  In the
+     case of YYERROR or YYBACKUP, subsequent parser actions might lead
+     to an incorrect destructor call or verbose syntax error message
+     before the lookahead is translated.  */
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
 
-    /* Now 'shift' the result of the reduction.  Determine what state
-       that goes to, based on the state we popped back to and the rule
-       number reduced by.  */
+  YYPOPSTACK (yylen);
+  yylen = 0;
 
-    yyn = yyr1[yyn];
+  *++yyvsp = yyval;
 
-    yystate = yypgoto[yyn - YYNTOKENS] + *yyssp;
-    if(0 <= yystate && yystate <= YYLAST && yycheck[yystate] == *yyssp)
-        yystate = yytable[yystate];
-    else
-        yystate = yydefgoto[yyn - YYNTOKENS];
+  /* Now 'shift' the result of the reduction.  Determine what state
+     that goes to, based on the state we popped back to and the rule
+     number reduced by.  */
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
 
-    goto yynewstate;
+  goto yynewstate;
 
 
-    /*--------------------------------------.
-    | yyerrlab -- here on detecting error.  |
-    `--------------------------------------*/
+/*--------------------------------------.
+| yyerrlab -- here on detecting error.  |
+`--------------------------------------*/
 yyerrlab:
-    /* Make sure we have latest lookahead translation.  See comments at
-       user semantic actions for why this is necessary.  */
-    yytoken = yychar == YYEMPTY ? YYEMPTY : YYTRANSLATE(yychar);
-
-    /* If not already recovering from an error, report this error.  */
-    if(!yyerrstatus) {
-        ++yynerrs;
-#if ! YYERROR_VERBOSE
-        yyerror(YY_("syntax error"));
-#else
-# define YYSYNTAX_ERROR yysyntax_error (&yymsg_alloc, &yymsg, \
-                                        yyssp, yytoken)
-        {
-            char const *yymsgp = YY_("syntax error");
-            int yysyntax_error_status;
-            yysyntax_error_status = YYSYNTAX_ERROR;
-            if(yysyntax_error_status == 0)
+  /* Make sure we have latest lookahead translation.  See comments at
+     user semantic actions for why this is necessary.  */
+  yytoken = yychar == DCEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
+  /* If not already recovering from an error, report this error.  */
+  if (!yyerrstatus)
+    {
+      ++yynerrs;
+      {
+        yypcontext_t yyctx
+          = {yyssp, yytoken};
+        char const *yymsgp = YY_("syntax error");
+        int yysyntax_error_status;
+        yysyntax_error_status = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
+        if (yysyntax_error_status == 0)
+          yymsgp = yymsg;
+        else if (yysyntax_error_status == -1)
+          {
+            if (yymsg != yymsgbuf)
+              YYSTACK_FREE (yymsg);
+            yymsg = YY_CAST (char *,
+                             YYSTACK_ALLOC (YY_CAST (YYSIZE_T, yymsg_alloc)));
+            if (yymsg)
+              {
+                yysyntax_error_status
+                  = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
                 yymsgp = yymsg;
-            else if(yysyntax_error_status == 1) {
-                if(yymsg != yymsgbuf)
-                    YYSTACK_FREE(yymsg);
-                yymsg = (char *) YYSTACK_ALLOC(yymsg_alloc);
-                if(!yymsg) {
-                    yymsg = yymsgbuf;
-                    yymsg_alloc = sizeof yymsgbuf;
-                    yysyntax_error_status = 2;
-                } else {
-                    yysyntax_error_status = YYSYNTAX_ERROR;
-                    yymsgp = yymsg;
-                }
-            }
-            yyerror(yymsgp);
-            if(yysyntax_error_status == 2)
-                goto yyexhaustedlab;
+              }
+            else
+              {
+                yymsg = yymsgbuf;
+                yymsg_alloc = sizeof yymsgbuf;
+                yysyntax_error_status = YYENOMEM;
+              }
+          }
+        yyerror (scanner, state, yymsgp);
+        if (yysyntax_error_status == YYENOMEM)
+          YYNOMEM;
+      }
+    }
+
+  if (yyerrstatus == 3)
+    {
+      /* If just tried and failed to reuse lookahead token after an
+         error, discard it.  */
+
+      if (yychar <= DCEOF)
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == DCEOF)
+            YYABORT;
         }
-# undef YYSYNTAX_ERROR
-#endif
-    }
-
-
-
-    if(yyerrstatus == 3) {
-        /* If just tried and failed to reuse lookahead token after an
-           error, discard it.  */
-
-        if(yychar <= YYEOF) {
-            /* Return failure if at end of input.  */
-            if(yychar == YYEOF)
-                YYABORT;
-        } else {
-            yydestruct("Error: discarding",
-                       yytoken, &yylval);
-            yychar = YYEMPTY;
+      else
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval, scanner, state);
+          yychar = DCEMPTY;
         }
     }
 
-    /* Else will try to reuse lookahead token after shifting the error
-       token.  */
-    goto yyerrlab1;
+  /* Else will try to reuse lookahead token after shifting the error
+     token.  */
+  goto yyerrlab1;
 
 
-    /*---------------------------------------------------.
-    | yyerrorlab -- error raised explicitly by YYERROR.  |
-    `---------------------------------------------------*/
+/*---------------------------------------------------.
+| yyerrorlab -- error raised explicitly by YYERROR.  |
+`---------------------------------------------------*/
 yyerrorlab:
-
-    /* Pacify compilers like GCC when the user code never invokes
-       YYERROR and the label yyerrorlab therefore never appears in user
-       code.  */
-    if(/*CONSTCOND*/ 0)
-        goto yyerrorlab;
-
-    /* Do not reclaim the symbols of the rule whose action triggered
-       this YYERROR.  */
-    YYPOPSTACK(yylen);
-    yylen = 0;
-    YY_STACK_PRINT(yyss, yyssp);
-    yystate = *yyssp;
-    goto yyerrlab1;
-
-
-    /*-------------------------------------------------------------.
-    | yyerrlab1 -- common code for both syntax error and YYERROR.  |
-    `-------------------------------------------------------------*/
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
+
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYERROR.  */
+  YYPOPSTACK (yylen);
+  yylen = 0;
+  YY_STACK_PRINT (yyss, yyssp);
+  yystate = *yyssp;
+  goto yyerrlab1;
+
+
+/*-------------------------------------------------------------.
+| yyerrlab1 -- common code for both syntax error and YYERROR.  |
+`-------------------------------------------------------------*/
 yyerrlab1:
-    yyerrstatus = 3;      /* Each real token shifted decrements this.  */
-
-    for(;;) {
-        yyn = yypact[yystate];
-        if(!yypact_value_is_default(yyn)) {
-            yyn += YYTERROR;
-            if(0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYTERROR) {
-                yyn = yytable[yyn];
-                if(0 < yyn)
-                    break;
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
+
+  /* Pop stack until we find a state that shifts the error token.  */
+  for (;;)
+    {
+      yyn = yypact[yystate];
+      if (!yypact_value_is_default (yyn))
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
             }
         }
 
-        /* Pop the current state because it cannot handle the error token.  */
-        if(yyssp == yyss)
-            YYABORT;
+      /* Pop the current state because it cannot handle the error token.  */
+      if (yyssp == yyss)
+        YYABORT;
 
 
-        yydestruct("Error: popping",
-                   yystos[yystate], yyvsp);
-        YYPOPSTACK(1);
-        yystate = *yyssp;
-        YY_STACK_PRINT(yyss, yyssp);
+      yydestruct ("Error: popping",
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, scanner, state);
+      YYPOPSTACK (1);
+      yystate = *yyssp;
+      YY_STACK_PRINT (yyss, yyssp);
     }
 
-    YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-    *++yyvsp = yylval;
-    YY_IGNORE_MAYBE_UNINITIALIZED_END
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 
 
-    /* Shift the error token.  */
-    YY_SYMBOL_PRINT("Shifting", yystos[yyn], yyvsp, yylsp);
+  /* Shift the error token.  */
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
 
-    yystate = yyn;
-    goto yynewstate;
+  yystate = yyn;
+  goto yynewstate;
 
 
-    /*-------------------------------------.
-    | yyacceptlab -- YYACCEPT comes here.  |
-    `-------------------------------------*/
+/*-------------------------------------.
+| yyacceptlab -- YYACCEPT comes here.  |
+`-------------------------------------*/
 yyacceptlab:
-    yyresult = 0;
-    goto yyreturn;
+  yyresult = 0;
+  goto yyreturnlab;
+
 
-    /*-----------------------------------.
-    | yyabortlab -- YYABORT comes here.  |
-    `-----------------------------------*/
+/*-----------------------------------.
+| yyabortlab -- YYABORT comes here.  |
+`-----------------------------------*/
 yyabortlab:
-    yyresult = 1;
-    goto yyreturn;
+  yyresult = 1;
+  goto yyreturnlab;
 
-#if !defined yyoverflow || YYERROR_VERBOSE
-    /*-------------------------------------------------.
-    | yyexhaustedlab -- memory exhaustion comes here.  |
-    `-------------------------------------------------*/
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
 yyexhaustedlab:
-    yyerror(YY_("memory exhausted"));
-    yyresult = 2;
-    /* Fall through.  */
-#endif
+  yyerror (scanner, state, YY_("memory exhausted"));
+  yyresult = 2;
+  goto yyreturnlab;
 
-yyreturn:
-    if(yychar != YYEMPTY) {
-        /* Make sure we have latest lookahead translation.  See comments at
-           user semantic actions for why this is necessary.  */
-        yytoken = YYTRANSLATE(yychar);
-        yydestruct("Cleanup: discarding lookahead",
-                   yytoken, &yylval);
-    }
-    /* Do not reclaim the symbols of the rule whose action triggered
-       this YYABORT or YYACCEPT.  */
-    YYPOPSTACK(yylen);
-    YY_STACK_PRINT(yyss, yyssp);
-    while(yyssp != yyss) {
-        yydestruct("Cleanup: popping",
-                   yystos[*yyssp], yyvsp);
-        YYPOPSTACK(1);
+
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
+  if (yychar != DCEMPTY)
+    {
+      /* Make sure we have latest lookahead translation.  See comments at
+         user semantic actions for why this is necessary.  */
+      yytoken = YYTRANSLATE (yychar);
+      yydestruct ("Cleanup: discarding lookahead",
+                  yytoken, &yylval, scanner, state);
+    }
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYABORT or YYACCEPT.  */
+  YYPOPSTACK (yylen);
+  YY_STACK_PRINT (yyss, yyssp);
+  while (yyssp != yyss)
+    {
+      yydestruct ("Cleanup: popping",
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, scanner, state);
+      YYPOPSTACK (1);
     }
 #ifndef yyoverflow
-    if(yyss != yyssa)
-        YYSTACK_FREE(yyss);
+  if (yyss != yyssa)
+    YYSTACK_FREE (yyss);
 #endif
-#if YYERROR_VERBOSE
-    if(yymsg != yymsgbuf)
-        YYSTACK_FREE(yymsg);
-#endif
-    return yyresult;
+  if (yymsg != yymsgbuf)
+    YYSTACK_FREE (yymsg);
+  return yyresult;
 }
 
-/* Start helper function section */
-namespace bamboo   // open namespace bamboo
-{
+ /* Start helper function section */
+namespace bamboo { // open namespace bamboo
 
 
-Module *read_dcfile(istream& in, const string& filename)
-{
+Module *read_dcfile(istream& in, const string& filename) {
     Module *m = new Module();
     bool ok = parse_dcfile(m, in, filename);
     if(ok) {
@@ -3350,8 +3503,7 @@ Module *read_dcfile(istream& in, const string& filename)
 
     return nullptr;
 }
-Module *read_dcfile(const string& filename)
-{
+Module *read_dcfile(const string& filename) {
     Module *m = new Module();
     bool ok = parse_dcfile(m, filename);
     if(ok) {
@@ -3360,15 +3512,17 @@ Module *read_dcfile(const string& filename)
 
     return nullptr;
 }
-bool parse_dcfile(Module *m, istream& in, const string& filename)
-{
-    dcparser_init_file(in, filename, *m);
-    dcparse();
-    dcparser_cleanup();
-    return (dc_errors() == 0);
+bool parse_dcfile(Module *m, istream& in, const string& filename) {
+    LexerState lexer(in, filename, START_DC_FILE);
+    ParserState state;
+    state.lexer = &lexer;
+    state.module = m;
+
+    ScannerGuard guard(&lexer);
+    dcparse(guard.scanner, &state);
+    return (lexer.error_count == 0);
 }
-bool parse_dcfile(Module *m, const string& filename)
-{
+bool parse_dcfile(Module *m, const string& filename) {
     ifstream in;
     in.open(filename.c_str());
     if(!in) {
@@ -3377,25 +3531,27 @@ bool parse_dcfile(Module *m, const string& filename)
     }
     return parse_dcfile(m, in, filename);
 }
-vector<uint8_t> parse_dcvalue(const Type *dtype, const string& formatted, bool& err)
-{
+vector<uint8_t> parse_dcvalue(const Type *dtype, const string& formatted, bool& err) {
     istringstream strm(formatted);
     return parse_dcvalue(dtype, strm, err);
 
 }
-vector<uint8_t> parse_dcvalue(const Type *dtype, istream& in, bool& err)
-{
+vector<uint8_t> parse_dcvalue(const Type *dtype, istream& in, bool& err) {
     vector<uint8_t> value;
+    LexerState lexer(in, "parse_value()", START_DC_VALUE);
+    ParserState state;
+    state.lexer = &lexer;
+    state.value = &value;
+    state.type_stack.push(TypeAndDepth(dtype, 0));
     try {
-        dcparser_init_value(in, "parse_value()", dtype, value);
-        dcparse();
-        dcparser_cleanup();
-    } catch(const exception&) {
+        ScannerGuard guard(&lexer);
+        dcparse(guard.scanner, &state);
+    } catch(const exception& e) {
         err = true;
         return vector<uint8_t>();
     }
 
-    if(dc_errors() > 0) {
+    if(lexer.error_count > 0) {
         err = true;
         return vector<uint8_t>();
     }
@@ -3405,141 +3561,176 @@ vector<uint8_t> parse_dcvalue(const Type *dtype, istream& in, bool& err)
 }
 
 
-bool check_depth()
+bool check_depth(ParserState *state)
+{
+    return (!state->type_stack.empty() && state->current_depth == state->type_stack.top().depth);
+}
+
+// has_errors returns true if the lexer or parser has reported an error, in which case
+//     the packed value may be incomplete and shouldn't be used as a default.
+bool has_errors(ParserState *state)
+{
+    return (state->lexer->error_count > 0);
+}
+
+// shared_type makes the module responsible for deleting a type which isn't owned by a field,
+//     such as a parameter's type, an array's element type or a typedef, and returns the type.
+//     Structs, classes and typedefs which were already declared belong to the module.
+Type *shared_type(ParserState *state, Type *type)
+{
+    if(type == nullptr || type == Type::invalid || type->as_struct() != nullptr) {
+        return type;
+    }
+    if(type->has_alias() && state->module->type_by_name(type->alias()) == type) {
+        return type;
+    }
+
+    state->module->add_shared_type(unique_ptr<Type>(type));
+    return type;
+}
+
+// builtin_element returns the element type of a string (char) or a blob (uint8).
+//     Each is created once per parse, and is shared by every string or blob in the module.
+Type *builtin_element(ParserState *state, Subtype subtype)
 {
-    return (!type_stack.empty() && current_depth == type_stack.top().depth);
+    Type*& element = (subtype == kTypeChar) ? state->char_type : state->byte_type;
+    if(element == nullptr) {
+        element = shared_type(state, new Numeric(subtype));
+    }
+    return element;
 }
 
-void depth_error(string what)
+void depth_error(void *scanner, ParserState *state, string what)
 {
-    if(type_stack.empty() || current_depth < type_stack.top().depth) {
-        dcerror("Too many nested values while parsing value for " + what + ".");
+    if(state->type_stack.empty() || state->current_depth < state->type_stack.top().depth) {
+        dcerror(scanner, "Too many nested values while parsing value for " + what + ".");
     } else {
-        dcerror("Too few nested values while parsing value for " + what + ".");
+        dcerror(scanner, "Too few nested values while parsing value for " + what + ".");
     }
 }
 
-void depth_error(int depth, string what)
+void depth_error(void *scanner, ParserState *state, int depth, string what)
 {
-    if(current_depth > depth) {
-        dcerror("Too few nested values before this " + what + " value.");
+    if(state->current_depth > depth) {
+        dcerror(scanner, "Too few nested values before this " + what + " value.");
     } else {
-        dcerror("Too many nested values before this " + what + " value.");
+        dcerror(scanner, "Too many nested values before this " + what + " value.");
     }
 }
 
-vector<uint8_t> number_value(Subtype type, double& number)
+vector<uint8_t> number_value(void *scanner, Subtype type, double &number)
 {
     switch(type) {
-    case kTypeFloat32:
-        if(isinf(float(number))) { dcerror("Value is out of range for type 'float32'."); }
-        return as_buffer(float(number));
-    case kTypeFloat64:
-        return as_buffer(number);
-    case kTypeInt8:
-    case kTypeInt16:
-    case kTypeInt32:
-    case kTypeInt64:
-    case kTypeChar:
-    case kTypeUint8:
-    case kTypeUint16:
-    case kTypeUint32:
-    case kTypeUint64:
-        dcerror("Cannot use floating-point value for integer datatype.");
-        return vector<uint8_t>();
-    default:
-        dcerror("Cannot use floating-point value for non-numeric datatype.");
-        return vector<uint8_t>();
+        case kTypeFloat32:
+            if(isinf(float(number))) { dcerror(scanner, "Value is out of range for type 'float32'."); }
+            return as_buffer(float(number));
+        case kTypeFloat64:
+            return as_buffer(number);
+        case kTypeInt8:
+        case kTypeInt16:
+        case kTypeInt32:
+        case kTypeInt64:
+        case kTypeChar:
+        case kTypeUint8:
+        case kTypeUint16:
+        case kTypeUint32:
+        case kTypeUint64:
+            dcerror(scanner, "Cannot use floating-point value for integer datatype.");
+            return vector<uint8_t>();
+        default:
+            dcerror(scanner, "Cannot use floating-point value for non-numeric datatype.");
+            return vector<uint8_t>();
     }
 }
 
-vector<uint8_t> number_value(Subtype type, int64_t& number)
+vector<uint8_t> number_value(void *scanner, Subtype type, int64_t &number)
 {
     switch(type) {
-    case kTypeInt8:
-        if(INT8_MIN > number || number > INT8_MAX) {
-            dcerror("Signed integer out of range for type 'int8'.");
-        }
-        return as_buffer(int8_t(number));
-    case kTypeInt16:
-        if(INT16_MIN > number || number > INT16_MAX) {
-            dcerror("Signed integer out of range for type 'int16'.");
-        }
-        return as_buffer(int16_t(number));
-    case kTypeInt32:
-        if(INT32_MIN > number || number > INT32_MAX) {
-            dcerror("Signed integer out of range for type 'int32'.");
-        }
-        return as_buffer(int32_t(number));
-    case kTypeInt64:
-        return as_buffer(number);
-    case kTypeChar:
-    case kTypeUint8:
-    case kTypeUint16:
-    case kTypeUint32:
-    case kTypeUint64: {
-        if(number < 0) {
-            dcerror("Can't use negative value for unsigned integer datatype.");
-        }
-        uint64_t value = number;
-        return number_value(type, value);
-    }
-    case kTypeFloat32:
-    case kTypeFloat64: {
-        // Note: Expecting number to be converted to a double by value (ie. 3 becomes 3.0)
-        double value = double(number);
-        return number_value(type, value);
-    }
-    default:
-        dcerror("Cannot use signed integer value for non-numeric datatype.");
-        return vector<uint8_t>();
+        case kTypeInt8:
+            if(INT8_MIN > number || number > INT8_MAX) {
+                dcerror(scanner, "Signed integer out of range for type 'int8'.");
+            }
+            return as_buffer(int8_t(number));
+        case kTypeInt16:
+            if(INT16_MIN > number || number > INT16_MAX) {
+                dcerror(scanner, "Signed integer out of range for type 'int16'.");
+            }
+            return as_buffer(int16_t(number));
+        case kTypeInt32:
+            if(INT32_MIN > number || number > INT32_MAX) {
+                dcerror(scanner, "Signed integer out of range for type 'int32'.");
+            }
+            return as_buffer(int32_t(number));
+        case kTypeInt64:
+            return as_buffer(number);
+        case kTypeChar:
+        case kTypeUint8:
+        case kTypeUint16:
+        case kTypeUint32:
+        case kTypeUint64: {
+            if(number < 0) {
+                dcerror(scanner, "Can't use negative value for unsigned integer datatype.");
+            }
+            uint64_t value = number;
+            return number_value(scanner, type, value);
+        }
+        case kTypeFloat32:
+        case kTypeFloat64: {
+            // Note: Expecting number to be converted to a double by value (ie. 3 becomes 3.0)
+            double value = number;
+            return number_value(scanner, type, value);
+        }
+        default:
+            dcerror(scanner, "Cannot use signed integer value for non-numeric datatype.");
+            return vector<uint8_t>();
     }
 }
 
-vector<uint8_t> number_value(Subtype type, uint64_t& number)
+vector<uint8_t> number_value(void *scanner, Subtype type, uint64_t &number)
 {
-    switch(type) {
-    case kTypeChar:
-        if(number > UINT8_MAX) {
-            dcerror("Unsigned integer out of range for type 'char'.");
-        }
-        return as_buffer(char(number));
-    case kTypeUint8:
-        if(number > UINT8_MAX) {
-            dcerror("Unsigned integer out of range for type 'uint8'.");
-        }
-        return as_buffer(uint8_t(number));
-    case kTypeUint16:
-        if(number > UINT16_MAX) {
-            dcerror("Unsigned integer out of range for type 'uint16'.");
-        }
-        return as_buffer(uint16_t(number));
-    case kTypeUint32:
-        if(number > UINT32_MAX) {
-            dcerror("Unsigned integer out of range for type 'uint32'.");
-        }
-        return as_buffer(uint32_t(number));
-    case kTypeUint64:
-        return as_buffer(number);
-    case kTypeInt8:
-    case kTypeInt16:
-    case kTypeInt32:
-    case kTypeInt64: {
-        if(number > INT64_MAX) {
-            dcerror("Unsigned integer out of range for signed integer datatype.");
-        }
-        int64_t value = number;
-        return number_value(type, value);
-    }
-    case kTypeFloat32:
-    case kTypeFloat64: {
-        // Note: Expecting number to be converted to a double by value (ie. 3 becomes 3.0)
-        double value = double(number);
-        return number_value(type, value);
-    }
-    default:
-        dcerror("Cannot use unsigned integer value for non-numeric datatype.");
-        return vector<uint8_t>();
+    switch(type)
+    {
+        case kTypeChar:
+            if(number > UINT8_MAX) {
+                dcerror(scanner, "Unsigned integer out of range for type 'char'.");
+            }
+            return as_buffer(char(number));
+        case kTypeUint8:
+            if(number > UINT8_MAX) {
+                dcerror(scanner, "Unsigned integer out of range for type 'uint8'.");
+            }
+            return as_buffer(uint8_t(number));
+        case kTypeUint16:
+            if(number > UINT16_MAX) {
+                dcerror(scanner, "Unsigned integer out of range for type 'uint16'.");
+            }
+            return as_buffer(uint16_t(number));
+        case kTypeUint32:
+            if(number > UINT32_MAX) {
+                dcerror(scanner, "Unsigned integer out of range for type 'uint32'.");
+            }
+            return as_buffer(uint32_t(number));
+        case kTypeUint64:
+            return as_buffer(number);
+        case kTypeInt8:
+        case kTypeInt16:
+        case kTypeInt32:
+        case kTypeInt64: {
+            if(number > INT64_MAX) {
+                dcerror(scanner, "Unsigned integer out of range for signed integer datatype.");
+            }
+            int64_t value = number;
+            return number_value(scanner, type, value);
+        }
+        case kTypeFloat32:
+        case kTypeFloat64: {
+            // Note: Expecting number to be converted to a double by value (ie. 3 becomes 3.0)
+            double value = number;
+            return number_value(scanner, type, value);
+        }
+        default:
+            dcerror(scanner, "Cannot use unsigned integer value for non-numeric datatype.");
+            return vector<uint8_t>();
     }
 }
 
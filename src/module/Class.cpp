@@ -25,6 +25,7 @@ const Class *Class::as_class() const
 bool Class::add_parent(Class *parent)
 {
     if(parent == nullptr) { return false; }
+    if(m_module->is_finalized()) { return false; }
 
     parent->add_child(this);
     m_parents.push_back(parent);
@@ -59,6 +60,11 @@ bool Class::add_field(unique_ptr<Field> field)
         return false;
     }
 
+    // A finalized module can't be changed
+    if(m_module->is_finalized()) {
+        return false;
+    }
+
     // Classes can't share fields.
     if(field->record() != nullptr && field->record() != this) {
         return false;
@@ -90,8 +96,8 @@ bool Class::add_field(unique_ptr<Field> field)
 
         // Add the field to the field dictionaries
         m_module->add_field(ref);
-        m_fields_by_id[field->id()] = ref;
-        m_fields_by_name[field->name()] = ref;
+        m_fields_by_name[Symbol::intern(field->name())] = ref;
+        update_field_ids(ref);
 
         // Transfer ownership of the Field to the Class
         field->set_struct(this);
@@ -101,16 +107,17 @@ bool Class::add_field(unique_ptr<Field> field)
     }
 
     // Add it to the set of our base field names
-    bool inserted = m_base_names.insert(field->name()).second;
+    Symbol name = Symbol::intern(field->name());
+    bool inserted = m_base_names.insert(name).second;
     // Fail if there is a name conflict
     if(!inserted) {
         return false;
     }
 
     // If a parent has a field with the same name, shadow it
-    auto prev_field = m_fields_by_name.find(field->name());
-    if(prev_field != m_fields_by_name.end()) {
-        shadow_field(prev_field->second);
+    Field **prev_field = m_fields_by_name.find(name);
+    if(prev_field != nullptr) {
+        shadow_field(*prev_field);
     }
 
     // Add the field to our full field list
@@ -118,9 +125,8 @@ bool Class::add_field(unique_ptr<Field> field)
 
     // Add the field to the field dictionaries
     m_module->add_field(ref);
-    m_fields_by_id[field->id()] = ref;
-    m_fields_by_name[field->name()] = ref;
-    m_indices_by_name[field->name()] = (unsigned int)m_fields.size() - 1;
+    m_fields_by_name[name] = ref;
+    m_indices_by_name[name] = (unsigned int)m_fields.size() - 1;
 
     // Update our size
     if(field->as_molecular() == nullptr
@@ -132,6 +138,8 @@ bool Class::add_field(unique_ptr<Field> field)
         }
     }
 
+    append_field(m_constructor.get());
+
     // Tell our children about the new field
     for(auto it = m_children.begin(); it != m_children.end(); ++it) {
         (*it)->add_inherited_field(this, ref);
@@ -148,40 +156,41 @@ bool Class::add_field(unique_ptr<Field> field)
 void Class::add_inherited_field(Class *parent, Field *field)
 {
     // If the field name matches any base field, it is shadowed.
-    if(m_base_names.find(field->name()) != m_base_names.end()) {
+    Symbol name = Symbol::intern(field->name());
+    if(m_base_names.find(name) != m_base_names.end()) {
         return;
     }
 
     // If another superclass provides a field with that name, the first parent takes precedence
-    auto prev_field = m_fields_by_name.find(field->name());
-    if(prev_field != m_fields_by_name.end()) {
-        Struct *parentB = prev_field->second->record();
+    Field **found = m_fields_by_name.find(name);
+    if(found != nullptr) {
+        Field *prev_field = *found;
+        Struct *parentB = prev_field->record();
         for(auto it = m_parents.begin(); it != m_parents.end(); ++it) {
             if((*it) == parentB) {
                 // The early parent's field takes precedence over the new field
                 return;
             } else if((*it) == parent) {
                 // This parent was added before the later parent, so shadow its field
-                shadow_field(prev_field->second);
+                shadow_field(prev_field);
             }
         }
     }
 
     // Add the field to our lookup tables
-    m_fields_by_id[field->id()] = field;
-    m_fields_by_name[field->name()] = field;
+    m_fields_by_name[name] = field;
 
     // Add the field to the list of fields, sorted by id
     if(m_fields.size() == 0) {
         m_fields.push_back(field);
-        m_indices_by_name[field->name()] = 1;
+        m_indices_by_name[name] = 1;
     } else {
         unsigned int index = (unsigned int)m_fields.size() - 1;
         // Note: Iterate in reverse because fields added later are more likely to be at the end
         for(auto it = m_fields.rbegin(); it != m_fields.rend(); ++it) {
             if((*it)->id() < field->id()) {
                 m_fields.insert(it.base(), field);
-                m_indices_by_name[field->name()] = index;
+                m_indices_by_name[name] = index;
                 break;
             }
             index -= 1;
@@ -197,6 +206,13 @@ void Class::add_inherited_field(Class *parent, Field *field)
         }
     }
 
+    if(m_fields.back() == field) {
+        append_field(m_constructor.get());
+    } else {
+        update_offsets();
+        update_field_ids(m_constructor.get());
+    }
+
     // Tell our children about the new field
     for(auto it = m_children.begin(); it != m_children.end(); ++it) {
         (*it)->add_inherited_field(this, field);
@@ -211,15 +227,17 @@ void Class::shadow_field(Field *field)
         m_size -= field->type()->fixed_size();
     }
 
-    m_fields_by_id.erase(field->id());
-    m_fields_by_name.erase(field->name());
-    m_indices_by_name.erase(field->name());
+    Symbol name = Symbol::find(field->name());
+    m_fields_by_name.erase(name);
+    m_indices_by_name.erase(name);
     for(auto it = m_fields.begin(); it != m_fields.end(); ++it) {
         if((*it) == field) {
             m_fields.erase(it);
             break;
         }
     }
+    update_offsets();
+    update_field_ids(m_constructor.get());
 
     // Tell our children to shadow the field
     for(auto it = m_children.begin(); it != m_children.end(); ++it) {
@@ -69,7 +69,7 @@ class Class : public Struct
     void shadow_field(Field *field);
 
     std::unique_ptr<Field> m_constructor;
-    std::unordered_set<std::string> m_base_names;
+    std::unordered_set<Symbol> m_base_names;
     std::vector<Class *> m_parents;
     std::vector<Class *> m_children;
 };
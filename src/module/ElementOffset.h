@@ -0,0 +1,26 @@
+// Filename: ElementOffset.h
+#pragma once
+#include <stddef.h> // for size_t
+namespace bamboo   // open namespace bamboo
+{
+
+
+// An ElementOffset locates a field of a Struct, or a parameter of a Method, within packed data.
+//     If anchor is kNoAnchor, the element starts <offset> bytes after the start of the value.
+//     Otherwise, the element starts <offset> bytes after the end of the element at index
+//     <anchor>, which is the closest preceding element that has a variable size.
+struct ElementOffset {
+    static const unsigned int kNoAnchor = (unsigned int)(-1);
+
+    unsigned int anchor;
+    size_t offset;
+
+    // is_fixed returns true if the element is at a fixed offset from the start of the value.
+    bool is_fixed() const
+    {
+        return anchor == kNoAnchor;
+    }
+};
+
+
+} // close namespace bamboo
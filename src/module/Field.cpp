@@ -3,6 +3,7 @@
 #include "../module/Module.h"
 #include "../module/Struct.h"
 #include "Value.h"
+#include <stdexcept> // std::out_of_range
 using namespace std;
 namespace bamboo   // open namespace
 {
@@ -16,8 +17,17 @@ Field::Field(Type *type, const string& name) : m_type(type), m_name(name)
 // destructor
 Field::~Field()
 {
-    delete m_type;
+    // The default value refers to the type, so it must be deleted first
     delete m_default_value;
+    // Structs and typedefs are owned by the module, not by the fields which use them
+    if(m_type == nullptr || m_type == Type::invalid || m_type->as_struct() != nullptr) {
+        return;
+    }
+    if(m_struct != nullptr && m_type->has_alias() &&
+       m_struct->module()->type_by_name(m_type->alias()) == m_type) {
+        return;
+    }
+    delete m_type;
 }
 
 // as_molecular returns this as a MolecularField if it is molecular, or nullptr otherwise.
@@ -34,6 +44,11 @@ const MolecularField *Field::as_molecular() const
 //     the same name already exists in the containing struct.
 bool Field::set_name(const string& name)
 {
+    // A finalized module can't be changed
+    if(is_finalized()) {
+        return false;
+    }
+
     // Check to make sure no other fields in our struct have this name
     if(m_struct != nullptr && m_struct->field_by_name(name) != nullptr) {
         return false;
@@ -44,8 +59,13 @@ bool Field::set_name(const string& name)
 }
 
 // set_type sets the distributed type of the field and clear's the default value.
-void Field::set_type(Type *type)
+bool Field::set_type(Type *type)
 {
+    // A finalized module can't be changed
+    if(is_finalized()) {
+        return false;
+    }
+
     m_type = type;
 
     // Reset our default value, if we had one
@@ -53,6 +73,15 @@ void Field::set_type(Type *type)
         delete m_default_value;
         m_default_value = nullptr;
     }
+
+    return true;
+}
+
+// keywords_locked returns true if the field's keywords can no longer be changed.
+bool Field::keywords_locked() const
+{
+    // A finalized module can't be changed
+    return is_finalized();
 }
 
 // set_default_value establishes a default value for this field.
@@ -60,6 +89,7 @@ void Field::set_type(Type *type)
 bool Field::set_default_value(const Value& default_value)
 {
     // TODO: Validate default value
+    if(is_finalized()) { return false; }
     if(m_default_value != nullptr) { delete m_default_value; }
     m_default_value = new Value(default_value);
     return true;
@@ -70,7 +100,25 @@ bool Field::set_default_value(const Value *default_value)
 }
 bool Field::set_default_value(const vector<uint8_t>& default_value)
 {
-    return set_default_value(Value(m_type, default_value));
+    if(is_finalized()) { return false; }
+
+    // Unpack the value in place, rather than unpacking a temporary and copying it.
+    Value *value;
+    try {
+        value = new Value(m_type, default_value);
+    } catch(const out_of_range&) {
+        // The packed data is too short for the field's type
+        return false;
+    }
+    if(m_default_value != nullptr) { delete m_default_value; }
+    m_default_value = value;
+    return true;
+}
+
+// is_finalized returns true if the field belongs to a module which has been finalized.
+bool Field::is_finalized() const
+{
+    return (m_struct != nullptr && m_struct->module()->is_finalized());
 }
 
 // set_id sets the unique index number associated with the field.
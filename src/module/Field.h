@@ -50,10 +50,12 @@ class Field : public KeywordList
     bool set_name(const std::string&);
 
     // set_type sets the distributed type of the field and clear's the default value.
-    void set_type(Type *);
+    //     Returns false if the field's module has been finalized.
+    bool set_type(Type *);
 
     // set_default_value defines a default value for this field.
-    //     Returns false if the value is invalid for the field's type.
+    //     Returns false if the value is invalid for the field's type,
+    //     or if the field's module has been finalized.
     virtual bool set_default_value(const Value&);
     virtual bool set_default_value(const Value *);
     virtual bool set_default_value(const std::vector<uint8_t>& packed);
@@ -63,6 +65,11 @@ class Field : public KeywordList
     };
 
   protected:
+    // is_finalized returns true if the field belongs to a module which has been finalized.
+    bool is_finalized() const;
+    // keywords_locked returns true once the field's module has been finalized.
+    bool keywords_locked() const override;
+
     // set_id sets the unique index number associated with the field.
     void set_id(unsigned int id);
     friend class Module;
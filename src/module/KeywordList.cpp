@@ -19,7 +19,9 @@ KeywordList::KeywordList(const KeywordList& other) :
 // assignment operator
 KeywordList& KeywordList::operator=(KeywordList rhs)
 {
-    swap(*this, rhs);
+    if(!keywords_locked()) {
+        swap(*this, rhs);
+    }
     return *this;
 }
 
@@ -57,6 +59,10 @@ void KeywordList::copy_keywords(const KeywordList& other)
 // add_keyword adds the indicated keyword to the list.
 bool KeywordList::add_keyword(const string& keyword)
 {
+    if(keywords_locked()) {
+        return false;
+    }
+
     bool inserted = m_keywords_by_name.insert(keyword).second;
     if(inserted) {
         m_keywords.push_back(keyword);
@@ -65,6 +71,12 @@ bool KeywordList::add_keyword(const string& keyword)
     return inserted;
 }
 
+// keywords_locked returns true if the list can no longer be changed.
+bool KeywordList::keywords_locked() const
+{
+    return false;
+}
+
 
 void swap(KeywordList& lhs, KeywordList& rhs)
 {
@@ -32,12 +32,18 @@ class KeywordList
     bool has_matching_keywords(const KeywordList& other) const;
 
     // copy_keywords replaces this keyword list with those from the other list.
+    //     Does nothing if the list is locked.
     void copy_keywords(const KeywordList& other);
 
     // add_keyword adds the indicated keyword to the list.
-    //     Returns true if it is added, false if it was already there.
+    //     Returns true if it is added, false if it was already there or the list is locked.
     bool add_keyword(const std::string& keyword);
 
+  protected:
+    // keywords_locked returns true if the list can no longer be changed.
+    //     A Field's keywords are locked once its module has been finalized.
+    virtual bool keywords_locked() const;
+
   private:
     std::vector<std::string> m_keywords; // the actual list of keywords
     std::unordered_set<std::string> m_keywords_by_name; // a map of name to keywords in list
@@ -10,6 +10,10 @@ namespace bamboo   // open namespace
 Method::Method()
 {
     m_subtype = kTypeMethod;
+
+    // The end of an empty method is its start
+    ElementOffset end = {ElementOffset::kNoAnchor, 0};
+    m_offsets.push_back(end);
 }
 
 // as_method returns this as a Method if it is a method, or nullptr otherwise.
@@ -34,18 +38,18 @@ bool Method::add_parameter(unique_ptr<Parameter> param)
 
     if(!param->name().empty()) {
         // Try to add the parameter
-        bool inserted = m_parameters_by_name.insert(
-                            unordered_map<string, Parameter *>::value_type(param->name(), ref)).second;
+        Symbol name = Symbol::intern(param->name());
+        bool inserted = m_parameters_by_name.insert(name, ref);
         if(!inserted) {
             // But the parameter had a name conflict
             return false;
         }
         // The size of the list is the index of the next item in the list
-        m_indices_by_name[param->name()] = (unsigned int)m_parameters.size();
+        m_indices_by_name[name] = (unsigned int)m_parameters.size();
     }
 
     // Update our size
-    if(has_fixed_size() || m_parameters.size() == 1) {
+    if(has_fixed_size() || m_parameters.empty()) {
         if(param->type()->has_fixed_size()) {
             m_size += param->type()->fixed_size();
         } else {
@@ -53,6 +57,16 @@ bool Method::add_parameter(unique_ptr<Parameter> param)
         }
     }
 
+    // The new parameter begins at the old end, and the end moves past the new parameter
+    ElementOffset end = m_offsets.back();
+    if(param->type()->has_fixed_size()) {
+        end.offset += param->type()->fixed_size();
+    } else {
+        end.anchor = (unsigned int)m_parameters.size();
+        end.offset = 0;
+    }
+    m_offsets.push_back(end);
+
     // Transfer ownership of the Parameter to the Method
     param->set_position((unsigned int)m_parameters.size());
     param->set_method(this);
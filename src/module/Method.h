@@ -2,9 +2,11 @@
 #pragma once
 #include <memory>        // std::unique_ptr
 #include <vector>        // std::vector
-#include <unordered_map> // std::unordered_map
 #include "Type.h"
+#include "ElementOffset.h"
 #include "Parameter.h"
+#include "Symbol.h"
+#include "SymbolMap.h"
 namespace bamboo   // open namespace
 {
 
@@ -29,9 +31,19 @@ class Method : public Type
     // get_parameter returns the <n>th parameter of the method.
     inline Parameter *get_parameter(unsigned int n);
     inline const Parameter *get_parameter(unsigned int n) const;
+    // parameter_offset returns the location of the <n>th parameter within the packed arguments.
+    //     Passing n == num_parameters() returns the location of the end of the arguments.
+    //     Throws std::out_of_range
+    inline const ElementOffset& parameter_offset(unsigned int n) const;
+
     // parameter_by_name returns the requested parameter or nullptr if there is no such param.
+    //     Looking up a Symbol is cheapest; a string is first resolved with Symbol::find.
     inline Parameter *parameter_by_name(const std::string& name);
     inline const Parameter *parameter_by_name(const std::string& name) const;
+    inline Parameter *parameter_by_name(const char *name);
+    inline const Parameter *parameter_by_name(const char *name) const;
+    inline Parameter *parameter_by_name(Symbol name);
+    inline const Parameter *parameter_by_name(Symbol name) const;
 
     // add_parameter adds a new parameter to the method.
     //     Returns false if the parameter could not be added to the method.
@@ -39,8 +51,9 @@ class Method : public Type
 
   private:
     std::vector<std::unique_ptr<Parameter> > m_parameters;
-    std::unordered_map<std::string, unsigned int> m_indices_by_name;
-    std::unordered_map<std::string, Parameter *> m_parameters_by_name;
+    std::vector<ElementOffset> m_offsets;
+    SymbolMap<unsigned int> m_indices_by_name;
+    SymbolMap<Parameter *> m_parameters_by_name;
 };
 
 
@@ -13,20 +13,31 @@ inline Parameter *Method::get_parameter(unsigned int n) {
 inline const Parameter *Method::get_parameter(unsigned int n) const {
     return m_parameters.at(n).get();
 }
+// parameter_offset returns the location of the <n>th parameter within the packed arguments.
+inline const ElementOffset& Method::parameter_offset(unsigned int n) const {
+    return m_offsets.at(n);
+}
+
 // parameter_by_name returns the parameter with <name>, or nullptr if no such param exists.
 inline Parameter *Method::parameter_by_name(const std::string& name) {
-    auto it = m_parameters_by_name.find(name);
-    if(it == m_parameters_by_name.end()) {
-        return nullptr;
-    }
-    return it->second;
+    return parameter_by_name(Symbol::find(name));
 }
 inline const Parameter *Method::parameter_by_name(const std::string& name) const {
-    auto it = m_parameters_by_name.find(name);
-    if(it == m_parameters_by_name.end()) {
-        return nullptr;
-    }
-    return it->second;
+    return parameter_by_name(Symbol::find(name));
+}
+inline Parameter *Method::parameter_by_name(const char *name) {
+    return parameter_by_name(Symbol::find(name));
+}
+inline const Parameter *Method::parameter_by_name(const char *name) const {
+    return parameter_by_name(Symbol::find(name));
+}
+inline Parameter *Method::parameter_by_name(Symbol name) {
+    Parameter *const *param = m_parameters_by_name.find(name);
+    return param != nullptr ? *param : nullptr;
+}
+inline const Parameter *Method::parameter_by_name(Symbol name) const {
+    Parameter *const *param = m_parameters_by_name.find(name);
+    return param != nullptr ? *param : nullptr;
 }
 
 
@@ -7,13 +7,27 @@ namespace bamboo   // open namespace
 {
 
 
-typedef std::unordered_map<std::string, Type *>::value_type TypeName;
-
 // constructor
 Module::Module()
 {
 }
 
+// destructor
+Module::~Module()
+{
+    m_schema.reset();
+
+    // A struct or class may refer to the ones declared before it, for example in the default
+    //     value of a field, so they are destroyed in the reverse of the order they were added.
+    while(!m_structs.empty() || !m_classes.empty()) {
+        if(m_classes.empty() || (!m_structs.empty() && m_structs.back()->id() > m_classes.back()->id())) {
+            m_structs.pop_back();
+        } else {
+            m_classes.pop_back();
+        }
+    }
+}
+
 // class_by_id returns the requested class or nullptr if there is no such class.
 Class *Module::class_by_id(unsigned int id)
 {
@@ -39,6 +53,22 @@ const Class *Module::class_by_id(unsigned int id) const
 }
 // class_by_name returns the requested class or nullptr if there is no such class.
 Class *Module::class_by_name(const std::string& name)
+{
+    return class_by_name(Symbol::find(name));
+}
+const Class *Module::class_by_name(const std::string& name) const
+{
+    return class_by_name(Symbol::find(name));
+}
+Class *Module::class_by_name(const char *name)
+{
+    return class_by_name(Symbol::find(name));
+}
+const Class *Module::class_by_name(const char *name) const
+{
+    return class_by_name(Symbol::find(name));
+}
+Class *Module::class_by_name(Symbol name)
 {
     Type *dt = type_by_name(name);
     if(dt == nullptr) {
@@ -49,7 +79,7 @@ Class *Module::class_by_name(const std::string& name)
     }
     return dt->as_struct()->as_class();
 }
-const Class *Module::class_by_name(const std::string& name) const
+const Class *Module::class_by_name(Symbol name) const
 {
     const Type *dt = type_by_name(name);
     if(dt == nullptr) {
@@ -68,13 +98,18 @@ bool Module::add_class(std::unique_ptr<Class> cls)
 {
     Class *ref = cls.get();
 
+    // A finalized module can't be changed
+    if(is_finalized()) {
+        return false;
+    }
+
     // Classes have to have a name
     if(cls->name().empty()) {
         return false;
     }
 
     // A Class can't share a name with any other type.
-    bool inserted = m_types_by_name.insert(TypeName(cls->name(), ref)).second;
+    bool inserted = m_types_by_name.insert(Symbol::intern(cls->name()), ref);
     if(!inserted) {
         return false;
     }
@@ -95,13 +130,18 @@ bool Module::add_struct(std::unique_ptr<Struct> record)
 {
     Struct *ref = record.get();
 
+    // A finalized module can't be changed
+    if(is_finalized()) {
+        return false;
+    }
+
     // Structs have to have a name
     if(record->name().empty()) {
         return false;
     }
 
     // A Struct can't share a name with any other type.
-    bool inserted = m_types_by_name.insert(TypeName(record->name(), ref)).second;
+    bool inserted = m_types_by_name.insert(Symbol::intern(record->name()), ref);
     if(!inserted) {
         return false;
     }
@@ -119,33 +159,61 @@ bool Module::add_struct(std::unique_ptr<Struct> record)
 //     Returns false if there is a name conflict.
 bool Module::add_typedef(const std::string& name, Type *type)
 {
-    // Typedefs can't use the empty string as a name
-    if(name.empty()) {
+    // Typedefs can't use the empty string as a name, or be added to a finalized module
+    if(name.empty() || is_finalized()) {
         return false;
     }
 
     // A type alias can't share a name with any other type.
-    return m_types_by_name.insert(TypeName(name, type)).second;
+    Symbol symbol = Symbol::intern(name);
+    if(!m_types_by_name.insert(symbol, type)) {
+        return false;
+    }
+    m_typedefs.push_back(std::make_pair(symbol, type));
+    return true;
 }
 
 // add_import adds a newly-allocated import to the module.
 //     Imports with duplicate modules are combined.
 void Module::add_import(std::unique_ptr<Import> import)
 {
+    if(is_finalized()) {
+        return;
+    }
+
     // TODO: Combine duplicates
 
     // Transfer ownership of the import to the module
     m_imports.push_back(move(import));
 }
 
+// add_shared_type makes the module responsible for deleting a type which isn't owned by a field.
+//     Unlike the other add methods, it can be used after the module is finalized, because it
+//     doesn't change the module's contents.
+void Module::add_shared_type(std::unique_ptr<Type> type)
+{
+    m_shared_types.push_back(move(type));
+}
+
 // add_keyword adds a keyword with the name <keyword> to the list of declared keywords.
 void Module::add_keyword(const std::string& keyword)
 {
-    if(!has_keyword(keyword)) {
+    if(!is_finalized() && !has_keyword(keyword)) {
         m_keywords.push_back(keyword);
     }
 }
 
+// finalize freezes the module and returns a packed, read-only Schema of its contents.
+const Schema& Module::finalize()
+{
+    if(m_schema == nullptr) {
+        std::unique_ptr<Schema> schema(new Schema());
+        schema->build(*this);
+        m_schema = move(schema);
+    }
+    return *m_schema;
+}
+
 // add_field gives the field a unique id within the module.
 void Module::add_field(Field *field)
 {
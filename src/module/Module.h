@@ -2,9 +2,12 @@
 #pragma once
 #include <string>        // std::string
 #include <vector>        // std::vector
-#include <unordered_map> // std::unordered_map
 #include <memory>        // std::unique_ptr
+#include <utility>       // std::pair
 #include "Class.h"
+#include "Schema.h"
+#include "Symbol.h"
+#include "SymbolMap.h"
 namespace bamboo   // open namespace
 {
 
@@ -27,6 +30,7 @@ class Module
 {
   public:
     Module(); // constructor
+    ~Module(); // destructor
     Module(const Module&) = delete;
     Module& operator=(const Module&) = delete;
 
@@ -47,8 +51,13 @@ class Module
     Class *class_by_id(unsigned int id);
     const Class *class_by_id(unsigned int id) const;
     // class_by_name returns the requested class or nullptr if there is no such class.
+    //     Looking up a Symbol is cheapest; a string is first resolved with Symbol::find.
     Class *class_by_name(const std::string& name);
     const Class *class_by_name(const std::string& name) const;
+    Class *class_by_name(const char *name);
+    const Class *class_by_name(const char *name) const;
+    Class *class_by_name(Symbol name);
+    const Class *class_by_name(Symbol name) const;
 
     // num_types returns the number of types in the module.
     //     All type ids will be within the range 0 <= id < num_types().
@@ -57,9 +66,27 @@ class Module
     inline Type *type_by_id(unsigned int id);
     inline const Type *type_by_id(unsigned int id) const;
     // type_by_name returns the requested type or nullptr if there is no such type.
+    //     Looking up a Symbol is cheapest; a string is first resolved with Symbol::find.
     inline Type *type_by_name(const std::string& name);
     inline const Type *type_by_name(const std::string& name) const;
+    inline Type *type_by_name(const char *name);
+    inline const Type *type_by_name(const char *name) const;
+    inline Type *type_by_name(Symbol name);
+    inline const Type *type_by_name(Symbol name) const;
+
+    // num_typedefs returns the number of typedefs in the module.
+    inline size_t num_typedefs() const;
+    // get_typedef_name returns the alias declared by the <n>th typedef in the module.
+    //     Throws std::out_of_range
+    inline const std::string& get_typedef_name(unsigned int n) const;
+    // get_typedef_type returns the type aliased by the <n>th typedef in the module.
+    //     Throws std::out_of_range
+    inline Type *get_typedef_type(unsigned int n);
+    inline const Type *get_typedef_type(unsigned int n) const;
 
+    // num_fields returns the number of fields in the module.
+    //     All field ids will be within the range 0 <= id < num_fields().
+    inline size_t num_fields() const;
     // field_by_id returns the request field or nullptr if there is no such field.
     inline Field *field_by_id(unsigned int id);
     inline const Field *field_by_id(unsigned int id) const;
@@ -98,11 +125,29 @@ class Module
     // add_keyword adds a keyword with the name <keyword> to the list of declared keywords.
     void add_keyword(const std::string& keyword);
 
+    // add_shared_type makes the module responsible for deleting a type which isn't owned by
+    //     a field, such as the type of a parameter, an array's element type, or a typedef.
+    //     The type is deleted after all of the module's structs and classes.
+    void add_shared_type(std::unique_ptr<Type> type);
+
+    // finalize returns a packed, read-only Schema of the module's contents.
+    //     Afterwards, classes, structs, fields, typedefs, imports and keywords can no longer be
+    //     added to the module, and its fields can't be renamed, retyped or given keywords or
+    //     default values; those calls return false or are ignored.  Methods, parameters and
+    //     types are not checked: the schema is a snapshot, and changing them afterwards leaves
+    //     it out of date.  Calling finalize again returns the same schema.
+    const Schema& finalize();
+    // is_finalized returns true if finalize has been called on the module.
+    inline bool is_finalized() const;
+    // schema returns the module's Schema, or nullptr if the module hasn't been finalized.
+    inline const Schema *schema() const;
+
   private:
     // add_field gives the field a unique id within the module.
     void add_field(Field *field);
     friend class Class;
     friend class Struct;
+    friend class Schema;
 
     std::vector<std::unique_ptr<Struct> > m_structs;
     std::vector<std::unique_ptr<Class> > m_classes;
@@ -111,7 +156,11 @@ class Module
 
     std::vector<Field *> m_fields_by_id;
     std::vector<Type *> m_types_by_id;
-    std::unordered_map<std::string, Type *> m_types_by_name;
+    SymbolMap<Type *> m_types_by_name;
+    std::vector<std::pair<Symbol, Type *> > m_typedefs;
+    std::vector<std::unique_ptr<Type> > m_shared_types;
+
+    std::unique_ptr<Schema> m_schema;
 };
 
 
@@ -53,22 +53,54 @@ inline const Type *Module::type_by_id(unsigned int id) const {
 }
 // type_by_name returns the requested type or nullptr if there is no such type.
 inline Type *Module::type_by_name(const std::string& name) {
-    auto type_ref = m_types_by_name.find(name);
-    if(type_ref != m_types_by_name.end()) {
-        return type_ref->second;
+    return type_by_name(Symbol::find(name));
+}
+inline const Type *Module::type_by_name(const std::string& name) const {
+    return type_by_name(Symbol::find(name));
+}
+inline Type *Module::type_by_name(const char *name) {
+    return type_by_name(Symbol::find(name));
+}
+inline const Type *Module::type_by_name(const char *name) const {
+    return type_by_name(Symbol::find(name));
+}
+inline Type *Module::type_by_name(Symbol name) {
+    Type **type_ref = m_types_by_name.find(name);
+    if(type_ref != nullptr) {
+        return *type_ref;
     }
 
     return nullptr;
 }
-inline const Type *Module::type_by_name(const std::string& name) const {
-    auto type_ref = m_types_by_name.find(name);
-    if(type_ref != m_types_by_name.end()) {
-        return type_ref->second;
+inline const Type *Module::type_by_name(Symbol name) const {
+    Type *const *type_ref = m_types_by_name.find(name);
+    if(type_ref != nullptr) {
+        return *type_ref;
     }
 
     return (const Type *)nullptr;
 }
 
+// num_typedefs returns the number of typedefs in the module.
+inline size_t Module::num_typedefs() const {
+    return m_typedefs.size();
+}
+// get_typedef_name returns the alias declared by the <n>th typedef in the module.
+inline const std::string& Module::get_typedef_name(unsigned int n) const {
+    return m_typedefs.at(n).first.name();
+}
+// get_typedef_type returns the type aliased by the <n>th typedef in the module.
+inline Type *Module::get_typedef_type(unsigned int n) {
+    return m_typedefs.at(n).second;
+}
+inline const Type *Module::get_typedef_type(unsigned int n) const {
+    return m_typedefs.at(n).second;
+}
+
+// num_fields returns the number of fields in the module.
+inline size_t Module::num_fields() const {
+    return m_fields_by_id.size();
+}
 // field_by_id returns the request field or nullptr if there is no such field.
 inline Field *Module::field_by_id(unsigned int id) {
     if(id < m_fields_by_id.size()) {
@@ -115,5 +147,14 @@ inline const std::string& Module::get_keyword(unsigned int n) const {
     return m_keywords.at(n);
 }
 
+// is_finalized returns true if finalize has been called on the module.
+inline bool Module::is_finalized() const {
+    return m_schema != nullptr;
+}
+// schema returns the module's Schema, or nullptr if the module hasn't been finalized.
+inline const Schema *Module::schema() const {
+    return m_schema.get();
+}
+
 
 } // close namespace bamboo
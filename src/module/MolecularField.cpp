@@ -2,6 +2,7 @@
 #include "MolecularField.h"
 #include "../bits/buffers.h"
 #include "module/Class.h"
+#include "module/Module.h"
 #include "module/Value.h"
 using namespace std;
 namespace bamboo   // open namespace bamboo
@@ -18,6 +19,8 @@ MolecularField::MolecularField(Class *cls, const string& name) :
 // destructor
 MolecularField::~MolecularField()
 {
+    // The field's type is the field itself, so Field's destructor must not delete it
+    Field::m_type = nullptr;
 }
 
 // as_molecular returns this as a MolecularField if it is molecular, or nullptr otherwise.
@@ -37,6 +40,9 @@ bool MolecularField::add_field(Field *field)
     // Moleculars cannot be nested
     if(field->as_molecular()) { return false; }
 
+    // A finalized module can't be changed
+    if(Struct::m_module->is_finalized()) { return false; }
+
     // Copy our keywords from the first added field
     // Each field has to have the same set of keywords
     if(m_fields.size() == 0) { copy_keywords(*field); }
@@ -54,6 +60,8 @@ bool MolecularField::add_field(Field *field)
         }
     }
 
+    update_offsets();
+
     return true;
 }
 
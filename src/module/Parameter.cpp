@@ -3,6 +3,7 @@
 #include "../module/Struct.h"
 #include "../module/Method.h"
 #include "Value.h"
+#include <stdexcept> // std::out_of_range
 using namespace std;
 namespace bamboo   // open namespace bamboo
 {
@@ -14,6 +15,13 @@ Parameter::Parameter(Type *type, const string& name) : m_type(type), m_name(name
     if(m_type == nullptr) { m_type = Type::invalid; }
 }
 
+// destructor
+Parameter::~Parameter()
+{
+    // The parameter's type isn't owned by the parameter, but its default value is
+    delete m_default_value;
+}
+
 // set_name sets the name of this parameter.  Returns false if a parameter with
 //     the same name already exists in the containing method.
 bool Parameter::set_name(const string& name)
@@ -67,7 +75,17 @@ bool Parameter::set_default_value(const Value *default_value)
 }
 bool Parameter::set_default_value(const vector<uint8_t>& default_value)
 {
-    return set_default_value(Value(m_type, default_value));
+    // Unpack the value in place, rather than unpacking a temporary and copying it.
+    Value *value;
+    try {
+        value = new Value(m_type, default_value);
+    } catch(const out_of_range&) {
+        // The packed data is too short for the parameter's type
+        return false;
+    }
+    if(m_default_value != nullptr) { delete m_default_value; }
+    m_default_value = value;
+    return true;
 }
 
 // set_position allows a method to tell the parameter its order in the function.
@@ -21,6 +21,7 @@ class Parameter
     Parameter(Type *type, const std::string& name = ""); // TODO: Throw null_error
     Parameter(const Parameter&) = delete;
     Parameter& operator=(const Parameter&) = delete;
+    ~Parameter();
 
     // name returns the parameter's name.  An unnamed parameter returns the empty string.
     inline const std::string& name() const;
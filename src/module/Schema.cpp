@@ -0,0 +1,215 @@
+// Filename: Schema.cpp
+#include "Schema.h"
+#include <algorithm>     // std::sort, std::lower_bound
+#include <string.h>      // strcmp
+#include <unordered_map> // std::unordered_map
+#include "Module.h"
+#include "Type.h"
+#include "Array.h"
+#include "Method.h"
+#include "Parameter.h"
+#include "Struct.h"
+#include "Class.h"
+#include "Field.h"
+using namespace std;
+namespace bamboo   // open namespace bamboo
+{
+
+
+// A SchemaBuilder assigns schema indices to a module's types and interns their names.
+class SchemaBuilder
+{
+  public:
+    SchemaBuilder(vector<SchemaType>& types, vector<const Type *>& sources, vector<char>& names) :
+        m_types(types), m_sources(sources), m_names(names) {}
+
+    // add_type returns the index of the type, reserving one if it hasn't been seen before.
+    //     The type's contents are filled in afterwards by Schema::build.
+    uint32_t add_type(const Type *type)
+    {
+        auto it = m_indices.find(type);
+        if(it != m_indices.end()) { return it->second; }
+
+        uint32_t index = (uint32_t)m_types.size();
+        m_indices[type] = index;
+        m_types.push_back(SchemaType());
+        m_sources.push_back(type);
+        return index;
+    }
+
+    // intern returns the offset of the name in the name table, adding it if necessary.
+    uint32_t intern(const string& name)
+    {
+        if(name.empty()) { return Schema::kNone; }
+
+        auto it = m_offsets.find(name);
+        if(it != m_offsets.end()) { return it->second; }
+
+        uint32_t offset = (uint32_t)m_names.size();
+        m_names.insert(m_names.end(), name.begin(), name.end());
+        m_names.push_back('\0');
+        m_offsets[name] = offset;
+        return offset;
+    }
+
+  private:
+    vector<SchemaType>& m_types;
+    vector<const Type *>& m_sources;
+    vector<char>& m_names;
+    unordered_map<const Type *, uint32_t> m_indices;
+    unordered_map<string, uint32_t> m_offsets;
+};
+
+static uint32_t anchor_index(const ElementOffset& offset)
+{
+    return offset.is_fixed() ? Schema::kNone : (uint32_t)offset.anchor;
+}
+
+// build fills in the schema from the module.
+void Schema::build(const Module& module)
+{
+    SchemaBuilder builder(m_types, m_source_types, m_names);
+
+    // The module's own types keep their ids as indices
+    for(unsigned int i = 0; i < module.num_types(); ++i) {
+        builder.add_type(module.type_by_id(i));
+    }
+
+    // Every type referred to by a field or a typedef needs an index before the types are filled in
+    m_fields.resize(module.m_fields_by_id.size());
+    m_source_fields.assign(module.m_fields_by_id.begin(), module.m_fields_by_id.end());
+    for(const Field *field : m_source_fields) {
+        if(field == nullptr) { continue; }
+        builder.add_type(field->type());
+        if(field->record() != nullptr) { builder.add_type(field->record()); }
+    }
+    module.m_types_by_name.for_each([this, &builder](Symbol name, const Type *type) {
+        NameIndex entry;
+        entry.name = builder.intern(name.name());
+        entry.type = builder.add_type(type);
+        m_types_by_name.push_back(entry);
+    });
+
+    for(const string& keyword : module.m_keywords) {
+        m_keywords.push_back(builder.intern(keyword));
+    }
+
+    // Fill in each type; this may discover more types (parameters and array elements),
+    //     which are appended and then filled in by later iterations of the loop.
+    for(uint32_t i = 0; i < m_types.size(); ++i) {
+        const Type *type = m_source_types[i];
+        SchemaType entry = SchemaType();
+        entry.subtype = (uint32_t)type->subtype();
+        entry.name = type->has_alias() ? builder.intern(type->alias()) : kNone;
+        entry.size = type->has_fixed_size() ? (uint32_t)type->fixed_size() : 0;
+        entry.element = kNone;
+        entry.first_parent = (uint32_t)m_parents.size();
+
+        const Array *array = type->as_array();
+        if(array != nullptr) {
+            entry.element = builder.add_type(array->element_type());
+            entry.array_size = (uint32_t)array->array_size();
+        }
+
+        const Method *method = type->as_method();
+        if(method != nullptr) {
+            entry.first = (uint32_t)m_parameters.size();
+            entry.count = (uint32_t)method->num_parameters();
+            for(unsigned int n = 0; n < method->num_parameters(); ++n) {
+                const Parameter *param = method->get_parameter(n);
+                const ElementOffset& offset = method->parameter_offset(n);
+                SchemaParameter p;
+                p.name = builder.intern(param->name());
+                p.type = builder.add_type(param->type());
+                p.anchor = anchor_index(offset);
+                p.offset = (uint32_t)offset.offset;
+                m_parameters.push_back(p);
+            }
+        }
+
+        const Struct *record = type->as_struct();
+        if(record != nullptr) {
+            if(!record->name().empty()) { entry.name = builder.intern(record->name()); }
+            entry.first = (uint32_t)m_members.size();
+            entry.count = (uint32_t)record->num_fields();
+            for(unsigned int n = 0; n < record->num_fields(); ++n) {
+                const ElementOffset& offset = record->field_offset(n);
+                SchemaMember member;
+                member.field = record->get_field(n)->id();
+                member.anchor = anchor_index(offset);
+                member.offset = (uint32_t)offset.offset;
+                m_members.push_back(member);
+            }
+
+            const Class *cls = record->as_class();
+            if(cls != nullptr) {
+                entry.num_parents = (uint32_t)cls->num_parents();
+                for(unsigned int n = 0; n < cls->num_parents(); ++n) {
+                    m_parents.push_back(builder.add_type(cls->get_parent(n)));
+                }
+            }
+        }
+
+        m_types[i] = entry;
+    }
+
+    for(uint32_t id = 0; id < m_fields.size(); ++id) {
+        const Field *field = m_source_fields[id];
+        SchemaField entry;
+        entry.name = kNone;
+        entry.type = kNone;
+        entry.record = kNone;
+        entry.first_keyword = (uint32_t)m_keyword_refs.size();
+        entry.num_keywords = 0;
+        if(field != nullptr) {
+            entry.name = builder.intern(field->name());
+            entry.type = builder.add_type(field->type());
+            if(field->record() != nullptr) { entry.record = builder.add_type(field->record()); }
+
+            // Keywords are referred to by their position in the module's list of keywords;
+            //     a keyword that was never declared is added to the end of the list.
+            entry.num_keywords = (uint32_t)field->num_keywords();
+            for(unsigned int n = 0; n < field->num_keywords(); ++n) {
+                uint32_t name = builder.intern(field->get_keyword(n));
+                auto it = find(m_keywords.begin(), m_keywords.end(), name);
+                if(it == m_keywords.end()) { it = m_keywords.insert(it, name); }
+                m_keyword_refs.push_back((uint32_t)(it - m_keywords.begin()));
+            }
+        }
+        m_fields[id] = entry;
+    }
+
+    const char *names = m_names.data();
+    sort(m_types_by_name.begin(), m_types_by_name.end(),
+    [names](const NameIndex& lhs, const NameIndex& rhs) {
+        return strcmp(names + lhs.name, names + rhs.name) < 0;
+    });
+}
+
+// member_index returns the position of the field with the id <field> in the members of
+//     a struct, class, or molecular field, or kNone if it isn't a member.
+uint32_t Schema::member_index(const SchemaType& type, uint32_t field) const
+{
+    const SchemaMember *first = members(type);
+    for(uint32_t n = 0; n < type.count; ++n) {
+        if(first[n].field == field) { return n; }
+    }
+    return kNone;
+}
+
+// type_by_name returns the index of the type, or typedef, with the name; or kNone.
+uint32_t Schema::type_by_name(const string& name) const
+{
+    const char *names = m_names.data();
+    auto it = lower_bound(m_types_by_name.begin(), m_types_by_name.end(), name,
+    [names](const NameIndex& entry, const string& key) {
+        return key.compare(names + entry.name) > 0;
+    });
+    if(it == m_types_by_name.end() || name.compare(names + it->name) != 0) {
+        return kNone;
+    }
+    return it->type;
+}
+
+
+} // close namespace bamboo
@@ -0,0 +1,173 @@
+// Filename: Schema.h
+#pragma once
+#include <stdint.h> // for uint32_t
+#include <string>   // std::string
+#include <vector>   // std::vector
+namespace bamboo   // open namespace bamboo
+{
+
+
+// Foward declarations
+class Module;
+class Type;
+class Field;
+
+// A SchemaType describes one type of a Schema.
+//     Depending on the subtype, <first> and <count> select the type's members (structs, classes
+//     and molecular fields) or parameters (methods), and <element> is an array's element type.
+struct SchemaType {
+    uint32_t subtype;    // a bamboo::Subtype
+    uint32_t name;       // the type's name in the schema's name table, or kNone
+    uint32_t size;       // the packed size in bytes if the type has a fixed size, or 0
+    uint32_t element;    // arrays: the index of the element type
+    uint32_t array_size; // arrays: the number of elements if it is constant, or 0
+    uint32_t first;      // structs: the first member; methods: the first parameter
+    uint32_t count;      // structs: the number of members; methods: the number of parameters
+    uint32_t first_parent; // classes: the first entry in the list of parents
+    uint32_t num_parents;  // classes: the number of parent classes
+};
+
+// A SchemaField describes a field of a struct or class.  Fields are indexed by their id.
+struct SchemaField {
+    uint32_t name;          // the field's name in the schema's name table, or kNone
+    uint32_t type;          // the index of the field's type
+    uint32_t record;        // the index of the struct or class that declares the field
+    uint32_t first_keyword; // the first entry in the list of keywords
+    uint32_t num_keywords;  // the number of keywords the field has
+};
+
+// A SchemaMember is a field of a struct or class, including inherited fields, with its location
+//     in the packed struct (see ElementOffset).  A struct's members are in the order they are packed.
+struct SchemaMember {
+    uint32_t field;  // the id of the field
+    uint32_t anchor; // the index of the closest preceding variable-size member, or kNone
+    uint32_t offset; // bytes after the end of the anchor (or the start of the struct)
+};
+
+// A SchemaParameter is a parameter of a method, with its location in the packed arguments.
+struct SchemaParameter {
+    uint32_t name;   // the parameter's name in the schema's name table, or kNone
+    uint32_t type;   // the index of the parameter's type
+    uint32_t anchor; // the index of the closest preceding variable-size parameter, or kNone
+    uint32_t offset; // bytes after the end of the anchor (or the start of the arguments)
+};
+
+// A Schema is a read-only snapshot of a finalized Module, with every type, field, and parameter
+//     stored in a few contiguous arrays and linked by index rather than by pointer.  Names are
+//     interned into one table, and sizes and offsets are precomputed, so walking the schema
+//     touches far fewer cache lines than walking the Module's objects.  The snapshot isn't
+//     updated if a method, parameter or type of the module is changed after it is finalized.
+//
+//     The first num_types() of a Module have the same index in the schema as their id in the
+//     module; the types they use (arrays, methods, etc.) follow.  Field indices are field ids.
+class Schema
+{
+  public:
+    static const uint32_t kNone = 0xFFFFFFFF;
+
+    // num_types returns the number of types in the schema.
+    size_t num_types() const
+    {
+        return m_types.size();
+    }
+    // get_type returns the type with the index <n>.
+    const SchemaType& get_type(uint32_t n) const
+    {
+        return m_types[n];
+    }
+
+    // num_fields returns the number of fields in the schema.
+    size_t num_fields() const
+    {
+        return m_fields.size();
+    }
+    // get_field returns the field with the id <id>.
+    const SchemaField& get_field(uint32_t id) const
+    {
+        return m_fields[id];
+    }
+
+    // members returns the members of a struct, class, or molecular field;
+    //     the type's <count> is the number of members.
+    const SchemaMember *members(const SchemaType& type) const
+    {
+        return m_members.data() + type.first;
+    }
+    // parameters returns the parameters of a method; the type's <count> is the number of parameters.
+    const SchemaParameter *parameters(const SchemaType& type) const
+    {
+        return m_parameters.data() + type.first;
+    }
+    // parents returns the indices of the parents of a class.
+    const uint32_t *parents(const SchemaType& type) const
+    {
+        return m_parents.data() + type.first_parent;
+    }
+    // keywords returns a field's keywords, as indices into the module's list of keywords.
+    const uint32_t *keywords(const SchemaField& field) const
+    {
+        return m_keyword_refs.data() + field.first_keyword;
+    }
+
+    // member_index returns the position of the field with the id <field> in the members of
+    //     a struct, class, or molecular field, or kNone if it isn't a member.
+    uint32_t member_index(const SchemaType& type, uint32_t field) const;
+
+    // name returns a name from the name table, or an empty string for kNone.
+    const char *name(uint32_t name) const
+    {
+        return name == kNone ? "" : m_names.data() + name;
+    }
+    // type_by_name returns the index of the type, or typedef, with the name; or kNone.
+    uint32_t type_by_name(const std::string& name) const;
+
+    // num_keywords returns the number of keywords declared in the module.
+    size_t num_keywords() const
+    {
+        return m_keywords.size();
+    }
+    // get_keyword returns the name of the <n>th keyword declared in the module.
+    const char *get_keyword(uint32_t n) const
+    {
+        return name(m_keywords[n]);
+    }
+
+    // source_type returns the module's Type for the type with the index <n>.
+    const Type *source_type(uint32_t n) const
+    {
+        return m_source_types[n];
+    }
+    // source_field returns the module's Field for the field with the id <id>.
+    const Field *source_field(uint32_t id) const
+    {
+        return m_source_fields[id];
+    }
+
+  private:
+    Schema() {}
+    // build fills in the schema from the module.
+    void build(const Module& module);
+    friend class Module;
+
+    // A NameIndex entry maps a type name (or typedef) to its type, sorted by name.
+    struct NameIndex {
+        uint32_t name;
+        uint32_t type;
+    };
+
+    std::vector<SchemaType> m_types;
+    std::vector<SchemaField> m_fields;
+    std::vector<SchemaMember> m_members;
+    std::vector<SchemaParameter> m_parameters;
+    std::vector<uint32_t> m_parents;
+    std::vector<uint32_t> m_keyword_refs;
+    std::vector<uint32_t> m_keywords;
+    std::vector<NameIndex> m_types_by_name;
+    std::vector<char> m_names;
+
+    std::vector<const Type *> m_source_types;
+    std::vector<const Field *> m_source_fields;
+};
+
+
+} // close namespace bamboo
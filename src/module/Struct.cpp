@@ -1,5 +1,6 @@
 // Filename: Struct.cpp
 #include "Struct.h"
+#include <algorithm> // std::sort
 #include "../module/Module.h"
 #include "../module/Field.h"
 using namespace std;
@@ -10,12 +11,14 @@ namespace bamboo   // open namespace bamboo
 Struct::Struct(Module *module, const string& name) : m_module(module), m_id(0), m_name(name)
 {
     m_subtype = kTypeStruct;
+    update_offsets();
 }
 
 // protected constructor
 Struct::Struct(Module *module) : m_module(module), m_id(0)
 {
     m_subtype = kTypeStruct;
+    update_offsets();
 }
 
 // as_struct returns this as a Struct if it is a Struct, or nullptr otherwise.
@@ -48,6 +51,11 @@ bool Struct::add_field(std::unique_ptr<Field> field)
         return false;
     }
 
+    // A finalized module can't be changed
+    if(m_module->is_finalized()) {
+        return false;
+    }
+
     // Structs can't share a field
     if(field->record() != nullptr && field->record() != this) {
         return false;
@@ -70,19 +78,19 @@ bool Struct::add_field(std::unique_ptr<Field> field)
         }
 
         // Try to add the field
-        bool inserted = m_fields_by_name.insert(
-                            unordered_map<string, Field *>::value_type(field->name(), ref)).second;
+        Symbol name = Symbol::intern(field->name());
+        bool inserted = m_fields_by_name.insert(name, ref);
         if(!inserted) {
             // But the field had a name conflict
             return false;
         }
         // The index of this named field is the next available index
-        m_indices_by_name[field->name()] = (unsigned int)m_fields.size();
+        m_indices_by_name[name] = (unsigned int)m_fields.size();
     }
 
     // Struct fields are accessible by id.
     m_module->add_field(ref);
-    m_fields_by_id.insert(unordered_map<int, Field *>::value_type(field->id(), ref));
+    field->set_struct(this);
 
     // Add it to the accessible list of fields
     m_fields.push_back(ref);
@@ -94,11 +102,113 @@ bool Struct::add_field(std::unique_ptr<Field> field)
         }
     }
 
+    append_field();
+
     // Transfer ownership of the Field to the Struct
     m_owned_fields.push_back(move(field));
 
     return true;
 }
 
+// update_offsets recomputes the location of each field after the list of fields changes.
+void Struct::update_offsets()
+{
+    m_offsets.resize(m_fields.size() + 1);
+
+    ElementOffset location = {ElementOffset::kNoAnchor, 0};
+    for(unsigned int i = 0; i < m_fields.size(); ++i) {
+        m_offsets[i] = location;
+
+        const Type *type = m_fields[i]->type();
+        if(type->has_fixed_size()) {
+            location.offset += type->fixed_size();
+        } else {
+            location.anchor = i;
+            location.offset = 0;
+        }
+    }
+
+    // The last entry is the end of the struct
+    m_offsets[m_fields.size()] = location;
+}
+
+// Small gaps between field ids are filled with empty slots rather than starting a new run
+static const unsigned int kMaxFieldGap = 8;
+
+// update_field_ids rebuilds the id lookup table after the list of fields changes.
+void Struct::update_field_ids(Field *constructor)
+{
+    vector<FieldSlot> fields;
+    fields.reserve(m_fields.size() + 1);
+    if(constructor != nullptr) {
+        fields.push_back(FieldSlot{constructor, -1});
+    }
+    for(unsigned int i = 0; i < m_fields.size(); ++i) {
+        fields.push_back(FieldSlot{m_fields[i], (int)i});
+    }
+    sort(fields.begin(), fields.end(), [](const FieldSlot& lhs, const FieldSlot& rhs) {
+        return lhs.field->id() < rhs.field->id();
+    });
+
+    m_field_runs.clear();
+    m_field_slots.clear();
+    for(const FieldSlot& slot : fields) {
+        unsigned int id = slot.field->id();
+        if(!m_field_runs.empty()) {
+            FieldRun& run = m_field_runs.back();
+            unsigned int next_id = run.first_id + run.count;
+            if(id >= next_id && id - next_id <= kMaxFieldGap) {
+                m_field_slots.resize(m_field_slots.size() + (id - next_id), FieldSlot{nullptr, -1});
+                m_field_slots.push_back(slot);
+                run.count = id - run.first_id + 1;
+                continue;
+            }
+        }
+        m_field_runs.push_back(FieldRun{id, 1, (unsigned int)m_field_slots.size()});
+        m_field_slots.push_back(slot);
+    }
+}
+
+// append_field updates the offsets and id lookup table after a field is added to the end.
+void Struct::append_field(Field *constructor)
+{
+    unsigned int index = (unsigned int)m_fields.size() - 1;
+    Field *field = m_fields[index];
+    unsigned int id = field->id();
+
+    // The field's offset is the previous end of the struct
+    if(m_offsets.size() != m_fields.size()) {
+        update_offsets();
+    } else {
+        ElementOffset location = m_offsets.back();
+        if(field->type()->has_fixed_size()) {
+            location.offset += field->type()->fixed_size();
+        } else {
+            location.anchor = index;
+            location.offset = 0;
+        }
+        m_offsets.push_back(location);
+    }
+
+    // Fields are usually added with a new, largest id; otherwise the table must be re-sorted
+    if(m_field_runs.empty()) {
+        m_field_runs.push_back(FieldRun{id, 1, 0});
+        m_field_slots.push_back(FieldSlot{field, (int)index});
+        return;
+    }
+    FieldRun& run = m_field_runs.back();
+    unsigned int next_id = run.first_id + run.count;
+    if(id < next_id) {
+        update_field_ids(constructor);
+    } else if(id - next_id <= kMaxFieldGap) {
+        m_field_slots.resize(m_field_slots.size() + (id - next_id), FieldSlot{nullptr, -1});
+        m_field_slots.push_back(FieldSlot{field, (int)index});
+        run.count = id - run.first_id + 1;
+    } else {
+        m_field_runs.push_back(FieldRun{id, 1, (unsigned int)m_field_slots.size()});
+        m_field_slots.push_back(FieldSlot{field, (int)index});
+    }
+}
+
 
 } // close namespace bamboo
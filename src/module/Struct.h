@@ -1,10 +1,12 @@
 // Filename: Struct.h
 #pragma once
 #include "Type.h"
+#include "ElementOffset.h"
+#include "Symbol.h"
+#include "SymbolMap.h"
 #include <memory>        // std::unique_ptr
 #include <string>        // std::string
 #include <vector>        // std::vector
-#include <unordered_map> // std::unordered_map
 namespace bamboo   // open namespace
 {
 
@@ -49,12 +51,25 @@ class Struct : public Type
     inline Field *get_field(unsigned int n);
     inline const Field *get_field(unsigned int n) const;
 
+    // field_offset returns the location of the <n>th field within the packed struct.
+    //     Passing n == num_fields() returns the location of the end of the struct.
+    //     Throws std::out_of_range
+    inline const ElementOffset& field_offset(unsigned int n) const;
+
     // field_by_id returns the field with the index <id>, or nullptr if no such field exists.
     inline Field *field_by_id(unsigned int id);
     inline const Field *field_by_id(unsigned int id) const;
+    // field_index_by_id returns the position of the field with the index <id> in the struct
+    //     (see get_field), or -1 if no such field exists or the field is a class constructor.
+    inline int field_index_by_id(unsigned int id) const;
     // field_by_name returns the field with <name>, or nullptr if no such field exists.
+    //     Looking up a Symbol is cheapest; a string is first resolved with Symbol::find.
     inline Field *field_by_name(const std::string& name);
     inline const Field *field_by_name(const std::string& name) const;
+    inline Field *field_by_name(const char *name);
+    inline const Field *field_by_name(const char *name) const;
+    inline Field *field_by_name(Symbol name);
+    inline const Field *field_by_name(Symbol name) const;
 
     // add_field adds a new Field to the struct.
     //     Returns false if the field could not be added to the struct.
@@ -67,15 +82,42 @@ class Struct : public Type
     void set_id(unsigned int id);
     friend class Module;
 
+    // update_offsets recomputes the location of each field after the list of fields changes.
+    void update_offsets();
+    // update_field_ids rebuilds the id lookup table after the list of fields changes.
+    //     A class passes its constructor, which has an id but isn't in the list of fields.
+    void update_field_ids(Field *constructor = nullptr);
+    // append_field updates the offsets and id lookup table after a field is added to the end of
+    //     the list of fields, without recomputing the entries for the fields before it.
+    void append_field(Field *constructor = nullptr);
+
+    // A FieldSlot is the entry for a field id in the lookup table.
+    struct FieldSlot {
+        Field *field;  // nullptr if the id isn't a field of this struct
+        int index;     // the field's position in m_fields, or -1
+    };
+    // A FieldRun is a range of consecutive field ids with entries in the lookup table.
+    //     Field ids are assigned module-wide, in the order that fields are declared, so a
+    //     struct's fields are contiguous and a class has about one run per ancestor.
+    struct FieldRun {
+        unsigned int first_id;
+        unsigned int count;
+        unsigned int first_slot;
+    };
+    // field_slot returns the lookup table entry for the id, or nullptr if it is outside every run.
+    inline const FieldSlot *field_slot(unsigned int id) const;
+
     Module *m_module;
     unsigned int m_id;
     std::string m_name;
 
     std::vector<Field *> m_fields;
     std::vector<std::unique_ptr<Field> > m_owned_fields;
-    std::unordered_map<std::string, unsigned int> m_indices_by_name;
-    std::unordered_map<std::string, Field *> m_fields_by_name;
-    std::unordered_map<unsigned int, Field *> m_fields_by_id;
+    std::vector<ElementOffset> m_offsets;
+    SymbolMap<unsigned int> m_indices_by_name;
+    SymbolMap<Field *> m_fields_by_name;
+    std::vector<FieldRun> m_field_runs;
+    std::vector<FieldSlot> m_field_slots;
 };
 
 
@@ -34,36 +34,60 @@ inline const Field *Struct::get_field(unsigned int n) const {
     return m_fields.at(n);
 }
 
+// field_offset returns the location of the <n>th field within the packed struct.
+inline const ElementOffset& Struct::field_offset(unsigned int n) const {
+    return m_offsets.at(n);
+}
+
+// field_slot returns the lookup table entry for the id, or nullptr if it is outside every run.
+inline const Struct::FieldSlot *Struct::field_slot(unsigned int id) const {
+    for(const FieldRun& run : m_field_runs) {
+        // Ids before the run wrap around to a large offset
+        unsigned int offset = id - run.first_id;
+        if(offset < run.count) {
+            return &m_field_slots[run.first_slot + offset];
+        }
+    }
+    return nullptr;
+}
+
 // field_by_id returns the field with the index <id>, or nullptr if no such field exists.
 inline Field *Struct::field_by_id(unsigned int id) {
-    auto it = m_fields_by_id.find(id);
-    if(it == m_fields_by_id.end()) {
-        return nullptr;
-    }
-    return it->second;
+    const FieldSlot *slot = field_slot(id);
+    return slot != nullptr ? slot->field : nullptr;
 }
 inline const Field *Struct::field_by_id(unsigned int id) const {
-    auto it = m_fields_by_id.find(id);
-    if(it == m_fields_by_id.end()) {
-        return nullptr;
-    }
-    return it->second;
+    const FieldSlot *slot = field_slot(id);
+    return slot != nullptr ? slot->field : nullptr;
+}
+
+// field_index_by_id returns the position of the field with the index <id> in the struct,
+//     or -1 if no such field exists or the field is a class constructor.
+inline int Struct::field_index_by_id(unsigned int id) const {
+    const FieldSlot *slot = field_slot(id);
+    return slot != nullptr ? slot->index : -1;
 }
 
 // field_by_name returns the field with <name>, or nullptr if no such field exists.
 inline Field *Struct::field_by_name(const std::string& name) {
-    auto it = m_fields_by_name.find(name);
-    if(it == m_fields_by_name.end()) {
-        return nullptr;
-    }
-    return it->second;
+    return field_by_name(Symbol::find(name));
 }
 inline const Field *Struct::field_by_name(const std::string& name) const {
-    auto it = m_fields_by_name.find(name);
-    if(it == m_fields_by_name.end()) {
-        return nullptr;
-    }
-    return it->second;
+    return field_by_name(Symbol::find(name));
+}
+inline Field *Struct::field_by_name(const char *name) {
+    return field_by_name(Symbol::find(name));
+}
+inline const Field *Struct::field_by_name(const char *name) const {
+    return field_by_name(Symbol::find(name));
+}
+inline Field *Struct::field_by_name(Symbol name) {
+    Field * const *field = m_fields_by_name.find(name);
+    return field != nullptr ? *field : nullptr;
+}
+inline const Field *Struct::field_by_name(Symbol name) const {
+    Field * const *field = m_fields_by_name.find(name);
+    return field != nullptr ? *field : nullptr;
 }
 
 // set_id sets the index number associated with this struct.
@@ -0,0 +1,192 @@
+// Filename: Symbol.cpp
+#include "Symbol.h"
+#include <atomic>    // std::atomic
+#include <memory>    // std::unique_ptr
+#include <mutex>     // std::mutex, std::lock_guard
+#include <stdexcept> // std::length_error
+#include <string.h>  // memcmp
+#include <vector>    // std::vector
+using namespace std;
+namespace bamboo   // open namespace bamboo
+{
+
+
+// A SymbolTable is the process-wide list of interned names.
+//     Entries are stored in fixed-size chunks which are never moved, so a Symbol's name can be
+//     read without a lock.  Names are found through an open-addressing index of entry ids;
+//     when the index fills up it is replaced by a larger one, but the old index is kept alive
+//     so that readers still using it aren't affected.  Only adding a name takes the lock.
+class SymbolTable
+{
+  public:
+    struct Entry {
+        string name;
+        size_t hash;
+    };
+
+    static SymbolTable& global()
+    {
+        static SymbolTable table;
+        return table;
+    }
+
+    SymbolTable() : m_count(0)
+    {
+        for(size_t i = 0; i < kMaxChunks; ++i) {
+            m_chunks[i].store(nullptr, memory_order_relaxed);
+        }
+        m_indexes.emplace_back(new Index(kInitialSlots));
+        m_index.store(m_indexes.back().get(), memory_order_release);
+    }
+
+    ~SymbolTable()
+    {
+        for(size_t i = 0; i < kMaxChunks; ++i) {
+            delete[] m_chunks[i].load(memory_order_relaxed);
+        }
+    }
+
+    const Entry& entry(uint32_t id) const
+    {
+        return m_chunks[id >> kChunkBits].load(memory_order_acquire)[id & kChunkMask];
+    }
+
+    uint32_t find(const char *name, size_t length, size_t hash) const
+    {
+        return find_in(*m_index.load(memory_order_acquire), name, length, hash);
+    }
+
+    uint32_t intern(const char *name, size_t length)
+    {
+        size_t hash = Symbol::hash_name(name, length);
+        uint32_t id = find(name, length, hash);
+        if(id != Symbol::kInvalid) { return id; }
+
+        lock_guard<mutex> guard(m_mutex);
+
+        // Another thread may have added the name while we were waiting for the lock
+        Index *index = m_index.load(memory_order_relaxed);
+        id = find_in(*index, name, length, hash);
+        if(id != Symbol::kInvalid) { return id; }
+
+        if(m_count == (uint32_t)kMaxChunks * kChunkSize) {
+            throw length_error("SymbolTable is full");
+        }
+
+        // Keep the index at most half full, so probe sequences stay short
+        if((size_t)(m_count + 1) * 2 > index->mask + 1) {
+            m_indexes.emplace_back(new Index((index->mask + 1) * 2));
+            index = m_indexes.back().get();
+            for(uint32_t i = 0; i < m_count; ++i) {
+                insert_into(*index, i, entry(i).hash);
+            }
+            m_index.store(index, memory_order_release);
+        }
+
+        id = m_count++;
+        Entry *chunk = m_chunks[id >> kChunkBits].load(memory_order_relaxed);
+        if(chunk == nullptr) {
+            chunk = new Entry[kChunkSize];
+            m_chunks[id >> kChunkBits].store(chunk, memory_order_release);
+        }
+        chunk[id & kChunkMask].name.assign(name, length);
+        chunk[id & kChunkMask].hash = hash;
+
+        insert_into(*index, id, hash);
+        return id;
+    }
+
+  private:
+    static const size_t kChunkBits = 10;
+    static const size_t kChunkSize = (size_t)1 << kChunkBits;
+    static const size_t kChunkMask = kChunkSize - 1;
+    static const size_t kMaxChunks = 4096;
+    static const size_t kInitialSlots = 1024;
+
+    // An Index maps names to entries; each slot holds an entry's id plus one, or 0 if it is empty.
+    struct Index {
+        size_t mask;
+        unique_ptr<atomic<uint32_t>[]> slots;
+
+        explicit Index(size_t size) : mask(size - 1), slots(new atomic<uint32_t>[size])
+        {
+            for(size_t i = 0; i < size; ++i) {
+                slots[i].store(0, memory_order_relaxed);
+            }
+        }
+    };
+
+    uint32_t find_in(const Index& index, const char *name, size_t length, size_t hash) const
+    {
+        for(size_t i = hash & index.mask;; i = (i + 1) & index.mask) {
+            uint32_t slot = index.slots[i].load(memory_order_acquire);
+            if(slot == 0) { return Symbol::kInvalid; }
+
+            const Entry& candidate = entry(slot - 1);
+            if(candidate.hash == hash && candidate.name.length() == length &&
+               memcmp(candidate.name.data(), name, length) == 0) {
+                return slot - 1;
+            }
+        }
+    }
+
+    static void insert_into(Index& index, uint32_t id, size_t hash)
+    {
+        size_t i = hash & index.mask;
+        while(index.slots[i].load(memory_order_relaxed) != 0) {
+            i = (i + 1) & index.mask;
+        }
+        index.slots[i].store(id + 1, memory_order_release);
+    }
+
+    atomic<Entry *> m_chunks[kMaxChunks];
+    atomic<Index *> m_index;
+    vector<unique_ptr<Index> > m_indexes; // the current index, and every index it replaced
+    uint32_t m_count;
+    mutex m_mutex;
+};
+
+// intern returns the symbol for the name, adding it to the table if necessary.
+Symbol Symbol::intern(const char *name, size_t length)
+{
+    return Symbol(SymbolTable::global().intern(name, length));
+}
+
+// find returns the symbol for the name if it has been interned, or an invalid symbol.
+Symbol Symbol::find(const char *name, size_t length)
+{
+    return Symbol(SymbolTable::global().find(name, length, hash_name(name, length)));
+}
+
+// name returns the symbol's name, or an empty string if the symbol is invalid.
+const string& Symbol::name() const
+{
+    static const string empty;
+    if(m_id == kInvalid) { return empty; }
+    return SymbolTable::global().entry(m_id).name;
+}
+
+// hash returns the hash of the symbol's name.
+size_t Symbol::hash() const
+{
+    if(m_id == kInvalid) { return hash_name("", 0); }
+    return SymbolTable::global().entry(m_id).hash;
+}
+
+// hash_name returns the hash of a name, as returned by Symbol::hash.
+//     This is 64-bit FNV-1a, which is quick for the short identifiers used in a module.
+size_t Symbol::hash_name(const char *name, size_t length)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for(size_t i = 0; i < length; ++i) {
+        hash ^= (uint8_t)name[i];
+        hash *= 1099511628211ULL;
+    }
+    // Fold the high bits down; the multiply only carries differences upward, and the
+    //     table is indexed by the low bits.
+    hash ^= hash >> 32;
+    return (size_t)hash;
+}
+
+
+} // close namespace bamboo
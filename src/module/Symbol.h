@@ -0,0 +1,109 @@
+// Filename: Symbol.h
+#pragma once
+#include <stddef.h>   // for size_t
+#include <stdint.h>   // for uint32_t
+#include <string.h>   // for strlen
+#include <functional> // std::hash
+#include <string>     // std::string
+namespace bamboo   // open namespace bamboo
+{
+
+
+// A Symbol is an interned name: every distinct string is assigned a small integer id once,
+//     in a process-wide table, and its hash is computed only at that time.  Names of types,
+//     fields and parameters are stored as Symbols, so a name resolved to a Symbol ahead of time
+//     can be looked up with an integer key instead of hashing and comparing a std::string:
+//
+//         static const Symbol kSetPos = Symbol::intern("setPos");
+//         const Field *field = cls->field_by_name(kSetPos);
+//
+//     Symbols are never freed.  The table may be used from multiple threads; finding an
+//     existing symbol doesn't take a lock.
+class Symbol
+{
+  public:
+    static const uint32_t kInvalid = 0xFFFFFFFF;
+
+    // default-constructor:
+    //     creates an invalid symbol, which isn't equal to the symbol of any name.
+    Symbol() : m_id(kInvalid) {}
+
+    // intern returns the symbol for the name, adding it to the table if necessary.
+    static Symbol intern(const char *name, size_t length);
+    static Symbol intern(const char *name)
+    {
+        return intern(name, strlen(name));
+    }
+    static Symbol intern(const std::string& name)
+    {
+        return intern(name.data(), name.length());
+    }
+
+    // find returns the symbol for the name if it has been interned, or an invalid symbol.
+    //     Unlike intern, find never adds to the table, so it is safe to use with untrusted names.
+    static Symbol find(const char *name, size_t length);
+    static Symbol find(const char *name)
+    {
+        return find(name, strlen(name));
+    }
+    static Symbol find(const std::string& name)
+    {
+        return find(name.data(), name.length());
+    }
+
+    // valid returns true if the symbol was returned by intern or found by find.
+    bool valid() const
+    {
+        return m_id != kInvalid;
+    }
+    // id returns the symbol's index in the table, which is unique to its name.
+    uint32_t id() const
+    {
+        return m_id;
+    }
+    // name returns the symbol's name, or an empty string if the symbol is invalid.
+    const std::string& name() const;
+    // hash returns the hash of the symbol's name.
+    size_t hash() const;
+
+    // hash_name returns the hash of a name, as returned by Symbol::hash.
+    static size_t hash_name(const char *name, size_t length);
+
+    bool operator==(const Symbol& other) const
+    {
+        return m_id == other.m_id;
+    }
+    bool operator!=(const Symbol& other) const
+    {
+        return m_id != other.m_id;
+    }
+    bool operator<(const Symbol& other) const
+    {
+        return m_id < other.m_id;
+    }
+
+  private:
+    explicit Symbol(uint32_t id) : m_id(id) {}
+    friend class SymbolTable;
+    template<typename T> friend class SymbolMap;
+
+    uint32_t m_id;
+};
+
+
+} // close namespace bamboo
+namespace std   // open namespace std
+{
+
+
+// Symbols are hashed by id; their ids are already unique.
+template<>
+struct hash<bamboo::Symbol> {
+    size_t operator()(const bamboo::Symbol& symbol) const
+    {
+        return symbol.id();
+    }
+};
+
+
+} // close namespace std
@@ -0,0 +1,147 @@
+// Filename: SymbolMap.h
+#pragma once
+#include <stddef.h> // for size_t
+#include <stdint.h> // for uint32_t
+#include <vector>   // std::vector
+#include "Symbol.h"
+namespace bamboo   // open namespace bamboo
+{
+
+
+// A SymbolMap is a small hash map from Symbols to values, used for name lookups.
+//     Entries are stored inline in one array using linear probing, and are found by a
+//     multiplicative hash of the symbol's id, so a lookup is usually one multiply and
+//     one cache line.  Values should be cheap to copy, like pointers or indices.
+template<typename T>
+class SymbolMap
+{
+  public:
+    SymbolMap() : m_size(0), m_shift(32) {}
+
+    // size returns the number of entries in the map.
+    size_t size() const
+    {
+        return m_size;
+    }
+    // empty returns true if the map has no entries.
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    // find returns a pointer to the value for the symbol, or nullptr if it isn't in the map.
+    T *find(Symbol key)
+    {
+        size_t i = index_of(key);
+        return i != kMissing ? &m_slots[i].value : nullptr;
+    }
+    const T *find(Symbol key) const
+    {
+        size_t i = index_of(key);
+        return i != kMissing ? &m_slots[i].value : nullptr;
+    }
+
+    // insert adds the value for the symbol, unless the symbol is already in the map.
+    //     Returns true if the value was added.
+    bool insert(Symbol key, const T& value)
+    {
+        if(index_of(key) != kMissing) { return false; }
+        (*this)[key] = value;
+        return true;
+    }
+
+    // operator[] returns the value for the symbol, adding a default value if it isn't in the map.
+    T& operator[](Symbol key)
+    {
+        size_t i = index_of(key);
+        if(i != kMissing) { return m_slots[i].value; }
+
+        // Keep the table at most half full
+        if((m_size + 1) * 2 > m_slots.size()) { grow(); }
+
+        i = home(key.id());
+        while(m_slots[i].key != Symbol::kInvalid) { i = (i + 1) & (m_slots.size() - 1); }
+        m_slots[i].key = key.id();
+        m_slots[i].value = T();
+        ++m_size;
+        return m_slots[i].value;
+    }
+
+    // erase removes the symbol from the map.  Returns true if it was in the map.
+    bool erase(Symbol key)
+    {
+        size_t i = index_of(key);
+        if(i == kMissing) { return false; }
+
+        // Move later entries of the probe sequence back into the hole, so that
+        //     no entry is separated from its home slot by an empty slot.
+        size_t mask = m_slots.size() - 1;
+        for(size_t j = (i + 1) & mask; m_slots[j].key != Symbol::kInvalid; j = (j + 1) & mask) {
+            size_t h = home(m_slots[j].key);
+            if(((j - h) & mask) >= ((j - i) & mask)) {
+                m_slots[i] = m_slots[j];
+                i = j;
+            }
+        }
+        m_slots[i].key = Symbol::kInvalid;
+        --m_size;
+        return true;
+    }
+
+    // for_each calls the function with each symbol and value in the map, in no particular order.
+    template<typename Function>
+    void for_each(Function function) const
+    {
+        for(const Slot& slot : m_slots) {
+            if(slot.key != Symbol::kInvalid) { function(Symbol(slot.key), slot.value); }
+        }
+    }
+
+  private:
+    static const size_t kMissing = (size_t)(-1);
+    static const size_t kInitialSlots = 8;
+
+    struct Slot {
+        uint32_t key; // the symbol's id, or Symbol::kInvalid if the slot is empty
+        T value;
+    };
+
+    size_t home(uint32_t id) const
+    {
+        return (size_t)((uint32_t)(id * 2654435769u) >> m_shift);
+    }
+
+    size_t index_of(Symbol key) const
+    {
+        if(m_size == 0 || !key.valid()) { return kMissing; }
+        size_t mask = m_slots.size() - 1;
+        for(size_t i = home(key.id());; i = (i + 1) & mask) {
+            if(m_slots[i].key == key.id()) { return i; }
+            if(m_slots[i].key == Symbol::kInvalid) { return kMissing; }
+        }
+    }
+
+    void grow()
+    {
+        std::vector<Slot> slots(m_slots.empty() ? kInitialSlots : m_slots.size() * 2);
+        for(Slot& slot : slots) { slot.key = Symbol::kInvalid; }
+        slots.swap(m_slots);
+        m_shift = 32;
+        for(size_t n = m_slots.size(); n > 1; n >>= 1) { --m_shift; }
+
+        size_t mask = m_slots.size() - 1;
+        for(const Slot& slot : slots) {
+            if(slot.key == Symbol::kInvalid) { continue; }
+            size_t i = home(slot.key);
+            while(m_slots[i].key != Symbol::kInvalid) { i = (i + 1) & mask; }
+            m_slots[i] = slot;
+        }
+    }
+
+    std::vector<Slot> m_slots; // a power of two in size
+    size_t m_size;
+    unsigned int m_shift; // 32 - log2(number of slots)
+};
+
+
+} // close namespace bamboo
@@ -1,5 +1,7 @@
 // Filename: Value.cpp
-#include "../bits/buffers.h"
+#include <string.h> // memcpy
+#include <stdexcept> // std::out_of_range, std::length_error
+#include "../bits/byteorder.h"
 #include "Value.h"
 #include "Array.h"
 #include "Struct.h"
@@ -9,7 +11,7 @@ namespace bamboo   // open namespace bamboo
 {
 
 
-Value::Value(const Type *type) : type(type)
+Value::Value(const Type *type, EmptyTag, ValueArena *arena) : type(type), m_arena(arena)
 {
     if(type == nullptr) throw null_error("is not a valid Type");
     switch(type->subtype()) {
@@ -26,7 +28,7 @@ Value::Value(const Type *type) : type(type)
         uint_ = 0;
         break;
     case kTypeChar:
-        char_ = '\0';
+        uint_ = 0;
         break;
     case kTypeFloat32:
         float_ = 0;
@@ -36,92 +38,358 @@ Value::Value(const Type *type) : type(type)
         break;
     case kTypeString:
     case kTypeVarstring:
-        string_ = string(size_t(type->as_array()->range().min.uinteger), '\0');
+        new(&string_) string_t(arena);
         break;
     case kTypeBlob:
     case kTypeVarblob:
-        blob_ = vector<uint8_t>(size_t(type->as_array()->range().min.uinteger), uint8_t(0));
+        new(&blob_) blob_t(arena);
+        break;
+    case kTypeArray:
+    case kTypeVararray:
+        new(&elements_) elements_t(arena);
+        break;
+    case kTypeStruct:
+        new(&fields_) fields_t(arena);
+        break;
+    case kTypeMethod:
+        new(&arguments_) arguments_t(arena);
+        break;
+    case kTypeInvalid:
+        throw invalid_type("type has invalid subtype");
+        break;
+    }
+}
+
+Value::Value(const Type *type, ValueArena *arena) : Value(type, kEmpty, arena)
+{
+    switch(type->subtype()) {
+    case kTypeString:
+    case kTypeVarstring:
+        string_.assign(size_t(type->as_array()->range().min.uinteger), '\0');
+        break;
+    case kTypeBlob:
+    case kTypeVarblob:
+        blob_.assign(size_t(type->as_array()->range().min.uinteger), uint8_t(0));
         break;
     case kTypeArray:
     case kTypeVararray: {
         const Array *array = type->as_array();
-        elements_ = vector<Value>(size_t(array->range().min.uinteger), Value(array->element_type()));
+        size_t count = size_t(array->range().min.uinteger);
+        elements_.reserve(count);
+        for(size_t i = 0; i < count; ++i) {
+            elements_.emplace_back(array->element_type(), arena);
+        }
         break;
     }
     case kTypeStruct: {
-        fields_ = fields_t();
-
         // Construct the struct from default values for its fields
         const Struct *record = type->as_struct();
         size_t num_fields = record->num_fields();
+        fields_.reserve(num_fields);
         for(size_t i = 0; i < num_fields; ++i) {
             const Field *field = record->get_field((unsigned int)i);
             if(field->has_default_value()) {
                 // Get default value for field
-                fields_.emplace(field, *field->default_value());
+                fields_.emplace_back(*field->default_value(), arena);
             } else {
                 // Otherwise, use the implicit default (0, empty, etc...)
-                fields_.emplace(field, Value(field->type()));
+                fields_.emplace_back(field->type(), arena);
             }
         }
         break;
     }
     case kTypeMethod: {
-        arguments_ = arguments_t();
-
         // Construct the method-call from default values for its parameters
         const Method *method = type->as_method();
         size_t num_params = method->num_parameters();
+        arguments_.reserve(num_params);
         for(unsigned int i = 0; i < num_params; ++i) {
             const Parameter *param = method->get_parameter(i);
             if(param->has_default_value()) {
                 // Get default value for field
-                arguments_.emplace(param, *param->default_value());
+                arguments_.emplace_back(*param->default_value(), arena);
             } else {
                 // Otherwise, use the implicit default (0, empty, etc...)
-                arguments_.emplace(param, Value(param->type()));
+                arguments_.emplace_back(param->type(), arena);
             }
         }
         break;
     }
-    case kTypeInvalid:
-        throw invalid_type("type has invalid subtype");
+    default:
         break;
     }
 }
 
-Value::Value(const Type *type, const vector<uint8_t>&) : type(type)
+Value::Value(const Type *type, const vector<uint8_t>& packed, ValueArena *arena) :
+    Value(type, kEmpty, arena)
+{
+    const uint8_t *data = packed.empty() ? nullptr : &packed[0];
+    unpack(data, data + packed.size(), arena);
+}
+
+// read_native reads a native-endian value from packed data, advancing the data pointer.
+template<typename T>
+static T read_native(const uint8_t *& data, const uint8_t *end)
+{
+    if(end - data < (ptrdiff_t)sizeof(T)) {
+        throw out_of_range("packed data ended before the value was complete");
+    }
+    T r;
+    memcpy(&r, data, sizeof(T));
+    data += sizeof(T);
+    return r;
+}
+
+// read_bytes returns a pointer to the next <length> bytes of packed data, advancing past them.
+static const uint8_t *read_bytes(const uint8_t *& data, const uint8_t *end, size_t length)
+{
+    if(size_t(end - data) < length) {
+        throw out_of_range("packed data ended before the value was complete");
+    }
+    const uint8_t *start = data;
+    data += length;
+    return start;
+}
+
+// skip_packed advances the data pointer past a value of the given type.
+static void skip_packed(const Type *type, const uint8_t *& data, const uint8_t *end)
+{
+    if(type->has_fixed_size()) {
+        read_bytes(data, end, type->fixed_size());
+        return;
+    }
+
+    switch(type->subtype()) {
+    case kTypeVarstring:
+    case kTypeVarblob:
+    case kTypeVararray: {
+        size_t len = read_native<sizetag_t>(data, end);
+        read_bytes(data, end, len);
+        break;
+    }
+    case kTypeArray: {
+        const Array *array = type->as_array();
+        for(size_t i = 0; i < array->array_size(); ++i) {
+            skip_packed(array->element_type(), data, end);
+        }
+        break;
+    }
+    case kTypeStruct: {
+        const Struct *record = type->as_struct();
+        size_t num_fields = record->num_fields();
+        for(unsigned int i = 0; i < num_fields; ++i) {
+            skip_packed(record->get_field(i)->type(), data, end);
+        }
+        break;
+    }
+    case kTypeMethod: {
+        const Method *method = type->as_method();
+        size_t num_params = method->num_parameters();
+        for(unsigned int i = 0; i < num_params; ++i) {
+            skip_packed(method->get_parameter(i)->type(), data, end);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+size_t packed_size(const Type *type, const uint8_t *packed, size_t length)
 {
-    // TODO: Implement
     if(type == nullptr) throw null_error("is not a valid Type");
+    const uint8_t *data = packed;
+    skip_packed(type, data, packed + length);
+    return size_t(data - packed);
+}
+
+size_t packed_size(const Type *type, const vector<uint8_t>& packed, size_t offset)
+{
+    if(offset > packed.size()) {
+        throw out_of_range("packed data ended before the value was complete");
+    }
+    return packed_size(type, packed.data() + offset, packed.size() - offset);
+}
+
+// unpack decodes this value from native-endian packed data, advancing the data pointer.
+//     The value must have been constructed empty.
+void Value::unpack(const uint8_t *& data, const uint8_t *end, ValueArena *arena)
+{
     switch(type->subtype()) {
     case kTypeInt8:
+        int_ = read_native<int8_t>(data, end);
+        break;
     case kTypeInt16:
+        int_ = read_native<int16_t>(data, end);
+        break;
     case kTypeInt32:
+        int_ = read_native<int32_t>(data, end);
+        break;
     case kTypeInt64:
+        int_ = read_native<int64_t>(data, end);
+        break;
     case kTypeUint8:
+        uint_ = read_native<uint8_t>(data, end);
+        break;
     case kTypeUint16:
+        uint_ = read_native<uint16_t>(data, end);
+        break;
     case kTypeUint32:
+        uint_ = read_native<uint32_t>(data, end);
+        break;
     case kTypeUint64:
+        uint_ = read_native<uint64_t>(data, end);
+        break;
+    case kTypeChar:
+        char_ = read_native<char>(data, end);
+        break;
+    case kTypeFloat32:
+        float_ = read_native<float>(data, end);
+        break;
+    case kTypeFloat64:
+        double_ = read_native<double>(data, end);
+        break;
+    case kTypeString: {
+        size_t len = type->fixed_size();
+        string_.assign((const char *)read_bytes(data, end, len), len);
+        break;
+    }
+    case kTypeVarstring: {
+        size_t len = read_native<sizetag_t>(data, end);
+        string_.assign((const char *)read_bytes(data, end, len), len);
+        break;
+    }
+    case kTypeBlob: {
+        size_t len = type->fixed_size();
+        const uint8_t *bytes = read_bytes(data, end, len);
+        blob_.assign(bytes, bytes + len);
+        break;
+    }
+    case kTypeVarblob: {
+        size_t len = read_native<sizetag_t>(data, end);
+        const uint8_t *bytes = read_bytes(data, end, len);
+        blob_.assign(bytes, bytes + len);
+        break;
+    }
+    case kTypeArray: {
+        const Array *array = type->as_array();
+        size_t count = array->array_size();
+        elements_.reserve(count);
+        for(size_t i = 0; i < count; ++i) {
+            elements_.emplace_back(array->element_type(), kEmpty, arena);
+            elements_.back().unpack(data, end, arena);
+        }
+        break;
+    }
+    case kTypeVararray: {
+        const Array *array = type->as_array();
+        size_t len = read_native<sizetag_t>(data, end);
+        if(size_t(end - data) < len) {
+            throw out_of_range("packed data ended before the value was complete");
+        }
+        const uint8_t *array_end = data + len;
+        if(array->element_type()->has_fixed_size()) {
+            elements_.reserve(len / array->element_type()->fixed_size());
+        }
+        while(data < array_end) {
+            const uint8_t *element_start = data;
+            elements_.emplace_back(array->element_type(), kEmpty, arena);
+            elements_.back().unpack(data, array_end, arena);
+            if(data == element_start) {
+                throw out_of_range("packed array element didn't consume any data");
+            }
+        }
+        break;
+    }
+    case kTypeStruct: {
+        const Struct *record = type->as_struct();
+        size_t num_fields = record->num_fields();
+        fields_.reserve(num_fields);
+        for(unsigned int i = 0; i < num_fields; ++i) {
+            fields_.emplace_back(record->get_field(i)->type(), kEmpty, arena);
+            fields_.back().unpack(data, end, arena);
+        }
+        break;
+    }
+    case kTypeMethod: {
+        const Method *method = type->as_method();
+        size_t num_params = method->num_parameters();
+        arguments_.reserve(num_params);
+        for(unsigned int i = 0; i < num_params; ++i) {
+            arguments_.emplace_back(method->get_parameter(i)->type(), kEmpty, arena);
+            arguments_.back().unpack(data, end, arena);
+        }
+        break;
+    }
+    case kTypeInvalid:
+        break;
+    }
+}
+
+Value::Value(const Value& other) : Value(other, nullptr) {}
+
+Value::Value(const Value& other, ValueArena *arena) : Value(other.type, kEmpty, arena)
+{
+    copy_contents(other, arena);
+}
+
+Value::Value(Value&& other) noexcept : type(other.type), m_arena(other.m_arena)
+{
+    switch(type->subtype()) {
+    case kTypeInt8:
+    case kTypeInt16:
+    case kTypeInt32:
+    case kTypeInt64:
+        int_ = other.int_;
+        break;
     case kTypeChar:
+    case kTypeUint8:
+    case kTypeUint16:
+    case kTypeUint32:
+    case kTypeUint64:
+        uint_ = other.uint_;
+        break;
     case kTypeFloat32:
+        float_ = other.float_;
+        break;
     case kTypeFloat64:
+        double_ = other.double_;
+        break;
     case kTypeString:
     case kTypeVarstring:
+        new(&string_) string_t(move(other.string_));
+        break;
     case kTypeBlob:
     case kTypeVarblob:
+        new(&blob_) blob_t(move(other.blob_));
+        break;
     case kTypeArray:
     case kTypeVararray:
+        new(&elements_) elements_t(move(other.elements_));
+        break;
     case kTypeStruct:
+        new(&fields_) fields_t(move(other.fields_));
+        break;
     case kTypeMethod:
+        new(&arguments_) arguments_t(move(other.arguments_));
         break;
     case kTypeInvalid:
-        throw invalid_type("type has invalid subtype");
         break;
     }
 }
 
-Value::Value(const Value& other) : type(other.type)
+Value::Value(Value&& other, ValueArena *arena) : Value(other.type, kEmpty, arena)
+{
+    if(other.arena() == arena) {
+        // The other value's storage can be used as-is
+        swap(*this, other);
+    } else {
+        copy_contents(other, arena);
+    }
+}
+
+// copy_contents deep copies the contents of a value with the same type into this empty value.
+void Value::copy_contents(const Value& other, ValueArena *arena)
 {
     switch(type->subtype()) {
     case kTypeInt8:
@@ -145,30 +413,58 @@ Value::Value(const Value& other) : type(other.type)
         break;
     case kTypeString:
     case kTypeVarstring:
-        string_ = other.string_;
+        string_.assign(other.string_.data(), other.string_.size());
         break;
     case kTypeBlob:
     case kTypeVarblob:
-        blob_ = other.blob_;
+        blob_.assign(other.blob_.begin(), other.blob_.end());
         break;
     case kTypeArray:
     case kTypeVararray:
-        elements_ = other.elements_;
+        elements_.reserve(other.elements_.size());
+        for(const Value& element : other.elements_) {
+            elements_.emplace_back(element, arena);
+        }
         break;
     case kTypeStruct:
-        fields_ = other.fields_;
+        fields_.reserve(other.fields_.size());
+        for(const Value& field : other.fields_) {
+            fields_.emplace_back(field, arena);
+        }
         break;
     case kTypeMethod:
-        arguments_ = other.arguments_;
+        arguments_.reserve(other.arguments_.size());
+        for(const Value& argument : other.arguments_) {
+            arguments_.emplace_back(argument, arena);
+        }
         break;
     case kTypeInvalid:
         break;
     }
 }
 
-Value& Value::operator=(Value rhs)
+Value& Value::operator=(const Value& rhs)
+{
+    if(this != &rhs) {
+        Value copy(rhs, arena());
+        swap(*this, copy);
+    }
+    return *this;
+}
+
+Value& Value::operator=(Value&& rhs)
 {
-    swap(*this, rhs);
+    if(this != &rhs) {
+        if(arena() == rhs.arena()) {
+            // The other value's storage can be used as-is
+            swap(*this, rhs);
+        } else {
+            // Otherwise, heap storage would leak from an arena value that is never destroyed,
+            //     and arena storage would outlive the arena in a heap value.
+            Value copy(rhs, arena());
+            swap(*this, copy);
+        }
+    }
     return *this;
 }
 
@@ -177,15 +473,15 @@ Value::~Value()
     switch(type->subtype()) {
     case kTypeString:
     case kTypeVarstring:
-        string_.~string();
+        string_.~string_t();
         break;
     case kTypeBlob:
     case kTypeVarblob:
-        blob_.~vector<uint8_t>();
+        blob_.~blob_t();
         break;
     case kTypeArray:
     case kTypeVararray:
-        elements_.~vector<Value>();
+        elements_.~elements_t();
         break;
     case kTypeStruct:
         fields_.~fields_t();
@@ -219,147 +515,218 @@ size_t Value::size() const
     }
 };
 
-vector<uint8_t> Value::pack() const
+// packed_size_of returns the size of a value's packed data, using length tags of type Tag.
+template<typename Tag>
+static size_t packed_size_of(const Value& value)
 {
+    const Type *type = value.type;
     switch(type->subtype()) {
+    case kTypeVarstring:
+        return sizeof(Tag) + value.string_.size();
+    case kTypeVarblob:
+        return sizeof(Tag) + value.blob_.size();
+    case kTypeArray:
+    case kTypeVararray: {
+        size_t size = type->subtype() == kTypeVararray ? sizeof(Tag) : 0;
+        const Type *element_type = type->as_array()->element_type();
+        if(element_type->as_numeric() != nullptr) {
+            return size + value.elements_.size() * element_type->fixed_size();
+        }
+        for(const Value& element : value.elements_) {
+            size += packed_size_of<Tag>(element);
+        }
+        return size;
+    }
+    case kTypeStruct: {
+        size_t size = 0;
+        for(const Value& field : value.fields_) {
+            size += packed_size_of<Tag>(field);
+        }
+        return size;
+    }
+    case kTypeMethod: {
+        size_t size = 0;
+        for(const Value& argument : value.arguments_) {
+            size += packed_size_of<Tag>(argument);
+        }
+        return size;
+    }
+    case kTypeInvalid:
+        return 0;
+    default:
+        return type->fixed_size();
+    }
+}
+
+// put writes a number into a packed buffer, converting it to little-endian if Wire is set.
+template<bool Wire, typename T>
+static inline void put(uint8_t *& out, T v)
+{
+    if(Wire) { v = swap_le(v); }
+    memcpy(out, &v, sizeof(T));
+    out += sizeof(T);
+}
+
+// put_size writes a length tag of type Tag into a packed buffer.
+template<bool Wire, typename Tag>
+static inline void put_size(uint8_t *out, size_t size)
+{
+    if(size > size_t(Tag(-1))) {
+        throw length_error("packed value is too long for its length tag");
+    }
+    Tag tag = Tag(size);
+    put<Wire>(out, tag);
+}
+
+// put_bytes writes raw bytes into a packed buffer.
+static inline void put_bytes(uint8_t *& out, const void *data, size_t length)
+{
+    if(length > 0) {
+        memcpy(out, data, length);
+        out += length;
+    }
+}
+
+// put_fixed_bytes writes exactly <fixed_length> bytes of data into a packed buffer,
+//     truncating the data or padding it with zeros so that it fits its fixed-length type.
+static inline void put_fixed_bytes(uint8_t *& out, const void *data, size_t length,
+                                   size_t fixed_length)
+{
+    if(length > fixed_length) { length = fixed_length; }
+    put_bytes(out, data, length);
+    memset(out, 0, fixed_length - length);
+    out += fixed_length - length;
+}
+
+// write_packed writes a value's packed data into a buffer which is big enough to hold it,
+//     using length tags of type Tag, and converting numbers to little-endian if Wire is set.
+template<bool Wire, typename Tag>
+static void write_packed(const Value& value, uint8_t *& out)
+{
+    switch(value.type->subtype()) {
     case kTypeInt8:
-        return as_buffer(int8_t(int_));
+        put<Wire>(out, int8_t(value.int_));
+        break;
     case kTypeInt16:
-        return as_buffer(int16_t(int_));
+        put<Wire>(out, int16_t(value.int_));
+        break;
     case kTypeInt32:
-        return as_buffer(int32_t(int_));
+        put<Wire>(out, int32_t(value.int_));
+        break;
     case kTypeInt64:
-        return as_buffer(int64_t(int_));
+        put<Wire>(out, int64_t(value.int_));
+        break;
     case kTypeUint8:
-        return as_buffer(uint8_t(uint_));
+        put<Wire>(out, uint8_t(value.uint_));
+        break;
     case kTypeUint16:
-        return as_buffer(uint16_t(uint_));
+        put<Wire>(out, uint16_t(value.uint_));
+        break;
     case kTypeUint32:
-        return as_buffer(uint32_t(uint_));
+        put<Wire>(out, uint32_t(value.uint_));
+        break;
     case kTypeUint64:
-        return as_buffer(uint64_t(uint_));
+        put<Wire>(out, uint64_t(value.uint_));
+        break;
     case kTypeChar:
-        return as_buffer(char_);
+        put<Wire>(out, value.char_);
+        break;
     case kTypeFloat32:
-        return as_buffer(float_);
+        put<Wire>(out, value.float_);
+        break;
     case kTypeFloat64:
-        return as_buffer(double_);
+        put<Wire>(out, value.double_);
+        break;
     case kTypeString:
-        return as_buffer(string_);
-    case kTypeVarstring: {
-        vector<uint8_t> packed = as_buffer(uint16_t(string_.size()));
-        pack_value(as_buffer(string_), packed);
-        return packed;
-    }
+        put_fixed_bytes(out, value.string_.data(), value.string_.size(), value.type->fixed_size());
+        break;
+    case kTypeVarstring:
+        put_size<Wire, Tag>(out, value.string_.size());
+        out += sizeof(Tag);
+        put_bytes(out, value.string_.data(), value.string_.size());
+        break;
     case kTypeBlob:
-        return blob_;
-    case kTypeVarblob: {
-        vector<uint8_t> packed = as_buffer(uint16_t(string_.size()));
-        pack_value(blob_, packed);
-        return packed;
-    }
-    case kTypeArray: {
-        vector<uint8_t> packed;
-        for(const Value& element : elements_) {
-            pack_value(element.pack(), packed);
+        put_fixed_bytes(out, value.blob_.data(), value.blob_.size(), value.type->fixed_size());
+        break;
+    case kTypeVarblob:
+        put_size<Wire, Tag>(out, value.blob_.size());
+        out += sizeof(Tag);
+        put_bytes(out, value.blob_.data(), value.blob_.size());
+        break;
+    case kTypeArray:
+        for(const Value& element : value.elements_) {
+            write_packed<Wire, Tag>(element, out);
         }
-        return packed;
-    }
+        break;
     case kTypeVararray: {
-        // Reserve a 16-bit unsigned integer
-        vector<uint8_t> packed = as_buffer(uint16_t(0));
-        for(const Value& element : elements_) {
-            pack_value(element.pack(), packed);
+        // Leave space for the length tag, and fill it in once the elements are written
+        uint8_t *tag = out;
+        out += sizeof(Tag);
+        for(const Value& element : value.elements_) {
+            write_packed<Wire, Tag>(element, out);
         }
-        // Set the size using the reserved bytes
-        uint16_t *size_ptr = (uint16_t *)&packed[0];
-        *size_ptr = uint16_t(packed.size() - sizeof(uint16_t));
-        return packed;
+        put_size<Wire, Tag>(tag, size_t(out - tag) - sizeof(Tag));
+        break;
     }
-    case kTypeStruct: {
-        const Struct *record = type->as_struct();
-        size_t num_fields = record->num_fields();
-        vector<uint8_t> packed;
-        for(unsigned int i = 0; i < num_fields; ++i) {
-            pack_value(fields_.at(record->get_field(i)).pack(), packed);
+    case kTypeStruct:
+        for(const Value& field : value.fields_) {
+            write_packed<Wire, Tag>(field, out);
         }
-        return packed;
-    }
-    case kTypeMethod: {
-        const Method *method = type->as_method();
-        size_t num_params = method->num_parameters();
-        vector<uint8_t> packed;
-        for(unsigned int i = 0; i < num_params; ++i) {
-            pack_value(arguments_.at(method->get_parameter(i)).pack(), packed);
+        break;
+    case kTypeMethod:
+        for(const Value& argument : value.arguments_) {
+            write_packed<Wire, Tag>(argument, out);
         }
-        return packed;
-    }
+        break;
     case kTypeInvalid:
         break;
     }
+}
 
-    return vector<uint8_t>();
-};
+size_t Value::packed_size() const
+{
+    return packed_size_of<sizetag_t>(*this);
+}
+
+vector<uint8_t> Value::pack() const
+{
+    vector<uint8_t> packed(packed_size_of<sizetag_t>(*this));
+    uint8_t *out = packed.data();
+    write_packed<false, sizetag_t>(*this, out);
+    return packed;
+}
 
 vector<uint8_t> Value::pack32() const
 {
-    switch(type->subtype()) {
-    case kTypeVarstring: {
-        vector<uint8_t> packed = as_buffer(uint32_t(string_.size()));
-        pack_value(as_buffer(string_), packed);
-        return packed;
-    }
-    case kTypeVarblob: {
-        vector<uint8_t> packed = as_buffer(uint32_t(string_.size()));
-        pack_value(blob_, packed);
-        return packed;
-    }
-    case kTypeArray: {
-        vector<uint8_t> packed;
-        for(const Value& element : elements_) {
-            pack_value(element.pack32(), packed);
-        }
-        return packed;
-    }
-    case kTypeVararray: {
-        // Reserve a 32-bit unsigned integer
-        vector<uint8_t> packed = as_buffer(uint32_t(0));
-        for(const Value& element : elements_) {
-            pack_value(element.pack32(), packed);
-        }
-        // Set the size using the reserved bytes
-        uint32_t *size_ptr = (uint32_t *)&packed[0];
-        *size_ptr = uint32_t(packed.size() - sizeof(uint32_t));
-        return packed;
-    }
-    case kTypeStruct: {
-        const Struct *record = type->as_struct();
-        size_t num_fields = record->num_fields();
-        vector<uint8_t> packed;
-        for(unsigned int i = 0; i < num_fields; ++i) {
-            pack_value(fields_.at(record->get_field(i)).pack32(), packed);
-        }
-        return packed;
-    }
-    case kTypeMethod: {
-        const Method *method = type->as_method();
-        size_t num_params = method->num_parameters();
-        vector<uint8_t> packed;
-        for(unsigned int i = 0; i < num_params; ++i) {
-            pack_value(arguments_.at(method->get_parameter(i)).pack32(), packed);
-        }
-        return packed;
-    }
-    default:
-        return pack();
-    }
-};
+    vector<uint8_t> packed(packed_size_of<uint32_t>(*this));
+    uint8_t *out = packed.data();
+    write_packed<false, uint32_t>(*this, out);
+    return packed;
+}
 
-void swap(Value& lhs, Value& rhs)
+uint8_t *Value::pack_into(uint8_t *buffer) const
+{
+    write_packed<true, sizetag_t>(*this, buffer);
+    return buffer;
+}
+
+void swap(Value& lhs, Value& rhs) noexcept
 {
     using std::swap;
 
+    if(lhs.type->subtype() != rhs.type->subtype()) {
+        // The values are stored in different members of the union,
+        // so they have to be moved through a temporary.
+        Value tmp(move(lhs));
+        lhs.~Value();
+        new(&lhs) Value(move(rhs));
+        rhs.~Value();
+        new(&rhs) Value(move(tmp));
+        return;
+    }
+
     swap(lhs.type, rhs.type);
+    swap(lhs.m_arena, rhs.m_arena);
     switch(lhs.type->subtype()) {
     case kTypeInt8:
     case kTypeInt16:
@@ -404,6 +771,5 @@ void swap(Value& lhs, Value& rhs)
 }
 
 
-
 } // close namespace bamboo
 
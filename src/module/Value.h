@@ -2,10 +2,11 @@
 #pragma once
 #include <string>
 #include <vector>
-#include <map>
 #include "../bits/errors.h"
 #include "../module/Field.h"
 #include "../module/Parameter.h"
+#include "ValueArena.h"
+#include "ValueBlob.h"
 namespace bamboo   // open namespace bamboo
 {
 
@@ -15,16 +16,46 @@ class Type;
 
 // A Value is a variant that can represent the value of any Bamboo::Type.
 // Value's constructor throws null_error if the type is null or invalid_type if the type is invalid.
+//
+// A Value can optionally be constructed in a ValueArena, in which case its strings, blobs, and
+//     arrays, and all of its nested values, are allocated from the arena instead of the heap.
+//     Copying a value always makes a heap copy, unless the copy is given an arena explicitly.
+//
+// Because they use the value's allocator, string_ is not a std::string and blob_ is not a
+//     std::vector<uint8_t>.  string_ is a std::basic_string with a ValueAllocator, and blob_ is
+//     a ValueBlob, which stores short blobs inline.  Both have data(), size(), begin(), and end(),
+//     so they can be copied out, ie. std::string(v.string_.data(), v.string_.size()).
 struct Value {
 
-    typedef std::map<const Field *, Value, Field::sort_by_id> fields_t;
-    typedef std::map<const Parameter *, Value, Parameter::sort_by_position> arguments_t;
+    typedef std::basic_string<char, std::char_traits<char>, ValueAllocator<char> > string_t;
+    typedef ValueBlob blob_t;
+    typedef std::vector<Value, ValueAllocator<Value> > elements_t;
+    // The values of a struct's fields and of a method's arguments are stored contiguously,
+    //     indexed by the position of the field/parameter (ie. struct->get_field(n) is fields_[n]).
+    typedef std::vector<Value, ValueAllocator<Value> > fields_t;
+    typedef std::vector<Value, ValueAllocator<Value> > arguments_t;
 
-    explicit Value(const Type *);
-    Value(const Type *, const std::vector<uint8_t>& packed);
-    // Must redefine copy/assign/destruct for non-trivial union
+    // EmptyTag selects a constructor which leaves the value's strings, blobs, arrays, and
+    //     fields empty (and its numbers zero), instead of filling them with default values.
+    //     This is used to construct a value which is about to be decoded.
+    enum EmptyTag { kEmpty };
+
+    explicit Value(const Type *, ValueArena *arena = nullptr);
+    Value(const Type *, EmptyTag, ValueArena *arena = nullptr);
+    // Value(type, packed) unpacks a value from native-endian packed data.
+    //     Throws std::out_of_range if the data ends before the value is complete.
+    Value(const Type *, const std::vector<uint8_t>& packed, ValueArena *arena = nullptr);
+    // Must redefine copy/move/assign/destruct for non-trivial union
     Value(const Value&);
-    Value& operator=(Value rhs);
+    Value(Value&&) noexcept;
+    // Value(other, arena) makes a deep copy of a value in an arena (or on the heap if null).
+    Value(const Value&, ValueArena *arena);
+    // Value(other, arena) moves a value which is already in the arena, or copies it otherwise.
+    Value(Value&&, ValueArena *arena);
+    // Copy assignment copies the value into this value's arena, if it has one.
+    Value& operator=(const Value&);
+    // Move assignment moves a value which is in the same arena as this value, or copies it otherwise.
+    Value& operator=(Value&&);
     ~Value();
 
     const Type *type;
@@ -36,9 +67,9 @@ struct Value {
         double double_;
 #ifndef _MSC_VER
         // Use C++11 relaxed union for compliant compilers
-        std::string string_;
-        std::vector<uint8_t> blob_;
-        std::vector<Value> elements_;
+        string_t string_;
+        blob_t blob_;
+        elements_t elements_;
         fields_t fields_;
         arguments_t arguments_;
     };
@@ -46,19 +77,54 @@ struct Value {
     };
 
     // Have a bloated Value for MSVC
-    std::string string_;
-    std::vector<uint8_t> blob_;
-    std::vector<Value> elements_;
+    string_t string_;
+    blob_t blob_;
+    elements_t elements_;
     fields_t fields_;
     arguments_t arguments_;
 #endif
 
+    // arena returns the arena that the value was constructed in, which its strings, blobs,
+    //     and arrays are allocated from.  Returns nullptr if the value is on the heap.
+    ValueArena *arena() const
+    {
+        return m_arena;
+    }
+
     size_t size() const;
+
+    // packed_size returns the exact number of bytes in the value's packed data,
+    //     which is also the number of bytes it takes up in a datagram.
+    size_t packed_size() const;
+    // pack returns the value's packed data in native endianness.  Fixed-length strings and blobs
+    //     are truncated, or padded with zeros, to their type's length.
     std::vector<uint8_t> pack() const;
+    // pack32 is like pack, but uses 32-bit length tags regardless of the size of sizetag_t.
     std::vector<uint8_t> pack32() const;
+    // pack_into writes the value's packed data in wire endianness (little-endian) into a buffer
+    //     of at least packed_size() bytes, and returns a pointer to the end of the written data.
+    //     For example, to add a value to a datagram: value.pack_into(dg.add_buffer(size)).
+    uint8_t *pack_into(uint8_t *buffer) const;
+
+    friend void swap(Value&, Value&) noexcept;
+
+  private:
+    void unpack(const uint8_t *& data, const uint8_t *end, ValueArena *arena);
+    void copy_contents(const Value& other, ValueArena *arena);
+
+    // The arena is stored even for numbers, which don't allocate, so that a number in an arena
+    //     knows not to take heap storage when a string or struct is moved into it.
+    ValueArena *m_arena;
 };
 
-void swap(Value&, Value&);
+void swap(Value&, Value&) noexcept;
+
+// packed_size returns the number of bytes taken up by a value of the given type in packed data,
+//     without unpacking it.  Only the length tags of variable-size types are read; since packed
+//     data is the same size as wire data, this is also the size the value takes in a datagram.
+//     Throws std::out_of_range if the data ends before the value is complete.
+size_t packed_size(const Type *, const uint8_t *packed, size_t length);
+size_t packed_size(const Type *, const std::vector<uint8_t>& packed, size_t offset = 0);
 
 } // close namespace bamboo
 
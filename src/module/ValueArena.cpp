@@ -0,0 +1,81 @@
+// Filename: ValueArena.cpp
+#include "ValueArena.h"
+#include <stdlib.h> // malloc, free
+using namespace std;
+namespace bamboo   // open namespace bamboo
+{
+
+
+ValueArena::ValueArena(size_t block_size) : m_block_size(block_size)
+{
+    if(m_block_size < sizeof(Block)) { m_block_size = kDefaultBlockSize; }
+}
+
+ValueArena::~ValueArena()
+{
+    Block *block = m_head;
+    while(block != nullptr) {
+        Block *prev = block->prev;
+        free(block);
+        block = prev;
+    }
+}
+
+// allocate_slow starts a new block which is big enough for the allocation.
+//     Blocks double in size, so that a large tree only takes a few blocks.
+void *ValueArena::allocate_slow(size_t size, size_t align)
+{
+    size_t block_size = m_head != nullptr ? m_head->size * 2 : m_block_size;
+    while(block_size < size + align) {
+        block_size *= 2;
+    }
+
+    Block *block = (Block *)malloc(sizeof(Block) + block_size);
+    if(block == nullptr) {
+        throw bad_alloc();
+    }
+    if(m_head != nullptr) {
+        m_used_in_prev += size_t(m_cursor - block_data(m_head));
+    }
+    block->prev = m_head;
+    block->size = block_size;
+    m_head = block;
+    m_cursor = block_data(block);
+    m_end = m_cursor + block_size;
+
+    return allocate(size, align);
+}
+
+void ValueArena::clear()
+{
+    if(m_head == nullptr) { return; }
+
+    // Free every block except the head, which is also the largest
+    Block *block = m_head->prev;
+    while(block != nullptr) {
+        Block *prev = block->prev;
+        free(block);
+        block = prev;
+    }
+    m_head->prev = nullptr;
+    m_cursor = block_data(m_head);
+    m_used_in_prev = 0;
+}
+
+size_t ValueArena::used() const
+{
+    if(m_head == nullptr) { return 0; }
+    return m_used_in_prev + size_t(m_cursor - block_data(m_head));
+}
+
+size_t ValueArena::capacity() const
+{
+    size_t total = 0;
+    for(Block *block = m_head; block != nullptr; block = block->prev) {
+        total += block->size;
+    }
+    return total;
+}
+
+
+} // close namespace bamboo
@@ -0,0 +1,151 @@
+// Filename: ValueArena.h
+#pragma once
+#include <stddef.h> // for size_t
+#include <new>      // for std::bad_alloc
+#include <utility>  // for std::forward
+#include <type_traits>
+namespace bamboo   // open namespace bamboo
+{
+
+
+// A ValueArena is a monotonic memory region that a whole tree of Values can be allocated from.
+//     Allocating from an arena just bumps a pointer, and deallocating does nothing; the memory
+//     is released all at once when the arena is cleared or destroyed.  This makes decoding a
+//     deeply nested message, and throwing it away again, much cheaper than using the heap.
+//
+//     An arena is not thread-safe, and must outlive every Value allocated from it.
+class ValueArena
+{
+  public:
+    static const size_t kDefaultBlockSize = 4096;
+
+    explicit ValueArena(size_t block_size = kDefaultBlockSize);
+    ValueArena(const ValueArena&) = delete;
+    ValueArena& operator=(const ValueArena&) = delete;
+    ~ValueArena();
+
+    // allocate returns <size> bytes of uninitialized memory aligned to <align> bytes.
+    //     Throws std::bad_alloc if the memory cannot be allocated.
+    void *allocate(size_t size, size_t align = alignof(max_align_t))
+    {
+        size_t pad = (align - (size_t(m_cursor) & (align - 1))) & (align - 1);
+        if(size + pad > size_t(m_end - m_cursor)) {
+            return allocate_slow(size, align);
+        }
+        char *ptr = m_cursor + pad;
+        m_cursor = ptr + size;
+        return ptr;
+    }
+
+    // create constructs an object in the arena.  Objects created in the arena are never
+    //     destroyed, so they (and anything they allocate) should also use the arena.
+    template<typename T, typename... Args>
+    T *create(Args&&... args)
+    {
+        return new(allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    // clear releases all of the memory allocated from the arena at once.  The most recently
+    //     allocated block is kept so that a reused arena stops allocating from the heap.
+    void clear();
+
+    // used returns the number of bytes allocated from the arena since it was last cleared.
+    size_t used() const;
+    // capacity returns the total size of the blocks currently held by the arena.
+    size_t capacity() const;
+
+  private:
+    struct Block {
+        Block *prev;
+        size_t size; // bytes in the block, excluding the header
+    };
+
+    void *allocate_slow(size_t size, size_t align);
+    static char *block_data(Block *block)
+    {
+        return (char *)(block + 1);
+    }
+
+    Block *m_head = nullptr; // the block currently being allocated from
+    char *m_cursor = nullptr;
+    char *m_end = nullptr;
+    size_t m_block_size;
+    size_t m_used_in_prev = 0; // bytes used in the blocks before the head
+};
+
+// A ValueAllocator is the allocator used by a Value's strings, blobs, and arrays.
+//     It allocates from a ValueArena, or from the heap if it has no arena.
+template<typename T>
+class ValueAllocator
+{
+  public:
+    typedef T value_type;
+
+    // A container keeps its allocator when it is moved or swapped, so an arena's memory
+    //     moves along with the container.  Copies are made on the heap, unless an arena is
+    //     explicitly requested, so that a copy can outlive the arena it was copied from.
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+    typedef std::false_type propagate_on_container_copy_assignment;
+
+    ValueAllocator() noexcept : m_arena(nullptr) {}
+    ValueAllocator(ValueArena *arena) noexcept : m_arena(arena) {}
+    template<typename U>
+    ValueAllocator(const ValueAllocator<U>& other) noexcept : m_arena(other.arena()) {}
+
+    ValueAllocator select_on_container_copy_construction() const
+    {
+        return ValueAllocator();
+    }
+
+    T *allocate(size_t n)
+    {
+        if(m_arena != nullptr) {
+            return (T *)m_arena->allocate(n * sizeof(T), alignof(T));
+        }
+        return (T *)::operator new(n * sizeof(T));
+    }
+    void deallocate(T *ptr, size_t)
+    {
+        if(m_arena == nullptr) {
+            ::operator delete(ptr);
+        }
+    }
+
+    // construct passes the allocator's arena on to any element which accepts one (ie. a Value),
+    //     so that elements copied into a container, such as when it grows, share its arena.
+    template<typename U, typename... Args>
+    typename std::enable_if<std::is_constructible<U, Args..., ValueArena *>::value>::type
+    construct(U *ptr, Args&&... args)
+    {
+        ::new((void *)ptr) U(std::forward<Args>(args)..., m_arena);
+    }
+    template<typename U, typename... Args>
+    typename std::enable_if<!std::is_constructible<U, Args..., ValueArena *>::value>::type
+    construct(U *ptr, Args&&... args)
+    {
+        ::new((void *)ptr) U(std::forward<Args>(args)...);
+    }
+
+    ValueArena *arena() const
+    {
+        return m_arena;
+    }
+
+  private:
+    ValueArena *m_arena;
+};
+
+template<typename T, typename U>
+inline bool operator==(const ValueAllocator<T>& lhs, const ValueAllocator<U>& rhs)
+{
+    return lhs.arena() == rhs.arena();
+}
+template<typename T, typename U>
+inline bool operator!=(const ValueAllocator<T>& lhs, const ValueAllocator<U>& rhs)
+{
+    return lhs.arena() != rhs.arena();
+}
+
+
+} // close namespace bamboo
@@ -0,0 +1,237 @@
+// Filename: ValueBlob.h
+#pragma once
+#include <stdint.h>  // for uint8_t, uint32_t
+#include <stddef.h>  // for size_t
+#include <string.h>  // for memcpy, memcmp, memset
+#include <stdexcept> // for std::length_error
+#include "ValueArena.h"
+namespace bamboo   // open namespace bamboo
+{
+
+
+// A ValueBlob is the byte array used for a Value's blobs.  Blobs of up to kInlineSize bytes
+//     (ie. hashes, ids, and other small payloads) are stored inside the ValueBlob itself, so they
+//     don't allocate at all; larger blobs are allocated with the blob's ValueAllocator.
+//     It provides the parts of the std::vector<uint8_t> interface that are used for blobs.
+class ValueBlob
+{
+  public:
+    typedef uint8_t value_type;
+    typedef uint8_t *iterator;
+    typedef const uint8_t *const_iterator;
+    typedef ValueAllocator<uint8_t> allocator_type;
+
+    static const size_t kInlineSize = 16;
+
+    explicit ValueBlob(const allocator_type& alloc = allocator_type()) noexcept :
+        m_alloc(alloc), m_size(0), m_capacity(kInlineSize) {}
+    // A copy is made on the heap, like the containers which use a ValueAllocator.
+    ValueBlob(const ValueBlob& other) : ValueBlob()
+    {
+        assign(other.begin(), other.end());
+    }
+    ValueBlob(const ValueBlob& other, const allocator_type& alloc) : ValueBlob(alloc)
+    {
+        assign(other.begin(), other.end());
+    }
+    // A moved blob keeps its allocator, and the source is left empty.
+    ValueBlob(ValueBlob&& other) noexcept : ValueBlob(other.m_alloc)
+    {
+        swap(*this, other);
+    }
+    ~ValueBlob()
+    {
+        release();
+    }
+
+    // Copy assignment keeps this blob's allocator; move assignment takes the other blob's.
+    ValueBlob& operator=(const ValueBlob& other)
+    {
+        if(this != &other) {
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+    ValueBlob& operator=(ValueBlob&& other) noexcept
+    {
+        if(this != &other) {
+            release();
+            m_alloc = other.m_alloc;
+            m_size = 0;
+            m_capacity = kInlineSize;
+            swap(*this, other);
+        }
+        return *this;
+    }
+
+    allocator_type get_allocator() const
+    {
+        return m_alloc;
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+    // capacity returns the number of bytes the blob can hold without allocating.
+    size_t capacity() const
+    {
+        return m_capacity;
+    }
+    // is_inline returns true if the blob's bytes are stored inside the ValueBlob.
+    bool is_inline() const
+    {
+        return m_capacity <= kInlineSize;
+    }
+
+    uint8_t *data()
+    {
+        return is_inline() ? m_inline : m_heap;
+    }
+    const uint8_t *data() const
+    {
+        return is_inline() ? m_inline : m_heap;
+    }
+    iterator begin()
+    {
+        return data();
+    }
+    iterator end()
+    {
+        return data() + m_size;
+    }
+    const_iterator begin() const
+    {
+        return data();
+    }
+    const_iterator end() const
+    {
+        return data() + m_size;
+    }
+    uint8_t& operator[](size_t n)
+    {
+        return data()[n];
+    }
+    const uint8_t& operator[](size_t n) const
+    {
+        return data()[n];
+    }
+
+    // assign replaces the contents of the blob with the bytes from <first> to <last>.
+    void assign(const uint8_t *first, const uint8_t *last)
+    {
+        size_t count = size_t(last - first);
+        if(count > m_capacity) {
+            reallocate(count, false);
+        }
+        if(count > 0) {
+            memmove(data(), first, count);
+        }
+        m_size = uint32_t(count);
+    }
+    // assign can also fill the blob with <count> copies of a byte.
+    void assign(size_t count, uint8_t value)
+    {
+        if(count > m_capacity) {
+            reallocate(count, false);
+        }
+        memset(data(), value, count);
+        m_size = uint32_t(count);
+    }
+
+    // resize changes the size of the blob, filling any new bytes with zeros.
+    void resize(size_t count)
+    {
+        if(count > m_capacity) {
+            reallocate(count, true);
+        }
+        if(count > m_size) {
+            memset(data() + m_size, 0, count - m_size);
+        }
+        m_size = uint32_t(count);
+    }
+    // reserve makes sure the blob can hold <count> bytes without allocating.
+    void reserve(size_t count)
+    {
+        if(count > m_capacity) {
+            reallocate(count, true);
+        }
+    }
+    void clear()
+    {
+        m_size = 0;
+    }
+
+    friend void swap(ValueBlob& lhs, ValueBlob& rhs) noexcept
+    {
+        // Nothing points into the inline buffer, so the blobs can be swapped field by field
+        uint8_t storage[sizeof(lhs.m_inline)];
+        memcpy(storage, lhs.m_inline, sizeof(storage));
+        memcpy(lhs.m_inline, rhs.m_inline, sizeof(storage));
+        memcpy(rhs.m_inline, storage, sizeof(storage));
+
+        allocator_type alloc = lhs.m_alloc;
+        lhs.m_alloc = rhs.m_alloc;
+        rhs.m_alloc = alloc;
+        uint32_t size = lhs.m_size;
+        lhs.m_size = rhs.m_size;
+        rhs.m_size = size;
+        uint32_t capacity = lhs.m_capacity;
+        lhs.m_capacity = rhs.m_capacity;
+        rhs.m_capacity = capacity;
+    }
+
+    friend bool operator==(const ValueBlob& lhs, const ValueBlob& rhs)
+    {
+        return lhs.m_size == rhs.m_size && (lhs.m_size == 0 ||
+                memcmp(lhs.data(), rhs.data(), lhs.m_size) == 0);
+    }
+    friend bool operator!=(const ValueBlob& lhs, const ValueBlob& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+  private:
+    // reallocate moves the blob to a heap (or arena) buffer of at least <count> bytes.
+    //     Throws std::length_error if the blob would be larger than 4 GiB.
+    void reallocate(size_t count, bool keep_contents)
+    {
+        if(count > UINT32_MAX) {
+            throw std::length_error("ValueBlob can't hold more than 4 GiB");
+        }
+        size_t capacity = count < size_t(m_capacity) * 2 ? size_t(m_capacity) * 2 : count;
+        if(capacity > UINT32_MAX) {
+            capacity = UINT32_MAX;
+        }
+
+        uint8_t *buffer = m_alloc.allocate(capacity);
+        if(keep_contents && m_size > 0) {
+            memcpy(buffer, data(), m_size);
+        }
+        release();
+        m_heap = buffer;
+        m_capacity = uint32_t(capacity);
+    }
+    void release()
+    {
+        if(!is_inline()) {
+            m_alloc.deallocate(m_heap, m_capacity);
+            m_capacity = kInlineSize;
+        }
+    }
+
+    allocator_type m_alloc;
+    uint32_t m_size;
+    uint32_t m_capacity; // more than kInlineSize if the bytes are in m_heap
+    union {
+        uint8_t *m_heap;
+        uint8_t m_inline[kInlineSize];
+    };
+};
+
+
+} // close namespace bamboo
@@ -0,0 +1,387 @@
+#include "BufferPool.h"
+#include <mutex>         // std::mutex, std::lock_guard
+#include <unordered_set> // std::unordered_set
+using namespace std;
+namespace bamboo    // open namespace bamboo
+{
+
+
+// The number of buffers moved between a thread's pool and the shared overflow list at once.
+static const size_t kTransferBatch = 32;
+
+// A PooledBuffer is the header stored in the first bytes of a free buffer,
+// so that the free lists don't have to allocate any memory of their own.
+struct PooledBuffer {
+    PooledBuffer *next;
+};
+
+// FreeLists are the free buffers of each size class.
+struct FreeLists {
+    PooledBuffer *heads[BufferPool::kNumSizeClasses] = {};
+    size_t counts[BufferPool::kNumSizeClasses] = {};
+
+    void push(unsigned int index, PooledBuffer *pooled)
+    {
+        pooled->next = heads[index];
+        heads[index] = pooled;
+        counts[index] += 1;
+    }
+
+    PooledBuffer *pop(unsigned int index)
+    {
+        PooledBuffer *pooled = heads[index];
+        if(pooled != nullptr) {
+            heads[index] = pooled->next;
+            counts[index] -= 1;
+        }
+        return pooled;
+    }
+
+    void clear()
+    {
+        for(unsigned int i = 0; i < BufferPool::kNumSizeClasses; ++i) {
+            while(PooledBuffer *pooled = pop(i)) {
+                delete [] (uint8_t *)pooled;
+            }
+        }
+    }
+};
+
+// PoolCounters are the statistics of a single thread.  They are only changed by their own
+//     thread, but are atomic so that the process-wide stats can be read from any thread.
+struct PoolCounters {
+    atomic<uint64_t> hits{0};
+    atomic<uint64_t> misses{0};
+    atomic<uint64_t> recycled{0};
+    atomic<uint64_t> discarded{0};
+    atomic<size_t> pooled_buffers{0};
+    atomic<size_t> pooled_bytes{0};
+
+    void add_to(BufferPoolStats& stats) const
+    {
+        stats.hits += hits.load(memory_order_relaxed);
+        stats.misses += misses.load(memory_order_relaxed);
+        stats.recycled += recycled.load(memory_order_relaxed);
+        stats.discarded += discarded.load(memory_order_relaxed);
+        stats.pooled_buffers += pooled_buffers.load(memory_order_relaxed);
+        stats.pooled_bytes += pooled_bytes.load(memory_order_relaxed);
+    }
+
+    void reset()
+    {
+        hits.store(0, memory_order_relaxed);
+        misses.store(0, memory_order_relaxed);
+        recycled.store(0, memory_order_relaxed);
+        discarded.store(0, memory_order_relaxed);
+    }
+};
+
+static void count(atomic<uint64_t>& counter)
+{
+    counter.fetch_add(1, memory_order_relaxed);
+}
+
+struct ThreadPool;
+
+// The SharedPool is the state of the BufferPool that is shared between threads.
+struct SharedPool {
+    mutex lock;
+    FreeLists overflow; // buffers spilled by threads whose own free lists were full
+    atomic<size_t> available[BufferPool::kNumSizeClasses]; // overflow.counts, readable unlocked
+    unordered_set<ThreadPool *> threads; // the pools of the running threads
+    PoolCounters retired; // counters of exited threads, and of threads whose pool is destroyed
+
+    SharedPool()
+    {
+        for(unsigned int i = 0; i < BufferPool::kNumSizeClasses; ++i) {
+            available[i].store(0, memory_order_relaxed);
+        }
+    }
+};
+
+// shared_pool returns the shared state of the BufferPool.  It is never destroyed, so that
+//     threads which exit during (or after) static destruction can still release their buffers.
+static SharedPool& shared_pool()
+{
+    static SharedPool *shared = new SharedPool();
+    return *shared;
+}
+
+static thread_local bool t_pool_destroyed = false;
+
+// A ThreadPool is the set of free lists owned by a single thread.
+struct ThreadPool {
+    FreeLists free;
+    PoolCounters counters;
+
+    ThreadPool()
+    {
+        SharedPool& shared = shared_pool();
+        lock_guard<mutex> guard(shared.lock);
+        shared.threads.insert(this);
+    }
+
+    ~ThreadPool()
+    {
+        clear();
+
+        SharedPool& shared = shared_pool();
+        {
+            lock_guard<mutex> guard(shared.lock);
+            BufferPoolStats stats;
+            counters.add_to(stats);
+            shared.retired.hits.fetch_add(stats.hits, memory_order_relaxed);
+            shared.retired.misses.fetch_add(stats.misses, memory_order_relaxed);
+            shared.retired.recycled.fetch_add(stats.recycled, memory_order_relaxed);
+            shared.retired.discarded.fetch_add(stats.discarded, memory_order_relaxed);
+            shared.threads.erase(this);
+        }
+        t_pool_destroyed = true;
+    }
+
+    void clear()
+    {
+        free.clear();
+        counters.pooled_buffers.store(0, memory_order_relaxed);
+        counters.pooled_bytes.store(0, memory_order_relaxed);
+    }
+
+    void add_pooled(size_t buffers, size_t bytes)
+    {
+        counters.pooled_buffers.fetch_add(buffers, memory_order_relaxed);
+        counters.pooled_bytes.fetch_add(bytes, memory_order_relaxed);
+    }
+
+    void remove_pooled(size_t buffers, size_t bytes)
+    {
+        counters.pooled_buffers.fetch_sub(buffers, memory_order_relaxed);
+        counters.pooled_bytes.fetch_sub(bytes, memory_order_relaxed);
+    }
+};
+
+static thread_local ThreadPool t_pool;
+
+// thread_pool returns the calling thread's pool, or nullptr if it has already been destroyed.
+static ThreadPool *thread_pool()
+{
+    return t_pool_destroyed ? nullptr : &t_pool;
+}
+
+// size_class returns the index of the smallest size class that can hold <capacity> bytes.
+static unsigned int size_class(size_t capacity)
+{
+    unsigned int index = 0;
+    size_t class_size = BufferPool::kMinBufferSize;
+    while(class_size < capacity) {
+        class_size <<= 1;
+        index += 1;
+    }
+    return index;
+}
+
+// refill moves a batch of buffers of the given size class from the shared overflow list
+//     to the thread's pool, and returns false if the overflow list had none.
+static bool refill(ThreadPool& pool, unsigned int index)
+{
+    SharedPool& shared = shared_pool();
+    if(shared.available[index].load(memory_order_relaxed) == 0) {
+        return false;
+    }
+
+    size_t moved = 0;
+    {
+        lock_guard<mutex> guard(shared.lock);
+        while(moved < kTransferBatch) {
+            PooledBuffer *pooled = shared.overflow.pop(index);
+            if(pooled == nullptr) {
+                break;
+            }
+            pool.free.push(index, pooled);
+            moved += 1;
+        }
+        shared.available[index].store(shared.overflow.counts[index], memory_order_relaxed);
+    }
+
+    pool.add_pooled(moved, moved * (BufferPool::kMinBufferSize << index));
+    return moved > 0;
+}
+
+// spill moves a batch of buffers of the given size class from the thread's pool
+//     to the shared overflow list, keeping at most <max_buffers> in the overflow list.
+static void spill(ThreadPool& pool, unsigned int index, size_t max_buffers)
+{
+    SharedPool& shared = shared_pool();
+    if(shared.available[index].load(memory_order_relaxed) >= max_buffers) {
+        return;
+    }
+
+    size_t moved = 0;
+    {
+        lock_guard<mutex> guard(shared.lock);
+        while(moved < kTransferBatch && shared.overflow.counts[index] < max_buffers) {
+            PooledBuffer *pooled = pool.free.pop(index);
+            if(pooled == nullptr) {
+                break;
+            }
+            shared.overflow.push(index, pooled);
+            moved += 1;
+        }
+        shared.available[index].store(shared.overflow.counts[index], memory_order_relaxed);
+    }
+
+    pool.remove_pooled(moved, moved * (BufferPool::kMinBufferSize << index));
+}
+
+// constructor
+BufferPool::BufferPool() : m_max_buffers_per_class(128) {}
+
+// instance returns the process-wide buffer pool.
+BufferPool *BufferPool::instance()
+{
+    static BufferPool pool;
+    return &pool;
+}
+
+// allocate returns a buffer from the calling thread's pool, rounding up the capacity
+//     to the buffer's size class.
+uint8_t *BufferPool::allocate(size_t& capacity)
+{
+    ThreadPool *pool = thread_pool();
+    PoolCounters& counters = pool != nullptr ? pool->counters : shared_pool().retired;
+    if(capacity > kMaxBufferSize) {
+        count(counters.misses);
+        return new uint8_t[capacity];
+    }
+
+    unsigned int index = size_class(capacity);
+    capacity = kMinBufferSize << index;
+    if(pool == nullptr) {
+        count(counters.misses);
+        return new uint8_t[capacity];
+    }
+
+    PooledBuffer *pooled = pool->free.pop(index);
+    if(pooled == nullptr && refill(*pool, index)) {
+        pooled = pool->free.pop(index);
+    }
+    if(pooled == nullptr) {
+        count(counters.misses);
+        return new uint8_t[capacity];
+    }
+
+    count(counters.hits);
+    pool->remove_pooled(1, capacity);
+    return (uint8_t *)pooled;
+}
+
+// deallocate returns a buffer to the calling thread's pool.  Buffers released after the
+//     thread's pool has been destroyed (ie. by another thread_local's destructor) are freed.
+void BufferPool::deallocate(uint8_t *buffer, size_t capacity)
+{
+    if(buffer == nullptr) {
+        return;
+    }
+
+    ThreadPool *pool = thread_pool();
+    if(pool == nullptr) {
+        count(shared_pool().retired.discarded);
+        delete [] buffer;
+        return;
+    }
+
+    if(capacity > kMaxBufferSize) {
+        count(pool->counters.discarded);
+        delete [] buffer;
+        return;
+    }
+
+    unsigned int index = size_class(capacity);
+    size_t max_buffers = m_max_buffers_per_class.load(memory_order_relaxed);
+    if(pool->free.counts[index] >= max_buffers) {
+        spill(*pool, index, max_buffers);
+    }
+    if(pool->free.counts[index] >= max_buffers) {
+        count(pool->counters.discarded);
+        delete [] buffer;
+        return;
+    }
+
+    pool->free.push(index, (PooledBuffer *)buffer);
+    count(pool->counters.recycled);
+    pool->add_pooled(1, kMinBufferSize << index);
+}
+
+// stats returns the pool statistics for the whole process, including threads that have
+//     exited and the buffers held by the shared overflow list.
+BufferPoolStats BufferPool::stats() const
+{
+    SharedPool& shared = shared_pool();
+    lock_guard<mutex> guard(shared.lock);
+
+    BufferPoolStats stats;
+    shared.retired.add_to(stats);
+    for(ThreadPool *pool : shared.threads) {
+        pool->counters.add_to(stats);
+    }
+    for(unsigned int i = 0; i < kNumSizeClasses; ++i) {
+        stats.pooled_buffers += shared.overflow.counts[i];
+        stats.pooled_bytes += shared.overflow.counts[i] * (kMinBufferSize << i);
+    }
+    return stats;
+}
+
+// thread_stats returns the pool statistics for the calling thread.
+BufferPoolStats BufferPool::thread_stats() const
+{
+    BufferPoolStats stats;
+    ThreadPool *pool = thread_pool();
+    if(pool != nullptr) {
+        pool->counters.add_to(stats);
+    }
+    return stats;
+}
+
+// reset_stats clears the hit, miss, recycle, and discard counters of every thread.
+void BufferPool::reset_stats()
+{
+    SharedPool& shared = shared_pool();
+    lock_guard<mutex> guard(shared.lock);
+
+    shared.retired.reset();
+    for(ThreadPool *pool : shared.threads) {
+        pool->counters.reset();
+    }
+}
+
+// trim frees all of the buffers held by the calling thread's pool and the shared overflow list.
+void BufferPool::trim()
+{
+    ThreadPool *pool = thread_pool();
+    if(pool != nullptr) {
+        pool->clear();
+    }
+
+    SharedPool& shared = shared_pool();
+    lock_guard<mutex> guard(shared.lock);
+    shared.overflow.clear();
+    for(unsigned int i = 0; i < kNumSizeClasses; ++i) {
+        shared.available[i].store(0, memory_order_relaxed);
+    }
+}
+
+// max_buffers_per_class returns the number of free buffers each thread, and the shared
+//     overflow list, keeps per size class.
+size_t BufferPool::max_buffers_per_class() const
+{
+    return m_max_buffers_per_class.load(memory_order_relaxed);
+}
+
+// set_max_buffers_per_class limits how many free buffers each thread, and the shared
+//     overflow list, keeps per size class.
+void BufferPool::set_max_buffers_per_class(size_t count)
+{
+    m_max_buffers_per_class.store(count, memory_order_relaxed);
+}
+
+
+} // close namespace bamboo
@@ -0,0 +1,82 @@
+#pragma once
+#include <stdint.h> // for uint64_t
+#include <stddef.h> // for size_t
+#include <atomic>   // for std::atomic
+#include "Datagram.h"
+namespace bamboo    // open namespace bamboo
+{
+
+
+// BufferPoolStats describes how a BufferPool has been used, either by one thread or by the process.
+struct BufferPoolStats {
+    uint64_t hits = 0;      // allocations served from a pooled buffer
+    uint64_t misses = 0;    // allocations which had to allocate a new buffer
+    uint64_t recycled = 0;  // buffers returned to the pool for reuse
+    uint64_t discarded = 0; // buffers freed because their size class was full or too large
+    size_t pooled_buffers = 0; // number of free buffers currently held by the pool(s)
+    size_t pooled_bytes = 0;   // total capacity of the free buffers held by the pool(s)
+
+    // hit_rate returns the fraction of allocations that were served from the pool.
+    double hit_rate() const
+    {
+        uint64_t total = hits + misses;
+        return total ? double(hits) / double(total) : 0.0;
+    }
+};
+
+// A BufferPool is a DatagramAllocator which recycles datagram buffers instead of freeing them.
+//     Buffers are grouped in power-of-two size classes from kMinBufferSize to kMaxBufferSize;
+//     larger buffers bypass the pool.  Each thread keeps its own free lists, so allocating and
+//     releasing buffers usually doesn't take a lock.  When a thread's free list is full, released
+//     buffers move in batches to a shared overflow list, which threads that run out of buffers
+//     draw from; this lets a thread that only releases datagrams (ie. the consumer of a queue)
+//     return buffers to the thread that allocates them.
+//
+//     To have all datagrams use the pool, call:
+//         Datagram::set_default_allocator(BufferPool::instance());
+class BufferPool : public DatagramAllocator
+{
+  public:
+    static const size_t kMinBufferSize = 64;
+    static const size_t kMaxBufferSize = 65536;
+    static const unsigned int kNumSizeClasses = 11;
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    // instance returns the process-wide buffer pool.
+    static BufferPool *instance();
+
+    // allocate returns a buffer from the calling thread's pool, rounding up the capacity
+    //     to the buffer's size class.
+    uint8_t *allocate(size_t& capacity) override;
+    // deallocate returns a buffer to the calling thread's pool.  Buffers released after the
+    //     thread's pool has been destroyed (ie. by another thread_local's destructor) are freed.
+    void deallocate(uint8_t *buffer, size_t capacity) override;
+
+    // stats returns the pool statistics for the whole process, including threads that have
+    //     exited and the buffers held by the shared overflow list.
+    BufferPoolStats stats() const;
+    // thread_stats returns the pool statistics for the calling thread.
+    BufferPoolStats thread_stats() const;
+    // reset_stats clears the hit, miss, recycle, and discard counters of every thread.
+    void reset_stats();
+
+    // trim frees all of the buffers held by the calling thread's pool and the shared overflow list.
+    void trim();
+
+    // max_buffers_per_class returns the number of free buffers each thread, and the shared
+    //     overflow list, keeps per size class.
+    size_t max_buffers_per_class() const;
+    // set_max_buffers_per_class limits how many free buffers each thread, and the shared
+    //     overflow list, keeps per size class.
+    void set_max_buffers_per_class(size_t count);
+
+  private:
+    BufferPool();
+
+    std::atomic<size_t> m_max_buffers_per_class;
+};
+
+
+} // close namespace bamboo
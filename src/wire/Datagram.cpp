@@ -10,6 +10,79 @@ namespace bamboo    // close namespace bamboo
 {
 
 
+// A HeapAllocator allocates datagram buffers with new[] and delete[].
+class HeapAllocator : public DatagramAllocator
+{
+  public:
+    uint8_t *allocate(size_t& capacity) override
+    {
+        return new uint8_t[capacity];
+    }
+
+    void deallocate(uint8_t *buffer, size_t) override
+    {
+        delete [] buffer;
+    }
+};
+
+// heap returns an allocator which allocates buffers using new[] and delete[].
+DatagramAllocator *DatagramAllocator::heap()
+{
+    static HeapAllocator allocator;
+    return &allocator;
+}
+
+static DatagramAllocator *g_default_allocator = nullptr;
+
+// default_allocator returns the allocator used by datagrams constructed without one.
+DatagramAllocator *Datagram::default_allocator()
+{
+    if(g_default_allocator == nullptr) {
+        return DatagramAllocator::heap();
+    }
+    return g_default_allocator;
+}
+
+// set_default_allocator changes the allocator used by datagrams constructed without one.
+void Datagram::set_default_allocator(DatagramAllocator *allocator)
+{
+    g_default_allocator = allocator;
+}
+
+// grow reallocates the datagram's buffer so that it can hold at least <min_capacity> bytes.
+void Datagram::grow(size_t min_capacity)
+{
+    // Double the capacity (or use the requested capacity if that is larger), so that
+    // building a datagram from many small adds only reallocates O(log n) times.
+    size_t capacity = size_t(buf_cap) * 2;
+    if(capacity < min_capacity) {
+        capacity = min_capacity;
+    }
+    if(capacity < 64) {
+        capacity = 64;
+    }
+    if(capacity > kSizetagMax) {
+        capacity = kSizetagMax;
+    }
+
+    reallocate(capacity);
+}
+
+void Datagram::reallocate(size_t capacity)
+{
+    uint8_t *tmp_buf = buf_alloc->allocate(capacity);
+    if(buf_offset > 0) {
+        memcpy(tmp_buf, buf, buf_offset);
+    }
+    if(buf != nullptr) {
+        buf_alloc->deallocate(buf, buf_alloc_cap);
+    }
+    buf = tmp_buf;
+    buf_alloc_cap = capacity;
+    buf_cap = capacity < kSizetagMax ? sizetag_t(capacity) : sizetag_t(kSizetagMax);
+}
+
+
 // add_value adds a Value with the given type to the datagram, converting
 // byte-order from native-endianess to wire-endianess (if necessary).
 void Datagram::add_value(const Value& value)
@@ -18,13 +91,11 @@ void Datagram::add_value(const Value& value)
 };
 void Datagram::add_value(const Value *value)
 {
-    vector<uint8_t> packed = value->pack();
-
-#ifdef PLATFORM_BIG_ENDIAN
-    add_packed(type, packed); // endian-swap all values
-#else
-    add_data(packed);
-#endif
+    // Size the value first, so that it can be written straight into the datagram's buffer
+    size_t length = value->packed_size();
+    check_add_length(length);
+    value->pack_into(buf + buf_offset);
+    buf_offset += sizetag_t(length);
 };
 
 // add_packed adds data from a packed value, returning the number of bytes read from the buffer.
@@ -125,7 +196,13 @@ sizetag_t Datagram::add_packed(const Type *type,
         const Array *arr = type->as_array();
         if(arr->element_type()->fixed_size() == 1) {
             // If the element size is 1, we don't have to worry about endianness
-            add_blob(&packed[offset], len);
+            add_data(&packed[offset], len);
+            offset += len;
+            return offset;
+        }
+        if(arr->element_type()->as_numeric() != nullptr) {
+            // Arrays of numbers are converted in bulk
+            add_numbers(arr->element_type(), &packed[offset], len);
             offset += len;
             return offset;
         }
@@ -133,7 +210,14 @@ sizetag_t Datagram::add_packed(const Type *type,
         // Copy elements from the array till we reach the expected size
         sizetag_t array_end = offset + len;
         while(offset < array_end) {
+            sizetag_t element_start = offset;
             offset = add_packed(arr->element_type(), packed, offset);
+            if(offset == element_start) {
+                stringstream error;
+                error << "Datagram tried to copy array data, but an element of the array"
+                      " didn't consume any of the array length of " << len << ".\n";
+                throw BufferEOF(error.str());
+            }
         }
         if(offset > array_end) {
             stringstream error;
@@ -168,12 +252,25 @@ sizetag_t Datagram::add_packed(const Type *type,
             return offset;
         }
 
-        add_size(packed.size());
+        add_size(len);
+        if(arr->element_type()->as_numeric() != nullptr) {
+            // Arrays of numbers are converted in bulk
+            add_numbers(arr->element_type(), &packed[offset], len);
+            offset += len;
+            return offset;
+        }
 
         // Copy elements from the array till we reach the expected size
         sizetag_t array_end = offset + len;
         while(offset < array_end) {
+            sizetag_t element_start = offset;
             offset = add_packed(arr->element_type(), packed, offset);
+            if(offset == element_start) {
+                stringstream error;
+                error << "Datagram tried to copy array data, but an element of the array"
+                      " didn't consume any of the array length of " << len << ".\n";
+                throw BufferEOF(error.str());
+            }
         }
         if(offset > array_end) {
             stringstream error;
@@ -205,6 +302,36 @@ sizetag_t Datagram::add_packed(const Type *type,
     return offset;
 }
 
+// add_numbers adds <length> bytes of packed numbers with the given element type,
+//     converting them from native-endianess to wire-endianess in bulk.
+void Datagram::add_numbers(const Type *element, const uint8_t *packed, sizetag_t length)
+{
+    size_t width = element->fixed_size();
+    if(length % width != 0) {
+        stringstream error;
+        error << "Datagram tried to copy array data, but array data"
+              " exceeded the expected array length of " << length << ".\n";
+        throw BufferEOF(error.str());
+    }
+
+    check_add_length(length);
+    switch(width) {
+    case 2:
+        swap_le_array<uint16_t>(buf + buf_offset, packed, length / 2);
+        break;
+    case 4:
+        swap_le_array<uint32_t>(buf + buf_offset, packed, length / 4);
+        break;
+    case 8:
+        swap_le_array<uint64_t>(buf + buf_offset, packed, length / 8);
+        break;
+    default:
+        memcpy(buf + buf_offset, packed, length);
+        break;
+    }
+    buf_offset += length;
+}
+
 void swap(Datagram& lhs, Datagram& rhs)
 {
     using std::swap;
@@ -212,6 +339,8 @@ void swap(Datagram& lhs, Datagram& rhs)
     swap(lhs.buf, rhs.buf);
     swap(lhs.buf_cap, rhs.buf_cap);
     swap(lhs.buf_offset, rhs.buf_offset);
+    swap(lhs.buf_alloc, rhs.buf_alloc);
+    swap(lhs.buf_alloc_cap, rhs.buf_alloc_cap);
 }
 
 
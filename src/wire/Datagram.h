@@ -3,6 +3,7 @@
 #include <vector>    // for std::vector
 #include <sstream>   // for std::sstream
 #include <stdexcept> // for std::runtime_error
+#include <type_traits> // for std::is_arithmetic
 #include <string.h>  // for memcpy
 #include "../bits/sizetag.h"
 #include "../bits/byteorder.h"
@@ -29,6 +30,24 @@ class BufferEOF : public std::runtime_error
     BufferEOF(const std::string& what) : std::runtime_error(what) { }
 };
 
+// A DatagramAllocator provides the memory used for a Datagram's buffer.
+//     The default allocator uses new[] and delete[], but an application may provide its own
+//     allocator (ie. a pool or arena) to reduce the cost of creating and destroying datagrams.
+class DatagramAllocator
+{
+  public:
+    virtual ~DatagramAllocator() {}
+
+    // allocate returns a buffer of at least <capacity> bytes.  If the allocator provides more
+    //     space than requested, it updates capacity to the size of the returned buffer.
+    virtual uint8_t *allocate(size_t& capacity) = 0;
+    // deallocate releases a buffer and its capacity, as previously returned by allocate.
+    virtual void deallocate(uint8_t *buffer, size_t capacity) = 0;
+
+    // heap returns an allocator which allocates buffers using new[] and delete[].
+    static DatagramAllocator *heap();
+};
+
 // A Datagram is a buffer of binary data in network-endianness.
 class Datagram
 {
@@ -36,8 +55,10 @@ class Datagram
     uint8_t *buf;
     sizetag_t buf_cap;
     sizetag_t buf_offset;
+    DatagramAllocator *buf_alloc;
+    size_t buf_alloc_cap; // capacity returned by the allocator, which may exceed buf_cap
 
-    void check_add_length(sizetag_t len)
+    void check_add_length(size_t len)
     {
         if(buf_offset + len > kSizetagMax) {
             std::stringstream error;
@@ -47,81 +68,138 @@ class Datagram
         }
 
         if(buf_offset + len > buf_cap) {
-            uint8_t *tmp_buf = new uint8_t[buf_cap + len + 64];
-            memcpy(tmp_buf, buf, buf_cap);
-            delete [] buf;
-            buf = tmp_buf;
-            buf_cap = buf_cap + len + 64;
+            grow(buf_offset + len);
         }
     }
 
     void check_read_length(const std::vector<uint8_t>& buffer, sizetag_t offset, sizetag_t len)
     {
-        if(offset + len >= buffer.size()) {
+        if(size_t(offset) + len > buffer.size()) {
             std::string error("Datagram could not add data from provided buffer;"
                               " reached end of buffer.");
             throw BufferEOF(error);
         }
     }
 
+    // grow reallocates the datagram's buffer so that it can hold at least <min_capacity> bytes.
+    //     The capacity grows geometrically, so a sequence of adds copies each byte O(1) times.
+    void grow(size_t min_capacity);
+    // reallocate moves the datagram's data into a new buffer with the given capacity.
+    void reallocate(size_t capacity);
+
+    // add_numbers adds <length> bytes of packed numbers with the given element type,
+    //     converting them from native-endianess to wire-endianess in bulk.
+    void add_numbers(const Type *element, const uint8_t *packed, sizetag_t length);
+
+    // store_values writes each value to <dst> in little-endian, one after another.
+    static void store_values(uint8_t *) {}
+    template<typename T, typename... Ts>
+    static void store_values(uint8_t *dst, const T& value, const Ts&... rest)
+    {
+        store_le<T>(dst, value);
+        store_values(dst + sizeof(T), rest...);
+    }
+
+    // alloc_buffer allocates a buffer for a newly constructed datagram.
+    void alloc_buffer(size_t capacity)
+    {
+        buf = buf_alloc->allocate(capacity);
+        buf_alloc_cap = capacity;
+        buf_cap = capacity < kSizetagMax ? sizetag_t(capacity) : sizetag_t(kSizetagMax);
+    }
+
   public:
     // default-constructor:
     //     creates a new datagram with some pre-allocated space
-    Datagram() : buf(new uint8_t[64]), buf_cap(64), buf_offset(0) {}
+    Datagram() : buf_offset(0), buf_alloc(default_allocator())
+    {
+        alloc_buffer(64);
+    }
 
     // sized-constructor:
     //     allows you to specify the capacity of the datagram ahead of time,
     //     this should be used when the exact size is known ahead of time for performance
-    explicit Datagram(size_t capacity) : buf(new uint8_t[capacity]), buf_cap(capacity) {}
+    explicit Datagram(size_t capacity) : buf_offset(0), buf_alloc(default_allocator())
+    {
+        alloc_buffer(capacity);
+    }
+
+    // allocator-constructor:
+    //     creates a new datagram with the given capacity using a specific allocator.
+    Datagram(size_t capacity, DatagramAllocator *allocator) :
+        buf_offset(0), buf_alloc(allocator)
+    {
+        alloc_buffer(capacity);
+    }
 
     // copy-constructor:
     //     creates a new datagram which is a deep-copy of another datagram;
     //     capacity is not perserved and instead is reduced to the size of the source datagram.
-    Datagram(const Datagram& dg) :
-        buf(new uint8_t[dg.size()]),
-        buf_cap(dg.size()),
-        buf_offset(dg.size())
+    Datagram(const Datagram& dg) : buf_offset(dg.size()), buf_alloc(dg.buf_alloc)
     {
-        memcpy(buf, dg.buf, dg.size());
+        alloc_buffer(dg.size());
+        if(dg.size() > 0) {
+            memcpy(buf, dg.buf, dg.size());
+        }
+    }
+
+    // move-constructor:
+    //     creates a new datagram which takes ownership of another datagram's buffer;
+    //     the source datagram is left empty, but may still be reused or assigned to.
+    Datagram(Datagram&& dg) noexcept :
+        buf(dg.buf), buf_cap(dg.buf_cap), buf_offset(dg.buf_offset), buf_alloc(dg.buf_alloc),
+        buf_alloc_cap(dg.buf_alloc_cap)
+    {
+        dg.buf = nullptr;
+        dg.buf_cap = 0;
+        dg.buf_alloc_cap = 0;
+        dg.buf_offset = 0;
     }
 
     // shallow-constructor:
-    //     creates a new datagram that uses an existing buffer as its data
+    //     creates a new datagram that uses an existing buffer as its data;
+    //     the datagram takes ownership of the buffer, which must have been allocated with new[].
     Datagram(uint8_t *data, sizetag_t length, sizetag_t capacity) :
-        buf(data), buf_cap(capacity), buf_offset(length) {}
+        buf(data), buf_cap(capacity), buf_offset(length), buf_alloc(DatagramAllocator::heap()),
+        buf_alloc_cap(capacity) {}
 
     // binary-constructor(pointer):
     //     creates a new datagram with a copy of the data contained at the pointer.
     Datagram(const uint8_t *data, sizetag_t length) :
-        buf(new uint8_t[length]),
-        buf_cap(length),
-        buf_offset(length)
+        buf_offset(length), buf_alloc(default_allocator())
     {
+        alloc_buffer(length);
         memcpy(buf, data, length);
     }
 
     // binary-constructor(vector):
     //     creates a new datagram with a copy of the binary data contained in a vector<uint8_t>.
     explicit Datagram(const std::vector<uint8_t>& data) :
-        buf(new uint8_t[data.size()]),
-        buf_cap(data.size()),
-        buf_offset(data.size())
+        buf_offset(data.size()), buf_alloc(default_allocator())
     {
+        alloc_buffer(data.size());
         memcpy(buf, &data[0], data.size());
     }
 
     // binary-constructor(string):
     //     creates a new datagram with a copy of the data contained in a string, treated as binary.
     explicit Datagram(const std::string& data) :
-        buf(new uint8_t[data.length()]),
-        buf_cap(data.length()),
-        buf_offset(data.length())
+        buf_offset(data.length()), buf_alloc(default_allocator())
     {
+        alloc_buffer(data.length());
         memcpy(buf, data.c_str(), data.length());
     }
 
-    // assignment operator
-    Datagram& operator=(Datagram dg)
+    // copy-assignment operator
+    Datagram& operator=(const Datagram& dg)
+    {
+        Datagram copy(dg);
+        swap(*this, copy);
+        return *this;
+    }
+
+    // move-assignment operator
+    Datagram& operator=(Datagram&& dg) noexcept
     {
         swap(*this, dg);
         return *this;
@@ -133,7 +211,9 @@ class Datagram
     // destructor
     ~Datagram()
     {
-        delete [] buf;
+        if(buf != nullptr) {
+            buf_alloc->deallocate(buf, buf_alloc_cap);
+        }
     }
 
     // add_bool adds an 8-bit integer to the datagram that is guaranteed
@@ -284,6 +364,15 @@ class Datagram
             buf_offset += dg.buf_offset;
         }
     }
+    void add_data(Datagram&& dg)
+    {
+        if(buf_offset == 0) {
+            // We don't have any data yet, so take the other datagram's buffer instead of copying
+            swap(*this, dg);
+        } else {
+            add_data(dg);
+        }
+    }
 
     // add_string adds a bamboo string to the datagram from binary data;
     // a length tag (typically a uint16_t) is prepended to the string before it is added.
@@ -333,6 +422,37 @@ class Datagram
         buf_offset += dg.buf_offset;
     }
 
+    // add_array adds <count> numeric values to the datagram in one operation, arranging each
+    //     value in little-endian.  No length tag is added; to add a bamboo vararray, first
+    //     add the array's length in bytes with add_size.
+    template<typename T>
+    void add_array(const T *values, size_t count)
+    {
+        static_assert(std::is_arithmetic<T>::value, "add_array requires a numeric type");
+        check_add_length(count * sizeof(T));
+        swap_le_array<T>(buf + buf_offset, values, count);
+        buf_offset += sizetag_t(count * sizeof(T));
+    }
+    template<typename T>
+    void add_array(const std::vector<T>& values)
+    {
+        add_array(values.data(), values.size());
+    }
+
+    // add adds several numeric values to the datagram, arranging each in little-endian.
+    //     The total size is known at compile time, so the datagram's length is checked once
+    //     and the values are stored without any further branches.  Each value is added with
+    //     the size of its C++ type, ie. dg.add(channel, sender, uint16_t(msgtype)) adds
+    //     the same data as add_uint64, add_uint64, add_uint16 on 64-bit channels.
+    template<typename... Ts>
+    void add(const Ts&... values)
+    {
+        const size_t length = packed_sizeof<Ts...>::value;
+        check_add_length(length);
+        store_values(buf + buf_offset, values...);
+        buf_offset += sizetag_t(length);
+    }
+
     // add_buffer reserves a buffer of size "length" at the end of the datagram
     // and returns a pointer to the buffer so it can be filled manually
     uint8_t *add_buffer(sizetag_t length)
@@ -364,11 +484,40 @@ class Datagram
         return buf_cap;
     }
 
+    // reserve makes sure that the datagram can hold at least <capacity> bytes without
+    //     reallocating.  Unlike growing the datagram with adds, the capacity is not rounded up.
+    //     Throws DatagramOverflow if the capacity is more than the maximum datagram size.
+    void reserve(size_t capacity)
+    {
+        if(capacity > kSizetagMax) {
+            std::stringstream error;
+            error << "Datagram tried to reserve more than max datagram size, capacity("
+                  << capacity << ")" << " max_size(" << kSizetagMax << ")\n";
+            throw DatagramOverflow(error.str());
+        }
+
+        if(capacity > buf_cap) {
+            reallocate(capacity);
+        }
+    }
+
     // data returns a pointer to the start of the Datagram's data buffer.
     const uint8_t *data() const
     {
         return buf;
     }
+
+    // allocator returns the allocator that provides the datagram's buffer.
+    DatagramAllocator *allocator() const
+    {
+        return buf_alloc;
+    }
+
+    // default_allocator returns the allocator used by datagrams constructed without one.
+    static DatagramAllocator *default_allocator();
+    // set_default_allocator changes the allocator used by datagrams constructed without one;
+    //     passing nullptr restores the heap allocator.  Existing datagrams keep their allocator.
+    static void set_default_allocator(DatagramAllocator *allocator);
 };
 
 
@@ -11,24 +11,157 @@ namespace bamboo    // close namespace bamboo
 {
 
 
+// check_array_progress throws an error if an array element didn't consume any data,
+//     so that an array of empty elements can't repeat forever.
+static void check_array_progress(sizetag_t element_start, sizetag_t offset, sizetag_t length)
+{
+    if(offset == element_start) {
+        stringstream error;
+        error << "Datagram iterator tried to read array data, but an element of the array"
+              " didn't consume any of the array length of " << length << ".\n";
+        throw DatagramIteratorEOF(error.str());
+    }
+}
+
 // read_value interprets the following data as a
 // value for the Type in native endianness.
 Value DatagramIterator::read_value(const Type *type)
 {
-    // Note: We can probably make this a lot more efficient by constructing the value manually
-    //       from the wire-endian data instead of unpacking it into native endianess first.
-    //       Though that would probably cause some code duplication with Value's constructor.
-    vector<uint8_t> packed = read_packed(type);
-    return Value(type, packed);
+    // Decode the wire data straight into the value, rather than unpacking it into
+    // a native-endian buffer first and then parsing that buffer a second time.
+    Value value(type, Value::kEmpty);
+    read_value_into(value, nullptr);
+    return value;
+}
+
+Value *DatagramIterator::read_value(const Type *type, ValueArena& arena)
+{
+    Value *value = arena.create<Value>(type, Value::kEmpty, &arena);
+    read_value_into(*value, &arena);
+    return value;
+}
+
+void DatagramIterator::read_value_into(Value& value, ValueArena *arena)
+{
+    const Type *type = value.type;
+    switch(type->subtype()) {
+    case kTypeInt8:
+        value.int_ = read_int8();
+        break;
+    case kTypeInt16:
+        value.int_ = read_int16();
+        break;
+    case kTypeInt32:
+        value.int_ = read_int32();
+        break;
+    case kTypeInt64:
+        value.int_ = read_int64();
+        break;
+    case kTypeUint8:
+        value.uint_ = read_uint8();
+        break;
+    case kTypeUint16:
+        value.uint_ = read_uint16();
+        break;
+    case kTypeUint32:
+        value.uint_ = read_uint32();
+        break;
+    case kTypeUint64:
+        value.uint_ = read_uint64();
+        break;
+    case kTypeChar:
+        value.char_ = read_char();
+        break;
+    case kTypeFloat32:
+        value.float_ = read_float32();
+        break;
+    case kTypeFloat64:
+        value.double_ = read_float64();
+        break;
+    case kTypeString: {
+        DatagramView view = read_data_view(sizetag_t(type->fixed_size()));
+        value.string_.assign(view.chars(), view.size());
+        break;
+    }
+    case kTypeVarstring: {
+        DatagramView view = read_string_view();
+        value.string_.assign(view.chars(), view.size());
+        break;
+    }
+    case kTypeBlob: {
+        DatagramView view = read_data_view(sizetag_t(type->fixed_size()));
+        value.blob_.assign(view.data(), view.data() + view.size());
+        break;
+    }
+    case kTypeVarblob: {
+        DatagramView view = read_blob_view();
+        value.blob_.assign(view.data(), view.data() + view.size());
+        break;
+    }
+    case kTypeArray: {
+        const Array *arr = type->as_array();
+        size_t count = arr->array_size();
+        value.elements_.reserve(count);
+        for(size_t i = 0; i < count; ++i) {
+            value.elements_.emplace_back(arr->element_type(), Value::kEmpty, arena);
+            read_value_into(value.elements_.back(), arena);
+        }
+        break;
+    }
+    case kTypeVararray: {
+        const Array *arr = type->as_array();
+        sizetag_t length = read_size();
+        check_read_length(length);
+        sizetag_t array_end = m_offset + length;
+        if(arr->element_type()->has_fixed_size()) {
+            value.elements_.reserve(length / arr->element_type()->fixed_size());
+        }
+        while(m_offset < array_end) {
+            sizetag_t element_start = m_offset;
+            value.elements_.emplace_back(arr->element_type(), Value::kEmpty, arena);
+            read_value_into(value.elements_.back(), arena);
+            check_array_progress(element_start, m_offset, length);
+        }
+        if(m_offset > array_end) {
+            stringstream error;
+            error << "Datagram iterator tried to read array data, but array data"
+                  " exceeded the expected array length of " << length << ".\n";
+            throw DatagramIteratorEOF(error.str());
+        }
+        break;
+    }
+    case kTypeStruct: {
+        const Struct *dstruct = type->as_struct();
+        size_t num_fields = dstruct->num_fields();
+        value.fields_.reserve(num_fields);
+        for(unsigned int i = 0; i < num_fields; ++i) {
+            value.fields_.emplace_back(dstruct->get_field(i)->type(), Value::kEmpty, arena);
+            read_value_into(value.fields_.back(), arena);
+        }
+        break;
+    }
+    case kTypeMethod: {
+        const Method *dmethod = type->as_method();
+        size_t num_params = dmethod->num_parameters();
+        value.arguments_.reserve(num_params);
+        for(unsigned int i = 0; i < num_params; ++i) {
+            value.arguments_.emplace_back(dmethod->get_parameter(i)->type(), Value::kEmpty, arena);
+            read_value_into(value.arguments_.back(), arena);
+        }
+        break;
+    }
+    case kTypeInvalid:
+        break;
+    }
 }
 
 vector<uint8_t> DatagramIterator::read_packed(const Type *type)
 {
 #ifndef PLATFORM_BIG_ENDIAN
     // We're little endian so we don't have to worry about byte-swapping the data
-    const uint8_t *start = m_dg->data() + m_offset;
+    const uint8_t *start = m_data + m_offset;
     skip_type(type); // note: this will advanced m_offset
-    return vector<uint8_t>(start, m_dg->data() + m_offset);
+    return vector<uint8_t>(start, m_data + m_offset);
 #else
     // Lets go ahead and unpack that manually
     vector<uint8_t> buf;
@@ -96,12 +229,19 @@ void DatagramIterator::read_packed(const Type *dtype, vector<uint8_t>& buffer)
             pack_value(read_data(dtype->fixed_size()), buffer);
             break;
         }
+        if(arr->element_type()->as_numeric() != nullptr) {
+            // Arrays of numbers are converted in bulk
+            read_packed_numbers(arr->element_type(), sizetag_t(dtype->fixed_size()), buffer);
+            break;
+        }
 
         // Read elements from the array till we reach the expected size
         sizetag_t len = dtype->fixed_size();
         sizetag_t array_end = m_offset + len;
         while(m_offset < array_end) {
+            sizetag_t element_start = m_offset;
             read_packed(arr->element_type(), buffer);
+            check_array_progress(element_start, m_offset, len);
         }
         if(m_offset > array_end) {
             stringstream error;
@@ -128,11 +268,26 @@ void DatagramIterator::read_packed(const Type *dtype, vector<uint8_t>& buffer)
             pack_value(read_data(len), buffer);
             break;
         }
+        if(arr->element_type()->as_numeric() != nullptr) {
+            // Arrays of numbers are converted in bulk
+            read_packed_numbers(arr->element_type(), len, buffer);
+            break;
+        }
+#ifndef PLATFORM_BIG_ENDIAN
+        if(arr->element_type()->has_fixed_size()) {
+            // We're little endian, so fixed-size elements can be copied as-is
+            DatagramView data = read_data_view(len);
+            buffer.insert(buffer.end(), data.data(), data.data() + data.size());
+            break;
+        }
+#endif
 
         // Read elements from the array till we reach the expected size
         sizetag_t array_end = m_offset + len;
         while(m_offset < array_end) {
+            sizetag_t element_start = m_offset;
             read_packed(arr->element_type(), buffer);
+            check_array_progress(element_start, m_offset, len);
         }
         if(m_offset > array_end) {
             stringstream error;
@@ -164,14 +319,45 @@ void DatagramIterator::read_packed(const Type *dtype, vector<uint8_t>& buffer)
     }
 }
 
+// read_packed_numbers reads <length> bytes of numbers with the given element type,
+//     converting them to native endianness in bulk and appending them to the buffer.
+void DatagramIterator::read_packed_numbers(const Type *element, sizetag_t length,
+                                           vector<uint8_t>& buffer)
+{
+    size_t width = element->fixed_size();
+    if(length % width != 0) {
+        stringstream error;
+        error << "Datagram iterator tried to read array data, but array data"
+              " exceeded the expected array length of " << length << ".\n";
+        throw DatagramIteratorEOF(error.str());
+    }
+
+    check_read_length(length);
+    size_t start = buffer.size();
+    buffer.resize(start + length);
+    switch(width) {
+    case 2:
+        swap_le_array<uint16_t>(&buffer[start], m_data + m_offset, length / 2);
+        break;
+    case 4:
+        swap_le_array<uint32_t>(&buffer[start], m_data + m_offset, length / 4);
+        break;
+    case 8:
+        swap_le_array<uint64_t>(&buffer[start], m_data + m_offset, length / 8);
+        break;
+    default:
+        memcpy(&buffer[start], m_data + m_offset, length);
+        break;
+    }
+    m_offset += length;
+}
+
 // skip_type can be used to seek past the packed data for a Type.
 //     Throws DatagramIteratorEOF if it skips past the end of the datagram.
 void DatagramIterator::skip_type(const Type *dtype)
 {
     if(dtype->has_fixed_size()) {
-        sizetag_t length = dtype->fixed_size();
-        check_read_length(length);
-        m_offset += length;
+        skip(dtype->fixed_size());
         return;
     }
 
@@ -186,18 +372,12 @@ void DatagramIterator::skip_type(const Type *dtype)
     }
     case kTypeStruct: {
         const Struct *dstruct = dtype->as_struct();
-        size_t num_fields = dstruct->num_fields();
-        for(unsigned int i = 0; i < num_fields; ++i) {
-            skip_type(dstruct->get_field(i)->type());
-        }
+        skip_fields(dstruct, (unsigned int)dstruct->num_fields());
         break;
     }
     case kTypeMethod: {
         const Method *dmethod = dtype->as_method();
-        size_t num_params = dmethod->num_parameters();
-        for(unsigned int i = 0; i < num_params; ++i) {
-            skip_type(dmethod->get_parameter(i)->type());
-        }
+        skip_parameters(dmethod, (unsigned int)dmethod->num_parameters());
         break;
     }
     default: {
@@ -208,4 +388,28 @@ void DatagramIterator::skip_type(const Type *dtype)
 }
 
 
+// skip_fields seeks from the start of a packed struct to the start of its <n>th field.
+void DatagramIterator::skip_fields(const Struct *dstruct, unsigned int n)
+{
+    const ElementOffset& location = dstruct->field_offset(n);
+    if(!location.is_fixed()) {
+        // Seek to the closest variable-size field, then skip over it
+        skip_fields(dstruct, location.anchor);
+        skip_type(dstruct->get_field(location.anchor)->type());
+    }
+    skip(location.offset);
+}
+
+// skip_parameters seeks from the start of packed arguments to the <n>th parameter.
+void DatagramIterator::skip_parameters(const Method *dmethod, unsigned int n)
+{
+    const ElementOffset& location = dmethod->parameter_offset(n);
+    if(!location.is_fixed()) {
+        // Seek to the closest variable-size parameter, then skip over it
+        skip_parameters(dmethod, location.anchor);
+        skip_type(dmethod->get_parameter(location.anchor)->type());
+    }
+    skip(location.offset);
+}
+
 } // close namespace bamboo
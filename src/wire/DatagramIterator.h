@@ -1,5 +1,10 @@
 #pragma once
+#include <assert.h> // for assert
+#include <tuple>    // for std::tuple
 #include "Datagram.h"
+#include "DatagramView.h"
+#include "../bits/errors.h"
+#include "../module/Type.h"
 namespace bamboo    // close namespace bamboo
 {
 
@@ -12,36 +17,214 @@ class DatagramIteratorEOF : public std::runtime_error
     DatagramIteratorEOF(const std::string& what) : std::runtime_error(what) { }
 };
 
+// Foward declarations
+class Struct;
+class Method;
+class ValueArena;
+
+// A ValidatedRegion is a span of a datagram which has already been bounds-checked as a whole,
+//     so that the values inside of it can be read without checking each read individually.
+//     Reading past the end of the region is a programming error and is only caught by
+//     assertions in debug builds.  Get a region from DatagramIterator::validate.
+class ValidatedRegion
+{
+  public:
+    ValidatedRegion(const uint8_t *data, sizetag_t length) : m_ptr(data), m_end(data + length) {}
+
+    // read_bool reads the next byte from the region and returns either false or true.
+    bool read_bool()
+    {
+        return read_uint8() != false;
+    }
+
+    // read_char reads a byte from the region, returning an 8-bit ascii character.
+    char read_char()
+    {
+        return (char)read_uint8();
+    }
+
+    // read_int8 reads a byte from the region, returning a signed 8-bit integer.
+    int8_t read_int8()
+    {
+        return (int8_t)read_uint8();
+    }
+
+    // read_int16 reads 2 bytes, returning a signed 16-bit integer in native endianness.
+    int16_t read_int16()
+    {
+        return (int16_t)read_uint16();
+    }
+
+    // read_int32 reads 4 bytes, returning a signed 32-bit integer in native endianness.
+    int32_t read_int32()
+    {
+        return (int32_t)read_uint32();
+    }
+
+    // read_int64 reads 8 bytes, returning a signed 64-bit integer in native endianness.
+    int64_t read_int64()
+    {
+        return (int64_t)read_uint64();
+    }
+
+    // read_uint8 reads a byte from the region, returning an unsigned 8-bit integer.
+    uint8_t read_uint8()
+    {
+        assert(m_ptr + 1 <= m_end);
+        uint8_t r = *m_ptr;
+        m_ptr += 1;
+        return r;
+    }
+
+    // read_uint16 reads 2 bytes, returning an unsigned 16-bit integer in native endianness.
+    uint16_t read_uint16()
+    {
+        assert(m_ptr + 2 <= m_end);
+        uint16_t r = *(uint16_t *)m_ptr;
+        m_ptr += 2;
+        return swap_le(r);
+    }
+
+    // read_uint32 reads 4 bytes, returning an unsigned 32-bit integer in native endianness.
+    uint32_t read_uint32()
+    {
+        assert(m_ptr + 4 <= m_end);
+        uint32_t r = *(uint32_t *)m_ptr;
+        m_ptr += 4;
+        return swap_le(r);
+    }
+
+    // read_uint64 reads 8 bytes, returning an unsigned 64-bit integer in native endianness.
+    uint64_t read_uint64()
+    {
+        assert(m_ptr + 8 <= m_end);
+        uint64_t r = *(uint64_t *)m_ptr;
+        m_ptr += 8;
+        return swap_le(r);
+    }
+
+    // read_size reads a sizetag_t from the region.
+    sizetag_t read_size()
+    {
+        assert(m_ptr + sizeof(sizetag_t) <= m_end);
+        sizetag_t r = *(sizetag_t *)m_ptr;
+        m_ptr += sizeof(sizetag_t);
+        return swap_le(r);
+    }
+
+    // read_float32 reads 4 bytes, returning a 32-bit float in native endianness.
+    float read_float32()
+    {
+        assert(m_ptr + 4 <= m_end);
+        float r = *(float *)m_ptr;
+        m_ptr += 4;
+        return swap_le(r);
+    }
+
+    // read_float64 reads 8 bytes, returning a 64-bit float (double) in native endianness.
+    double read_float64()
+    {
+        assert(m_ptr + 8 <= m_end);
+        double r = *(double *)m_ptr;
+        m_ptr += 8;
+        return swap_le(r);
+    }
+
+    // read_data_view returns a view of the next <length> bytes in the region.
+    DatagramView read_data_view(sizetag_t length)
+    {
+        assert(m_ptr + length <= m_end);
+        DatagramView view(m_ptr, length);
+        m_ptr += length;
+        return view;
+    }
+
+    // skip advances past the next <length> bytes in the region.
+    void skip(sizetag_t length)
+    {
+        assert(m_ptr + length <= m_end);
+        m_ptr += length;
+    }
+
+    // remaining returns the number of unread bytes left in the region.
+    sizetag_t remaining() const
+    {
+        return sizetag_t(m_end - m_ptr);
+    }
+
+  private:
+    const uint8_t *m_ptr;
+    const uint8_t *m_end;
+};
+
 // A DatagramIterator lets you step trough a datagram by reading a single value at a time.
+//     An iterator can read a Datagram or any other buffer (see DatagramView) in place,
+//     without copying it.  The underlying data must not be modified or freed while it is
+//     being iterated over.
 class DatagramIterator
 {
   protected:
-    const Datagram *m_dg;
+    const uint8_t *m_data;
+    sizetag_t m_size;
     sizetag_t m_offset;
 
-    DatagramIterator(const Datagram *dg, sizetag_t offset = 0) : m_dg(dg), m_offset(offset)
+    DatagramIterator(const Datagram *dg, sizetag_t offset = 0) :
+        m_data(dg->data()), m_size(dg->size()), m_offset(offset)
     {
         check_read_length(0);
     }
 
-    void check_read_length(sizetag_t length)
+    void check_read_length(size_t length)
     {
-        //fprintf(stderr, "Checked %d, found %d", m_offset + length, m_dg->size());
-        if(m_offset + length > m_dg->size()) {
+        //fprintf(stderr, "Checked %d, found %d", m_offset + length, m_size);
+        if(m_offset + length > m_size) {
             std::stringstream error;
             error << "Datagram iterator tried to read past dg end, offset+length("
-                  << m_offset + length << "), buf_size(" << m_dg->size() << ")\n";
+                  << m_offset + length << "), buf_size(" << m_size << ")\n";
             throw DatagramIteratorEOF(error.str());
         };
     }
 
+    // load_value reads a numeric value from <src> and advances the pointer past it.
+    template<typename T>
+    static T load_value(const uint8_t *& src)
+    {
+        T value = load_le<T>(src);
+        src += sizeof(T);
+        return value;
+    }
+
+    // read_packed_numbers reads <length> bytes of numbers with the given element type,
+    //     converting them to native endianness in bulk and appending them to the buffer.
+    void read_packed_numbers(const Type *element, sizetag_t length, std::vector<uint8_t>& buffer);
+    // read_value_into decodes the data directly into an empty-constructed value,
+    //     allocating any nested values in the arena (or on the heap if null).
+    void read_value_into(Value& value, ValueArena *arena);
+
   public:
     // constructor
-    DatagramIterator(const Datagram& dg, sizetag_t offset = 0) : m_dg(&dg), m_offset(offset)
+    DatagramIterator(const Datagram& dg, sizetag_t offset = 0) :
+        m_data(dg.data()), m_size(dg.size()), m_offset(offset)
     {
         check_read_length(0); //shortcuts, yay
     }
 
+    // view-constructor:
+    //     iterates over the data referenced by the view without copying it.
+    DatagramIterator(const DatagramView& view, sizetag_t offset = 0) :
+        m_data(view.data()), m_size(view.size()), m_offset(offset)
+    {
+        check_read_length(0);
+    }
+
+    // buffer-constructor:
+    //     iterates over <length> bytes starting at the pointer without copying them.
+    DatagramIterator(const uint8_t *data, sizetag_t length, sizetag_t offset = 0) :
+        m_data(data), m_size(length), m_offset(offset)
+    {
+        check_read_length(0);
+    }
+
     // read_bool reads the next byte from the datagram and returns either false or true.
     bool read_bool()
     {
@@ -54,7 +237,7 @@ class DatagramIterator
     char read_char()
     {
         check_read_length(1);
-        char r = *(char *)(m_dg->data() + m_offset);
+        char r = *(char *)(m_data + m_offset);
         m_offset += 1;
         return r;
     }
@@ -64,7 +247,7 @@ class DatagramIterator
     int8_t read_int8()
     {
         check_read_length(1);
-        int8_t r = *(int8_t *)(m_dg->data() + m_offset);
+        int8_t r = *(int8_t *)(m_data + m_offset);
         m_offset += 1;
         return r;
     }
@@ -74,7 +257,7 @@ class DatagramIterator
     int16_t read_int16()
     {
         check_read_length(2);
-        int16_t r = *(int16_t *)(m_dg->data() + m_offset);
+        int16_t r = *(int16_t *)(m_data + m_offset);
         m_offset += 2;
         return swap_le(r);
     }
@@ -84,7 +267,7 @@ class DatagramIterator
     int32_t read_int32()
     {
         check_read_length(4);
-        int32_t r = *(int32_t *)(m_dg->data() + m_offset);
+        int32_t r = *(int32_t *)(m_data + m_offset);
         m_offset += 4;
         return swap_le(r);
     }
@@ -94,7 +277,7 @@ class DatagramIterator
     int64_t read_int64()
     {
         check_read_length(8);
-        int64_t r = *(int64_t *)(m_dg->data() + m_offset);
+        int64_t r = *(int64_t *)(m_data + m_offset);
         m_offset += 8;
         return swap_le(r);
     }
@@ -104,7 +287,7 @@ class DatagramIterator
     uint8_t read_uint8()
     {
         check_read_length(1);
-        uint8_t r = *(uint8_t *)(m_dg->data() + m_offset);
+        uint8_t r = *(uint8_t *)(m_data + m_offset);
         m_offset += 1;
         return r;
     }
@@ -114,7 +297,7 @@ class DatagramIterator
     uint16_t read_uint16()
     {
         check_read_length(2);
-        uint16_t r = *(uint16_t *)(m_dg->data() + m_offset);
+        uint16_t r = *(uint16_t *)(m_data + m_offset);
         m_offset += 2;
         return swap_le(r);
     }
@@ -124,7 +307,7 @@ class DatagramIterator
     uint32_t read_uint32()
     {
         check_read_length(4);
-        uint32_t r = *(uint32_t *)(m_dg->data() + m_offset);
+        uint32_t r = *(uint32_t *)(m_data + m_offset);
         m_offset += 4;
         return swap_le(r);
     }
@@ -134,7 +317,7 @@ class DatagramIterator
     uint64_t read_uint64()
     {
         check_read_length(8);
-        uint64_t r = *(uint64_t *)(m_dg->data() + m_offset);
+        uint64_t r = *(uint64_t *)(m_data + m_offset);
         m_offset += 8;
         return swap_le(r);
     }
@@ -143,7 +326,7 @@ class DatagramIterator
     sizetag_t read_size()
     {
         check_read_length(sizeof(sizetag_t));
-        sizetag_t r = *(sizetag_t *)(m_dg->data() + m_offset);
+        sizetag_t r = *(sizetag_t *)(m_data + m_offset);
         m_offset += sizeof(sizetag_t);
         return swap_le(r);
     }
@@ -153,7 +336,7 @@ class DatagramIterator
     float read_float32()
     {
         check_read_length(4);
-        float r = *(float *)(m_dg->data() + m_offset);
+        float r = *(float *)(m_data + m_offset);
         m_offset += 4;
         return swap_le(r);
     }
@@ -163,11 +346,26 @@ class DatagramIterator
     double read_float64()
     {
         check_read_length(8);
-        double r = *(double *)(m_dg->data() + m_offset);
+        double r = *(double *)(m_data + m_offset);
         m_offset += 8;
         return swap_le(r);
     }
 
+    // read reads several numeric values from the datagram, converting each to native endianness,
+    //     and returns them as a tuple; ie. dgi.read<uint64_t, uint64_t, uint16_t>() reads a
+    //     message header.  The datagram's length is checked once for all of the values.
+    template<typename... Ts>
+    std::tuple<Ts...> read()
+    {
+        const size_t length = packed_sizeof<Ts...>::value;
+        check_read_length(length);
+        const uint8_t *src = m_data + m_offset;
+        m_offset += sizetag_t(length);
+        (void)src; // unused when reading an empty tuple
+        // Elements of a braced initializer are always evaluated from left to right
+        return std::tuple<Ts...> { load_value<Ts>(src)... };
+    }
+
     // read_string reads a string from the datagram in the format
     //     {sizetag_t length; char[length] characters} and returns the character data.
     // When given a length, returns the next <length> bytes as a string.
@@ -175,14 +373,14 @@ class DatagramIterator
     {
         sizetag_t length = read_size();
         check_read_length(length);
-        std::string str((char *)(m_dg->data() + m_offset), length);
+        std::string str((char *)(m_data + m_offset), length);
         m_offset += length;
         return str;
     }
     std::string read_string(sizetag_t length)
     {
         check_read_length(length);
-        std::string str((char *)(m_dg->data() + m_offset), length);
+        std::string str((char *)(m_data + m_offset), length);
         m_offset += length;
         return str;
     }
@@ -204,14 +402,17 @@ class DatagramIterator
     Datagram read_datagram()
     {
         sizetag_t length = read_size();
-        return Datagram(m_dg->data() + m_offset, length);
+        check_read_length(length);
+        Datagram dg(m_data + m_offset, length);
+        m_offset += length;
+        return dg;
     }
 
     // read_data returns the next <length> bytes in the datagram.
     std::vector<uint8_t> read_data(sizetag_t length)
     {
         check_read_length(length);
-        std::vector<uint8_t> data(m_dg->data() + m_offset, m_dg->data() + m_offset + length);
+        std::vector<uint8_t> data(m_data + m_offset, m_data + m_offset + length);
         m_offset += length;
         return data;
     }
@@ -219,33 +420,129 @@ class DatagramIterator
     // read_remainder returns a vector containing the rest of the bytes in the datagram.
     std::vector<uint8_t> read_remainder()
     {
-        return read_data(m_dg->size() - m_offset);
+        return read_data(m_size - m_offset);
+    }
+
+    // read_array reads <count> numeric values from the datagram into <out> in one operation,
+    //     converting each value to native endianness.  No length tag is read.
+    template<typename T>
+    void read_array(T *out, size_t count)
+    {
+        static_assert(std::is_arithmetic<T>::value, "read_array requires a numeric type");
+        check_read_length(count * sizeof(T));
+        swap_le_array<T>(out, m_data + m_offset, count);
+        m_offset += sizetag_t(count * sizeof(T));
+    }
+    template<typename T>
+    std::vector<T> read_array(size_t count)
+    {
+        // Check the length before allocating, since the count may come from the datagram
+        check_read_length(count * sizeof(T));
+        std::vector<T> values(count);
+        read_array(values.data(), count);
+        return values;
+    }
+
+    // read_string_view reads a string like read_string, but returns a view of the
+    //     characters inside of the datagram instead of copying them.
+    // When given a length, returns a view of the next <length> bytes.
+    DatagramView read_string_view()
+    {
+        sizetag_t length = read_size();
+        return read_data_view(length);
+    }
+    DatagramView read_string_view(sizetag_t length)
+    {
+        return read_data_view(length);
+    }
+
+    // read_blob_view reads a blob like read_blob, but returns a view of the
+    //     binary data inside of the datagram instead of copying it.
+    // When given a length, returns a view of the next <length> bytes.
+    DatagramView read_blob_view()
+    {
+        sizetag_t length = read_size();
+        return read_data_view(length);
+    }
+    DatagramView read_blob_view(sizetag_t length)
+    {
+        return read_data_view(length);
+    }
+
+    // read_data_view returns a view of the next <length> bytes in the datagram.
+    DatagramView read_data_view(sizetag_t length)
+    {
+        check_read_length(length);
+        DatagramView view(m_data + m_offset, length);
+        m_offset += length;
+        return view;
+    }
+
+    // read_remainder_view returns a view of the rest of the bytes in the datagram.
+    DatagramView read_remainder_view()
+    {
+        return read_data_view(m_size - m_offset);
     }
 
     // read_value interprets the data as a value for the Type in native endianness.
     Value read_value(const Type *);
+    // read_value can also decode the value into an arena.  The returned value, and everything
+    //     it contains, is allocated from the arena; it doesn't need to be destroyed, and it is
+    //     released when the arena is cleared or destroyed.
+    Value *read_value(const Type *, ValueArena& arena);
 
     // read_packed returns a vector containing the native-endian data corresponding to the type.
     std::vector<uint8_t> read_packed(const Type *);
     // read_packed can also endian-swap packed data into a pre-existing buffer.
     void read_packed(const Type *, std::vector<uint8_t>&);
 
+    // validate checks that the next <length> bytes are in the datagram and returns them as
+    //     a region which can be read without any further bounds checks.  The iterator is
+    //     advanced past the entire region.
+    //     Throws DatagramIteratorEOF if the region extends past the end of the datagram.
+    ValidatedRegion validate(sizetag_t length)
+    {
+        check_read_length(length);
+        ValidatedRegion region(m_data + m_offset, length);
+        m_offset += length;
+        return region;
+    }
+    // validate can also check the next value of a fixed-size Type, such as a struct of numbers.
+    //     Throws invalid_type if the type does not have a fixed size.
+    ValidatedRegion validate(const Type *type)
+    {
+        if(!type->has_fixed_size()) {
+            throw invalid_type("can only validate a region for a fixed-size type");
+        }
+        check_read_length(type->fixed_size());
+        return validate(sizetag_t(type->fixed_size()));
+    }
+
     // skip increments the current message offset by a length.
     //     Throws DatagramIteratorEOF if it skips past the end of the datagram.
-    void skip(sizetag_t length)
+    void skip(size_t length)
     {
         check_read_length(length);
-        m_offset += length;
+        m_offset += sizetag_t(length);
     }
 
     // skip_type can be used to seek past the packed data for a Type.
     //     Throws DatagramIteratorEOF if it skips past the end of the datagram.
     void skip_type(const Type *);
 
+    // skip_fields seeks from the start of a packed struct to the start of its <n>th field.
+    //     Fixed-size fields are skipped together, so only the variable-size fields before the
+    //     <n>th field are read.  Passing n == num_fields() skips the entire struct.
+    //     Throws DatagramIteratorEOF if it skips past the end of the datagram.
+    void skip_fields(const Struct *, unsigned int n);
+    // skip_parameters seeks from the start of packed arguments to the <n>th parameter.
+    //     Throws DatagramIteratorEOF if it skips past the end of the datagram.
+    void skip_parameters(const Method *, unsigned int n);
+
     // remaining returns the number of unread bytes left
     sizetag_t remaining() const
     {
-        return m_dg->size() - m_offset;
+        return m_size - m_offset;
     }
 
     // tell returns the current message offset in std::vector<uint8_t>
@@ -0,0 +1,96 @@
+#pragma once
+#include <string> // for std::string
+#if __cplusplus >= 201703L
+#include <string_view> // for std::string_view
+#endif
+#include "Datagram.h"
+namespace bamboo    // open namespace bamboo
+{
+
+
+// A DatagramView is a non-owning reference to a buffer of binary data in network-endianness,
+//     such as a Datagram or a message inside of a network receive buffer.
+//     A view never copies the data, so the viewed buffer must outlive the view.
+class DatagramView
+{
+  public:
+    // default-constructor:
+    //     creates an empty view
+    DatagramView() : m_data(nullptr), m_size(0) {}
+
+    // buffer-constructor:
+    //     creates a view of <length> bytes starting at the pointer.
+    DatagramView(const uint8_t *data, sizetag_t length) : m_data(data), m_size(length) {}
+
+    // datagram-constructor:
+    //     creates a view of the current contents of the datagram.
+    DatagramView(const Datagram& dg) : m_data(dg.data()), m_size(dg.size()) {}
+
+    // size returns the number of bytes in the view.
+    sizetag_t size() const
+    {
+        return m_size;
+    }
+
+    // empty returns true if the view does not contain any bytes.
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    // data returns a pointer to the start of the viewed data.
+    const uint8_t *data() const
+    {
+        return m_data;
+    }
+
+    // chars returns the viewed data as a pointer to (not null-terminated) characters.
+    const char *chars() const
+    {
+        return (const char *)m_data;
+    }
+
+    // str returns a copy of the viewed data as a string.
+    std::string str() const
+    {
+        return std::string((const char *)m_data, m_size);
+    }
+
+#if __cplusplus >= 201703L
+    // string_view returns the viewed data as a std::string_view.
+    std::string_view string_view() const
+    {
+        return std::string_view((const char *)m_data, m_size);
+    }
+#endif
+
+    // equals returns true if the viewed data is byte-for-byte equal to the given data.
+    bool equals(const void *data, size_t length) const
+    {
+        return length == m_size && (m_size == 0 || memcmp(m_data, data, m_size) == 0);
+    }
+
+    bool operator==(const DatagramView& other) const
+    {
+        return equals(other.m_data, other.m_size);
+    }
+    bool operator!=(const DatagramView& other) const
+    {
+        return !(*this == other);
+    }
+    bool operator==(const std::string& str) const
+    {
+        return equals(str.data(), str.length());
+    }
+    bool operator!=(const std::string& str) const
+    {
+        return !(*this == str);
+    }
+
+  private:
+    const uint8_t *m_data;
+    sizetag_t m_size;
+};
+
+
+} // close namespace bamboo
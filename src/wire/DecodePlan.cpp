@@ -0,0 +1,373 @@
+#include "DecodePlan.h"
+#include "../bits/buffers.h"
+#include "../module/Array.h"
+#include "../module/Struct.h"
+#include "../module/Method.h"
+#include "../module/Field.h"
+#include "../module/Parameter.h"
+using namespace std;
+namespace bamboo    // open namespace bamboo
+{
+
+
+// constructor
+DecodePlan::DecodePlan(const Type *type) : m_type(type), m_max_depth(0)
+{
+    compile(type);
+
+    // Track the deepest array nesting so the interpreter can size its stack
+    unsigned int depth = 0;
+    for(auto it = m_ops.begin(); it != m_ops.end(); ++it) {
+        if(it->code == kOpArray || it->code == kOpVararray) {
+            depth += 1;
+            if(depth > m_max_depth) { m_max_depth = depth; }
+        } else if(it->code == kOpArrayEnd) {
+            depth -= 1;
+        }
+    }
+}
+
+// emit appends an operation to the plan, combining it with the previous operation if possible.
+void DecodePlan::emit(Opcode code, sizetag_t arg)
+{
+    if(arg == 0 && code <= kOpSwap64) {
+        return;
+    }
+
+    if(!m_ops.empty()) {
+        // Merge runs of copies or swaps, as long as the run still fits in a datagram
+        static const size_t widths[] = {1, 2, 4, 8};
+        Op& prev = m_ops.back();
+        if(prev.code == code && code <= kOpSwap64
+           && (prev.arg + size_t(arg)) * widths[code] <= kSizetagMax) {
+            prev.arg += arg;
+            return;
+        }
+    }
+
+    Op op = {code, arg, 0};
+    m_ops.push_back(op);
+}
+
+// begin_array appends the start of an array, returning its index to pass to end_array.
+size_t DecodePlan::begin_array(Opcode code, sizetag_t arg)
+{
+    Op op = {code, arg, 0};
+    m_ops.push_back(op);
+    return m_ops.size() - 1;
+}
+
+// end_array closes the array started at <start> with a loop back to its first element.
+void DecodePlan::end_array(size_t start)
+{
+    Op op = {kOpArrayEnd, 0, (unsigned int)start};
+    m_ops.push_back(op);
+    m_ops[start].jump = (unsigned int)(m_ops.size() - 1);
+}
+
+// compile appends the operations needed to decode a value of <type>.
+void DecodePlan::compile(const Type *type)
+{
+    if(type->fixed_size() > kSizetagMax) {
+        // The type can't fit in a datagram, and its size can't fit in an operation,
+        // so emit reads which always run past the end of the datagram.
+        emit(kOpCopy, sizetag_t(kSizetagMax));
+        emit(kOpCopy, 1);
+        return;
+    }
+
+#ifndef PLATFORM_BIG_ENDIAN
+    if(type->has_fixed_size()) {
+        // We're little endian, so any fixed-size type is just copied as-is
+        emit(kOpCopy, sizetag_t(type->fixed_size()));
+        return;
+    }
+#endif
+
+    switch(type->subtype()) {
+    case kTypeChar:
+    case kTypeInt8:
+    case kTypeUint8:
+        emit(kOpCopy, 1);
+        break;
+    case kTypeInt16:
+    case kTypeUint16:
+        emit(kOpSwap16, 1);
+        break;
+    case kTypeInt32:
+    case kTypeUint32:
+    case kTypeFloat32:
+        emit(kOpSwap32, 1);
+        break;
+    case kTypeInt64:
+    case kTypeUint64:
+    case kTypeFloat64:
+        emit(kOpSwap64, 1);
+        break;
+    case kTypeString:
+    case kTypeBlob:
+        emit(kOpCopy, sizetag_t(type->fixed_size()));
+        break;
+    case kTypeArray: {
+        const Array *arr = type->as_array();
+        const Type *element = arr->element_type();
+        if(element->fixed_size() == 1) {
+            // If the element size is 1, we don't have to worry about endianness
+            emit(kOpCopy, sizetag_t(type->fixed_size()));
+        } else if(element->as_numeric() != nullptr) {
+            // Arrays of numbers can be swapped in one run
+            switch(element->fixed_size()) {
+            case 2:
+                emit(kOpSwap16, sizetag_t(arr->array_size()));
+                break;
+            case 4:
+                emit(kOpSwap32, sizetag_t(arr->array_size()));
+                break;
+            default:
+                emit(kOpSwap64, sizetag_t(arr->array_size()));
+                break;
+            }
+        } else {
+            size_t start = begin_array(kOpArray, sizetag_t(type->fixed_size()));
+            compile(element);
+            end_array(start);
+        }
+        break;
+    }
+    case kTypeVarstring:
+    case kTypeVarblob:
+        emit(kOpSized, 0);
+        break;
+    case kTypeVararray: {
+        const Type *element = type->as_array()->element_type();
+#ifndef PLATFORM_BIG_ENDIAN
+        bool verbatim = element->has_fixed_size();
+#else
+        bool verbatim = element->fixed_size() == 1;
+#endif
+        if(verbatim) {
+            emit(kOpSized, 0);
+        } else if(element->as_numeric() != nullptr) {
+            // Arrays of numbers can be swapped in one run
+            switch(element->fixed_size()) {
+            case 2:
+                emit(kOpSizedSwap16, 0);
+                break;
+            case 4:
+                emit(kOpSizedSwap32, 0);
+                break;
+            default:
+                emit(kOpSizedSwap64, 0);
+                break;
+            }
+        } else {
+            size_t start = begin_array(kOpVararray, 0);
+            compile(element);
+            end_array(start);
+        }
+        break;
+    }
+    case kTypeStruct: {
+        const Struct *dstruct = type->as_struct();
+        size_t num_fields = dstruct->num_fields();
+        for(unsigned int i = 0; i < num_fields; ++i) {
+            compile(dstruct->get_field(i)->type());
+        }
+        break;
+    }
+    case kTypeMethod: {
+        const Method *dmethod = type->as_method();
+        size_t num_params = dmethod->num_parameters();
+        for(unsigned int i = 0; i < num_params; ++i) {
+            compile(dmethod->get_parameter(i)->type());
+        }
+        break;
+    }
+    case kTypeInvalid:
+        break;
+    }
+}
+
+// read_packed reads a value of the plan's type, returning its native-endian packed data.
+vector<uint8_t> DecodePlan::read_packed(DatagramIterator& dgi) const
+{
+    vector<uint8_t> buffer;
+    read_packed(dgi, buffer);
+    return buffer;
+}
+
+// array_overrun throws an error for an array whose elements extended past its length.
+static void array_overrun(sizetag_t len)
+{
+    stringstream error;
+    error << "Datagram iterator tried to read array data, but array data"
+          " exceeded the expected array length of " << len << ".\n";
+    throw DatagramIteratorEOF(error.str());
+}
+
+// array_stalled throws an error for an array whose elements don't consume any data,
+//     which would otherwise repeat forever.
+static void array_stalled(sizetag_t len)
+{
+    stringstream error;
+    error << "Datagram iterator tried to read array data, but an element of the array"
+          " didn't consume any of the remaining array length of " << len << ".\n";
+    throw DatagramIteratorEOF(error.str());
+}
+
+// An ArrayFrame is the state of an array being read by a plan.
+struct ArrayFrame {
+    sizetag_t end;     // the offset where the array's data ends
+    sizetag_t element; // the offset where the current element started
+};
+
+// read_packed can also append the packed data to a pre-existing buffer.
+void DecodePlan::read_packed(DatagramIterator& dgi, vector<uint8_t>& buffer) const
+{
+    // Each open array's state; most plans have few nested arrays
+    ArrayFrame local_frames[8];
+    vector<ArrayFrame> heap_frames;
+    ArrayFrame *frames = local_frames;
+    if(m_max_depth > 8) {
+        heap_frames.resize(m_max_depth);
+        frames = &heap_frames[0];
+    }
+    unsigned int depth = 0;
+
+    const Op *ops = m_ops.empty() ? nullptr : &m_ops[0];
+    size_t num_ops = m_ops.size();
+    for(size_t pc = 0; pc < num_ops; ++pc) {
+        const Op& op = ops[pc];
+        switch(op.code) {
+        case kOpCopy: {
+            DatagramView data = dgi.read_data_view(op.arg);
+            buffer.insert(buffer.end(), data.data(), data.data() + data.size());
+            break;
+        }
+        case kOpSwap16: {
+            DatagramView data = dgi.read_data_view(sizetag_t(op.arg * 2));
+            size_t start = buffer.size();
+            buffer.resize(start + data.size());
+            swap_le_array<uint16_t>(&buffer[start], data.data(), op.arg);
+            break;
+        }
+        case kOpSwap32: {
+            DatagramView data = dgi.read_data_view(sizetag_t(op.arg * 4));
+            size_t start = buffer.size();
+            buffer.resize(start + data.size());
+            swap_le_array<uint32_t>(&buffer[start], data.data(), op.arg);
+            break;
+        }
+        case kOpSwap64: {
+            DatagramView data = dgi.read_data_view(sizetag_t(op.arg * 8));
+            size_t start = buffer.size();
+            buffer.resize(start + data.size());
+            swap_le_array<uint64_t>(&buffer[start], data.data(), op.arg);
+            break;
+        }
+        case kOpSized: {
+            sizetag_t len = dgi.read_size();
+            pack_value(len, buffer);
+            DatagramView data = dgi.read_data_view(len);
+            buffer.insert(buffer.end(), data.data(), data.data() + data.size());
+            break;
+        }
+        case kOpSizedSwap16:
+        case kOpSizedSwap32:
+        case kOpSizedSwap64: {
+            sizetag_t len = dgi.read_size();
+            pack_value(len, buffer);
+            size_t width = size_t(2) << (op.code - kOpSizedSwap16);
+            if(len % width != 0) {
+                array_overrun(len);
+            }
+            DatagramView data = dgi.read_data_view(len);
+            size_t start = buffer.size();
+            buffer.resize(start + data.size());
+            if(op.code == kOpSizedSwap16) {
+                swap_le_array<uint16_t>(&buffer[start], data.data(), len / 2);
+            } else if(op.code == kOpSizedSwap32) {
+                swap_le_array<uint32_t>(&buffer[start], data.data(), len / 4);
+            } else {
+                swap_le_array<uint64_t>(&buffer[start], data.data(), len / 8);
+            }
+            break;
+        }
+        case kOpArray:
+        case kOpVararray: {
+            sizetag_t len = op.arg;
+            if(op.code == kOpVararray) {
+                len = dgi.read_size();
+                pack_value(len, buffer);
+            }
+            if(len == 0) {
+                pc = op.jump; // skip straight past the array
+                break;
+            }
+            ArrayFrame& frame = frames[depth++];
+            frame.end = sizetag_t(dgi.tell() + len);
+            frame.element = sizetag_t(dgi.tell());
+            break;
+        }
+        case kOpArrayEnd: {
+            ArrayFrame& frame = frames[depth - 1];
+            sizetag_t offset = sizetag_t(dgi.tell());
+            if(offset < frame.end) {
+                if(offset == frame.element) {
+                    array_stalled(sizetag_t(frame.end - offset));
+                }
+                frame.element = offset;
+                pc = op.jump; // loop back around to the next element
+            } else {
+                depth -= 1;
+                if(offset > frame.end) {
+                    const Op& start = ops[op.jump];
+                    array_overrun(start.code == kOpArray ? start.arg : sizetag_t(0));
+                }
+            }
+            break;
+        }
+        }
+    }
+}
+
+// skip advances the iterator past a value of the plan's type.
+void DecodePlan::skip(DatagramIterator& dgi) const
+{
+    const Op *ops = m_ops.empty() ? nullptr : &m_ops[0];
+    size_t num_ops = m_ops.size();
+    for(size_t pc = 0; pc < num_ops; ++pc) {
+        const Op& op = ops[pc];
+        switch(op.code) {
+        case kOpCopy:
+            dgi.skip(op.arg);
+            break;
+        case kOpSwap16:
+            dgi.skip(sizetag_t(op.arg * 2));
+            break;
+        case kOpSwap32:
+            dgi.skip(sizetag_t(op.arg * 4));
+            break;
+        case kOpSwap64:
+            dgi.skip(sizetag_t(op.arg * 8));
+            break;
+        case kOpSized:
+        case kOpSizedSwap16:
+        case kOpSizedSwap32:
+        case kOpSizedSwap64:
+        case kOpVararray:
+            dgi.skip(dgi.read_size());
+            pc = op.code == kOpVararray ? op.jump : pc;
+            break;
+        case kOpArray:
+            dgi.skip(op.arg);
+            pc = op.jump;
+            break;
+        case kOpArrayEnd:
+            break;
+        }
+    }
+}
+
+
+} // close namespace bamboo
@@ -0,0 +1,78 @@
+#pragma once
+#include <vector> // for std::vector
+#include "DatagramIterator.h"
+namespace bamboo    // open namespace bamboo
+{
+
+
+// Foward declarations
+class Type;
+
+// A DecodePlan is a Type (typically a Struct, Class, or Method) which has been compiled once
+//     into a flat list of decoding operations, such as "copy N bytes" or "read a sizetag and
+//     copy that many bytes".  Decoding with a plan runs a small loop over the operations,
+//     instead of recursing through the Type's fields and parameters for every message.
+//     A plan refers to its Type, so the Type (and its Module) must outlive the plan.
+//     Plans are opt-in: DatagramIterator doesn't use them, so an application builds (and keeps)
+//     a plan for each type that it decodes often.
+class DecodePlan
+{
+  public:
+    explicit DecodePlan(const Type *type);
+
+    // type returns the Type that the plan was compiled from.
+    const Type *type() const
+    {
+        return m_type;
+    }
+
+    // num_ops returns the number of operations in the compiled plan.
+    size_t num_ops() const
+    {
+        return m_ops.size();
+    }
+
+    // read_packed reads a value of the plan's type, returning its native-endian packed data.
+    //     This produces the same data as DatagramIterator::read_packed.
+    //     Throws DatagramIteratorEOF if the value extends past the end of the datagram.
+    std::vector<uint8_t> read_packed(DatagramIterator& dgi) const;
+    // read_packed can also append the packed data to a pre-existing buffer.
+    void read_packed(DatagramIterator& dgi, std::vector<uint8_t>& buffer) const;
+
+    // skip advances the iterator past a value of the plan's type.
+    //     Throws DatagramIteratorEOF if it skips past the end of the datagram.
+    void skip(DatagramIterator& dgi) const;
+
+  private:
+    enum Opcode {
+        kOpCopy,         // copy <arg> bytes
+        kOpSwap16,       // copy <arg> 16-bit values, converting their byte-order
+        kOpSwap32,       // copy <arg> 32-bit values, converting their byte-order
+        kOpSwap64,       // copy <arg> 64-bit values, converting their byte-order
+        kOpSized,        // read a sizetag, then copy that many bytes
+        kOpSizedSwap16,  // read a sizetag, then copy that many bytes of 16-bit values, converted
+        kOpSizedSwap32,  // read a sizetag, then copy that many bytes of 32-bit values, converted
+        kOpSizedSwap64,  // read a sizetag, then copy that many bytes of 64-bit values, converted
+        kOpArray,        // start a fixed-length array of <arg> bytes; its elements follow
+        kOpVararray,     // read a sizetag and start an array of that many bytes
+        kOpArrayEnd,     // repeat the array's elements until all of its bytes are read
+    };
+
+    struct Op {
+        Opcode code;
+        sizetag_t arg;
+        unsigned int jump; // array start: index of its end; array end: index of its start
+    };
+
+    void compile(const Type *type);
+    void emit(Opcode code, sizetag_t arg);
+    size_t begin_array(Opcode code, sizetag_t arg);
+    void end_array(size_t start);
+
+    const Type *m_type;
+    std::vector<Op> m_ops;
+    unsigned int m_max_depth;
+};
+
+
+} // close namespace bamboo
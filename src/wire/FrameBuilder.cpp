@@ -0,0 +1,54 @@
+#include "FrameBuilder.h"
+#include "SegmentedDatagram.h"
+using namespace std;
+namespace bamboo    // open namespace bamboo
+{
+
+
+FrameBuilder::FrameBuilder(size_t capacity) : m_frames(0)
+{
+    m_buffer.reserve(capacity);
+}
+
+uint8_t *FrameBuilder::append_frame(sizetag_t length)
+{
+    size_t offset = m_buffer.size();
+    m_buffer.resize(offset + sizeof(sizetag_t) + length);
+    store_le<sizetag_t>(&m_buffer[offset], length);
+    ++m_frames;
+    return &m_buffer[offset + sizeof(sizetag_t)];
+}
+
+void FrameBuilder::add_frame(const DatagramView& dg)
+{
+    uint8_t *frame = append_frame(dg.size());
+    if(!dg.empty()) {
+        memcpy(frame, dg.data(), dg.size());
+    }
+}
+
+void FrameBuilder::add_frame(const SegmentedDatagram& dg)
+{
+    if(dg.size() > kSizetagMax) {
+        stringstream error;
+        error << "FrameBuilder tried to add a frame past max datagram size, size("
+              << dg.size() << ")" << " max_size(" << kSizetagMax << ")\n";
+        throw DatagramOverflow(error.str());
+    }
+
+    uint8_t *frame = append_frame(sizetag_t(dg.size()));
+    if(dg.head().size() > 0) {
+        memcpy(frame, dg.head().data(), dg.head().size());
+        frame += dg.head().size();
+    }
+    for(size_t i = 0; i < dg.num_segments(); ++i) {
+        const DatagramView& segment = dg.get_segment(i);
+        if(!segment.empty()) {
+            memcpy(frame, segment.data(), segment.size());
+            frame += segment.size();
+        }
+    }
+}
+
+
+} // close namespace bamboo
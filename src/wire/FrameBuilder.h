@@ -0,0 +1,73 @@
+#pragma once
+#include <stddef.h> // for size_t
+#include <vector>   // for std::vector
+#include "Datagram.h"
+#include "DatagramView.h"
+namespace bamboo    // open namespace bamboo
+{
+
+
+class SegmentedDatagram;
+
+// A FrameBuilder packs many datagrams back-to-back into one contiguous buffer, each one
+//     prefixed with its length as a sizetag_t ("framed").  A whole batch of messages can then
+//     be sent with a single write, and read back in place with a FrameReader.
+//
+//     Unlike a Datagram, the buffer may grow past the maximum datagram size; only each
+//     individual frame is limited to it.
+class FrameBuilder
+{
+  public:
+    explicit FrameBuilder(size_t capacity = 4096);
+
+    // add_frame appends a datagram to the buffer, preceded by its length.
+    //     Datagrams and SharedDatagrams convert to a DatagramView implicitly.
+    void add_frame(const DatagramView& dg);
+    // add_frame appends the head and segments of a segmented datagram as a single frame.
+    //     Throws DatagramOverflow if the datagram is larger than the maximum datagram size.
+    void add_frame(const SegmentedDatagram& dg);
+
+    // num_frames returns the number of frames added since the builder was last cleared.
+    size_t num_frames() const
+    {
+        return m_frames;
+    }
+    // size returns the number of bytes in the buffer, including the length prefixes.
+    size_t size() const
+    {
+        return m_buffer.size();
+    }
+    // empty returns true if no frames have been added.
+    bool empty() const
+    {
+        return m_buffer.empty();
+    }
+    // data returns a pointer to the start of the buffer.
+    const uint8_t *data() const
+    {
+        return m_buffer.data();
+    }
+
+    // clear removes all of the frames, keeping the buffer's capacity for the next batch.
+    void clear()
+    {
+        m_buffer.clear();
+        m_frames = 0;
+    }
+    // reserve makes sure the buffer can hold at least <capacity> bytes without reallocating.
+    void reserve(size_t capacity)
+    {
+        m_buffer.reserve(capacity);
+    }
+
+  private:
+    // append_frame adds the length prefix for a frame with <length> bytes and returns a
+    //     pointer to where the frame's data should be written.
+    uint8_t *append_frame(sizetag_t length);
+
+    std::vector<uint8_t> m_buffer;
+    size_t m_frames;
+};
+
+
+} // close namespace bamboo
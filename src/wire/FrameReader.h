@@ -0,0 +1,77 @@
+#pragma once
+#include <stddef.h> // for size_t
+#include "DatagramView.h"
+#include "DatagramIterator.h"
+namespace bamboo    // open namespace bamboo
+{
+
+
+// A FrameReader splits a buffer of framed datagrams, as written by a FrameBuilder, into the
+//     individual datagrams without copying them.  A buffer read from a stream may end partway
+//     through a frame; the reader stops before the incomplete frame, and consumed() tells how
+//     many bytes were used so the rest can be kept until more data arrives:
+//
+//         FrameReader frames(recv_buffer, recv_length);
+//         DatagramView frame;
+//         while(frames.next(frame)) {
+//             DatagramIterator dgi(frame);
+//             handle_message(dgi);
+//         }
+//         discard_front(recv_buffer, frames.consumed());
+//
+//     The buffer must not be modified or freed while its frames are being read.
+class FrameReader
+{
+  public:
+    FrameReader(const uint8_t *data, size_t length) :
+        m_data(data), m_size(length), m_offset(0) {}
+    explicit FrameReader(const std::vector<uint8_t>& buffer) :
+        m_data(buffer.data()), m_size(buffer.size()), m_offset(0) {}
+
+    // next sets <frame> to the next complete frame in the buffer and returns true,
+    //     or returns false if there isn't a complete frame left.
+    bool next(DatagramView& frame)
+    {
+        if(m_size - m_offset < sizeof(sizetag_t)) { return false; }
+        sizetag_t length = load_le<sizetag_t>(m_data + m_offset);
+        if(m_size - m_offset - sizeof(sizetag_t) < length) { return false; }
+
+        frame = DatagramView(m_data + m_offset + sizeof(sizetag_t), length);
+        m_offset += sizeof(sizetag_t) + length;
+        return true;
+    }
+
+    // for_each calls <handler> with a DatagramIterator over each complete frame in turn,
+    //     and returns the number of frames read.
+    template<typename Handler>
+    size_t for_each(Handler handler)
+    {
+        size_t count = 0;
+        DatagramView frame;
+        while(next(frame)) {
+            DatagramIterator dgi(frame);
+            handler(dgi);
+            ++count;
+        }
+        return count;
+    }
+
+    // consumed returns the number of bytes used by the frames read so far.
+    size_t consumed() const
+    {
+        return m_offset;
+    }
+    // remaining returns the number of bytes after the last frame read.
+    size_t remaining() const
+    {
+        return m_size - m_offset;
+    }
+
+  private:
+    const uint8_t *m_data;
+    size_t m_size;
+    size_t m_offset;
+};
+
+
+} // close namespace bamboo
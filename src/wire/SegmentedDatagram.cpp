@@ -0,0 +1,84 @@
+#include "SegmentedDatagram.h"
+using namespace std;
+namespace bamboo    // open namespace bamboo
+{
+
+
+void SegmentedDatagram::check_add_length(size_t length)
+{
+    if(size() + length > kSizetagMax) {
+        stringstream error;
+        error << "SegmentedDatagram tried to add data past max datagram size, size+length("
+              << size() + length << ")" << " max_size(" << kSizetagMax << ")\n";
+        throw DatagramOverflow(error.str());
+    }
+}
+
+void SegmentedDatagram::add_segment(shared_ptr<const Datagram> segment)
+{
+    check_add_length(segment->size());
+    DatagramView view(*segment);
+    m_segments.push_back(Segment{move(segment), SharedDatagram(), view});
+    m_size += view.size();
+}
+
+void SegmentedDatagram::add_segment(SharedDatagram segment)
+{
+    check_add_length(segment.size());
+    DatagramView view = segment.view();
+    m_segments.push_back(Segment{nullptr, move(segment), view});
+    m_size += view.size();
+}
+
+void SegmentedDatagram::add_segment(Datagram&& segment)
+{
+    add_segment(make_shared<const Datagram>(move(segment)));
+}
+
+void SegmentedDatagram::add_view(const DatagramView& view)
+{
+    check_add_length(view.size());
+    m_segments.push_back(Segment{nullptr, SharedDatagram(), view});
+    m_size += view.size();
+}
+
+Datagram SegmentedDatagram::flatten() const
+{
+    Datagram dg(size());
+    dg.add_data(m_head);
+    for(const Segment& segment : m_segments) {
+        if(!segment.view.empty()) {
+            dg.add_data(segment.view.data(), segment.view.size());
+        }
+    }
+    return dg;
+}
+
+#ifndef _WIN32
+size_t SegmentedDatagram::to_iovec(struct iovec *iov, size_t count) const
+{
+    size_t n = 0;
+    if(n < count && m_head.size() > 0) {
+        iov[n].iov_base = (void *)m_head.data();
+        iov[n].iov_len = m_head.size();
+        ++n;
+    }
+    for(size_t i = 0; n < count && i < m_segments.size(); ++i) {
+        if(m_segments[i].view.empty()) { continue; }
+        iov[n].iov_base = (void *)m_segments[i].view.data();
+        iov[n].iov_len = m_segments[i].view.size();
+        ++n;
+    }
+    return n;
+}
+
+vector<struct iovec> SegmentedDatagram::iovecs() const
+{
+    vector<struct iovec> iov(m_segments.size() + 1);
+    iov.resize(to_iovec(iov.data(), iov.size()));
+    return iov;
+}
+#endif
+
+
+} // close namespace bamboo
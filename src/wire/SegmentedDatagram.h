@@ -0,0 +1,100 @@
+#pragma once
+#include <memory> // for std::shared_ptr
+#include <vector> // for std::vector
+#ifndef _WIN32
+#include <sys/uio.h> // for struct iovec
+#endif
+#include "Datagram.h"
+#include "DatagramView.h"
+#include "SharedDatagram.h"
+namespace bamboo    // open namespace bamboo
+{
+
+
+// A SegmentedDatagram is a datagram made of a chain of buffers instead of a single contiguous one.
+//     Segments can be shared between many datagrams without being copied, which makes it cheap
+//     to send one payload to many recipients.  Each datagram also has its own head, a regular
+//     Datagram which always comes before the segments, for data such as per-recipient headers:
+//
+//         auto payload = std::make_shared<const Datagram>(std::move(update));
+//         for(channel_t channel : recipients) {
+//             SegmentedDatagram dg;
+//             dg.head().add(uint8_t(1), channel, sender, msgtype);
+//             dg.add_segment(payload);
+//             std::vector<iovec> iov = dg.iovecs();
+//             writev(fd, iov.data(), iov.size());
+//         }
+//
+//     A shared segment is immutable; it is kept alive for as long as any datagram references it.
+class SegmentedDatagram
+{
+  public:
+    // A Segment is one buffer of a SegmentedDatagram.
+    struct Segment {
+        std::shared_ptr<const Datagram> owner; // set if the segment is a shared Datagram
+        SharedDatagram shared;                 // set if the segment is a SharedDatagram
+        DatagramView view;
+    };
+
+    SegmentedDatagram() : m_head(32), m_size(0) {}
+
+    // head returns the datagram's head, which may be added to directly.
+    Datagram& head()
+    {
+        return m_head;
+    }
+    const Datagram& head() const
+    {
+        return m_head;
+    }
+
+    // add_segment appends a shared, immutable datagram to the end of the datagram without
+    //     copying its data.  Throws DatagramOverflow if the total size would exceed the
+    //     maximum datagram size.
+    void add_segment(std::shared_ptr<const Datagram> segment);
+    void add_segment(SharedDatagram segment);
+    // add_segment appends a datagram to the end of the datagram, taking ownership of its buffer.
+    void add_segment(Datagram&& segment);
+    // add_view appends a segment which references data owned by someone else.  The data must
+    //     outlive the datagram, and every copy of it.
+    void add_view(const DatagramView& view);
+
+    // size returns the total number of bytes in the head and all of the segments.
+    size_t size() const
+    {
+        return m_head.size() + m_size;
+    }
+
+    // num_segments returns the number of segments added to the datagram, excluding the head.
+    size_t num_segments() const
+    {
+        return m_segments.size();
+    }
+    // get_segment returns a view of the <n>th segment added to the datagram.
+    const DatagramView& get_segment(size_t n) const
+    {
+        return m_segments[n].view;
+    }
+
+    // flatten copies the head and segments into a single contiguous datagram.
+    //     Throws DatagramOverflow if the total size exceeds the maximum datagram size.
+    Datagram flatten() const;
+
+#ifndef _WIN32
+    // to_iovec fills in up to <count> iovecs with the head and each of the segments,
+    //     skipping any that are empty, and returns the number of iovecs used.
+    size_t to_iovec(struct iovec *iov, size_t count) const;
+    // iovecs returns the iovecs to pass to writev or sendmsg to send the datagram.
+    std::vector<struct iovec> iovecs() const;
+#endif
+
+  private:
+    void check_add_length(size_t length);
+
+    Datagram m_head;
+    std::vector<Segment> m_segments;
+    sizetag_t m_size; // bytes in the segments, excluding the head
+};
+
+
+} // close namespace bamboo
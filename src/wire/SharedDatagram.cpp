@@ -0,0 +1,25 @@
+#include "SharedDatagram.h"
+#include <new> // for placement new
+using namespace std;
+namespace bamboo    // open namespace bamboo
+{
+
+
+SharedDatagram::SharedDatagram(const uint8_t *data, sizetag_t length) : m_block(nullptr)
+{
+    if(length == 0) { return; }
+
+    m_block = new(::operator new(sizeof(Block) + length)) Block;
+    m_block->refs.store(1, memory_order_relaxed);
+    m_block->size = length;
+    memcpy((uint8_t *)(m_block + 1), data, length);
+}
+
+void SharedDatagram::destroy(Block *block)
+{
+    block->~Block();
+    ::operator delete(block);
+}
+
+
+} // close namespace bamboo
@@ -0,0 +1,135 @@
+#pragma once
+#include <atomic> // for std::atomic
+#include "Datagram.h"
+#include "DatagramView.h"
+namespace bamboo    // open namespace bamboo
+{
+
+
+// A SharedDatagram is an immutable datagram whose buffer is shared by all of its copies.
+//     Copying a SharedDatagram only increments a reference count, so one message can be queued
+//     to many subscribers, or kept in a history buffer, without duplicating its data.
+//     The reference count is atomic; copies may be passed to and released on other threads.
+//
+//     The data and the reference count are stored in a single allocation of exactly the
+//     datagram's size, so freezing a datagram also drops any spare capacity it had.
+//     To modify the data, make a new Datagram with to_datagram.
+class SharedDatagram
+{
+  public:
+    // default-constructor:
+    //     creates an empty datagram, which doesn't allocate.
+    SharedDatagram() : m_block(nullptr) {}
+
+    // buffer-constructor:
+    //     creates a shared datagram with a copy of <length> bytes starting at the pointer.
+    SharedDatagram(const uint8_t *data, sizetag_t length);
+
+    // datagram-constructor:
+    //     freezes a copy of the current contents of the datagram.
+    explicit SharedDatagram(const Datagram& dg) : SharedDatagram(dg.data(), dg.size()) {}
+
+    // view-constructor:
+    //     freezes a copy of the viewed data.
+    explicit SharedDatagram(const DatagramView& view) : SharedDatagram(view.data(), view.size()) {}
+
+    // copy-constructor:
+    //     shares the other datagram's buffer.
+    SharedDatagram(const SharedDatagram& other) noexcept : m_block(other.m_block)
+    {
+        if(m_block != nullptr) {
+            m_block->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // move-constructor
+    SharedDatagram(SharedDatagram&& other) noexcept : m_block(other.m_block)
+    {
+        other.m_block = nullptr;
+    }
+
+    // copy-assignment operator
+    SharedDatagram& operator=(const SharedDatagram& other) noexcept
+    {
+        SharedDatagram copy(other);
+        swap(*this, copy);
+        return *this;
+    }
+
+    // move-assignment operator
+    SharedDatagram& operator=(SharedDatagram&& other) noexcept
+    {
+        swap(*this, other);
+        return *this;
+    }
+
+    // implement swap for SharedDatagram
+    friend void swap(SharedDatagram& lhs, SharedDatagram& rhs) noexcept
+    {
+        Block *block = lhs.m_block;
+        lhs.m_block = rhs.m_block;
+        rhs.m_block = block;
+    }
+
+    // destructor
+    ~SharedDatagram()
+    {
+        if(m_block != nullptr && m_block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            destroy(m_block);
+        }
+    }
+
+    // size returns the number of bytes in the datagram.
+    sizetag_t size() const
+    {
+        return m_block != nullptr ? m_block->size : 0;
+    }
+
+    // empty returns true if the datagram doesn't contain any bytes.
+    bool empty() const
+    {
+        return m_block == nullptr;
+    }
+
+    // data returns a pointer to the start of the datagram's data.
+    const uint8_t *data() const
+    {
+        return m_block != nullptr ? (const uint8_t *)(m_block + 1) : nullptr;
+    }
+
+    // view returns a view of the datagram's data, which can be read with a DatagramIterator.
+    DatagramView view() const
+    {
+        return DatagramView(data(), size());
+    }
+    operator DatagramView() const
+    {
+        return view();
+    }
+
+    // use_count returns the number of SharedDatagrams sharing this datagram's buffer.
+    size_t use_count() const
+    {
+        return m_block != nullptr ? m_block->refs.load(std::memory_order_relaxed) : 0;
+    }
+
+    // to_datagram returns a modifiable copy of the datagram.
+    Datagram to_datagram() const
+    {
+        return m_block != nullptr ? Datagram(data(), size()) : Datagram();
+    }
+
+  private:
+    // A Block is the header of a shared buffer; the data immediately follows it.
+    struct Block {
+        std::atomic<size_t> refs;
+        sizetag_t size;
+    };
+
+    static void destroy(Block *block);
+
+    Block *m_block;
+};
+
+
+} // close namespace bamboo
@@ -0,0 +1,150 @@
+// Filename: buffer_pool.cpp
+// test-buffer-pool checks that the BufferPool recycles buffers within a thread, returns buffers
+//     released by a consumer thread to the producer thread, keeps process-wide statistics, and
+//     frees buffers released after a thread's pool has been destroyed.
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "wire/BufferPool.h"
+using namespace std;
+using namespace bamboo;
+
+static const size_t kBatch = 512;
+
+// A LateRelease frees a datagram when its thread exits.
+struct LateRelease {
+    Datagram *dg = nullptr;
+    ~LateRelease()
+    {
+        delete dg;
+    }
+};
+
+static thread_local LateRelease t_late;
+
+static bool fail(const char *message)
+{
+    cerr << "FAIL: " << message << "\n";
+    return false;
+}
+
+static bool test_recycle(BufferPool *pool)
+{
+    {
+        Datagram dg(100, pool);
+        if(dg.cap() != 128) {
+            return fail("the capacity wasn't rounded up to the size class");
+        }
+    }
+    if(pool->thread_stats().pooled_buffers != 1) {
+        return fail("the buffer wasn't returned to the thread's pool");
+    }
+
+    BufferPoolStats before = pool->thread_stats();
+    {
+        Datagram dg(80, pool);
+    }
+    BufferPoolStats after = pool->thread_stats();
+    if(after.hits != before.hits + 1 || after.misses != before.misses) {
+        return fail("a recycled buffer wasn't reused");
+    }
+
+    // The largest datagram's buffer is recycled with the capacity it was allocated with
+    {
+        Datagram dg(kSizetagMax, pool);
+        dg.add_data(vector<uint8_t>(kSizetagMax, 7));
+    }
+    {
+        Datagram dg(kSizetagMax, pool);
+        if(dg.cap() != kSizetagMax) {
+            return fail("the largest datagram has the wrong capacity");
+        }
+    }
+    if(pool->thread_stats().hits != after.hits + 1) {
+        return fail("the largest datagram's buffer wasn't reused");
+    }
+    return true;
+}
+
+static bool test_producer_consumer(BufferPool *pool)
+{
+    uint64_t first_hits = 0, second_hits = 0;
+    thread producer([&]() {
+        vector<Datagram *> sent;
+        for(size_t i = 0; i < kBatch; ++i) {
+            sent.push_back(new Datagram(200, pool));
+        }
+        first_hits = pool->thread_stats().hits;
+
+        thread consumer([&]() {
+            for(Datagram *dg : sent) {
+                delete dg;
+            }
+        });
+        consumer.join();
+
+        for(size_t i = 0; i < kBatch; ++i) {
+            sent[i] = new Datagram(200, pool);
+        }
+        second_hits = pool->thread_stats().hits;
+        for(Datagram *dg : sent) {
+            delete dg;
+        }
+    });
+    producer.join();
+
+    if(first_hits != 0) {
+        return fail("the producer's first batch came from an empty pool");
+    }
+    if(second_hits != pool->max_buffers_per_class()) {
+        cerr << "hits: " << second_hits << "\n";
+        return fail("the producer didn't reuse the buffers released by the consumer");
+    }
+    return true;
+}
+
+static bool test_late_release(BufferPool *pool)
+{
+    uint64_t discarded = pool->stats().discarded;
+    thread late([&]() {
+        // Construct the LateRelease before the thread's pool, so that it is destroyed after it
+        t_late.dg = nullptr;
+        t_late.dg = new Datagram(100, pool);
+    });
+    late.join();
+
+    if(pool->stats().discarded != discarded + 1) {
+        return fail("a buffer released after its thread's pool was destroyed wasn't freed");
+    }
+    return true;
+}
+
+int main()
+{
+    BufferPool *pool = BufferPool::instance();
+    if(!test_recycle(pool) || !test_producer_consumer(pool) || !test_late_release(pool)) {
+        return 1;
+    }
+
+    // The process-wide stats include the threads which have exited
+    BufferPoolStats stats = pool->stats();
+    BufferPoolStats local = pool->thread_stats();
+    if(stats.misses < local.misses + kBatch || stats.hits < local.hits + 128) {
+        return fail("the process-wide stats don't include the exited threads");
+    }
+
+    pool->trim();
+    stats = pool->stats();
+    if(stats.pooled_buffers != 0 || stats.pooled_bytes != 0) {
+        return fail("trim didn't free the pooled buffers");
+    }
+
+    pool->reset_stats();
+    stats = pool->stats();
+    if(stats.hits != 0 || stats.misses != 0 || stats.recycled != 0 || stats.discarded != 0) {
+        return fail("reset_stats didn't clear the counters");
+    }
+
+    cout << "hit rate " << local.hit_rate() << " on the main thread\n";
+    return 0;
+}
@@ -0,0 +1,51 @@
+// Filename: byteorder.cpp
+// test-byteorder checks that swap_le_array converts every value of unaligned arrays of
+//     each width, including the values left over after its vectorized loop.
+#include <iostream>
+#include <vector>
+#include "bits/byteorder.h"
+using namespace std;
+using namespace bamboo;
+
+// check_width compares swap_le_array against reversing the bytes of each value by hand.
+template<typename T>
+static bool check_width()
+{
+    vector<uint8_t> input(sizeof(T) * 40 + 4), output(input.size()), expected(input.size());
+    for(size_t i = 0; i < input.size(); ++i) {
+        input[i] = uint8_t(i * 7 + 1);
+    }
+
+    for(size_t count = 0; count <= 40; ++count) {
+        for(size_t align = 0; align < 4; ++align) {
+            const uint8_t *src = &input[align];
+            for(size_t i = 0; i < count * sizeof(T); ++i) {
+#ifdef PLATFORM_BIG_ENDIAN
+                size_t value = i / sizeof(T), byte = i % sizeof(T);
+                expected[i] = src[value * sizeof(T) + (sizeof(T) - 1 - byte)];
+#else
+                expected[i] = src[i];
+#endif
+            }
+
+            swap_le_array<T>(&output[align], src, count);
+            for(size_t i = 0; i < count * sizeof(T); ++i) {
+                if(output[align + i] != expected[i]) {
+                    cerr << "FAIL: swap_le_array<" << sizeof(T) << " bytes> converted byte " << i
+                         << " of " << count << " values wrong\n";
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    if(!check_width<uint8_t>() || !check_width<uint16_t>() || !check_width<uint32_t>() ||
+       !check_width<uint64_t>() || !check_width<float>() || !check_width<double>()) {
+        return 1;
+    }
+    return 0;
+}
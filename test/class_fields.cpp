@@ -0,0 +1,200 @@
+// Filename: class_fields.cpp
+// test-class-fields checks that the field id lookup table and field offsets of structs and
+//     classes, which are updated incrementally as fields are added, match the tables rebuilt
+//     from scratch from the final list of fields.  The classes use inheritance, multiple
+//     inheritance, shadowing and constructors, and some fields are added to a parent after
+//     its children were declared.
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include "module/Module.h"
+#include "module/Class.h"
+#include "module/Field.h"
+#include "module/Method.h"
+#include "module/Numeric.h"
+#include "module/Parameter.h"
+#include "dcfile/parse.h"
+using namespace std;
+using namespace bamboo;
+
+static const char *kSource =
+    "struct Plain { uint8 a; string b; uint16 c; blob d; uint32 e; };\n"
+    "dclass Base {\n"
+    "  Base(uint32 id);\n"
+    "  setA(uint8 a);\n"
+    "  setB(string b);\n"
+    "  setC(uint16 c);\n"
+    "};\n"
+    "struct Filler1 { uint8 f0; uint8 f1; uint8 f2; uint8 f3; uint8 f4; uint8 f5; };\n"
+    "struct Filler2 { uint8 f0; uint8 f1; uint8 f2; uint8 f3; uint8 f4; uint8 f5; };\n"
+    "dclass Other { setD(uint32 d); setB(uint64 b); };\n"
+    "dclass Mixed : Other, Base {\n"
+    "  Mixed(uint8 kind);\n"
+    "  setC(uint8 c, uint8 d);\n"
+    "  setE(blob e);\n"
+    "};\n"
+    "struct Filler3 { uint8 f0; uint8 f1; uint8 f2; uint8 f3; uint8 f4; uint8 f5; };\n"
+    "dclass Leaf : Mixed { setA(int8 a); setF(uint8 f); };\n";
+
+static bool fail(const string& message)
+{
+    cerr << "FAIL: " << message << "\n";
+    return false;
+}
+
+// check compares a struct's lookup table and offsets against ones computed from its fields.
+static bool check(const Module& module, const Struct *record)
+{
+    const Class *cls = record->as_class();
+    const Field *constructor = cls != nullptr ? cls->constructor() : nullptr;
+
+    // Every id in the module, and a few past the end, maps to the field's position or to nothing
+    for(unsigned int id = 0; id < module.num_fields() + 10; ++id) {
+        const Field *field = module.field_by_id(id);
+        const Field *expected = nullptr;
+        int expected_index = -1;
+        for(unsigned int i = 0; i < record->num_fields(); ++i) {
+            if(record->get_field(i) == field) {
+                expected = field;
+                expected_index = (int)i;
+            }
+        }
+        if(field != nullptr && field == constructor) {
+            expected = field;
+        }
+
+        if(record->field_by_id(id) != expected) {
+            return fail(record->name() + ".field_by_id(" + to_string(id) + ") is wrong");
+        }
+        if(record->field_index_by_id(id) != expected_index) {
+            return fail(record->name() + ".field_index_by_id(" + to_string(id) + ") is wrong");
+        }
+    }
+
+    // The fields are sorted by id
+    for(unsigned int i = 1; i < record->num_fields(); ++i) {
+        if(record->get_field(i - 1)->id() >= record->get_field(i)->id()) {
+            return fail(record->name() + "'s fields aren't sorted by id");
+        }
+    }
+
+    // Each field is at the end of the fixed-size fields since the last variable-size field
+    ElementOffset location = {ElementOffset::kNoAnchor, 0};
+    for(unsigned int i = 0; i <= record->num_fields(); ++i) {
+        const ElementOffset& offset = record->field_offset(i);
+        if(offset.anchor != location.anchor || offset.offset != location.offset) {
+            return fail(record->name() + ".field_offset(" + to_string(i) + ") is wrong");
+        }
+        if(i == record->num_fields()) { break; }
+
+        const Type *type = record->get_field(i)->type();
+        if(type->has_fixed_size()) {
+            location.offset += type->fixed_size();
+        } else {
+            location.anchor = i;
+            location.offset = 0;
+        }
+    }
+    return true;
+}
+
+static bool check_all(const Module& module)
+{
+    for(unsigned int i = 0; i < module.num_structs(); ++i) {
+        if(!check(module, module.get_struct(i))) { return false; }
+    }
+    for(unsigned int i = 0; i < module.num_classes(); ++i) {
+        if(!check(module, module.get_class(i))) { return false; }
+    }
+    return true;
+}
+
+// add_method adds a field named <name> to the class, with one parameter of the given subtype.
+//     A parameter doesn't own its type, so the type is given to the module.
+static bool add_method(Class *cls, const string& name, Subtype subtype)
+{
+    Type *type = new Numeric(subtype);
+    cls->module()->add_shared_type(unique_ptr<Type>(type));
+    unique_ptr<Method> method(new Method());
+    method->add_parameter(unique_ptr<Parameter>(new Parameter(type)));
+    return cls->add_field(unique_ptr<Field>(new Field(method.release(), name)));
+}
+
+// test_late_fields adds fields to parents after their children were declared, checking the
+//     tables after every change.
+static bool test_late_fields()
+{
+    Module module;
+    Class *grand = new Class(&module, "Grand");
+    Class *parent = new Class(&module, "Parent");
+    Class *second = new Class(&module, "Second");
+    Class *child = new Class(&module, "Child");
+    module.add_class(unique_ptr<Class>(grand));
+    module.add_class(unique_ptr<Class>(parent));
+    module.add_class(unique_ptr<Class>(second));
+    module.add_class(unique_ptr<Class>(child));
+
+    if(!add_method(grand, "Grand", kTypeUint32) || !add_method(grand, "setA", kTypeUint8) ||
+       !add_method(second, "setZ", kTypeUint64)) {
+        return fail("couldn't add the first fields");
+    }
+    parent->add_parent(grand);
+    child->add_parent(parent);
+    child->add_parent(second);
+    if(!check_all(module)) { return false; }
+
+    struct Step {
+        Class *cls;
+        const char *name;
+        Subtype subtype;
+    };
+    const Step steps[] = {
+        {child, "Child", kTypeUint8},     // a constructor after inherited fields
+        {child, "setC", kTypeUint16},
+        {grand, "setB", kTypeString},     // inherited by both descendants, at the end
+        {parent, "setA", kTypeInt16},     // shadows Grand's setA in Parent and Child
+        {second, "setY", kTypeBlob},      // inherited from the second parent
+        {grand, "setD", kTypeUint32},
+        {child, "setB", kTypeUint8},      // shadows an inherited field with a base field
+        {parent, "setE", kTypeFloat64},
+        {second, "setE", kTypeInt8},      // loses to the first parent's field of the same name
+    };
+    for(const Step& step : steps) {
+        // Leave large gaps between field ids, so the table has many runs
+        Class *filler = new Class(&module, string("Filler") + step.name + step.cls->name());
+        module.add_class(unique_ptr<Class>(filler));
+        for(int i = 0; i < 10; ++i) {
+            add_method(filler, "f" + to_string(i), kTypeUint8);
+        }
+
+        if(!add_method(step.cls, step.name, step.subtype)) {
+            return fail(string("couldn't add ") + step.cls->name() + "." + step.name);
+        }
+        if(!check_all(module)) {
+            cerr << "  after adding " << step.cls->name() << "." << step.name << "\n";
+            return false;
+        }
+    }
+
+    if(child->field_by_name("setA")->record() != parent ||
+       child->field_by_name("setB")->record() != child ||
+       child->field_by_name("setE")->record() != parent) {
+        return fail("a field was shadowed by the wrong field");
+    }
+    return true;
+}
+
+int main()
+{
+    Module module;
+    istringstream in(kSource);
+    if(!parse_dcfile(&module, in, "test.dc")) {
+        cerr << "FAIL: couldn't parse the test module\n";
+        return 1;
+    }
+    if(!check_all(module) || !test_late_fields()) {
+        return 1;
+    }
+    return 0;
+}
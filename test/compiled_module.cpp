@@ -0,0 +1,199 @@
+// Filename: compiled_module.cpp
+// test-compiled-module checks that a compiled module loads back into the same module, and that
+//     corrupted compiled modules are rejected (or loaded) without touching freed memory.
+//     It is most useful when the library is built with -fsanitize=address.
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string.h>
+#include <vector>
+#include "module/Module.h"
+#include "module/Class.h"
+#include "module/Field.h"
+#include "bits/byteorder.h"
+#include "dcfile/parse.h"
+#include "dcfile/compile.h"
+using namespace std;
+using namespace bamboo;
+
+static const char *kSource =
+    "keyword required;\n"
+    "keyword broadcast;\n"
+    "keyword ram;\n"
+    "keyword db;\n"
+    "keyword airecv;\n"
+    "from game import Avatar/AI/OV, Maproot\n"
+    "import other\n"
+    "typedef uint32 doId;\n"
+    "typedef uint16(0-1000) flags;\n"
+    "typedef int16 % 360 angle;\n"
+    "typedef uint8 bytes4[4];\n"
+    "struct Pos { int16/10 x; int16/10 y = 5; float32 z; };\n"
+    "struct Box { Pos corners[2]; uint8 n = 3; char c; uint16 list[1-5]; };\n"
+    "struct Holder { Box boxes[]; int64(-100-100) big; uint32%360/100 d; float64 f = 1.5; };\n"
+    "dclass Base {\n"
+    "  Base(doId id, uint8 = 7);\n"
+    "  setPos(Pos p) required broadcast;\n"
+    "  setId(doId) required broadcast;\n"
+    "  setAngle(angle a = 90, int16 % 360 / 2 (0-100), flags f, uint16(0-1000) r) ram;\n"
+    "  setBlob(blob) db;\n"
+    "};\n"
+    "dclass Other { setThing(Holder h) airecv; int8 val = -3 required; };\n"
+    "dclass Child : Base, Other {\n"
+    "  setPos(Pos p, uint8 extra) required broadcast;\n"
+    "  setList(uint16 xs[], int8 k) broadcast;\n"
+    "  setBoth(uint8 a, uint8 b) required;\n"
+    "  setFixed(bytes4 b, uint32 arr[3]) db;\n"
+    "  mol : setPos, setId;\n"
+    "  mol2 : setFixed, setBlob;\n"
+    "};\n"
+    "dclass Third : Child { setName(string(0-32) name) required; };\n";
+
+// The parser gives every field which uses a typedef or a struct the same type.
+static const char *kSharedSource =
+    "typedef uint32 doId;\n"
+    "struct Pos { int16 x; int16 y; };\n"
+    "struct Ids { doId a; doId b; Pos p; Pos q; };\n"
+    "dclass Thing { setIds(doId id, Ids ids); doId owner; };\n";
+
+// Word offsets into a compiled module (see compile.cpp)
+static const size_t kHeaderSections = 7;
+static const size_t kSectionFields = 4, kSectionTypedefs = 6;
+static const size_t kFieldWords = 10, kTypedefWords = 2;
+
+// type_word returns a pointer to the type index of a field or typedef in a compiled module.
+static uint8_t *type_word(vector<uint8_t>& data, size_t section, size_t words, size_t n)
+{
+    size_t offset = load_le<uint32_t>(&data[(kHeaderSections + 2 * section) * 4]);
+    return &data[offset + (n * words + 1) * 4];
+}
+
+// test_shared_types checks that fields which share a type in the parsed module are loaded with
+//     types of their own, and that files in which fields share a type are rejected.
+static bool test_shared_types()
+{
+    Module *module = new Module();
+    istringstream in(kSharedSource);
+    if(!parse_dcfile(module, in, "shared.dc")) {
+        cerr << "FAIL: couldn't parse the shared types module\n";
+        return false;
+    }
+    const Struct *ids = module->type_by_name("Ids")->as_struct();
+    unsigned int a = ids->field_by_name("a")->id(), b = ids->field_by_name("b")->id();
+    unsigned int p = ids->field_by_name("p")->id(), q = ids->field_by_name("q")->id();
+
+    vector<uint8_t> compiled = compile_module(module);
+    Module *loaded = read_compiled_module(compiled.data(), compiled.size(), "shared");
+    if(loaded == nullptr) {
+        cerr << "FAIL: couldn't load a module whose fields share types\n";
+        return false;
+    }
+    if(compile_module(loaded) != compiled) {
+        cerr << "FAIL: the loaded shared types module doesn't compile to the same bytes\n";
+        return false;
+    }
+    const Type *pos = loaded->type_by_name("Pos");
+    if(loaded->field_by_id(a)->type() == loaded->field_by_id(b)->type() ||
+       loaded->field_by_id(a)->type() == loaded->type_by_name("doId") ||
+       loaded->field_by_id(p)->type() != pos || loaded->field_by_id(q)->type() != pos) {
+        cerr << "FAIL: the loaded fields don't have types of their own\n";
+        return false;
+    }
+    delete loaded;
+    delete module;
+
+    // Two fields, or a field and a typedef, can't share a type
+    vector<uint8_t> shared_field = compiled;
+    memcpy(type_word(shared_field, kSectionFields, kFieldWords, b),
+           type_word(shared_field, kSectionFields, kFieldWords, a), 4);
+    vector<uint8_t> shared_typedef = compiled;
+    memcpy(type_word(shared_typedef, kSectionTypedefs, kTypedefWords, 0),
+           type_word(shared_typedef, kSectionFields, kFieldWords, a), 4);
+    for(const vector<uint8_t> *data : {&shared_field, &shared_typedef}) {
+        streambuf *errors = cerr.rdbuf(nullptr);
+        Module *invalid = read_compiled_module(data->data(), data->size(), "invalid");
+        cerr.rdbuf(errors);
+        if(invalid != nullptr) {
+            delete invalid;
+            cerr << "FAIL: loaded a module in which a field's type is shared\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+// load reads a compiled module, and deletes it if it was loaded.
+static bool load(const vector<uint8_t>& data, size_t length)
+{
+    Module *module = read_compiled_module(data.data(), length, "test");
+    delete module;
+    return module != nullptr;
+}
+
+int main()
+{
+    Module *module = new Module();
+    istringstream in(kSource);
+    if(!parse_dcfile(module, in, "test.dc")) {
+        cerr << "FAIL: couldn't parse the test module\n";
+        return 1;
+    }
+
+    // A loaded module compiles to the same bytes as the original
+    vector<uint8_t> compiled = compile_module(module);
+    Module *loaded = read_compiled_module(compiled.data(), compiled.size(), "test");
+    if(loaded == nullptr) {
+        cerr << "FAIL: couldn't load the compiled module\n";
+        return 1;
+    }
+    if(compile_module(loaded) != compiled) {
+        cerr << "FAIL: the loaded module doesn't compile to the same bytes\n";
+        return 1;
+    }
+    delete loaded;
+    delete module;
+    if(!test_shared_types()) {
+        return 1;
+    }
+
+    // Corrupted modules must be rejected or loaded, but never crash; errors are discarded
+    streambuf *errors = cerr.rdbuf(nullptr);
+    size_t rejected = 0, attempts = 0;
+
+    // Flip each bit in turn
+    for(size_t i = 0; i < compiled.size(); ++i) {
+        for(int bit = 0; bit < 8; ++bit) {
+            vector<uint8_t> corrupt = compiled;
+            corrupt[i] ^= uint8_t(1 << bit);
+            rejected += load(corrupt, corrupt.size()) ? 0 : 1;
+            ++attempts;
+        }
+    }
+
+    // Flip several bits at once
+    mt19937 random(1234);
+    uniform_int_distribution<size_t> position(0, compiled.size() * 8 - 1);
+    for(int n = 0; n < 20000; ++n) {
+        vector<uint8_t> corrupt = compiled;
+        for(int flips = 1 + n % 4; flips > 0; --flips) {
+            size_t bit = position(random);
+            corrupt[bit / 8] ^= uint8_t(1 << (bit % 8));
+        }
+        rejected += load(corrupt, corrupt.size()) ? 0 : 1;
+        ++attempts;
+    }
+
+    // Truncate the module
+    for(size_t length = 0; length < compiled.size(); ++length) {
+        if(load(compiled, length)) {
+            cerr.rdbuf(errors);
+            cerr << "FAIL: a module truncated to " << length << " bytes was loaded\n";
+            return 1;
+        }
+    }
+
+    cerr.rdbuf(errors);
+    cout << "rejected " << rejected << " of " << attempts << " corrupted modules\n";
+    return 0;
+}
@@ -0,0 +1,119 @@
+// Filename: datagram_iterator.cpp
+// test-datagram-iterator checks that the DatagramIterator rejects malformed data
+//     instead of misreading it or looping forever.
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string.h>
+#include <vector>
+#include "module/Module.h"
+#include "module/Struct.h"
+#include "module/Value.h"
+#include "module/ValueArena.h"
+#include "dcfile/parse.h"
+#include "wire/DatagramIterator.h"
+using namespace std;
+using namespace bamboo;
+
+static const char *kSource =
+    "struct Huge { uint8 big[70000]; };\n"
+    "struct HugeThenString { uint8 big[70000]; string s; uint8 after; };\n"
+    "struct Empty {};\n"
+    "struct Empties { Empty es[]; };\n";
+
+static bool fail(const char *message)
+{
+    cerr << "FAIL: " << message << "\n";
+    return false;
+}
+
+// skips returns true if skip_type succeeds over the datagram.
+static bool skips(const Type *type, const Datagram& dg)
+{
+    DatagramIterator dgi(dg);
+    try {
+        dgi.skip_type(type);
+    } catch(DatagramIteratorEOF&) {
+        return false;
+    }
+    return true;
+}
+
+// test_large_offsets checks that offsets which don't fit in a sizetag aren't truncated.
+static bool test_large_offsets(const Module& module)
+{
+    // With a 16-bit sizetag, a truncated offset of 70000 would only skip 4464 bytes
+    Datagram dg;
+    dg.add_data(string(70000 % 65536, '\0'));
+    dg.add_size(0);
+    dg.add_uint8(1);
+
+    if(skips(module.type_by_name("Huge"), dg)) {
+        return fail("skipped a fixed-size struct larger than the datagram");
+    }
+    if(skips(module.type_by_name("HugeThenString"), dg)) {
+        return fail("skipped to a field past the end of the datagram");
+    }
+
+    DatagramIterator dgi(dg);
+    try {
+        dgi.validate(module.type_by_name("Huge"));
+        return fail("validated a fixed-size struct larger than the datagram");
+    } catch(DatagramIteratorEOF&) {}
+    return true;
+}
+
+// test_empty_elements checks that an array of elements which don't consume any data
+//     is rejected instead of being read forever.
+static bool test_empty_elements(const Module& module)
+{
+    const Type *type = module.type_by_name("Empties");
+    Datagram dg;
+    dg.add_size(4);
+    dg.add_uint32(0);
+
+    try {
+        DatagramIterator(dg).read_value(type);
+        return fail("read a value with an array of empty elements");
+    } catch(DatagramIteratorEOF&) {}
+    try {
+        ValueArena arena;
+        DatagramIterator(dg).read_value(type, arena);
+        return fail("read a value with an array of empty elements into an arena");
+    } catch(DatagramIteratorEOF&) {}
+    try {
+        vector<uint8_t> buffer;
+        DatagramIterator(dg).read_packed(type, buffer);
+        return fail("read packed data with an array of empty elements");
+    } catch(DatagramIteratorEOF&) {}
+
+    vector<uint8_t> packed(sizeof(sizetag_t) + 4, 0);
+    sizetag_t length = 4;
+    memcpy(&packed[0], &length, sizeof(length));
+    try {
+        Value value(type, packed);
+        return fail("unpacked a value with an array of empty elements");
+    } catch(out_of_range&) {}
+    try {
+        Datagram copy;
+        copy.add_packed(type, packed);
+        return fail("copied packed data with an array of empty elements");
+    } catch(BufferEOF&) {}
+    return true;
+}
+
+int main()
+{
+    Module module;
+    istringstream in(kSource);
+    if(!parse_dcfile(&module, in, "test.dc")) {
+        cerr << "FAIL: couldn't parse the test module\n";
+        return 1;
+    }
+
+    if(!test_large_offsets(module) || !test_empty_elements(module)) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,265 @@
+// Filename: decode_plan.cpp
+// test-decode-plan checks that a DecodePlan reads and skips exactly the same bytes as the
+//     DatagramIterator does for the same type, for both valid and corrupted datagrams.
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "module/Module.h"
+#include "module/Array.h"
+#include "module/Class.h"
+#include "module/Method.h"
+#include "module/Parameter.h"
+#include "dcfile/parse.h"
+#include "wire/DecodePlan.h"
+using namespace std;
+using namespace bamboo;
+
+static const char *kSource =
+    "typedef uint32 doId;\n"
+    "typedef int16 % 360 angle;\n"
+    "typedef uint8 bytes4[4];\n"
+    "struct Pos { int16/10 x; int16/10 y; float32 z; };\n"
+    "struct Named { string name; uint16 ids[]; };\n"
+    "struct Box { Pos corners[2]; uint8 n; char c; uint16 list[1-5]; Named tags[]; };\n"
+    "struct Holder { Box boxes[]; int64 big; uint32%360/100 d; float64 f; Named pair[2]; };\n"
+    "struct Deep { Holder levels[][2]; blob data; string(4) code; uint64 wide[]; };\n"
+    "dclass Avatar {\n"
+    "  Avatar(doId id, uint8 kind);\n"
+    "  setPos(Pos p);\n"
+    "  setAngles(angle a, angle list[], int32 fixed[3]);\n"
+    "  setHolder(Holder h, bytes4 b);\n"
+    "  setDeep(Deep d, string note, blob extra);\n"
+    "  setNames(Named names[], char letters[]);\n"
+    "};\n";
+
+// write_random appends a valid random encoding of <type> to the datagram.
+static void write_random(const Type *type, Datagram& dg, mt19937& random)
+{
+    uniform_int_distribution<int> byte(0, 255);
+    uniform_int_distribution<int> count(0, 3);
+    switch(type->subtype()) {
+    case kTypeArray: {
+        const Array *arr = type->as_array();
+        for(size_t i = 0; i < arr->array_size(); ++i) {
+            write_random(arr->element_type(), dg, random);
+        }
+        break;
+    }
+    case kTypeVarstring:
+    case kTypeVarblob: {
+        int length = count(random) * 3;
+        dg.add_size(sizetag_t(length));
+        for(int i = 0; i < length; ++i) {
+            dg.add_uint8(uint8_t(byte(random)));
+        }
+        break;
+    }
+    case kTypeVararray: {
+        Datagram elements;
+        for(int i = count(random); i > 0; --i) {
+            write_random(type->as_array()->element_type(), elements, random);
+        }
+        dg.add_size(elements.size());
+        dg.add_data(elements);
+        break;
+    }
+    case kTypeStruct: {
+        const Struct *dstruct = type->as_struct();
+        for(unsigned int i = 0; i < dstruct->num_fields(); ++i) {
+            write_random(dstruct->get_field(i)->type(), dg, random);
+        }
+        break;
+    }
+    case kTypeMethod: {
+        const Method *dmethod = type->as_method();
+        for(unsigned int i = 0; i < dmethod->num_parameters(); ++i) {
+            write_random(dmethod->get_parameter(i)->type(), dg, random);
+        }
+        break;
+    }
+    default:
+        for(size_t i = 0; i < type->fixed_size(); ++i) {
+            dg.add_uint8(uint8_t(byte(random)));
+        }
+        break;
+    }
+}
+
+// A Result is the outcome of decoding a datagram.  When decoding fails, the partially
+//     decoded data and the offset of the failure may differ, because plans merge their reads.
+struct Result {
+    bool failed = false;
+    vector<uint8_t> packed;
+    sizetag_t offset = 0;
+
+    bool operator==(const Result& other) const
+    {
+        if(failed || other.failed) {
+            return failed == other.failed;
+        }
+        return packed == other.packed && offset == other.offset;
+    }
+};
+
+static Result read_with_iterator(const Type *type, const Datagram& dg)
+{
+    Result result;
+    DatagramIterator dgi(dg);
+    try {
+        dgi.read_packed(type, result.packed);
+    } catch(DatagramIteratorEOF&) {
+        result.failed = true;
+    }
+    result.offset = dgi.tell();
+    return result;
+}
+
+static Result read_with_plan(const DecodePlan& plan, const Datagram& dg)
+{
+    Result result;
+    DatagramIterator dgi(dg);
+    try {
+        plan.read_packed(dgi, result.packed);
+    } catch(DatagramIteratorEOF&) {
+        result.failed = true;
+    }
+    result.offset = dgi.tell();
+    return result;
+}
+
+static Result skip_with_iterator(const Type *type, const Datagram& dg)
+{
+    Result result;
+    DatagramIterator dgi(dg);
+    try {
+        dgi.skip_type(type);
+    } catch(DatagramIteratorEOF&) {
+        result.failed = true;
+    }
+    result.offset = dgi.tell();
+    return result;
+}
+
+static Result skip_with_plan(const DecodePlan& plan, const Datagram& dg)
+{
+    Result result;
+    DatagramIterator dgi(dg);
+    try {
+        plan.skip(dgi);
+    } catch(DatagramIteratorEOF&) {
+        result.failed = true;
+    }
+    result.offset = dgi.tell();
+    return result;
+}
+
+// check compares the plan against the iterator for one datagram.
+static bool check(const Type *type, const DecodePlan& plan, const Datagram& dg, const char *what)
+{
+    if(!(read_with_plan(plan, dg) == read_with_iterator(type, dg))) {
+        cerr << "FAIL: read_packed differs for a " << what << " datagram\n";
+        return false;
+    }
+    if(!(skip_with_plan(plan, dg) == skip_with_iterator(type, dg))) {
+        cerr << "FAIL: skip differs for a " << what << " datagram\n";
+        return false;
+    }
+    return true;
+}
+
+static bool check_type(const Type *type, mt19937& random)
+{
+    DecodePlan plan(type);
+    uniform_int_distribution<int> byte(0, 255);
+    for(int n = 0; n < 50; ++n) {
+        Datagram dg;
+        write_random(type, dg, random);
+        if(!check(type, plan, dg, "valid")) {
+            return false;
+        }
+        if(read_with_plan(plan, dg).offset != dg.size()) {
+            cerr << "FAIL: the plan didn't read the whole datagram\n";
+            return false;
+        }
+
+        // Truncated and corrupted datagrams must fail (or succeed) in the same way
+        for(sizetag_t length = 0; length < dg.size(); ++length) {
+            Datagram truncated(dg.data(), length);
+            if(!check(type, plan, truncated, "truncated")) {
+                return false;
+            }
+        }
+        if(dg.size() > 0) {
+            vector<uint8_t> corrupt(dg.data(), dg.data() + dg.size());
+            corrupt[size_t(random() % corrupt.size())] = uint8_t(byte(random));
+            if(!check(type, plan, Datagram(corrupt), "corrupted")) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    Module *module = new Module();
+    istringstream in(kSource);
+    if(!parse_dcfile(module, in, "test.dc")) {
+        cerr << "FAIL: couldn't parse the test module\n";
+        return 1;
+    }
+
+    mt19937 random(1234);
+    for(unsigned int i = 0; i < module->num_structs(); ++i) {
+        if(!check_type(module->get_struct(i), random)) {
+            cerr << "  in struct " << module->get_struct(i)->name() << "\n";
+            return 1;
+        }
+    }
+    for(unsigned int i = 0; i < module->num_classes(); ++i) {
+        const Class *cls = module->get_class(i);
+        for(unsigned int j = 0; j < cls->num_fields(); ++j) {
+            const Field *field = cls->get_field(j);
+            if(!check_type(field->type(), random)) {
+                cerr << "  in field " << cls->name() << "." << field->name() << "\n";
+                return 1;
+            }
+        }
+        if(cls->has_constructor() && !check_type(cls->constructor()->type(), random)) {
+            cerr << "  in the constructor of " << cls->name() << "\n";
+            return 1;
+        }
+    }
+
+    // An array of elements which don't consume any data is rejected instead of repeating forever
+    Module edges;
+    istringstream edges_in("struct E {};\n"
+                           "struct H { E es[]; };\n"
+                           "struct Huge { uint8 big[70000]; };\n");
+    if(!parse_dcfile(&edges, edges_in, "edges.dc")) {
+        cerr << "FAIL: couldn't parse the edge case module\n";
+        return 1;
+    }
+    Datagram stalled;
+    stalled.add_size(4);
+    stalled.add_uint32(0);
+    DecodePlan plan(edges.get_struct(1));
+    if(!read_with_plan(plan, stalled).failed) {
+        cerr << "FAIL: an array of empty elements was read\n";
+        return 1;
+    }
+
+    // A type larger than a datagram is never read, even if its size was truncated to a sizetag
+    Datagram truncated;
+    truncated.add_data(string(70000 % 65536, '\0'));
+    DecodePlan huge(edges.get_struct(2));
+    if(!read_with_plan(huge, truncated).failed || !skip_with_plan(huge, truncated).failed) {
+        cerr << "FAIL: a struct larger than the datagram was read\n";
+        return 1;
+    }
+
+    delete module;
+    return 0;
+}
@@ -0,0 +1,134 @@
+// Filename: frame_reader.cpp
+// test-frame-reader checks that a FrameReader reads back exactly the frames written by a
+//     FrameBuilder, stops before a partial trailing frame, and reports how many bytes it used
+//     so that a stream split at any point can be resumed.
+#include <iostream>
+#include <string>
+#include <string.h>
+#include <vector>
+#include "wire/FrameBuilder.h"
+#include "wire/FrameReader.h"
+#include "wire/SegmentedDatagram.h"
+using namespace std;
+using namespace bamboo;
+
+static bool fail(const char *message)
+{
+    cerr << "FAIL: " << message << "\n";
+    return false;
+}
+
+// make_frames returns the frames used by the test, including an empty one.
+static vector<Datagram> make_frames()
+{
+    vector<Datagram> frames(4);
+    frames[0].add_uint32(0xdeadbeef);
+    frames[2].add_string("a frame with a string in it");
+    frames[3].add_data(string(300, 'x'));
+    return frames;
+}
+
+static bool same_frame(const DatagramView& frame, const Datagram& expected)
+{
+    return frame.size() == expected.size() &&
+           (frame.size() == 0 || memcmp(frame.data(), expected.data(), frame.size()) == 0);
+}
+
+// test_partial checks a buffer cut off at every possible length.
+static bool test_partial(const FrameBuilder& builder, const vector<Datagram>& frames)
+{
+    // ends[n] is the offset just after the <n>th frame
+    vector<size_t> ends;
+    size_t offset = 0;
+    for(const Datagram& dg : frames) {
+        offset += sizeof(sizetag_t) + dg.size();
+        ends.push_back(offset);
+    }
+    if(offset != builder.size() || builder.num_frames() != frames.size()) {
+        return fail("the builder's size or number of frames is wrong");
+    }
+
+    for(size_t length = 0; length <= builder.size(); ++length) {
+        FrameReader reader(builder.data(), length);
+        DatagramView frame;
+        size_t count = 0;
+        while(reader.next(frame)) {
+            if(count >= frames.size() || !same_frame(frame, frames[count])) {
+                return fail("a frame was read back wrong");
+            }
+            if(frame.data() < builder.data() ||
+               frame.data() + frame.size() > builder.data() + length) {
+                return fail("a frame wasn't read in place, or extends past the buffer");
+            }
+            ++count;
+        }
+
+        // Only the complete frames are read, and the partial one is left for later
+        size_t complete = 0;
+        while(complete < ends.size() && ends[complete] <= length) { ++complete; }
+        size_t used = complete > 0 ? ends[complete - 1] : 0;
+        if(count != complete) {
+            return fail("the reader didn't stop before the partial trailing frame");
+        }
+        if(reader.consumed() != used || reader.remaining() != length - used) {
+            return fail("consumed doesn't end at the last complete frame");
+        }
+        if(reader.next(frame) || reader.consumed() != used) {
+            return fail("reading past the last complete frame changed the reader");
+        }
+    }
+    return true;
+}
+
+// test_resume checks that a stream split into two reads yields every frame exactly once,
+//     when the bytes which weren't consumed are kept and the rest are appended to them.
+static bool test_resume(const FrameBuilder& builder, const vector<Datagram>& frames)
+{
+    for(size_t split = 0; split <= builder.size(); ++split) {
+        vector<uint8_t> buffer(builder.data(), builder.data() + split);
+        vector<vector<uint8_t> > read;
+        auto handler = [&read](DatagramIterator& dgi) {
+            read.push_back(dgi.read_remainder());
+        };
+
+        FrameReader first(buffer);
+        first.for_each(handler);
+        buffer.erase(buffer.begin(), buffer.begin() + first.consumed());
+        buffer.insert(buffer.end(), builder.data() + split, builder.data() + builder.size());
+
+        FrameReader second(buffer);
+        second.for_each(handler);
+        if(second.remaining() != 0 || read.size() != frames.size()) {
+            return fail("a stream split in two didn't read every frame");
+        }
+        for(size_t i = 0; i < frames.size(); ++i) {
+            DatagramView frame(read[i].data(), sizetag_t(read[i].size()));
+            if(!same_frame(frame, frames[i])) {
+                return fail("a stream split in two read a frame wrong");
+            }
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    vector<Datagram> frames = make_frames();
+    FrameBuilder builder(16);
+    for(size_t i = 0; i < frames.size(); ++i) {
+        if(i == 2) {
+            // A segmented datagram is written as a single frame
+            SegmentedDatagram segmented;
+            segmented.head().add_data(frames[i].data(), 5);
+            segmented.add_view(DatagramView(frames[i].data() + 5, frames[i].size() - 5));
+            builder.add_frame(segmented);
+        } else {
+            builder.add_frame(frames[i]);
+        }
+    }
+
+    if(!test_partial(builder, frames) || !test_resume(builder, frames)) {
+        return 1;
+    }
+    return 0;
+}
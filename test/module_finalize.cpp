@@ -0,0 +1,68 @@
+// Filename: module_finalize.cpp
+// test-module-finalize checks that the fields of a finalized module can't be changed,
+//     including through the KeywordList interface they inherit.
+#include <iostream>
+#include <sstream>
+#include "module/Module.h"
+#include "module/Class.h"
+#include "module/Field.h"
+#include "dcfile/parse.h"
+using namespace std;
+using namespace bamboo;
+
+static const char *kSource =
+    "keyword ram;\n"
+    "keyword db;\n"
+    "dclass Avatar { setName(string name) ram; setLevel(uint8 level) db; };\n";
+
+static bool fail(const char *message)
+{
+    cerr << "FAIL: " << message << "\n";
+    return false;
+}
+
+static bool test_keywords(Module& module)
+{
+    Class *cls = module.get_class(0);
+    Field *name = cls->field_by_name("setName");
+    Field *level = cls->field_by_name("setLevel");
+    module.finalize();
+
+    if(name->add_keyword("db") || name->has_keyword("db")) {
+        return fail("a keyword was added to a field of a finalized module");
+    }
+    KeywordList& keywords = *name;
+    if(keywords.add_keyword("db") || name->has_keyword("db")) {
+        return fail("a keyword was added to a finalized field through its KeywordList");
+    }
+    keywords.copy_keywords(*level);
+    if(!name->has_keyword("ram") || name->has_keyword("db") || name->num_keywords() != 1) {
+        return fail("a finalized field's keywords were replaced with copy_keywords");
+    }
+    keywords = *level;
+    if(!name->has_keyword("ram") || name->has_keyword("db")) {
+        return fail("a finalized field's keywords were replaced by assignment");
+    }
+
+    // A list which doesn't belong to a field can still be changed
+    KeywordList list;
+    list.copy_keywords(*level);
+    if(!list.has_keyword("db") || !list.add_keyword("ram") || list.num_keywords() != 2) {
+        return fail("a plain keyword list couldn't be changed");
+    }
+    return true;
+}
+
+int main()
+{
+    Module module;
+    istringstream in(kSource);
+    if(!parse_dcfile(&module, in, "test.dc")) {
+        cerr << "FAIL: couldn't parse the test module\n";
+        return 1;
+    }
+    if(!test_keywords(module)) {
+        return 1;
+    }
+    return 0;
+}
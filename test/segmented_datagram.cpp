@@ -0,0 +1,112 @@
+// Filename: segmented_datagram.cpp
+// test-segmented-datagram checks that a SegmentedDatagram's iovecs list the head and each
+//     segment in the order they were added, skipping empty ones, and match flatten.
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string.h>
+#include <vector>
+#include "wire/SegmentedDatagram.h"
+using namespace std;
+using namespace bamboo;
+
+static bool fail(const char *message)
+{
+    cerr << "FAIL: " << message << "\n";
+    return false;
+}
+
+// make_datagram returns a datagram with <length> bytes, all equal to <fill>.
+static Datagram make_datagram(size_t length, uint8_t fill)
+{
+    Datagram dg;
+    dg.add_data(string(length, char(fill)));
+    return dg;
+}
+
+// test_ordering checks the iovecs of a datagram with one segment of each kind.
+static bool test_ordering()
+{
+    static const uint8_t kViewData[] = { 5, 5, 5 };
+
+    SegmentedDatagram dg;
+    dg.head().add_uint16(0x0101);
+    dg.add_segment(make_shared<const Datagram>(make_datagram(4, 2)));
+    dg.add_segment(SharedDatagram(make_datagram(5, 3)));
+    dg.add_segment(Datagram());
+    dg.add_segment(make_datagram(6, 4));
+    dg.add_view(DatagramView(kViewData, sizeof(kViewData)));
+    dg.add_segment(SharedDatagram());
+
+    if(dg.num_segments() != 6 || dg.size() != 2 + 4 + 5 + 6 + 3) {
+        return fail("the segments or size of the datagram are wrong");
+    }
+
+    // The empty segments are skipped
+    vector<struct iovec> iov = dg.iovecs();
+    const size_t expected_lengths[] = { 2, 4, 5, 6, 3 };
+    if(iov.size() != 5) {
+        return fail("the datagram doesn't have one iovec per non-empty buffer");
+    }
+    if(iov[0].iov_base != dg.head().data()) {
+        return fail("the first iovec isn't the head");
+    }
+    if(iov[4].iov_base != kViewData) {
+        return fail("a view was copied instead of referenced");
+    }
+    for(size_t i = 0; i < iov.size(); ++i) {
+        if(iov[i].iov_len != expected_lengths[i]) {
+            return fail("the iovecs aren't in the order the segments were added");
+        }
+        const uint8_t *bytes = (const uint8_t *)iov[i].iov_base;
+        for(size_t j = 0; j < iov[i].iov_len; ++j) {
+            if(bytes[j] != uint8_t(i + 1)) {
+                return fail("an iovec points at the wrong segment");
+            }
+        }
+    }
+
+    // Concatenating the iovecs gives the same bytes as flatten
+    Datagram flat = dg.flatten();
+    vector<uint8_t> gathered;
+    for(const struct iovec& v : iov) {
+        gathered.insert(gathered.end(), (const uint8_t *)v.iov_base,
+                        (const uint8_t *)v.iov_base + v.iov_len);
+    }
+    if(gathered.size() != flat.size() || memcmp(gathered.data(), flat.data(), flat.size()) != 0) {
+        return fail("the iovecs don't match the flattened datagram");
+    }
+
+    // to_iovec stops after <count> iovecs, keeping the order
+    struct iovec partial[3];
+    if(dg.to_iovec(partial, 3) != 3 || partial[0].iov_base != iov[0].iov_base ||
+       partial[1].iov_base != iov[1].iov_base || partial[2].iov_base != iov[2].iov_base) {
+        return fail("to_iovec didn't fill the first iovecs in order");
+    }
+    return true;
+}
+
+// test_empty_head checks that an empty head isn't given an iovec.
+static bool test_empty_head()
+{
+    SegmentedDatagram dg;
+    if(!dg.iovecs().empty()) {
+        return fail("an empty datagram has iovecs");
+    }
+
+    SharedDatagram shared(make_datagram(7, 9));
+    dg.add_segment(shared);
+    vector<struct iovec> iov = dg.iovecs();
+    if(iov.size() != 1 || iov[0].iov_base != shared.data() || iov[0].iov_len != 7) {
+        return fail("a datagram with an empty head doesn't start with its first segment");
+    }
+    return true;
+}
+
+int main()
+{
+    if(!test_ordering() || !test_empty_head()) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,132 @@
+// Filename: shared_datagram.cpp
+// test-shared-datagram checks that copies of a SharedDatagram share one buffer, and that the
+//     buffer is freed exactly when the last copy is destroyed, whether the copies were made by
+//     copying, moving, or assigning, and on which thread they are released.
+#include <atomic>
+#include <iostream>
+#include <new>
+#include <stdlib.h>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "wire/SharedDatagram.h"
+using namespace std;
+using namespace bamboo;
+
+// Count the live allocations, so the test can tell when a shared buffer is freed
+static atomic<long> g_allocations(0);
+
+void *operator new(size_t size)
+{
+    void *ptr = malloc(size > 0 ? size : 1);
+    if(ptr == nullptr) { throw bad_alloc(); }
+    g_allocations.fetch_add(1, memory_order_relaxed);
+    return ptr;
+}
+void operator delete(void *ptr) noexcept
+{
+    if(ptr == nullptr) { return; }
+    g_allocations.fetch_sub(1, memory_order_relaxed);
+    free(ptr);
+}
+void operator delete(void *ptr, size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+static bool fail(const char *message)
+{
+    cerr << "FAIL: " << message << "\n";
+    return false;
+}
+
+static SharedDatagram make_shared_datagram()
+{
+    static const uint8_t kData[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    return SharedDatagram(kData, sizeof(kData));
+}
+
+// test_copies checks the reference count through copies, moves and assignments.
+static bool test_copies()
+{
+    long before = g_allocations.load();
+    {
+        SharedDatagram original = make_shared_datagram();
+        if(g_allocations.load() != before + 1 || original.use_count() != 1) {
+            return fail("a shared datagram didn't make exactly one allocation");
+        }
+
+        SharedDatagram copy(original);
+        SharedDatagram assigned;
+        assigned = copy;
+        if(original.use_count() != 3 || copy.data() != original.data() ||
+           assigned.data() != original.data() || g_allocations.load() != before + 1) {
+            return fail("copies of a shared datagram don't share its buffer");
+        }
+
+        // Moving transfers the reference without changing the count
+        SharedDatagram moved(move(copy));
+        SharedDatagram move_assigned;
+        move_assigned = move(assigned);
+        if(original.use_count() != 3 || !copy.empty() || copy.use_count() != 0 ||
+           moved.data() != original.data() || move_assigned.data() != original.data()) {
+            return fail("moving a shared datagram changed its reference count");
+        }
+
+        // Assigning over a copy releases its reference
+        moved = SharedDatagram();
+        if(original.use_count() != 2) {
+            return fail("assigning over a copy didn't release its reference");
+        }
+        original = SharedDatagram();
+        if(move_assigned.use_count() != 1 || g_allocations.load() != before + 1) {
+            return fail("releasing the original didn't release its reference");
+        }
+
+        // Self-assignment doesn't drop the last reference
+        SharedDatagram& self = move_assigned;
+        move_assigned = self;
+        if(move_assigned.use_count() != 1 || move_assigned.data()[7] != 8) {
+            return fail("self-assignment changed the shared datagram");
+        }
+    }
+    if(g_allocations.load() != before) {
+        return fail("the buffer wasn't freed when the last copy was destroyed");
+    }
+    return true;
+}
+
+// test_threads checks that copies released on many threads free the buffer exactly once.
+static bool test_threads()
+{
+    long before = g_allocations.load();
+    for(int round = 0; round < 20; ++round) {
+        vector<SharedDatagram> copies(64, make_shared_datagram());
+        vector<thread> threads;
+        for(int t = 0; t < 4; ++t) {
+            vector<SharedDatagram> batch;
+            for(int i = t; i < 64; i += 4) {
+                batch.push_back(move(copies[i]));
+            }
+            threads.emplace_back([](vector<SharedDatagram> mine) {
+                for(int i = 0; i < 100; ++i) {
+                    SharedDatagram copy = mine[i % mine.size()];
+                }
+                mine.clear();
+            }, move(batch));
+        }
+        for(thread& t : threads) { t.join(); }
+    }
+    if(g_allocations.load() != before) {
+        return fail("a buffer shared between threads wasn't freed exactly once");
+    }
+    return true;
+}
+
+int main()
+{
+    if(!test_copies() || !test_threads()) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,200 @@
+// Filename: symbols.cpp
+// test-symbols checks that a SymbolMap still finds every entry after erasing from the middle
+//     of colliding probe sequences, and that the SymbolTable gives every thread the same
+//     symbol for a name while other threads are adding names and growing its index.
+#include <atomic>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "module/Symbol.h"
+#include "module/SymbolMap.h"
+using namespace std;
+using namespace bamboo;
+
+static bool fail(const char *message)
+{
+    cerr << "FAIL: " << message << "\n";
+    return false;
+}
+
+// home_of returns the slot a SymbolMap with <slots> slots would first probe for the symbol.
+static size_t home_of(Symbol symbol, size_t slots)
+{
+    unsigned int shift = 32;
+    for(size_t n = slots; n > 1; n >>= 1) { --shift; }
+    return (size_t)((uint32_t)(symbol.id() * 2654435769u) >> shift);
+}
+
+// matches returns true if the map holds exactly the entries of the reference map.
+static bool matches(const SymbolMap<int>& map, const std::map<Symbol, int>& expected,
+                    const vector<Symbol>& symbols)
+{
+    if(map.size() != expected.size()) { return false; }
+    for(Symbol symbol : symbols) {
+        const int *value = map.find(symbol);
+        auto it = expected.find(symbol);
+        if(it == expected.end() ? value != nullptr : value == nullptr || *value != it->second) {
+            return false;
+        }
+    }
+    size_t visited = 0;
+    bool ok = true;
+    map.for_each([&](Symbol symbol, int value) {
+        auto it = expected.find(symbol);
+        ok = ok && it != expected.end() && it->second == value;
+        ++visited;
+    });
+    return ok && visited == expected.size();
+}
+
+// test_collisions erases each entry of a probe sequence which shares one home slot and
+//     wraps around the end of the table, checking the others are still found.
+static bool test_collisions()
+{
+    // A map with four entries has eight slots; use the last slot so the sequence wraps
+    vector<Symbol> colliding;
+    for(int i = 0; colliding.size() < 4; ++i) {
+        Symbol symbol = Symbol::intern("collide" + to_string(i));
+        if(home_of(symbol, 8) == 7) { colliding.push_back(symbol); }
+    }
+    // And one entry whose home slot is inside the sequence, so it must not be moved before it
+    Symbol inside;
+    for(int i = 0; !inside.valid(); ++i) {
+        Symbol symbol = Symbol::intern("inside" + to_string(i));
+        if(home_of(symbol, 8) == 1) { inside = symbol; }
+    }
+
+    vector<Symbol> all(colliding);
+    all.push_back(inside);
+    for(size_t erased = 0; erased < all.size(); ++erased) {
+        SymbolMap<int> map;
+        std::map<Symbol, int> expected;
+        for(size_t i = 0; i < 3; ++i) {
+            map[all[i]] = int(i);
+            expected[all[i]] = int(i);
+        }
+        map.insert(inside, 100);
+        expected[inside] = 100;
+
+        map.erase(all[erased]);
+        expected.erase(all[erased]);
+        if(!matches(map, expected, all)) {
+            return fail("erasing from a colliding probe sequence lost an entry");
+        }
+
+        // The hole left by the erase can be reused
+        map[all[erased]] = 7;
+        expected[all[erased]] = 7;
+        if(!matches(map, expected, all)) {
+            return fail("an entry couldn't be added back after it was erased");
+        }
+    }
+    return true;
+}
+
+// test_random compares a SymbolMap against std::map over random inserts and erases.
+static bool test_random()
+{
+    vector<Symbol> symbols;
+    for(int i = 0; i < 200; ++i) {
+        symbols.push_back(Symbol::intern("random" + to_string(i)));
+    }
+
+    mt19937 random(42);
+    SymbolMap<int> map;
+    std::map<Symbol, int> expected;
+    for(int step = 0; step < 20000; ++step) {
+        Symbol symbol = symbols[random() % symbols.size()];
+        if(random() % 3 == 0) {
+            if(map.erase(symbol) != (expected.erase(symbol) == 1)) {
+                return fail("erase returned the wrong result");
+            }
+        } else {
+            int value = int(random() % 1000);
+            if(map.insert(symbol, value) != expected.insert(make_pair(symbol, value)).second) {
+                return fail("insert returned the wrong result");
+            }
+        }
+        if(step % 97 == 0 && !matches(map, expected, symbols)) {
+            return fail("the map differs from std::map after random inserts and erases");
+        }
+    }
+    if(map.erase(Symbol()) || map.find(Symbol()) != nullptr) {
+        return fail("an invalid symbol was found in the map");
+    }
+    return matches(map, expected, symbols) ? true : fail("the map differs from std::map");
+}
+
+// test_concurrent interns the same names from several threads at once, while other threads
+//     look up names which were interned before they started.
+static bool test_concurrent()
+{
+    const int kThreads = 4;
+    const int kNames = 5000; // enough to replace the table's index several times
+
+    vector<Symbol> known;
+    for(int i = 0; i < 100; ++i) {
+        known.push_back(Symbol::intern("known" + to_string(i)));
+    }
+
+    vector<vector<Symbol> > results(kThreads, vector<Symbol>(kNames));
+    atomic<bool> done(false);
+    atomic<bool> reader_failed(false);
+    vector<thread> threads;
+    for(int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([t, kNames, &results]() {
+            // Each thread interns the names in a different order; the strides are coprime
+            //     with the number of names, so every thread interns every name
+            static const int kStrides[] = { 1, 3, 7, 9 };
+            for(int n = 0; n < kNames; ++n) {
+                int i = (n * kStrides[t] + t * 977) % kNames;
+                results[t][i] = Symbol::intern("concurrent" + to_string(i));
+            }
+        });
+    }
+    thread reader([&]() {
+        while(!done.load()) {
+            for(size_t i = 0; i < known.size(); ++i) {
+                string name = "known" + to_string(i);
+                if(Symbol::find(name) != known[i] || known[i].name() != name ||
+                   known[i].hash() != Symbol::hash_name(name.data(), name.size())) {
+                    reader_failed.store(true);
+                }
+            }
+        }
+    });
+    for(thread& t : threads) { t.join(); }
+    done.store(true);
+    reader.join();
+
+    if(reader_failed.load()) {
+        return fail("a symbol couldn't be found while other threads were adding names");
+    }
+    for(int i = 0; i < kNames; ++i) {
+        string name = "concurrent" + to_string(i);
+        Symbol symbol = results[0][i];
+        for(int t = 1; t < kThreads; ++t) {
+            if(results[t][i] != symbol) {
+                return fail("two threads were given different symbols for the same name");
+            }
+        }
+        if(!symbol.valid() || symbol.name() != name || Symbol::find(name) != symbol) {
+            return fail("a symbol interned concurrently has the wrong name");
+        }
+    }
+    if(Symbol::find("never interned").valid()) {
+        return fail("find returned a symbol for a name which wasn't interned");
+    }
+    return true;
+}
+
+int main()
+{
+    if(!test_collisions() || !test_random() || !test_concurrent()) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,194 @@
+// Filename: value_arena.cpp
+// test-value-arena checks that a ValueArena can be cleared and reused, that every value nested
+//     in an arena value is allocated from the same arena, and that copies of an arena value,
+//     or values moved between the heap and an arena, don't refer to the wrong storage.  It is most useful when the library is built with
+//     -fsanitize=address.
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string.h>
+#include "module/Module.h"
+#include "module/Value.h"
+#include "dcfile/parse.h"
+using namespace std;
+using namespace bamboo;
+
+static const char *kSource =
+    "struct Tag { string name; blob data; };\n"
+    "struct Node { uint32 id; Tag tags[]; string label; uint16 nums[]; };\n"
+    "struct Tree { Node nodes[]; blob payload; };\n"
+    "typedef uint32 number;\n";
+
+static const string kLongName = "a name which is too long to be stored inline";
+
+static bool fail(const char *message)
+{
+    cerr << "FAIL: " << message << "\n";
+    return false;
+}
+
+// in_arena returns true if a value and every value nested in it use the given arena.
+static bool in_arena(const Value& value, const ValueArena *arena)
+{
+    switch(value.type->subtype()) {
+    case kTypeString:
+    case kTypeVarstring:
+    case kTypeBlob:
+    case kTypeVarblob:
+        return value.arena() == arena;
+    case kTypeArray:
+    case kTypeVararray:
+        for(const Value& element : value.elements_) {
+            if(!in_arena(element, arena)) { return false; }
+        }
+        return value.arena() == arena;
+    case kTypeStruct:
+        for(const Value& field : value.fields_) {
+            if(!in_arena(field, arena)) { return false; }
+        }
+        return value.arena() == arena;
+    default:
+        return true;
+    }
+}
+
+// make_node builds a heap value for a Node with a tag that has a long name and a long blob.
+static Value make_node(const Module& module, uint32_t id)
+{
+    Value node(module.type_by_name("Node"));
+    node.fields_[0].uint_ = id;
+    Value tag(module.type_by_name("Tag"));
+    tag.fields_[0].string_.assign(kLongName.data(), kLongName.size());
+    tag.fields_[1].blob_.assign(100, uint8_t(id));
+    node.fields_[1].elements_.push_back(tag);
+    node.fields_[2].string_.assign(kLongName.data(), kLongName.size());
+    return node;
+}
+
+static bool test_clear()
+{
+    ValueArena arena(256);
+    for(int i = 0; i < 100; ++i) {
+        memset(arena.allocate(100), 0xff, 100);
+    }
+    size_t capacity = arena.capacity();
+    if(arena.used() < 100 * 100 || capacity < arena.used()) {
+        return fail("the arena's used bytes or capacity are wrong");
+    }
+
+    arena.clear();
+    if(arena.used() != 0) {
+        return fail("clear didn't release the arena's memory");
+    }
+    size_t kept = arena.capacity();
+    if(kept == 0 || kept >= capacity) {
+        return fail("clear didn't keep just the largest block");
+    }
+    for(int i = 0; i < 10; ++i) {
+        memset(arena.allocate(100), 0, 100);
+    }
+    if(arena.capacity() != kept || arena.used() < 10 * 100) {
+        return fail("a cleared arena didn't reuse its block");
+    }
+    return true;
+}
+
+static bool test_nested(const Module& module)
+{
+    ValueArena arena;
+    Value *tree = arena.create<Value>(module.type_by_name("Tree"), &arena);
+
+    // Heap values copied into the tree, including the copies made when the array grows,
+    // are moved to the arena by ValueAllocator::construct
+    for(uint32_t id = 0; id < 50; ++id) {
+        tree->fields_[0].elements_.push_back(make_node(module, id));
+    }
+    tree->fields_[1].blob_.assign(1000, uint8_t(7));
+    if(!in_arena(*tree, &arena)) {
+        return fail("a value nested in an arena value isn't in the arena");
+    }
+
+    // Short blobs are stored inline, long ones in the arena
+    Value *tag = arena.create<Value>(module.type_by_name("Tag"), &arena);
+    tag->fields_[1].blob_.assign(ValueBlob::kInlineSize, uint8_t(1));
+    if(!tag->fields_[1].blob_.is_inline()) {
+        return fail("a short blob wasn't stored inline");
+    }
+    size_t used = arena.used();
+    tag->fields_[1].blob_.assign(ValueBlob::kInlineSize + 1, uint8_t(1));
+    if(tag->fields_[1].blob_.is_inline() || arena.used() <= used) {
+        return fail("a long blob wasn't allocated from the arena");
+    }
+    return true;
+}
+
+static bool test_copy_out(const Module& module)
+{
+    ValueArena *arena = new ValueArena();
+    Value *tree = arena->create<Value>(module.type_by_name("Tree"), arena);
+    for(uint32_t id = 0; id < 20; ++id) {
+        tree->fields_[0].elements_.push_back(make_node(module, id));
+    }
+
+    Value copy(*tree);
+    Value assigned(module.type_by_name("Tree"));
+    assigned = *tree;
+    if(!in_arena(copy, nullptr) || !in_arena(assigned, nullptr)) {
+        return fail("a copy of an arena value refers to the arena");
+    }
+
+    // Reuse the arena's memory, then free it; the copies must be unaffected
+    arena->clear();
+    memset(arena->allocate(arena->capacity() / 2), 0xee, arena->capacity() / 2);
+    delete arena;
+
+    for(const Value *value : {&copy, &assigned}) {
+        const Value::elements_t& nodes = value->fields_[0].elements_;
+        if(nodes.size() != 20) {
+            return fail("a copy of an arena value lost its elements");
+        }
+        for(uint32_t id = 0; id < 20; ++id) {
+            const Value& tag = nodes[id].fields_[1].elements_[0];
+            if(nodes[id].fields_[0].uint_ != id ||
+               string(tag.fields_[0].string_.data(), tag.fields_[0].string_.size()) != kLongName ||
+               tag.fields_[1].blob_.size() != 100 || tag.fields_[1].blob_[99] != uint8_t(id)) {
+                return fail("a copy of an arena value changed when the arena was freed");
+            }
+        }
+    }
+    return true;
+}
+
+// test_move_assign checks that moving a value into a number keeps the number's arena.
+static bool test_move_assign(const Module& module)
+{
+    ValueArena arena;
+    Value *number = arena.create<Value>(module.type_by_name("number"), &arena);
+    *number = make_node(module, 1);
+    if(!in_arena(*number, &arena)) {
+        return fail("a heap value moved into an arena number wasn't copied into the arena");
+    }
+
+    Value heap_number(module.type_by_name("number"));
+    heap_number = move(*arena.create<Value>(make_node(module, 2), &arena));
+    if(!in_arena(heap_number, nullptr)) {
+        return fail("an arena value moved into a heap number wasn't copied to the heap");
+    }
+    return true;
+}
+
+int main()
+{
+    Module module;
+    istringstream in(kSource);
+    if(!parse_dcfile(&module, in, "test.dc")) {
+        cerr << "FAIL: couldn't parse the test module\n";
+        return 1;
+    }
+
+    if(!test_clear() || !test_nested(module) || !test_copy_out(module) ||
+       !test_move_assign(module)) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,63 @@
+// Filename: compile.cpp
+// bamboo-compile parses one or more .dc files into a single module, and writes it out as a
+//     compiled module which can be loaded with read_compiled_module instead of parsing the
+//     .dc files at startup.
+#include <iostream>
+#include <string>
+#include <vector>
+#include "module/Module.h"
+#include "dcfile/parse.h"
+#include "dcfile/compile.h"
+using namespace std;
+using namespace bamboo;
+
+static void usage(const char *program)
+{
+    cerr << "Usage: " << program << " [options] -o file.dcb file.dc [file.dc ...]\n"
+         << "Options:\n"
+         << "  -o <file>       write the compiled module to <file>\n"
+         << "  -k <keyword>    declare a keyword before parsing; may be repeated\n";
+}
+
+int main(int argc, char *argv[])
+{
+    string output;
+    vector<string> keywords, sources;
+    for(int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if((arg == "-o" || arg == "-k") && i + 1 < argc) {
+            string value = argv[++i];
+            if(arg == "-o") { output = value; }
+            else { keywords.push_back(value); }
+        } else if(arg == "-h" || arg == "--help") {
+            usage(argv[0]);
+            return 0;
+        } else if(!arg.empty() && arg[0] == '-') {
+            usage(argv[0]);
+            return 1;
+        } else {
+            sources.push_back(arg);
+        }
+    }
+    if(sources.empty() || output.empty()) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    Module module;
+    for(const string& keyword : keywords) {
+        module.add_keyword(keyword);
+    }
+    for(const string& source : sources) {
+        if(!parse_dcfile(&module, source)) {
+            cerr << "Error: could not parse " << source << ".\n";
+            return 1;
+        }
+    }
+
+    if(!write_compiled_module(&module, output)) {
+        cerr << "Error: could not write " << output << ".\n";
+        return 1;
+    }
+    return 0;
+}